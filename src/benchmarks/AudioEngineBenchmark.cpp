@@ -0,0 +1,315 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include "AudioEngineBenchmark.h"
+#include "Benchmark.h"
+
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/AudioEngine/TransportPosition.h>
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentComponent.h>
+#include <core/Basics/InstrumentLayer.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Note.h>
+#include <core/Basics/Pattern.h>
+#include <core/Basics/PatternList.h>
+#include <core/Basics/Sample.h>
+#include <core/Basics/Song.h>
+#include <core/CoreActionController.h>
+#include <core/Hydrogen.h>
+#include <core/IO/AudioOutput.h>
+#include <core/Preferences/Preferences.h>
+#include <core/Sampler/Sampler.h>
+#include <core/Timeline.h>
+
+#include <cmath>
+
+namespace H2Core
+{
+
+std::shared_ptr<Instrument> AudioEngineBenchmark::createInstrument( int nSampleRate ) {
+	// Ten seconds of a decaying, slightly detuned stereo sine. Long
+	// enough for all notes to be still playing at the end of an
+	// iteration even when pitched up.
+	const int nFrames = 10 * nSampleRate;
+	auto pData_L = new float[ nFrames ];
+	auto pData_R = new float[ nFrames ];
+	for ( int ii = 0; ii < nFrames; ++ii ) {
+		const float fEnvelope = std::exp( -1.0f * ii / nFrames );
+		pData_L[ ii ] = fEnvelope *
+			std::sin( 2 * M_PI * 220.0 * ii / nSampleRate );
+		pData_R[ ii ] = fEnvelope *
+			std::sin( 2 * M_PI * 221.0 * ii / nSampleRate );
+	}
+	auto pSample = std::make_shared<Sample>(
+		"/benchmark/sine.wav", License(), nFrames, nSampleRate,
+		pData_L, pData_R );
+
+	auto pLayer = std::make_shared<InstrumentLayer>( pSample );
+	auto pComponent = std::make_shared<InstrumentComponent>( "Main" );
+	pComponent->setLayer( pLayer, 0 );
+
+	auto pInstrument = std::make_shared<Instrument>( 0, "Benchmark" );
+	pInstrument->get_components()->push_back( pComponent );
+
+	return pInstrument;
+}
+
+long long AudioEngineBenchmark::renderVoices( std::shared_ptr<Instrument> pInstrument,
+											  int nVoices, float fPitch,
+											  int nCycles ) {
+	const int nBufferSize = Preferences::get_instance()->m_nBufferSize;
+	auto pSampler = Hydrogen::get_instance()->getAudioEngine()->getSampler();
+
+	for ( int ii = 0; ii < nVoices; ++ii ) {
+		// Spread the voices across the stereo field so all branches of
+		// the pan law are exercised.
+		const float fPan = nVoices > 1 ?
+			-1.0f + 2.0f * ii / static_cast<float>(nVoices - 1) : 0.0f;
+		pSampler->noteOn( new Note( pInstrument, 0, 0.8, fPan, -1, fPitch ) );
+	}
+
+	for ( int ii = 0; ii < nCycles; ++ii ) {
+		pSampler->process( nBufferSize );
+	}
+
+	pSampler->stopPlayingNotes();
+
+	return static_cast<long long>(nCycles) * nBufferSize;
+}
+
+std::shared_ptr<Song> AudioEngineBenchmark::createLargeSong() {
+	auto pSong = Song::load( Benchmark::testDataFile( "functional/test.h2song" ),
+							 true );
+	if ( pSong == nullptr ) {
+		___ERRORLOG( "Unable to load test song" );
+		return nullptr;
+	}
+
+	// Put a note every third tick on each instrument in every pattern
+	// (in addition to the present ones).
+	auto pInstruments = pSong->getDrumkit()->getInstruments();
+	auto pPatternList = pSong->getPatternList();
+	for ( int nPattern = 0; nPattern < pPatternList->size(); ++nPattern ) {
+		auto pPattern = pPatternList->get( nPattern );
+		for ( int nInstr = 0; nInstr < pInstruments->size(); ++nInstr ) {
+			auto pInstrument = pInstruments->get( nInstr );
+			for ( int nPos = nInstr % 3; nPos < pPattern->get_length(); nPos += 3 ) {
+				pPattern->insert_note( new Note( pInstrument, nPos, 0.5 ) );
+			}
+		}
+	}
+
+	// Cycle through all patterns, several at a time.
+	auto pColumns = pSong->getPatternGroupVector();
+	for ( int nColumn = pColumns->size(); nColumn < nLargeSongColumns; ++nColumn ) {
+		auto pColumn = new PatternList();
+		for ( int ii = 0; ii < std::min( 3, pPatternList->size() ); ++ii ) {
+			pColumn->add( pPatternList->get( ( nColumn + ii ) %
+											 pPatternList->size() ) );
+		}
+		pColumns->push_back( pColumn );
+	}
+
+	return pSong;
+}
+
+void AudioEngineBenchmark::registerBenchmarks( int nVoices ) {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pAE = pHydrogen->getAudioEngine();
+
+	// Both the song and the synthetic instrument are created lazily
+	// within the setUp() functions in order to not spend time on
+	// benchmarks excluded by a filter.
+	auto pInstrument = std::make_shared<std::shared_ptr<Instrument>>();
+	auto pLargeSong = std::make_shared<std::shared_ptr<Song>>();
+
+	auto lockAndReset = [=]() {
+		pAE->lock( RIGHT_HERE );
+		pAE->setState( AudioEngine::State::Testing );
+		pAE->reset( false );
+		pAE->m_fSongSizeInTicks = pHydrogen->getSong()->lengthInTicks();
+	};
+	auto unlock = [=]() {
+		pAE->clearNoteQueues();
+		pAE->getSampler()->stopPlayingNotes();
+		pAE->reset( false );
+		pAE->setState( AudioEngine::State::Ready );
+		pAE->unlock();
+	};
+
+	auto setUpLargeSong = [=]() {
+		if ( *pLargeSong == nullptr ) {
+			*pLargeSong = createLargeSong();
+			if ( *pLargeSong == nullptr ) {
+				return false;
+			}
+		}
+		if ( pHydrogen->getSong() != *pLargeSong ) {
+			pHydrogen->setSong( *pLargeSong );
+		}
+		CoreActionController::activateSongMode( true );
+		CoreActionController::activateLoopMode( true );
+		return true;
+	};
+
+	auto setUpSampler = [=]( Interpolation::InterpolateMode mode ) {
+		if ( *pInstrument == nullptr ) {
+			*pInstrument = createInstrument(
+				pHydrogen->getAudioOutput()->getSampleRate() );
+		}
+		pAE->getSampler()->setInterpolateMode( mode );
+		lockAndReset();
+		return true;
+	};
+
+	////////////////////////////////////////////////////////////////////
+	// Sampler
+
+	Benchmark::add(
+		QString( "sampler/voices%1" ).arg( nVoices ),
+		[=]() { return renderVoices( *pInstrument, nVoices, 0.0, nCycles ); },
+		[=]() { return setUpSampler( Interpolation::InterpolateMode::Linear ); },
+		unlock );
+
+	// Resampling is done in all cases. But only with a fractional
+	// step size the interpolation kernels have actual work to do.
+	for ( const auto& mode : { Interpolation::InterpolateMode::Linear,
+							   Interpolation::InterpolateMode::Cosine,
+							   Interpolation::InterpolateMode::Third,
+							   Interpolation::InterpolateMode::Cubic,
+							   Interpolation::InterpolateMode::Hermite,
+							   Interpolation::InterpolateMode::Sinc } ) {
+		Benchmark::add(
+			QString( "resample/%1" ).arg( Interpolation::ModeToQString( mode ) ),
+			[=]() { return renderVoices( *pInstrument, nVoices, 0.5, nCycles ); },
+			[=]() { return setUpSampler( mode ); },
+			unlock );
+	}
+
+	////////////////////////////////////////////////////////////////////
+	// Note queue
+
+	Benchmark::add(
+		"engine/updateNoteQueue",
+		[=]() {
+			const int nBufferSize = Preferences::get_instance()->m_nBufferSize;
+			for ( int ii = 0; ii < nCycles; ++ii ) {
+				pAE->updateNoteQueue( nBufferSize );
+				pAE->incrementTransportPosition( nBufferSize );
+				// The notes would be handed over to the Sampler in
+				// processPlayNotes(). Dropping them here keeps the
+				// queue - and thus the cost of insertion - at the size
+				// of a single cycle.
+				pAE->clearNoteQueues();
+			}
+			return static_cast<long long>(nCycles) * nBufferSize;
+		},
+		[=]() {
+			if ( ! setUpLargeSong() ) {
+				return false;
+			}
+			lockAndReset();
+			return true;
+		},
+		unlock );
+
+	////////////////////////////////////////////////////////////////////
+	// Tick/frame conversion
+
+	auto convert = [=]() {
+		const int nConversions = 100000;
+		const double fSongSize = pHydrogen->getSong()->lengthInTicks();
+		double fTickMismatch;
+		long long nSum = 0;
+		for ( int ii = 0; ii < nConversions; ++ii ) {
+			const double fTick = std::fmod( ii * 7.37, fSongSize );
+			const long long nFrame = TransportPosition::computeFrameFromTick(
+				fTick, &fTickMismatch );
+			nSum += static_cast<long long>(
+				TransportPosition::computeTickFromFrame( nFrame ) );
+		}
+		// Prevent the compiler from dropping the loop.
+		if ( nSum < 0 ) {
+			___ERRORLOG( "Invalid conversion" );
+		}
+		return 2 * static_cast<long long>(nConversions);
+	};
+
+	Benchmark::add( "conversion/constantTempo", convert,
+					[=]() {
+						if ( ! setUpLargeSong() ) {
+							return false;
+						}
+						pHydrogen->setIsTimelineActivated( false );
+						return true;
+					} );
+
+	Benchmark::add( "conversion/timeline", convert,
+					[=]() {
+						if ( ! setUpLargeSong() ) {
+							return false;
+						}
+						auto pTimeline = pHydrogen->getTimeline();
+						pTimeline->deleteAllTempoMarkers();
+						for ( int nColumn = 0; nColumn < nLargeSongColumns;
+							  nColumn += 2 ) {
+							pTimeline->addTempoMarker( nColumn,
+													   100 + ( nColumn * 7 ) % 80 );
+						}
+						pHydrogen->setIsTimelineActivated( true );
+						return true;
+					},
+					[=]() {
+						pHydrogen->setIsTimelineActivated( false );
+						pHydrogen->getTimeline()->deleteAllTempoMarkers();
+					} );
+
+	////////////////////////////////////////////////////////////////////
+	// Pattern iteration
+
+	Benchmark::add(
+		"patterns/iterate",
+		[=]() {
+			// Visit all notes column by column and tick by tick the
+			// way updateNoteQueue() does.
+			long long nNotes = 0;
+			for ( const auto& pColumn : *pHydrogen->getSong()->getPatternGroupVector() ) {
+				for ( int nPattern = 0; nPattern < pColumn->size(); ++nPattern ) {
+					auto pPattern = pColumn->get( nPattern );
+					const auto notes = pPattern->get_notes();
+					for ( int nTick = 0; nTick < pPattern->get_length(); ++nTick ) {
+						FOREACH_NOTE_CST_IT_BOUND_LENGTH( notes, it, nTick, pPattern ) {
+							if ( it->second != nullptr ) {
+								++nNotes;
+							}
+						}
+					}
+				}
+			}
+			return nNotes;
+		},
+		setUpLargeSong );
+}
+
+};
@@ -0,0 +1,75 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef AUDIO_ENGINE_BENCHMARK_H
+#define AUDIO_ENGINE_BENCHMARK_H
+
+#include <memory>
+
+namespace H2Core
+{
+
+class Instrument;
+class Song;
+
+/**
+ * Benchmarks of the realtime code paths of the #AudioEngine and
+ * #Sampler. All of them operate on the audio engine of the current
+ * #Hydrogen instance using the #FakeDriver, which does not process on
+ * its own, and hold the audio engine lock while being measured.
+ */
+class AudioEngineBenchmark
+{
+public:
+	/**
+	 * Adds all benchmarks to the #Benchmark registry.
+	 *
+	 * \param nVoices Number of notes rendered simultaneously by the
+	 *   #Sampler benchmarks.
+	 */
+	static void registerBenchmarks( int nVoices );
+
+	/** Song of test data densely filled with notes and padded to a
+	 * large number of columns. Shared with the loading benchmarks. */
+	static std::shared_ptr<Song> createLargeSong();
+
+private:
+	/** Instrument featuring a single, synthetic sample long enough
+	 * to keep all voices busy during a whole iteration. */
+	static std::shared_ptr<Instrument> createInstrument( int nSampleRate );
+
+	/** Triggers @a nVoices notes and renders @a nCycles buffers using
+	 * Sampler::process().
+	 *
+	 * \return number of frames rendered. */
+	static long long renderVoices( std::shared_ptr<Instrument> pInstrument,
+								   int nVoices, float fPitch, int nCycles );
+
+	/** Number of process cycles covered by a single iteration. */
+	static constexpr int nCycles = 64;
+	/** Number of columns of the song created by createLargeSong(). */
+	static constexpr int nLargeSongColumns = 64;
+};
+
+};
+
+#endif
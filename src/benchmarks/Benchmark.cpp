@@ -0,0 +1,302 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include "Benchmark.h"
+
+#include <core/config.h>
+#include <core/Object.h>
+
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSysInfo>
+#include <QThread>
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <numeric>
+
+std::vector<Benchmark::Entry>& Benchmark::registry() {
+	static std::vector<Entry> entries;
+	return entries;
+}
+
+QString Benchmark::testDataFile( const QString& sFile ) {
+	return QString( "%1/src/tests/data/%2" ).arg( CMAKE_SOURCE_DIR ).arg( sFile );
+}
+
+void Benchmark::add( const QString& sName, runFunction_t run,
+					 setUpFunction_t setUp, tearDownFunction_t tearDown ) {
+	registry().push_back( { sName, run, setUp, tearDown } );
+}
+
+QStringList Benchmark::names() {
+	QStringList names;
+	for ( const auto& entry : registry() ) {
+		names << entry.sName;
+	}
+	return names;
+}
+
+Benchmark::Result Benchmark::measure( const Entry& entry, int nIterations,
+									  int nWarmUp ) {
+	Result result;
+	result.sName = entry.sName;
+	result.nIterations = nIterations;
+	result.nFrames = 0;
+	result.fWallMedian = result.fWallMin = result.fWallMean =
+		result.fCpuMean = result.fNsPerFrame = 0;
+	result.bFailed = false;
+
+	if ( entry.setUp && ! entry.setUp() ) {
+		___ERRORLOG( QString( "Unable to set up [%1]" ).arg( entry.sName ) );
+		result.bFailed = true;
+		return result;
+	}
+
+	for ( int ii = 0; ii < nWarmUp && ! result.bFailed; ++ii ) {
+		result.bFailed = entry.run() < 0;
+	}
+
+	std::vector<double> wallTimes, cpuTimes;
+	wallTimes.reserve( nIterations );
+	cpuTimes.reserve( nIterations );
+	for ( int ii = 0; ii < nIterations && ! result.bFailed; ++ii ) {
+		const auto start = std::chrono::steady_clock::now();
+		const std::clock_t cpuStart = std::clock();
+
+		result.nFrames = entry.run();
+
+		const std::clock_t cpuEnd = std::clock();
+		const auto end = std::chrono::steady_clock::now();
+
+		wallTimes.push_back(
+			std::chrono::duration<double, std::milli>( end - start ).count() );
+		cpuTimes.push_back( 1000.0 * ( cpuEnd - cpuStart ) / CLOCKS_PER_SEC );
+
+		if ( result.nFrames < 0 ) {
+			result.bFailed = true;
+		}
+	}
+
+	if ( entry.tearDown ) {
+		entry.tearDown();
+	}
+
+	if ( result.bFailed ) {
+		___ERRORLOG( QString( "[%1] failed" ).arg( entry.sName ) );
+		result.nFrames = 0;
+		return result;
+	}
+
+	if ( nIterations <= 0 ) {
+		return result;
+	}
+
+	result.fWallMean = std::accumulate( wallTimes.begin(), wallTimes.end(), 0.0 ) /
+		nIterations;
+	result.fCpuMean = std::accumulate( cpuTimes.begin(), cpuTimes.end(), 0.0 ) /
+		nIterations;
+
+	std::sort( wallTimes.begin(), wallTimes.end() );
+	result.fWallMin = wallTimes.front();
+	if ( nIterations % 2 == 0 ) {
+		result.fWallMedian = 0.5 * ( wallTimes[ nIterations / 2 - 1 ] +
+									 wallTimes[ nIterations / 2 ] );
+	} else {
+		result.fWallMedian = wallTimes[ nIterations / 2 ];
+	}
+
+	result.fNsPerFrame = result.nFrames > 0 ?
+		result.fWallMedian * 1e6 / static_cast<double>(result.nFrames) : 0;
+
+	return result;
+}
+
+std::vector<Benchmark::Result> Benchmark::runAll( const QString& sFilter,
+												  int nIterations, int nWarmUp ) {
+	std::vector<Result> results;
+	for ( const auto& entry : registry() ) {
+		if ( ! sFilter.isEmpty() && ! entry.sName.contains( sFilter ) ) {
+			continue;
+		}
+		___INFOLOG( QString( "Running [%1]" ).arg( entry.sName ) );
+		results.push_back( measure( entry, nIterations, nWarmUp ) );
+	}
+	return results;
+}
+
+QJsonObject Benchmark::Result::toJson() const {
+	QJsonObject object;
+	object.insert( "name", sName );
+	object.insert( "iterations", nIterations );
+	object.insert( "frames", static_cast<double>(nFrames) );
+	object.insert( "wall_ms_median", fWallMedian );
+	object.insert( "wall_ms_min", fWallMin );
+	object.insert( "wall_ms_mean", fWallMean );
+	object.insert( "cpu_ms_mean", fCpuMean );
+	object.insert( "ns_per_frame", fNsPerFrame );
+	return object;
+}
+
+Benchmark::Result Benchmark::Result::fromJson( const QJsonObject& object ) {
+	Result result;
+	result.sName = object.value( "name" ).toString();
+	result.nIterations = object.value( "iterations" ).toInt();
+	result.nFrames = static_cast<long long>(object.value( "frames" ).toDouble());
+	result.fWallMedian = object.value( "wall_ms_median" ).toDouble();
+	result.fWallMin = object.value( "wall_ms_min" ).toDouble();
+	result.fWallMean = object.value( "wall_ms_mean" ).toDouble();
+	result.fCpuMean = object.value( "cpu_ms_mean" ).toDouble();
+	result.fNsPerFrame = object.value( "ns_per_frame" ).toDouble();
+	result.bFailed = false;
+	return result;
+}
+
+QJsonObject Benchmark::toJson( const std::vector<Result>& results ) {
+	QJsonArray benchmarks;
+	for ( const auto& result : results ) {
+		if ( ! result.bFailed ) {
+			benchmarks.append( result.toJson() );
+		}
+	}
+
+	QJsonObject host;
+	host.insert( "os", QSysInfo::prettyProductName() );
+	host.insert( "cpu_architecture", QSysInfo::currentCpuArchitecture() );
+	host.insert( "threads", QThread::idealThreadCount() );
+
+	QJsonObject object;
+	object.insert( "format_version", nFormatVersion );
+	object.insert( "hydrogen_version", QString( H2CORE_VERSION ) );
+	object.insert( "date", QDateTime::currentDateTimeUtc().toString( Qt::ISODate ) );
+	object.insert( "host", host );
+	object.insert( "benchmarks", benchmarks );
+	return object;
+}
+
+bool Benchmark::readBaseline( const QString& sPath, std::vector<Result>* pResults ) {
+	QFile file( sPath );
+	if ( ! file.open( QIODevice::ReadOnly ) ) {
+		___ERRORLOG( QString( "Unable to open baseline [%1]" ).arg( sPath ) );
+		return false;
+	}
+
+	QJsonParseError error;
+	const auto doc = QJsonDocument::fromJson( file.readAll(), &error );
+	if ( doc.isNull() || ! doc.isObject() ) {
+		___ERRORLOG( QString( "Unable to parse baseline [%1]: %2" )
+					 .arg( sPath ).arg( error.errorString() ) );
+		return false;
+	}
+
+	const auto object = doc.object();
+	if ( object.value( "format_version" ).toInt() != nFormatVersion ) {
+		___ERRORLOG( QString( "Unsupported format version [%1] of baseline [%2]" )
+					 .arg( object.value( "format_version" ).toInt() ).arg( sPath ) );
+		return false;
+	}
+
+	pResults->clear();
+	for ( const auto& value : object.value( "benchmarks" ).toArray() ) {
+		pResults->push_back( Result::fromJson( value.toObject() ) );
+	}
+
+	return true;
+}
+
+std::vector<Benchmark::Comparison> Benchmark::compare( const std::vector<Result>& results,
+													   const std::vector<Result>& baseline,
+													   double fThreshold ) {
+	std::vector<Comparison> comparisons;
+	for ( const auto& result : results ) {
+		if ( result.bFailed ) {
+			continue;
+		}
+		const auto it = std::find_if( baseline.begin(), baseline.end(),
+									  [&]( const Result& reference ) {
+										  return reference.sName == result.sName; } );
+		if ( it == baseline.end() ) {
+			continue;
+		}
+
+		// Compare the per-frame cost whenever available in order to
+		// not flag benchmarks whose size was changed on purpose.
+		double fBaseline, fCurrent;
+		if ( it->fNsPerFrame > 0 && result.fNsPerFrame > 0 ) {
+			fBaseline = it->fNsPerFrame;
+			fCurrent = result.fNsPerFrame;
+		} else {
+			fBaseline = it->fWallMedian;
+			fCurrent = result.fWallMedian;
+		}
+
+		Comparison comparison;
+		comparison.sName = result.sName;
+		comparison.fBaseline = fBaseline;
+		comparison.fCurrent = fCurrent;
+		comparison.fChange = fBaseline > 0 ?
+			100.0 * ( fCurrent - fBaseline ) / fBaseline : 0;
+		comparison.bRegression = comparison.fChange > fThreshold;
+		comparisons.push_back( comparison );
+	}
+
+	return comparisons;
+}
+
+QString Benchmark::format( const std::vector<Result>& results ) {
+	QString sOutput = QString( "%1 %2 %3 %4 %5 %6\n" )
+		.arg( "Benchmark", -28 ).arg( "frames", 10 ).arg( "median [ms]", 12 )
+		.arg( "min [ms]", 10 ).arg( "cpu [ms]", 10 ).arg( "ns/frame", 10 );
+	for ( const auto& result : results ) {
+		if ( result.bFailed ) {
+			sOutput.append( QString( "%1 %2\n" )
+							.arg( result.sName, -28 ).arg( "FAILED", 10 ) );
+			continue;
+		}
+		sOutput.append( QString( "%1 %2 %3 %4 %5 %6\n" )
+						.arg( result.sName, -28 )
+						.arg( result.nFrames, 10 )
+						.arg( result.fWallMedian, 12, 'f', 3 )
+						.arg( result.fWallMin, 10, 'f', 3 )
+						.arg( result.fCpuMean, 10, 'f', 3 )
+						.arg( result.fNsPerFrame, 10, 'f', 2 ) );
+	}
+	return sOutput;
+}
+
+QString Benchmark::format( const std::vector<Comparison>& comparisons ) {
+	QString sOutput = QString( "%1 %2 %3 %4\n" )
+		.arg( "Benchmark", -28 ).arg( "baseline", 12 ).arg( "current", 12 )
+		.arg( "change", 9 );
+	for ( const auto& comparison : comparisons ) {
+		sOutput.append( QString( "%1 %2 %3 %4%5\n" )
+						.arg( comparison.sName, -28 )
+						.arg( comparison.fBaseline, 12, 'f', 3 )
+						.arg( comparison.fCurrent, 12, 'f', 3 )
+						.arg( QString( "%1%" ).arg( comparison.fChange, 0, 'f', 1 ), 9 )
+						.arg( comparison.bRegression ? "  REGRESSION" : "" ) );
+	}
+	return sOutput;
+}
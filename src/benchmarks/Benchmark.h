@@ -0,0 +1,153 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef H2_BENCHMARK_H
+#define H2_BENCHMARK_H
+
+#include <functional>
+#include <vector>
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+/**
+ * Minimal registry and runner for the microbenchmarks of the
+ * `h2benchmarks` target.
+ *
+ * Each benchmark consists of an optional setUp() and tearDown() called
+ * once around the measurement and a run() function performing a single
+ * iteration. run() returns the number of units - usually audio frames
+ * - processed. It is used to normalize the results into a per-frame
+ * cost which stays comparable when the size of a benchmark changes.
+ *
+ * A benchmark fails in case setUp() returns false or run() returns a
+ * negative number. Its timings are meaningless then and it is neither
+ * written to JSON nor compared against a baseline. In case setUp()
+ * fails, it has to clean up after itself as tearDown() is not called.
+ *
+ * Each iteration is timed individually using both a monotonic wall
+ * clock and the CPU time of the process. The median of the wall-clock
+ * times is the figure compared against a baseline as it is robust
+ * against the occasional preemption of the benchmark process.
+ */
+class Benchmark
+{
+public:
+	struct Result {
+		QString sName;
+		int nIterations;
+		/** Units processed per iteration. */
+		long long nFrames;
+		/** All times in milliseconds per iteration. */
+		double fWallMedian;
+		double fWallMin;
+		double fWallMean;
+		double fCpuMean;
+		/** Median wall-clock time divided by #nFrames. */
+		double fNsPerFrame;
+		/** Whether setUp() or one of the iterations failed. */
+		bool bFailed;
+
+		QJsonObject toJson() const;
+		static Result fromJson( const QJsonObject& object );
+	};
+
+	struct Comparison {
+		QString sName;
+		double fBaseline;
+		double fCurrent;
+		/** Relative change of the median wall-clock time in percent.
+		 * Positive values indicate a slowdown. */
+		double fChange;
+		bool bRegression;
+	};
+
+	typedef std::function<long long()> runFunction_t;
+	typedef std::function<bool()> setUpFunction_t;
+	typedef std::function<void()> tearDownFunction_t;
+
+	/** Adds a benchmark to the registry. Names are grouped using
+	 * slashes, e.g. "resample/Cubic". */
+	static void add( const QString& sName, runFunction_t run,
+					 setUpFunction_t setUp = nullptr,
+					 tearDownFunction_t tearDown = nullptr );
+
+	/** Names of all registered benchmarks. */
+	static QStringList names();
+
+	/**
+	 * Runs all benchmarks whose name contains @a sFilter.
+	 *
+	 * \param nIterations Number of timed iterations per benchmark.
+	 * \param nWarmUp Number of untimed iterations preceding them.
+	 */
+	static std::vector<Result> runAll( const QString& sFilter,
+									   int nIterations, int nWarmUp );
+
+	/** Serializes all @a results which did not fail along with
+	 * information about the build and host. */
+	static QJsonObject toJson( const std::vector<Result>& results );
+	/**
+	 * Reads the results stored using toJson() from @a sPath.
+	 *
+	 * \return false in case the file could not be read or parsed.
+	 */
+	static bool readBaseline( const QString& sPath,
+							  std::vector<Result>* pResults );
+
+	/**
+	 * Compares all @a results against the ones in @a baseline of the
+	 * same name. Benchmarks not present in both or failed ones are
+	 * skipped.
+	 *
+	 * \param fThreshold Relative slowdown in percent above which a
+	 *   benchmark is considered a regression.
+	 */
+	static std::vector<Comparison> compare( const std::vector<Result>& results,
+											const std::vector<Result>& baseline,
+											double fThreshold );
+
+	/** Human readable tables for the terminal. */
+	static QString format( const std::vector<Result>& results );
+	static QString format( const std::vector<Comparison>& comparisons );
+
+	/** Absolute path of @a sFile within the test data folder
+	 * (src/tests/data) of the source tree. */
+	static QString testDataFile( const QString& sFile );
+
+	/** Version of the JSON layout written by toJson(). */
+	static constexpr int nFormatVersion = 1;
+
+private:
+	struct Entry {
+		QString sName;
+		runFunction_t run;
+		setUpFunction_t setUp;
+		tearDownFunction_t tearDown;
+	};
+
+	static std::vector<Entry>& registry();
+	static Result measure( const Entry& entry, int nIterations, int nWarmUp );
+};
+
+#endif
@@ -0,0 +1,170 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include "FileBenchmark.h"
+#include "AudioEngineBenchmark.h"
+#include "Benchmark.h"
+
+#include <core/config.h>
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Note.h>
+#include <core/Basics/Pattern.h>
+#include <core/Basics/Song.h>
+#include <core/Helpers/Filesystem.h>
+#include <core/Helpers/Xml.h>
+
+#include <memory>
+
+namespace H2Core
+{
+
+void FileBenchmark::registerBenchmarks() {
+	const QString sSongFile = Benchmark::testDataFile( "functional/test.h2song" );
+	const QString sLargeSongFile = Filesystem::tmp_file_path( "benchmark.h2song" );
+	const QString sPatternFile = Filesystem::tmp_file_path( "benchmark.h2pattern" );
+	const QString sDrumkitDir = Filesystem::sys_drumkits_dir() + "GMRockKit";
+
+	Benchmark::add(
+		"load/song",
+		[=]() {
+			auto pSong = Song::load( sSongFile, true );
+			if ( pSong == nullptr ) {
+				___ERRORLOG( QString( "Unable to load [%1]" ).arg( sSongFile ) );
+				return -1LL;
+			}
+			return 1LL;
+		} );
+
+	auto createLargeSong = [=]() {
+		auto pSong = AudioEngineBenchmark::createLargeSong();
+		if ( pSong == nullptr || ! pSong->save( sLargeSongFile, true ) ) {
+			___ERRORLOG( QString( "Unable to create [%1]" ).arg( sLargeSongFile ) );
+			return false;
+		}
+		return true;
+	};
+	auto removeLargeSong = [=]() { Filesystem::rm( sLargeSongFile, false, true ); };
+
+	Benchmark::add(
+		"load/largeSong",
+		[=]() {
+			auto pSong = Song::load( sLargeSongFile, true );
+			if ( pSong == nullptr ) {
+				___ERRORLOG( QString( "Unable to load [%1]" ).arg( sLargeSongFile ) );
+				return -1LL;
+			}
+			return 1LL;
+		},
+		createLargeSong, removeLargeSong );
+
+	// Reading the drumkit.xml alone and including decoding all its
+	// samples.
+	Benchmark::add(
+		"load/drumkit",
+		[=]() {
+			auto pDrumkit = Drumkit::load( sDrumkitDir, false, true );
+			if ( pDrumkit == nullptr ) {
+				___ERRORLOG( QString( "Unable to load [%1]" ).arg( sDrumkitDir ) );
+				return -1LL;
+			}
+			return static_cast<long long>(pDrumkit->getInstruments()->size());
+		} );
+
+	Benchmark::add(
+		"load/drumkitSamples",
+		[=]() {
+			auto pDrumkit = Drumkit::load( sDrumkitDir, false, true );
+			if ( pDrumkit == nullptr ) {
+				___ERRORLOG( QString( "Unable to load [%1]" ).arg( sDrumkitDir ) );
+				return -1LL;
+			}
+			pDrumkit->loadSamples();
+			return static_cast<long long>(pDrumkit->getInstruments()->size());
+		} );
+
+	// Synthesize a pattern large enough for parsing to dominate the
+	// file system access.
+	auto createPattern = [=]() {
+		Pattern pattern( "benchmark", "", "", MAX_NOTES, 4 );
+		for ( int ii = 0; ii < nPatternNotes; ++ii ) {
+			auto pNote = new Note( nullptr, ii % MAX_NOTES, 0.8, 0.0, -1, 0.0 );
+			pNote->set_instrument_id( ii % 16 );
+			pNote->setType( QString( "type %1" ).arg( ii % 16 ) );
+			pattern.insert_note( pNote );
+		}
+		if ( ! pattern.save_file( "GMRockKit", sPatternFile, true ) ) {
+			___ERRORLOG( QString( "Unable to create [%1]" ).arg( sPatternFile ) );
+			return false;
+		}
+		return true;
+	};
+	auto removePattern = [=]() { Filesystem::rm( sPatternFile, false, true ); };
+
+	Benchmark::add(
+		"load/pattern",
+		[=]() {
+			std::unique_ptr<Pattern> pPattern( Pattern::load_file( sPatternFile ) );
+			if ( pPattern == nullptr ) {
+				___ERRORLOG( QString( "Unable to load [%1]" ).arg( sPatternFile ) );
+				return -1LL;
+			}
+			return static_cast<long long>(pPattern->get_notes()->size());
+		},
+		createPattern, removePattern );
+
+	Benchmark::add(
+		"xml/parse",
+		[=]() {
+			XMLDoc doc;
+			if ( ! doc.read( sPatternFile, nullptr, true ) ) {
+				return -1LL;
+			}
+			return static_cast<long long>(nPatternNotes);
+		},
+		createPattern, removePattern );
+
+	// Reference for "load/largeSong" which streams the patterns instead.
+	Benchmark::add(
+		"xml/parseLargeSong",
+		[=]() {
+			XMLDoc doc;
+			if ( ! doc.read( sLargeSongFile, nullptr, true ) ) {
+				return -1LL;
+			}
+			return 1LL;
+		},
+		createLargeSong, removeLargeSong );
+
+	Benchmark::add(
+		"xml/parseAndValidate",
+		[=]() {
+			XMLDoc doc;
+			if ( ! doc.read( sPatternFile, Filesystem::pattern_xsd_path(), true ) ) {
+				return -1LL;
+			}
+			return static_cast<long long>(nPatternNotes);
+		},
+		createPattern, removePattern );
+}
+
+};
@@ -0,0 +1,50 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef FILE_BENCHMARK_H
+#define FILE_BENCHMARK_H
+
+namespace H2Core
+{
+
+/**
+ * Benchmarks of loading songs, drumkits, and patterns from disk as
+ * well as of the underlying XML parsing and validation.
+ *
+ * Since the files are read many times in a row, they will be served
+ * from the page cache and the results reflect parsing and decoding
+ * rather than disk access.
+ */
+class FileBenchmark
+{
+public:
+	/** Adds all benchmarks to the #Benchmark registry. */
+	static void registerBenchmarks();
+
+private:
+	/** Number of notes contained in the synthetic pattern. */
+	static constexpr int nPatternNotes = 20000;
+};
+
+};
+
+#endif
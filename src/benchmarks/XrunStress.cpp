@@ -0,0 +1,366 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include "XrunStress.h"
+
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/AudioEngine/ProcessProfiler.h>
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Note.h>
+#include <core/Basics/Pattern.h>
+#include <core/Basics/PatternList.h>
+#include <core/Basics/Song.h>
+#include <core/CoreActionController.h>
+#include <core/Helpers/Filesystem.h>
+#include <core/Hydrogen.h>
+#include <core/IO/AudioOutput.h>
+#include <core/Preferences/Preferences.h>
+
+#include <QJsonArray>
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <thread>
+
+namespace H2Core
+{
+
+QString XrunStress::EventToQString( Event event ) {
+	switch ( event ) {
+	case Event::Tempo:
+		return "tempo";
+	case Event::Relocation:
+		return "relocation";
+	case Event::Drumkit:
+		return "drumkit";
+	case Event::PatternEdit:
+		return "patternEdit";
+	default:
+		return QString( "Unknown event [%1]" ).arg( static_cast<int>(event) );
+	}
+}
+
+XrunStress::XrunStress( const Config& config )
+	: m_config( config )
+	, m_bDisturb( false )
+	, m_nDrumkitSwitches( 0 ) {
+	for ( auto& nCount : m_eventCounts ) {
+		nCount.store( 0 );
+	}
+
+	if ( m_config.events[ static_cast<int>(Event::Drumkit) ] ) {
+		for ( const auto& sKit : { "GMRockKit", "TR808EmulationKit" } ) {
+			auto pDrumkit = Drumkit::load(
+				Filesystem::sys_drumkits_dir() + sKit, false, true );
+			if ( pDrumkit == nullptr ) {
+				___ERRORLOG( QString( "Unable to load drumkit [%1]" ).arg( sKit ) );
+				continue;
+			}
+			pDrumkit->loadSamples();
+			m_drumkits.push_back( pDrumkit );
+		}
+	}
+}
+
+XrunStress::~XrunStress() {
+}
+
+std::vector<XrunStress::Result> XrunStress::run() {
+	auto pPref = Preferences::get_instance();
+	const int nOldBufferSize = pPref->m_nBufferSize;
+
+	std::vector<Result> results;
+	for ( const int nBufferSize : m_config.bufferSizes ) {
+		___INFOLOG( QString( "Stressing buffer size [%1]" ).arg( nBufferSize ) );
+		results.push_back( runBufferSize( nBufferSize ) );
+	}
+
+	pPref->m_nBufferSize = nOldBufferSize;
+	Hydrogen::get_instance()->restartDrivers();
+
+	return results;
+}
+
+XrunStress::Result XrunStress::runBufferSize( int nBufferSize ) {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pAudioEngine = pHydrogen->getAudioEngine();
+	auto pProfiler = pAudioEngine->getProfiler();
+
+	// The FakeDriver allocates its buffers on startup.
+	Preferences::get_instance()->m_nBufferSize = nBufferSize;
+	pHydrogen->restartDrivers();
+	CoreActionController::locateToTick( 0 );
+
+	Result result;
+	result.nBufferSize = nBufferSize;
+	result.nSampleRate = pHydrogen->getAudioOutput()->getSampleRate();
+	result.fPeriod = 1000.0 * nBufferSize / result.nSampleRate;
+
+	const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<double, std::milli>( result.fPeriod ) );
+	const long nTotalCycles = std::max(
+		1L, static_cast<long>( m_config.fDuration * 1000.0 / result.fPeriod ) );
+
+	// All latencies are stored in order to obtain exact percentiles.
+	// The memory is allocated up front to not do so in the process
+	// loop.
+	std::vector<float> latencies;
+	latencies.reserve( nTotalCycles );
+	long nMisses = 0;
+	long nLockFailures = 0;
+
+	for ( auto& nCount : m_eventCounts ) {
+		nCount.store( 0 );
+	}
+
+	// Start the first cycle to get transport rolling before anyone
+	// interferes and drop statistics of previous runs.
+	AudioEngine::audioEngine_process( nBufferSize, nullptr );
+	pProfiler->reset();
+
+	m_bDisturb.store( true );
+	std::vector<std::thread> disturbers;
+	for ( int ii = 0; ii < m_config.nThreads; ++ii ) {
+		disturbers.emplace_back( &XrunStress::disturb, this,
+								 static_cast<unsigned>( nBufferSize * 31 + ii ) );
+	}
+
+	std::thread processThread( [&]() {
+		auto release = std::chrono::steady_clock::now();
+		for ( long nCycle = 0; nCycle < nTotalCycles; ++nCycle ) {
+			const uint64_t nLocksBefore =
+				pProfiler->getStatistics( ProcessProfiler::Stage::Lock ).nCount;
+
+			// Sleep till shortly before the release and spin for the
+			// remainder. Waking up from sleep alone is too imprecise
+			// for the smallest periods.
+			const auto wakeUp = release - std::chrono::microseconds( 100 );
+			if ( std::chrono::steady_clock::now() < wakeUp ) {
+				std::this_thread::sleep_until( wakeUp );
+			}
+			while ( std::chrono::steady_clock::now() < release ) {
+				// spin
+			}
+
+			AudioEngine::audioEngine_process( nBufferSize, nullptr );
+
+			const auto end = std::chrono::steady_clock::now();
+			if ( pProfiler->getStatistics( ProcessProfiler::Stage::Lock ).nCount ==
+				 nLocksBefore ) {
+				++nLockFailures;
+			}
+
+			latencies.push_back(
+				std::chrono::duration<float, std::milli>( end - release ).count() );
+
+			release += period;
+			if ( end > release ) {
+				++nMisses;
+				// Like a device after an xrun we skip the periods we
+				// are late for.
+				while ( release < end ) {
+					release += period;
+				}
+			}
+		}
+	} );
+	processThread.join();
+
+	m_bDisturb.store( false );
+	for ( auto& disturber : disturbers ) {
+		disturber.join();
+	}
+
+	result.nCycles = latencies.size();
+	result.nMisses = nMisses;
+	result.nLockFailures = nLockFailures;
+	result.fLatencyMean = latencies.empty() ? 0 :
+		std::accumulate( latencies.begin(), latencies.end(), 0.0 ) / latencies.size();
+	std::sort( latencies.begin(), latencies.end() );
+	result.fLatencyMax = latencies.empty() ? 0 : latencies.back();
+	result.fLatencyPercentile99 = latencies.empty() ? 0 :
+		latencies[ std::min( latencies.size() - 1, latencies.size() * 99 / 100 ) ];
+
+	const auto lockStatistics =
+		pProfiler->getStatistics( ProcessProfiler::Stage::Lock );
+	result.fLockWaitMax = lockStatistics.fMax;
+	result.fLockWaitMean = lockStatistics.fMean;
+
+	for ( int ii = 0; ii < nEvents; ++ii ) {
+		result.events[ ii ] = m_eventCounts[ ii ].load();
+	}
+
+	return result;
+}
+
+void XrunStress::disturb( unsigned nSeed ) {
+	std::mt19937 rng( nSeed );
+
+	std::vector<Event> events;
+	for ( int ii = 0; ii < nEvents; ++ii ) {
+		if ( m_config.events[ ii ] ) {
+			events.push_back( static_cast<Event>(ii) );
+		}
+	}
+	if ( events.empty() ) {
+		return;
+	}
+
+	std::uniform_int_distribution<int> eventDist( 0, events.size() - 1 );
+	std::uniform_int_distribution<int> intervalDist(
+		0, 2 * std::max( m_config.nEventInterval, 0 ) );
+
+	while ( m_bDisturb.load() ) {
+		std::this_thread::sleep_for(
+			std::chrono::milliseconds( intervalDist( rng ) ) );
+		if ( ! m_bDisturb.load() ) {
+			break;
+		}
+
+		const auto event = events[ eventDist( rng ) ];
+		trigger( event, rng );
+		m_eventCounts[ static_cast<int>(event) ].fetch_add( 1 );
+	}
+}
+
+void XrunStress::trigger( Event event, std::mt19937& rng ) {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pAudioEngine = pHydrogen->getAudioEngine();
+	auto pSong = pHydrogen->getSong();
+	if ( pSong == nullptr ) {
+		return;
+	}
+
+	switch ( event ) {
+	case Event::Tempo:
+		CoreActionController::setBpm(
+			std::uniform_real_distribution<float>( 60, 240 )( rng ) );
+		break;
+
+	case Event::Relocation: {
+		const long nSongLength = std::max( 1L, pSong->lengthInTicks() );
+		CoreActionController::locateToTick(
+			std::uniform_int_distribution<long>( 0, nSongLength - 1 )( rng ) );
+		break;
+	}
+
+	case Event::Drumkit:
+		if ( ! m_drumkits.empty() ) {
+			const int nSwitch = m_nDrumkitSwitches.fetch_add( 1 );
+			CoreActionController::setDrumkit(
+				m_drumkits[ nSwitch % m_drumkits.size() ] );
+		}
+		break;
+
+	case Event::PatternEdit: {
+		pAudioEngine->lock( RIGHT_HERE );
+
+		auto pPatternList = pSong->getPatternList();
+		auto pInstruments = pSong->getDrumkit()->getInstruments();
+		if ( pPatternList->size() > 0 && pInstruments->size() > 0 ) {
+			auto pPattern = pPatternList->get(
+				std::uniform_int_distribution<int>(
+					0, pPatternList->size() - 1 )( rng ) );
+			auto pInstrument = pInstruments->get(
+				std::uniform_int_distribution<int>(
+					0, pInstruments->size() - 1 )( rng ) );
+			const int nColumn = std::uniform_int_distribution<int>(
+				0, std::max( 0, pPattern->get_length() - 1 ) )( rng );
+
+			// Toggle the note at the chosen grid cell.
+			Pattern::notes_t* notes = (Pattern::notes_t*)pPattern->get_notes();
+			bool bFound = false;
+			FOREACH_NOTE_IT_BOUND_END( notes, it, nColumn ) {
+				Note* pNote = it->second;
+				if ( pNote != nullptr &&
+					 pNote->get_instrument_id() == pInstrument->get_id() ) {
+					notes->erase( it );
+					delete pNote;
+					bFound = true;
+					break;
+				}
+			}
+			if ( ! bFound ) {
+				pPattern->insert_note( new Note( pInstrument, nColumn, 0.8 ) );
+			}
+			pHydrogen->setIsModified( true );
+		}
+
+		pAudioEngine->unlock();
+		break;
+	}
+
+	default:
+		break;
+	}
+}
+
+QJsonObject XrunStress::Result::toJson() const {
+	QJsonObject eventObject;
+	for ( int ii = 0; ii < nEvents; ++ii ) {
+		eventObject.insert( EventToQString( static_cast<Event>(ii) ),
+							static_cast<double>(events[ ii ]) );
+	}
+
+	QJsonObject object;
+	object.insert( "buffer_size", nBufferSize );
+	object.insert( "sample_rate", nSampleRate );
+	object.insert( "period_ms", fPeriod );
+	object.insert( "cycles", static_cast<double>(nCycles) );
+	object.insert( "deadline_misses", static_cast<double>(nMisses) );
+	object.insert( "lock_failures", static_cast<double>(nLockFailures) );
+	object.insert( "latency_ms_max", fLatencyMax );
+	object.insert( "latency_ms_p99", fLatencyPercentile99 );
+	object.insert( "latency_ms_mean", fLatencyMean );
+	object.insert( "lock_wait_ms_max", fLockWaitMax );
+	object.insert( "lock_wait_ms_mean", fLockWaitMean );
+	object.insert( "events", eventObject );
+	return object;
+}
+
+QString XrunStress::format( const std::vector<Result>& results ) {
+	QString sOutput = QString( "%1 %2 %3 %4 %5 %6 %7 %8 %9\n" )
+		.arg( "buffer", 6 ).arg( "period", 8 ).arg( "cycles", 8 )
+		.arg( "misses", 7 ).arg( "no lock", 7 ).arg( "lat p99", 8 )
+		.arg( "lat max", 8 ).arg( "lock max", 8 ).arg( "events", 7 );
+	for ( const auto& result : results ) {
+		const long nEventsTotal = std::accumulate(
+			result.events.begin(), result.events.end(), 0L );
+		sOutput.append( QString( "%1 %2 %3 %4 %5 %6 %7 %8 %9\n" )
+						.arg( result.nBufferSize, 6 )
+						.arg( result.fPeriod, 8, 'f', 3 )
+						.arg( result.nCycles, 8 )
+						.arg( result.nMisses, 7 )
+						.arg( result.nLockFailures, 7 )
+						.arg( result.fLatencyPercentile99, 8, 'f', 3 )
+						.arg( result.fLatencyMax, 8, 'f', 3 )
+						.arg( result.fLockWaitMax, 8, 'f', 3 )
+						.arg( nEventsTotal, 7 ) );
+	}
+	sOutput.append( "All times in milliseconds.\n" );
+	return sOutput;
+}
+
+};
@@ -0,0 +1,141 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#ifndef XRUN_STRESS_H
+#define XRUN_STRESS_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <QJsonObject>
+#include <QString>
+
+namespace H2Core
+{
+
+class Drumkit;
+
+/**
+ * Drives AudioEngine::audioEngine_process() on a synthetic realtime
+ * schedule while other threads modify the engine the way the GUI or
+ * OSC/MIDI handlers do.
+ *
+ * For each buffer size the #FakeDriver is restarted and the current
+ * song is played in loop mode for a fixed duration. A dedicated thread
+ * releases one process cycle per period (buffer size divided by sample
+ * rate) and checks whether it completes before its deadline. The
+ * deadline of a cycle is its release time plus one period. Cycles
+ * missing it are counted as xruns and the schedule is resynchronized -
+ * the way a real device skips the buffers it missed.
+ *
+ * Meanwhile disturber threads randomly inject tempo changes,
+ * relocations, drumkit switches, and note insertions/removals into the
+ * patterns of the song.
+ *
+ * The time spent waiting for the audio engine lock as well as failed
+ * lock attempts (resulting in a dropped buffer) are taken from the
+ * #ProcessProfiler of the engine.
+ */
+class XrunStress
+{
+public:
+	enum class Event {
+		/** CoreActionController::setBpm() */
+		Tempo = 0,
+		/** CoreActionController::locateToTick() */
+		Relocation = 1,
+		/** CoreActionController::setDrumkit() */
+		Drumkit = 2,
+		/** Inserting or removing a note while holding the audio
+		 * engine lock like the DrumPatternEditor does. */
+		PatternEdit = 3
+	};
+	static constexpr int nEvents = 4;
+	static QString EventToQString( Event event );
+
+	struct Config {
+		std::vector<int> bufferSizes;
+		/** Seconds of audio processed per buffer size. */
+		double fDuration;
+		/** Mean time between two events of a single disturber thread
+		 * in milliseconds. */
+		int nEventInterval;
+		int nThreads;
+		/** Which events will be injected. */
+		std::array<bool, nEvents> events;
+	};
+
+	struct Result {
+		int nBufferSize;
+		int nSampleRate;
+		/** Length of a period in milliseconds. */
+		float fPeriod;
+		long nCycles;
+		/** Cycles completing after their deadline. */
+		long nMisses;
+		/** Cycles in which the audio engine could not be locked in
+		 * time and no audio was rendered. */
+		long nLockFailures;
+		/** Time between release and completion of a cycle in
+		 * milliseconds. */
+		float fLatencyMax;
+		float fLatencyPercentile99;
+		float fLatencyMean;
+		/** Time waiting for the audio engine lock in milliseconds. */
+		float fLockWaitMax;
+		float fLockWaitMean;
+		std::array<long, nEvents> events;
+
+		QJsonObject toJson() const;
+	};
+
+	XrunStress( const Config& config );
+	~XrunStress();
+
+	/** Runs all buffer sizes in turn. Restores the buffer size of the
+	 * #Preferences afterwards. */
+	std::vector<Result> run();
+
+	/** Table of all @a results for the terminal. */
+	static QString format( const std::vector<Result>& results );
+
+private:
+	Result runBufferSize( int nBufferSize );
+	/** Main loop of a disturber thread. */
+	void disturb( unsigned nSeed );
+	void trigger( Event event, std::mt19937& rng );
+
+	Config m_config;
+	std::atomic<bool> m_bDisturb;
+	std::array<std::atomic<long>, nEvents> m_eventCounts;
+	/** Kits alternately switched to. Loaded once up front to not
+	 * measure disk access. */
+	std::vector<std::shared_ptr<Drumkit>> m_drumkits;
+	std::atomic<int> m_nDrumkitSwitches;
+};
+
+};
+
+#endif
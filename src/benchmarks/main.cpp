@@ -0,0 +1,370 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <core/config.h>
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/Basics/Song.h>
+#include <core/CoreActionController.h>
+#include <core/EventQueue.h>
+#include <core/Helpers/Filesystem.h>
+#include <core/Hydrogen.h>
+#include <core/Logger.h>
+#include <core/Preferences/Preferences.h>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+
+#include "AudioEngineBenchmark.h"
+#include "Benchmark.h"
+#include "FileBenchmark.h"
+#include "XrunStress.h"
+
+#include <iostream>
+
+using namespace H2Core;
+
+void setupEnvironment( unsigned nLogLevel, int nBufferSize )
+{
+	auto pLogger = Logger::bootstrap( nLogLevel, "", true, true );
+	Base::bootstrap( pLogger, true );
+	// Use the data folder of the source tree. This way the benchmarks
+	// do not depend on an installation of Hydrogen and always pick up
+	// the same drumkits and songs.
+	Filesystem::bootstrap( pLogger, QString( "%1/data/" ).arg( CMAKE_SOURCE_DIR ) );
+
+	// The fake driver does not process on its own. All process cycles
+	// are issued by the benchmarks themselves.
+	Preferences::create_instance();
+	auto pPref = Preferences::get_instance();
+	pPref->m_audioDriver = Preferences::AudioDriver::Fake;
+	pPref->m_nBufferSize = nBufferSize;
+
+	Hydrogen::create_instance();
+	EventQueue::get_instance()->setSilent( true );
+}
+
+int main( int argc, char **argv)
+{
+	QCoreApplication app( argc, argv );
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription(
+		"Microbenchmarks of the Hydrogen core library.\n\n"
+		"Results are printed as a table and can be written to a JSON file. "
+		"When a baseline written by a previous run is provided, all "
+		"benchmarks present in both are compared and the program exits "
+		"with a non-zero status in case one of them got slower by more "
+		"than the threshold. Benchmarks failing to set up or run are "
+		"reported, left out of the results, and cause a non-zero exit "
+		"status as well.\n\n"
+		"With --xrun-stress the audio engine is instead driven on a "
+		"synthetic realtime schedule for several buffer sizes while other "
+		"threads inject tempo changes, relocations, drumkit switches, and "
+		"pattern edits. Deadline misses, latency, and lock wait times are "
+		"reported." );
+	QCommandLineOption verboseOption( QStringList() << "V" << "verbose", "Level, if present, may be None, Error, Warning, Info, Debug or 0xHHHH", "Level" );
+	QCommandLineOption listOption( QStringList() << "l" << "list", "List all benchmarks and exit" );
+	QCommandLineOption filterOption( QStringList() << "f" << "filter", "Run only benchmarks whose name contains <Filter>", "Filter", "" );
+	QCommandLineOption iterationsOption( QStringList() << "n" << "iterations", "Number of timed iterations per benchmark (default: 10)", "Iterations", "10" );
+	QCommandLineOption warmUpOption( QStringList() << "w" << "warm-up", "Number of untimed iterations preceding them (default: 1)", "Iterations", "1" );
+	QCommandLineOption voicesOption( QStringList() << "voices", "Number of notes rendered simultaneously in the sampler benchmarks (default: 32)", "Voices", "32" );
+	QCommandLineOption bufferSizeOption( QStringList() << "buffer-size", "Number of frames per process cycle (default: 1024)", "Frames", "1024" );
+	QCommandLineOption outputOption( QStringList() << "o" << "output", "Write results to <File> in JSON format", "File", "" );
+	QCommandLineOption baselineOption( QStringList() << "b" << "baseline", "Compare results against <File> written by a previous run", "File", "" );
+	QCommandLineOption thresholdOption( QStringList() << "t" << "threshold", "Relative slowdown in percent considered a regression (default: 10)", "Percent", "10" );
+	QCommandLineOption stressOption( QStringList() << "xrun-stress", "Run the xrun stress harness instead of the benchmarks" );
+	QCommandLineOption bufferSizesOption( QStringList() << "buffer-sizes", "Comma separated buffer sizes used in the stress harness (default: 16,32,...,4096)", "Frames", "16,32,64,128,256,512,1024,2048,4096" );
+	QCommandLineOption durationOption( QStringList() << "duration", "Seconds of audio processed per buffer size in the stress harness (default: 2)", "Seconds", "2" );
+	QCommandLineOption intervalOption( QStringList() << "event-interval", "Mean time between two events injected by a single thread in milliseconds (default: 10)", "Milliseconds", "10" );
+	QCommandLineOption threadsOption( QStringList() << "threads", "Number of threads injecting events (default: 2)", "Threads", "2" );
+	QCommandLineOption eventsOption( QStringList() << "events", "Comma separated events to inject: tempo, relocation, drumkit, patternEdit (default: all)", "Events", "tempo,relocation,drumkit,patternEdit" );
+	QCommandLineOption songOption( QStringList() << "song", "Song played in the stress harness (default: test song)", "File", "" );
+	QCommandLineOption maxNotesOption( QStringList() << "max-notes", "Maximum number of notes played simultaneously by the sampler", "Notes", "" );
+	QCommandLineOption interpolationOption( QStringList() << "interpolation", "Interpolation mode of the sampler: Linear, Cosine, Third, Cubic, Hermite, Sinc", "Mode", "" );
+	QCommandLineOption failOnXrunOption( QStringList() << "fail-on-xrun", "Exit with a non-zero status in case the stress harness encountered a deadline miss" );
+	parser.addHelpOption();
+	parser.addOption( verboseOption );
+	parser.addOption( listOption );
+	parser.addOption( filterOption );
+	parser.addOption( iterationsOption );
+	parser.addOption( warmUpOption );
+	parser.addOption( voicesOption );
+	parser.addOption( bufferSizeOption );
+	parser.addOption( outputOption );
+	parser.addOption( baselineOption );
+	parser.addOption( thresholdOption );
+	parser.addOption( stressOption );
+	parser.addOption( bufferSizesOption );
+	parser.addOption( durationOption );
+	parser.addOption( intervalOption );
+	parser.addOption( threadsOption );
+	parser.addOption( eventsOption );
+	parser.addOption( songOption );
+	parser.addOption( maxNotesOption );
+	parser.addOption( interpolationOption );
+	parser.addOption( failOnXrunOption );
+	parser.process( app );
+
+	unsigned nLogLevel = Logger::Error;
+	if ( parser.isSet( verboseOption ) ) {
+		const QString sVerbosityString = parser.value( verboseOption );
+		if ( ! sVerbosityString.isEmpty() ) {
+			nLogLevel = Logger::parse_log_level( sVerbosityString.toLocal8Bit() );
+		} else {
+			nLogLevel = Logger::Error | Logger::Warning | Logger::Info;
+		}
+	}
+
+	bool bOk;
+	const int nIterations = parser.value( iterationsOption ).toInt( &bOk );
+	if ( ! bOk || nIterations < 1 ) {
+		std::cerr << "Invalid number of iterations" << std::endl;
+		return 2;
+	}
+	const int nWarmUp = parser.value( warmUpOption ).toInt( &bOk );
+	if ( ! bOk || nWarmUp < 0 ) {
+		std::cerr << "Invalid number of warm-up iterations" << std::endl;
+		return 2;
+	}
+	const int nVoices = parser.value( voicesOption ).toInt( &bOk );
+	if ( ! bOk || nVoices < 1 ) {
+		std::cerr << "Invalid number of voices" << std::endl;
+		return 2;
+	}
+	const int nBufferSize = parser.value( bufferSizeOption ).toInt( &bOk );
+	if ( ! bOk || nBufferSize < 1 || nBufferSize > MAX_BUFFER_SIZE ) {
+		std::cerr << "Invalid buffer size" << std::endl;
+		return 2;
+	}
+	const double fThreshold = parser.value( thresholdOption ).toDouble( &bOk );
+	if ( ! bOk ) {
+		std::cerr << "Invalid threshold" << std::endl;
+		return 2;
+	}
+
+	setupEnvironment( nLogLevel, nBufferSize );
+
+	auto pHydrogen = Hydrogen::get_instance();
+	if ( parser.isSet( maxNotesOption ) ) {
+		const int nMaxNotes = parser.value( maxNotesOption ).toInt( &bOk );
+		if ( ! bOk || nMaxNotes < 1 ) {
+			std::cerr << "Invalid maximum number of notes" << std::endl;
+			return 2;
+		}
+		Preferences::get_instance()->m_nMaxNotes = nMaxNotes;
+	}
+	if ( parser.isSet( interpolationOption ) ) {
+		bool bFound;
+		const auto mode = Interpolation::ModeFromQString(
+			parser.value( interpolationOption ), &bFound );
+		if ( bFound ) {
+			pHydrogen->getAudioEngine()->getSampler()->setInterpolateMode( mode );
+		}
+		else {
+			std::cerr << "Unknown interpolation mode" << std::endl;
+			return 2;
+		}
+	}
+
+	if ( parser.isSet( stressOption ) ) {
+		XrunStress::Config config;
+		for ( const auto& sSize : parser.value( bufferSizesOption ).split( "," ) ) {
+			const int nSize = sSize.trimmed().toInt( &bOk );
+			if ( ! bOk || nSize < 1 || nSize > MAX_BUFFER_SIZE ) {
+				std::cerr << "Invalid buffer size " << sSize.toStdString() << std::endl;
+				return 2;
+			}
+			config.bufferSizes.push_back( nSize );
+		}
+		config.fDuration = parser.value( durationOption ).toDouble( &bOk );
+		if ( ! bOk || config.fDuration <= 0 ) {
+			std::cerr << "Invalid duration" << std::endl;
+			return 2;
+		}
+		config.nEventInterval = parser.value( intervalOption ).toInt( &bOk );
+		if ( ! bOk || config.nEventInterval < 0 ) {
+			std::cerr << "Invalid event interval" << std::endl;
+			return 2;
+		}
+		config.nThreads = parser.value( threadsOption ).toInt( &bOk );
+		if ( ! bOk || config.nThreads < 0 ) {
+			std::cerr << "Invalid number of threads" << std::endl;
+			return 2;
+		}
+		config.events.fill( false );
+		for ( const auto& sEvent : parser.value( eventsOption ).split( "," ) ) {
+			bool bFound = false;
+			for ( int ii = 0; ii < XrunStress::nEvents; ++ii ) {
+				if ( XrunStress::EventToQString( static_cast<XrunStress::Event>(ii) )
+					 .compare( sEvent.trimmed(), Qt::CaseInsensitive ) == 0 ) {
+					config.events[ ii ] = true;
+					bFound = true;
+				}
+			}
+			if ( ! bFound && ! sEvent.trimmed().isEmpty() ) {
+				std::cerr << "Unknown event " << sEvent.toStdString() << std::endl;
+				return 2;
+			}
+		}
+
+		QString sSong = parser.value( songOption );
+		if ( sSong.isEmpty() ) {
+			sSong = Benchmark::testDataFile( "functional/test.h2song" );
+		}
+		auto pSong = Song::load( sSong, true );
+		if ( pSong == nullptr ) {
+			std::cerr << "Unable to load song " << sSong.toStdString() << std::endl;
+			return 2;
+		}
+		pHydrogen->setSong( pSong );
+		CoreActionController::activateSongMode( true );
+		CoreActionController::activateLoopMode( true );
+
+		XrunStress stress( config );
+		const auto results = stress.run();
+
+		QTextStream out( stdout );
+		out << XrunStress::format( results );
+		out.flush();
+
+		long nMisses = 0;
+		QJsonArray jsonResults;
+		for ( const auto& result : results ) {
+			nMisses += result.nMisses;
+			jsonResults.append( result.toJson() );
+		}
+
+		int nReturnCode = 0;
+		const QString sOutput = parser.value( outputOption );
+		if ( ! sOutput.isEmpty() ) {
+			QJsonObject json;
+			json.insert( "format_version", Benchmark::nFormatVersion );
+			json.insert( "hydrogen_version", QString( H2CORE_VERSION ) );
+			json.insert( "xrun_stress", jsonResults );
+			QFile file( sOutput );
+			if ( ! file.open( QIODevice::WriteOnly | QIODevice::Truncate ) ) {
+				std::cerr << "Unable to write results to "
+						  << sOutput.toStdString() << std::endl;
+				nReturnCode = 2;
+			} else {
+				file.write( QJsonDocument( json ).toJson() );
+			}
+		}
+
+		if ( nReturnCode == 0 && parser.isSet( failOnXrunOption ) && nMisses > 0 ) {
+			nReturnCode = 1;
+		}
+
+		auto pLogger = Logger::get_instance();
+		pLogger->flush();
+		delete pLogger;
+
+		return nReturnCode;
+	}
+
+	AudioEngineBenchmark::registerBenchmarks( nVoices );
+	FileBenchmark::registerBenchmarks();
+
+	QTextStream out( stdout );
+
+	if ( parser.isSet( listOption ) ) {
+		for ( const auto& sName : Benchmark::names() ) {
+			out << sName << "\n";
+		}
+		return 0;
+	}
+
+	// Read the baseline first to not run all benchmarks just to find
+	// out it is broken.
+	std::vector<Benchmark::Result> baseline;
+	const QString sBaseline = parser.value( baselineOption );
+	if ( ! sBaseline.isEmpty() &&
+		 ! Benchmark::readBaseline( sBaseline, &baseline ) ) {
+		std::cerr << "Unable to read baseline" << std::endl;
+		return 2;
+	}
+
+	const auto results = Benchmark::runAll( parser.value( filterOption ),
+											nIterations, nWarmUp );
+	out << Benchmark::format( results );
+
+	int nReturnCode = 0;
+	QJsonObject json = Benchmark::toJson( results );
+
+	QJsonArray failures;
+	for ( const auto& result : results ) {
+		if ( result.bFailed ) {
+			failures.append( result.sName );
+		}
+	}
+	json.insert( "failures", failures );
+
+	if ( ! sBaseline.isEmpty() ) {
+		const auto comparisons = Benchmark::compare( results, baseline, fThreshold );
+		out << "\nComparison against [" << sBaseline << "] (ns/frame):\n"
+			<< Benchmark::format( comparisons );
+
+		QJsonArray regressions;
+		for ( const auto& comparison : comparisons ) {
+			if ( comparison.bRegression ) {
+				regressions.append( comparison.sName );
+			}
+		}
+		json.insert( "regressions", regressions );
+		json.insert( "threshold_percent", fThreshold );
+
+		if ( regressions.size() > 0 ) {
+			out << QString( "\n%1 benchmark(s) regressed by more than %2%\n" )
+				.arg( regressions.size() ).arg( fThreshold );
+			nReturnCode = 1;
+		}
+	}
+
+	if ( failures.size() > 0 ) {
+		out << QString( "\n%1 benchmark(s) failed\n" ).arg( failures.size() );
+		nReturnCode = 2;
+	}
+	out.flush();
+
+	const QString sOutput = parser.value( outputOption );
+	if ( ! sOutput.isEmpty() ) {
+		QFile file( sOutput );
+		if ( ! file.open( QIODevice::WriteOnly | QIODevice::Truncate ) ) {
+			std::cerr << "Unable to write results to "
+					  << sOutput.toStdString() << std::endl;
+			nReturnCode = 2;
+		} else {
+			file.write( QJsonDocument( json ).toJson() );
+		}
+	}
+
+	auto pLogger = Logger::get_instance();
+	pLogger->flush();
+	delete pLogger;
+
+	return nReturnCode;
+}
@@ -0,0 +1,593 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2002-2008 by Alex >Comix< Cominu [comix@users.sourceforge.net]
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include "ControlServer.h"
+
+#ifndef WIN32
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/AudioEngine/ProcessProfiler.h>
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Song.h>
+#include <core/CoreActionController.h>
+#include <core/Hydrogen.h>
+#include <core/IO/AudioOutput.h>
+
+using namespace H2Core;
+
+ControlServer::ControlServer()
+	: m_nListenFd( -1 )
+	, m_bExporting( false )
+	, m_nSessionSampleRate( 0 )
+	, m_nSessionSampleDepth( 0 )
+	, m_nNextJobId( 1 )
+	, m_nJobsDone( 0 )
+	, m_nJobsFailed( 0 )
+	, m_bQuitRequested( false ) {
+}
+
+ControlServer::~ControlServer() {
+	auto pHydrogen = Hydrogen::get_instance();
+	if ( m_bExporting ) {
+		pHydrogen->stopExportSong();
+		m_bExporting = false;
+	}
+	stopExportSession();
+
+	// Last attempt to deliver pending replies, like the one to
+	// "quit".
+	for ( auto& client : m_clients ) {
+		flushClient( client );
+		::close( client.nFd );
+	}
+	m_clients.clear();
+
+	if ( m_nListenFd != -1 ) {
+		::close( m_nListenFd );
+		::unlink( m_sPath.toLocal8Bit().constData() );
+	}
+}
+
+bool ControlServer::listen( const QString& sPath ) {
+	const QByteArray path = sPath.toLocal8Bit();
+
+	struct sockaddr_un address;
+	memset( &address, 0, sizeof( address ) );
+	address.sun_family = AF_UNIX;
+	if ( path.size() >= static_cast<int>(sizeof( address.sun_path )) ) {
+		ERRORLOG( QString( "Socket path [%1] too long" ).arg( sPath ) );
+		return false;
+	}
+	strncpy( address.sun_path, path.constData(), sizeof( address.sun_path ) - 1 );
+
+	const int nFd = ::socket( AF_UNIX, SOCK_STREAM, 0 );
+	if ( nFd == -1 ) {
+		ERRORLOG( QString( "Unable to create socket: %1" )
+				  .arg( strerror( errno ) ) );
+		return false;
+	}
+
+	// Check whether a daemon is already listening or whether we deal
+	// with a leftover of a previous one which was not shut down
+	// properly.
+	struct stat fileInfo;
+	if ( ::stat( path.constData(), &fileInfo ) == 0 ) {
+		if ( ! S_ISSOCK( fileInfo.st_mode ) ) {
+			ERRORLOG( QString( "[%1] exists and is not a socket" ).arg( sPath ) );
+			::close( nFd );
+			return false;
+		}
+		if ( ::connect( nFd, reinterpret_cast<struct sockaddr*>(&address),
+						sizeof( address ) ) == 0 ) {
+			ERRORLOG( QString( "Another daemon is already listening at [%1]" )
+					  .arg( sPath ) );
+			::close( nFd );
+			return false;
+		}
+		WARNINGLOG( QString( "Removing stale socket [%1]" ).arg( sPath ) );
+		::unlink( path.constData() );
+	}
+
+	if ( ::bind( nFd, reinterpret_cast<struct sockaddr*>(&address),
+				 sizeof( address ) ) == -1 ||
+		 ::listen( nFd, 8 ) == -1 ) {
+		ERRORLOG( QString( "Unable to listen at [%1]: %2" )
+				  .arg( sPath ).arg( strerror( errno ) ) );
+		::close( nFd );
+		return false;
+	}
+	fcntl( nFd, F_SETFL, fcntl( nFd, F_GETFL ) | O_NONBLOCK );
+
+	// Writing to a client which disconnected in the meantime must not
+	// terminate the daemon.
+	signal( SIGPIPE, SIG_IGN );
+
+	m_sPath = sPath;
+	m_nListenFd = nFd;
+	INFOLOG( QString( "Listening at [%1]" ).arg( sPath ) );
+
+	return true;
+}
+
+void ControlServer::poll( int nTimeoutMs ) {
+	std::vector<struct pollfd> fds;
+	fds.push_back( { m_nListenFd, POLLIN, 0 } );
+	for ( const auto& client : m_clients ) {
+		short nEvents = POLLIN;
+		if ( ! client.output.isEmpty() ) {
+			nEvents |= POLLOUT;
+		}
+		fds.push_back( { client.nFd, nEvents, 0 } );
+	}
+
+	if ( ::poll( fds.data(), fds.size(), nTimeoutMs ) > 0 ) {
+		// Clients connected during this call are polled the next time.
+		std::vector<int> closedFds;
+		for ( size_t ii = 1; ii < fds.size(); ++ii ) {
+			const short nRevents = fds[ ii ].revents;
+			if ( nRevents == 0 ) {
+				continue;
+			}
+			for ( auto& client : m_clients ) {
+				if ( client.nFd != fds[ ii ].fd ) {
+					continue;
+				}
+				if ( ( ( nRevents & POLLOUT ) && ! flushClient( client ) ) ||
+					 ( ( nRevents & ~POLLOUT ) && ! readClient( client ) ) ) {
+					closedFds.push_back( client.nFd );
+				}
+			}
+		}
+		for ( const int nFd : closedFds ) {
+			closeClient( nFd );
+		}
+
+		if ( fds[ 0 ].revents & POLLIN ) {
+			acceptClient();
+		}
+	}
+
+	processJobs();
+}
+
+void ControlServer::acceptClient() {
+	const int nFd = ::accept( m_nListenFd, nullptr, nullptr );
+	if ( nFd == -1 ) {
+		if ( errno != EAGAIN && errno != EWOULDBLOCK ) {
+			ERRORLOG( QString( "Unable to accept connection: %1" )
+					  .arg( strerror( errno ) ) );
+		}
+		return;
+	}
+	fcntl( nFd, F_SETFL, fcntl( nFd, F_GETFL ) | O_NONBLOCK );
+
+	m_clients.push_back( { nFd, QByteArray(), QByteArray() } );
+	INFOLOG( QString( "Client [%1] connected" ).arg( nFd ) );
+}
+
+bool ControlServer::readClient( Client& client ) {
+	char buffer[ 1024 ];
+	const ssize_t nRead = ::recv( client.nFd, buffer, sizeof( buffer ), 0 );
+	if ( nRead == 0 ) {
+		return false;
+	}
+	else if ( nRead < 0 ) {
+		return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+	}
+	client.input.append( buffer, static_cast<int>(nRead) );
+
+	QStringList lines;
+	int nEnd;
+	while ( ( nEnd = client.input.indexOf( '\n' ) ) != -1 ) {
+		lines << QString::fromUtf8( client.input.left( nEnd ) ).trimmed();
+		client.input.remove( 0, nEnd + 1 );
+	}
+	const int nFd = client.nFd;
+	const bool bTooLong = client.input.size() > nMaxLineLength;
+
+	for ( const auto& sLine : lines ) {
+		if ( ! sLine.isEmpty() ) {
+			handleCommand( nFd, sLine );
+		}
+	}
+
+	if ( bTooLong ) {
+		reply( nFd, QString( "ERR command exceeds %1 bytes" )
+			   .arg( nMaxLineLength ) );
+		return false;
+	}
+
+	return true;
+}
+
+bool ControlServer::flushClient( Client& client ) {
+	while ( ! client.output.isEmpty() ) {
+		const ssize_t nSent = ::send( client.nFd, client.output.constData(),
+									  client.output.size(), 0 );
+		if ( nSent < 0 ) {
+			if ( errno == EINTR ) {
+				continue;
+			}
+			else if ( errno == EAGAIN || errno == EWOULDBLOCK ) {
+				return true;
+			}
+			WARNINGLOG( QString( "Unable to reply to client [%1]: %2" )
+						.arg( client.nFd ).arg( strerror( errno ) ) );
+			return false;
+		}
+		client.output.remove( 0, static_cast<int>(nSent) );
+	}
+
+	return true;
+}
+
+void ControlServer::closeClient( int nFd ) {
+	INFOLOG( QString( "Client [%1] disconnected" ).arg( nFd ) );
+	::close( nFd );
+
+	for ( auto it = m_clients.begin(); it != m_clients.end(); ++it ) {
+		if ( it->nFd == nFd ) {
+			m_clients.erase( it );
+			break;
+		}
+	}
+
+	// Jobs submitted by the client will still be processed.
+	for ( auto& job : m_jobs ) {
+		if ( job.nClientFd == nFd ) {
+			job.nClientFd = -1;
+		}
+	}
+	if ( m_bExporting && m_currentExport.nClientFd == nFd ) {
+		m_currentExport.nClientFd = -1;
+	}
+}
+
+void ControlServer::reply( int nFd, const QString& sMessage ) {
+	if ( nFd == -1 ) {
+		return;
+	}
+
+	for ( auto& client : m_clients ) {
+		if ( client.nFd == nFd ) {
+			client.output.append( sMessage.toUtf8() + '\n' );
+			// Whatever the socket does not accept right away is sent
+			// once it becomes writable again. In case of an error the
+			// connection is closed the next time the client is read
+			// from.
+			if ( ! flushClient( client ) ) {
+				client.output.clear();
+			}
+			return;
+		}
+	}
+}
+
+bool ControlServer::tokenize( const QString& sLine, QStringList* pTokens ) {
+	pTokens->clear();
+
+	QString sToken;
+	bool bInToken = false;
+	bool bQuoted = false;
+	for ( int ii = 0; ii < sLine.size(); ++ii ) {
+		const QChar c = sLine[ ii ];
+		if ( c == '\\' && ii + 1 < sLine.size() ) {
+			sToken.append( sLine[ ++ii ] );
+			bInToken = true;
+		}
+		else if ( c == '"' ) {
+			bQuoted = ! bQuoted;
+			bInToken = true;
+		}
+		else if ( c.isSpace() && ! bQuoted ) {
+			if ( bInToken ) {
+				pTokens->append( sToken );
+				sToken.clear();
+				bInToken = false;
+			}
+		}
+		else {
+			sToken.append( c );
+			bInToken = true;
+		}
+	}
+	if ( bInToken ) {
+		pTokens->append( sToken );
+	}
+
+	return ! bQuoted;
+}
+
+void ControlServer::handleCommand( int nFd, const QString& sLine ) {
+	INFOLOG( QString( "[%1] %2" ).arg( nFd ).arg( sLine ) );
+
+	QStringList tokens;
+	if ( ! tokenize( sLine, &tokens ) ) {
+		reply( nFd, "ERR unterminated quote" );
+		return;
+	}
+	const QString sCommand = tokens.value( 0 ).toLower();
+	auto pHydrogen = Hydrogen::get_instance();
+
+	if ( sCommand == "play" || sCommand == "stop" ) {
+		if ( m_bExporting || ! m_jobs.empty() ) {
+			reply( nFd, "ERR jobs pending" );
+			return;
+		}
+		if ( sCommand == "play" ) {
+			pHydrogen->sequencerPlay();
+		} else {
+			pHydrogen->sequencerStop();
+		}
+		reply( nFd, "OK" );
+	}
+	else if ( sCommand == "stats" ) {
+		reply( nFd, QString( "OK %1" ).arg( stats() ) );
+	}
+	else if ( sCommand == "quit" ) {
+		m_bQuitRequested = true;
+		reply( nFd, "OK" );
+	}
+	else if ( sCommand == "load" || sCommand == "kit" ||
+			  sCommand == "export" ) {
+		Job job;
+		job.nId = m_nNextJobId;
+		job.nClientFd = nFd;
+		job.sArgument = tokens.value( 1 );
+		job.nSampleRate = 44100;
+		job.nSampleDepth = 16;
+
+		if ( job.sArgument.isEmpty() || tokens.size() > 4 ||
+			 ( sCommand != "export" && tokens.size() > 2 ) ) {
+			reply( nFd, QString( "ERR usage: %1" ).arg(
+					   sCommand == "load" ? "load <song>" :
+					   sCommand == "kit" ? "kit <drumkit>" :
+					   "export <file> [<rate> [<bits>]]" ) );
+			return;
+		}
+
+		if ( sCommand == "load" ) {
+			job.type = Job::Type::LoadSong;
+		}
+		else if ( sCommand == "kit" ) {
+			job.type = Job::Type::SetDrumkit;
+		}
+		else {
+			job.type = Job::Type::Export;
+			bool bOk = true;
+			if ( tokens.size() > 2 ) {
+				job.nSampleRate = tokens[ 2 ].toInt( &bOk );
+			}
+			if ( bOk && tokens.size() > 3 ) {
+				job.nSampleDepth = tokens[ 3 ].toInt( &bOk );
+			}
+			if ( ! bOk || job.nSampleRate <= 0 || job.nSampleDepth <= 0 ) {
+				reply( nFd, "ERR invalid sample rate or depth" );
+				return;
+			}
+		}
+
+		++m_nNextJobId;
+		m_jobs.push_back( job );
+		reply( nFd, QString( "OK queued %1" ).arg( job.nId ) );
+	}
+	else {
+		reply( nFd, QString( "ERR unknown command [%1]" ).arg( sCommand ) );
+	}
+}
+
+void ControlServer::processJobs() {
+	while ( ! m_bExporting && ! m_jobs.empty() ) {
+		const Job job = m_jobs.front();
+		m_jobs.pop_front();
+
+		QString sError;
+		if ( ! runJob( job, &sError ) ) {
+			ERRORLOG( QString( "Job [%1] failed: %2" ).arg( job.nId ).arg( sError ) );
+			++m_nJobsFailed;
+			reply( job.nClientFd, QString( "FAILED %1 %2" )
+				   .arg( job.nId ).arg( sError ) );
+		}
+		else if ( ! m_bExporting ) {
+			++m_nJobsDone;
+			reply( job.nClientFd, QString( "DONE %1" ).arg( job.nId ) );
+		}
+	}
+
+	// Bring back the regular audio driver once there is nothing left
+	// to export.
+	if ( ! m_bExporting && m_jobs.empty() ) {
+		stopExportSession();
+	}
+}
+
+bool ControlServer::runJob( const Job& job, QString* pError ) {
+	auto pHydrogen = Hydrogen::get_instance();
+
+	if ( job.type == Job::Type::LoadSong ) {
+		stopExportSession();
+		const auto pSong = CoreActionController::loadSong( job.sArgument );
+		if ( pSong == nullptr || ! CoreActionController::setSong( pSong ) ) {
+			*pError = QString( "unable to load song [%1]" ).arg( job.sArgument );
+			return false;
+		}
+		return true;
+	}
+	else if ( job.type == Job::Type::SetDrumkit ) {
+		stopExportSession();
+		if ( ! CoreActionController::setDrumkit( job.sArgument ) ) {
+			*pError = QString( "unable to set drumkit [%1]" ).arg( job.sArgument );
+			return false;
+		}
+		return true;
+	}
+
+	const auto pSong = pHydrogen->getSong();
+	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
+		*pError = "no song loaded";
+		return false;
+	}
+
+	if ( pHydrogen->getIsExportSessionActive() &&
+		 ( job.nSampleRate != m_nSessionSampleRate ||
+		   job.nSampleDepth != m_nSessionSampleDepth ) ) {
+		stopExportSession();
+	}
+	if ( ! pHydrogen->getIsExportSessionActive() ) {
+		if ( ! pHydrogen->startExportSession( job.nSampleRate,
+											  job.nSampleDepth ) ) {
+			*pError = "unable to start export session";
+			return false;
+		}
+		m_nSessionSampleRate = job.nSampleRate;
+		m_nSessionSampleDepth = job.nSampleDepth;
+	}
+
+	auto pInstrumentList = pSong->getDrumkit()->getInstruments();
+	for ( int ii = 0; ii < pInstrumentList->size(); ++ii ) {
+		pInstrumentList->get( ii )->set_currently_exported( true );
+	}
+
+	m_currentExport = job;
+	m_bExporting = true;
+	pHydrogen->startExportSong( job.sArgument );
+
+	return true;
+}
+
+void ControlServer::exportProgress( int nValue ) {
+	if ( ! m_bExporting ) {
+		return;
+	}
+
+	if ( nValue == -1 ) {
+		finishExport( false, QString( "unable to export to [%1]" )
+					  .arg( m_currentExport.sArgument ) );
+	}
+	else if ( nValue >= 100 ) {
+		finishExport( true, "" );
+	}
+}
+
+void ControlServer::finishExport( bool bSuccess, const QString& sError ) {
+	Hydrogen::get_instance()->stopExportSong();
+	m_bExporting = false;
+
+	if ( bSuccess ) {
+		++m_nJobsDone;
+		reply( m_currentExport.nClientFd,
+			   QString( "DONE %1" ).arg( m_currentExport.nId ) );
+	}
+	else {
+		ERRORLOG( QString( "Job [%1] failed: %2" )
+				  .arg( m_currentExport.nId ).arg( sError ) );
+		++m_nJobsFailed;
+		reply( m_currentExport.nClientFd, QString( "FAILED %1 %2" )
+			   .arg( m_currentExport.nId ).arg( sError ) );
+	}
+}
+
+void ControlServer::stopExportSession() {
+	auto pHydrogen = Hydrogen::get_instance();
+	if ( pHydrogen->getIsExportSessionActive() ) {
+		pHydrogen->stopExportSession();
+	}
+}
+
+QString ControlServer::stats() const {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pAudioEngine = pHydrogen->getAudioEngine();
+	const auto pSong = pHydrogen->getSong();
+
+	QString sSong, sDrumkit;
+	if ( pSong != nullptr ) {
+		sSong = pSong->getFilename();
+		if ( pSong->getDrumkit() != nullptr ) {
+			sDrumkit = pSong->getDrumkit()->getName();
+		}
+	}
+	int nXRuns = 0;
+	if ( pHydrogen->getAudioOutput() != nullptr ) {
+		nXRuns = pHydrogen->getAudioOutput()->getXRuns();
+	}
+	const auto statistics = pAudioEngine->getProfiler()->getStatistics(
+		ProcessProfiler::Stage::Total );
+
+	// Values containing whitespace are quoted so they can be parsed
+	// using tokenize().
+	auto quote = []( const QString& sValue ) {
+		return QString( "\"%1\"" ).arg(
+			QString( sValue ).replace( "\\", "\\\\" ).replace( "\"", "\\\"" ) );
+	};
+
+	return QString( "state=%1 song=%2 kit=%3 exporting=%4 queued=%5 done=%6 failed=%7 xruns=%8 process_mean_ms=%9" )
+		.arg( AudioEngine::StateToQString( pAudioEngine->getState() ) )
+		.arg( quote( sSong ) ).arg( quote( sDrumkit ) )
+		.arg( m_bExporting ? m_currentExport.nId : 0 )
+		.arg( m_jobs.size() ).arg( m_nJobsDone ).arg( m_nJobsFailed )
+		.arg( nXRuns ).arg( statistics.fMean )
+		.append( QString( " process_max_ms=%1" ).arg( statistics.fMax ) );
+}
+
+QString ControlServer::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[ControlServer]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_sPath: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_sPath ) )
+			.append( QString( "%1%2m_clients: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_clients.size() ) )
+			.append( QString( "%1%2m_jobs: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_jobs.size() ) )
+			.append( QString( "%1%2m_bExporting: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_bExporting ) )
+			.append( QString( "%1%2m_nJobsDone: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nJobsDone ) )
+			.append( QString( "%1%2m_nJobsFailed: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nJobsFailed ) );
+	}
+	else {
+		sOutput = QString( "[ControlServer] m_sPath: %1" ).arg( m_sPath )
+			.append( QString( ", m_clients: %1" ).arg( m_clients.size() ) )
+			.append( QString( ", m_jobs: %1" ).arg( m_jobs.size() ) )
+			.append( QString( ", m_bExporting: %1" ).arg( m_bExporting ) )
+			.append( QString( ", m_nJobsDone: %1" ).arg( m_nJobsDone ) )
+			.append( QString( ", m_nJobsFailed: %1" ).arg( m_nJobsFailed ) );
+	}
+
+	return sOutput;
+}
+
+#endif // WIN32
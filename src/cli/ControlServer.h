@@ -0,0 +1,193 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2002-2008 by Alex >Comix< Cominu [comix@users.sourceforge.net]
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef CONTROL_SERVER_H
+#define CONTROL_SERVER_H
+
+#ifndef WIN32
+
+#include <deque>
+#include <vector>
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+#include <core/Object.h>
+
+/**
+ * Line based control interface of h2cli running as a daemon
+ * (--daemon).
+ *
+ * Clients connect to a UNIX domain socket and send one command per
+ * line. Arguments are separated by whitespace and can be enclosed in
+ * double quotes in case they contain whitespace themselves. Each
+ * command is answered by exactly one line starting either with "OK" or
+ * "ERR".
+ *
+ * - play / stop - start and stop the transport
+ * - stats - state of the engine, the current song and kit, and the job
+ *   queue as key=value pairs
+ * - load \<song\> - load a song (*.h2song)
+ * - kit \<drumkit\> - switch to a drumkit (name or path)
+ * - export \<file\> [\<rate\> [\<bits\>]] - export the current song
+ * - quit - shut down the daemon
+ *
+ * `load`, `kit`, and `export` are executed one after another in the
+ * order they were received and only acknowledged by "OK queued \<id\>"
+ * right away. Once a job is finished an additional line "DONE \<id\>" or
+ * "FAILED \<id\> \<reason\>" is sent to the client which submitted it.
+ * This way a client can submit a whole batch of songs at once.
+ *
+ * Consecutive export jobs using the same sample rate and depth share a
+ * single export session and the DiskWriterDriver is not restarted in
+ * between. Drumkits already loaded stay in the SoundLibraryDatabase
+ * for all subsequent jobs.
+ *
+ * All commands are handled within the main thread of h2cli using
+ * poll().
+ */
+class ControlServer : public H2Core::Object<ControlServer>
+{
+	H2_OBJECT(ControlServer)
+public:
+	ControlServer();
+	/** Stops a running export, closes all connections and removes
+	 * the socket file. */
+	~ControlServer();
+
+	/**
+	 * Creates the socket at @a sPath. In case a stale socket of a
+	 * previous daemon is found, it will be replaced.
+	 *
+	 * \return false in case the socket could not be created or another
+	 *   daemon is already listening at @a sPath.
+	 */
+	bool listen( const QString& sPath );
+
+	/** Waits up to @a nTimeoutMs milliseconds for new connections and
+	 * commands, handles them, and starts the next queued job if
+	 * possible. */
+	void poll( int nTimeoutMs );
+
+	/** Has to be called with the value of each EVENT_PROGRESS. */
+	void exportProgress( int nValue );
+
+	bool isQuitRequested() const;
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+	/** Maximum length of a single command in bytes. Clients sending
+	 * longer ones are disconnected. */
+	static constexpr int nMaxLineLength = 4096;
+
+	/**
+	 * Splits @a sLine into whitespace separated arguments. Double
+	 * quotes group arguments containing whitespace and a backslash
+	 * escapes the following character.
+	 *
+	 * \return false in case of an unterminated quote.
+	 */
+	static bool tokenize( const QString& sLine, QStringList* pTokens );
+
+private:
+	struct Client {
+		int nFd;
+		QByteArray input;
+		/** Replies not yet accepted by the socket. They are sent
+		 * once poll() reports the client to be writable again. */
+		QByteArray output;
+	};
+
+	struct Job {
+		enum class Type {
+			LoadSong,
+			SetDrumkit,
+			Export
+		};
+		Type type;
+		int nId;
+		/** Client the job was submitted by. -1 in case it already
+		 * disconnected. */
+		int nClientFd;
+		/** Path of the song, drumkit, or output file. */
+		QString sArgument;
+		int nSampleRate;
+		int nSampleDepth;
+	};
+
+	void acceptClient();
+	/** \return false in case the client disconnected or has to be
+	 * disconnected. */
+	bool readClient( Client& client );
+	/** Sends as much of the pending output of @a client as the
+	 * socket accepts without blocking.
+	 *
+	 * \return false in case the client has to be disconnected. */
+	bool flushClient( Client& client );
+	void closeClient( int nFd );
+	void handleCommand( int nFd, const QString& sLine );
+	/** Queues @a sMessage as a line in the output of client @a nFd. */
+	void reply( int nFd, const QString& sMessage );
+
+	/** Runs queued jobs until either the queue is empty or an export
+	 * was started. */
+	void processJobs();
+	/** \return false in case the job failed and @a pError was set. */
+	bool runJob( const Job& job, QString* pError );
+	void finishExport( bool bSuccess, const QString& sError );
+	/** Restores the audio driver used prior to exporting. */
+	void stopExportSession();
+
+	QString stats() const;
+
+	QString m_sPath;
+	int m_nListenFd;
+	std::vector<Client> m_clients;
+	std::deque<Job> m_jobs;
+	/** Export currently written by the DiskWriterDriver. Only valid if
+	 * #m_bExporting is true. */
+	Job m_currentExport;
+	bool m_bExporting;
+	int m_nSessionSampleRate;
+	int m_nSessionSampleDepth;
+	int m_nNextJobId;
+	int m_nJobsDone;
+	int m_nJobsFailed;
+	bool m_bQuitRequested;
+};
+
+inline bool ControlServer::isQuitRequested() const {
+	return m_bQuitRequested;
+}
+
+#endif // WIN32
+
+#endif
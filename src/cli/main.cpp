@@ -57,6 +57,8 @@
 #include <core/Sampler/Interpolation.h>
 #include <core/Version.h>
 
+#include "ControlServer.h"
+
 using namespace H2Core;
 
 class Sleeper : public QThread
@@ -70,7 +72,7 @@ public:
 volatile bool quit = false;
 void signal_handler ( int signum )
 {
-	if ( signum == SIGINT ) {
+	if ( signum == SIGINT || signum == SIGTERM ) {
 		std::cout << "Terminate signal caught" << std::endl;
 		quit = true;
 	}
@@ -159,7 +161,13 @@ int main(int argc, char *argv[])
 			"\n\nThe CLI of Hydrogen can be used in two different ways. Either for exporting a song into an audio file\n\n" +
 			"  h2cli -s /usr/share/hydrogen/data/demo_songs/GM_kit_demo1.h2song \\\n        -d GMRockKit -d auto -o ./example.wav\n\n" +
 			"or for checking, extracting, installing, or upgrading an existing drumkit\n\n" +
-			"  h2cli -c /usr/share/hydrogen/data/drumkits/GMRockKit" );
+			"  h2cli -c /usr/share/hydrogen/data/drumkits/GMRockKit"
+#ifndef WIN32
+			"\n\nIn addition, it can be run as a daemon accepting commands - like loading\n"
+			"songs, switching kits, and exporting - via a local socket\n\n"
+			"  h2cli -d Null --daemon /tmp/h2cli.sock"
+#endif
+			);
 
 		QStringList availableAudioDrivers;
 		for ( const auto& ddriver : H2Core::Preferences::getSupportedAudioDrivers() ) {
@@ -235,6 +243,15 @@ int main(int argc, char *argv[])
 		QCommandLineOption logTimestampsOption(
 			QStringList() << "T" << "log-timestamps",
 			"Add timestamps to all log messages" );
+		QCommandLineOption profileOption(
+			QStringList() << "profile",
+			"Print timing statistics of the individual stages of the audio engine's process cycle on exit" );
+#ifndef WIN32
+		QCommandLineOption daemonOption(
+			QStringList() << "daemon",
+			"Keep running in the background and accept commands on a UNIX domain socket created at the provided path. Each line holds one command: load <song>, kit <drumkit>, export <file> [<rate> [<bits>]], play, stop, stats, or quit. Export jobs are processed one after another without restarting Hydrogen.",
+			"Path" );
+#endif
 #ifdef H2CORE_HAVE_OSC
 		QCommandLineOption oscPortOption(
 			QStringList() << "O" << "osc-port",
@@ -264,6 +281,10 @@ int main(int argc, char *argv[])
 		parser.addOption( verboseOption );
 		parser.addOption( logFileOption );
 		parser.addOption( logTimestampsOption );
+		parser.addOption( profileOption );
+#ifndef WIN32
+		parser.addOption( daemonOption );
+#endif
 		parser.addHelpOption();
 		parser.addVersionOption();
 		// Evaluate the options
@@ -286,7 +307,18 @@ int main(int argc, char *argv[])
 		const QString sDrumkitToUpgrade = parser.value( upgradeDrumkitOption );
 		const QString sDrumkitToExtract = parser.value( extractDrumkitOption );
 		const bool bLogTimestamps = parser.isSet( logTimestampsOption );
+		const bool bProfile = parser.isSet( profileOption );
 		const QString sTarget = parser.value( targetOption );
+#ifndef WIN32
+		const QString sDaemonSocket = parser.value( daemonOption );
+#else
+		const QString sDaemonSocket;
+#endif
+		if ( ! sDaemonSocket.isEmpty() && ! sOutFilename.isEmpty() ) {
+			std::cerr << "The 'daemon' option can not be combined with 'outfile'. Please use the export command of the daemon instead."
+					  << std::endl;
+			exit( 1 );
+		}
 
 		bool bOk;
 		const short bits = parser.value( bitsOption ).toShort( &bOk );
@@ -478,6 +510,21 @@ int main(int argc, char *argv[])
 		EventQueue *pQueue = EventQueue::get_instance();
 
 		signal(SIGINT, signal_handler);
+		signal(SIGTERM, signal_handler);
+
+#ifndef WIN32
+		ControlServer* pControlServer = nullptr;
+		if ( ! sDaemonSocket.isEmpty() ) {
+			pControlServer = new ControlServer();
+			if ( ! pControlServer->listen( sDaemonSocket ) ) {
+				___ERRORLOG( QString( "Unable to start daemon at [%1]" )
+							 .arg( sDaemonSocket ) );
+				delete pControlServer;
+				pControlServer = nullptr;
+				nReturnCode = 1;
+			}
+		}
+#endif
 
 		// Hydrogen is up and running. Let's handle the requested user action.
 		//
@@ -600,6 +647,12 @@ int main(int argc, char *argv[])
 				/* Event handler */
 				switch ( event.type ) {
 				case EVENT_PROGRESS: /* event used only in export mode */
+#ifndef WIN32
+					if ( pControlServer != nullptr ) {
+						pControlServer->exportProgress( event.value );
+						break;
+					}
+#endif
 					if ( ! bExportMode ) {
 						break;
 					}
@@ -615,6 +668,16 @@ int main(int argc, char *argv[])
 					break;
 
 				case EVENT_NONE: /* Sleep if there is no more events */
+#ifndef WIN32
+					if ( pControlServer != nullptr ) {
+						// Wait for commands instead.
+						pControlServer->poll( 100 );
+						if ( pControlServer->isQuitRequested() ) {
+							quit = true;
+						}
+						break;
+					}
+#endif
 					Sleeper::msleep ( 100 );
 					break;
 				
@@ -629,10 +692,20 @@ int main(int argc, char *argv[])
 			}
 		}
 
+#ifndef WIN32
+		// Stops pending exports.
+		delete pControlServer;
+#endif
+
 		if ( pHydrogen->getAudioEngine()->getState() == H2Core::AudioEngine::State::Playing ) {
 			pHydrogen->sequencerStop();
 		}
 
+		if ( bProfile ) {
+			std::cout << pHydrogen->getAudioEngine()->getProfiler()->format()
+				.toLocal8Bit().data() << std::flush;
+		}
+
 		pSong = nullptr;
 
 		pPref->save();
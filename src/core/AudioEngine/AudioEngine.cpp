@@ -35,17 +35,20 @@
 #include <core/AudioEngine/TransportPosition.h>
 #include <core/Basics/AutomationPath.h>
 #include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
 #include <core/Basics/InstrumentComponent.h>
 #include <core/Basics/InstrumentLayer.h>
 #include <core/Basics/InstrumentList.h>
 #include <core/Basics/Note.h>
 #include <core/Basics/Pattern.h>
 #include <core/Basics/PatternList.h>
+#include <core/Basics/Sample.h>
 #include <core/Basics/Song.h>
 #include <core/EventQueue.h>
 #include <core/FX/Effects.h>
 #include <core/Helpers/Filesystem.h>
 #include <core/Helpers/Random.h>
+#include <core/Helpers/RealtimeMemory.h>
 #include <core/Hydrogen.h>
 #include <core/IO/AlsaAudioDriver.h>
 #include <core/IO/AlsaMidiDriver.h>
@@ -81,17 +84,11 @@ namespace H2Core
 		__logger->log( Logger::Debug, _class_name(), __FUNCTION__, \
 					   QString( "%1" ).arg( x ), "\033[34;1m" ); }
 
-/** Gets the current time.
- * \return Current time obtained by gettimeofday()*/
-inline timeval currentTime2()
-{
-	struct timeval now;
-	gettimeofday( &now, nullptr );
-	return now;
-}
-
 AudioEngine::AudioEngine()
 		: m_pSampler( nullptr )
+		, m_pReclaimer( nullptr )
+		, m_pTimeStretcher( nullptr )
+		, m_pProfiler( nullptr )
 		, m_pAudioDriver( nullptr )
 		, m_pMidiDriver( nullptr )
 		, m_pMidiDriverOut( nullptr )
@@ -105,6 +102,12 @@ AudioEngine::AudioEngine()
 		, m_fProcessTime( 0.0f )
 		, m_fLadspaTime( 0.0f )
 		, m_fMaxProcessTime( 0.0f )
+		, m_nMinorPageFaults( 0 )
+		, m_nMajorPageFaults( 0 )
+		, m_nTotalMinorPageFaults( 0 )
+		, m_nTotalMajorPageFaults( 0 )
+		, m_bPageFaultStatistics( false )
+		, m_nColumnPatternsMisses( 0 )
 		, m_fNextBpm( 120 )
 		, m_pLocker({nullptr, 0, nullptr, false})
 		, m_fLastTickEnd( 0 )
@@ -115,6 +118,9 @@ AudioEngine::AudioEngine()
 	m_pQueuingPosition = std::make_shared<TransportPosition>( "Queuing" );
 	
 	m_pSampler = new Sampler;
+	m_pReclaimer = new EpochReclaimer;
+	m_pTimeStretcher = new TimeStretcher( this );
+	m_pProfiler = new ProcessProfiler;
 
 	m_pEventQueue = EventQueue::get_instance();
 	
@@ -152,6 +158,11 @@ AudioEngine::~AudioEngine()
 	}
 	m_pSampler->stopPlayingNotes();
 
+	// Its workers lock the audio engine and swap samples using the
+	// reclaimer.
+	delete m_pTimeStretcher;
+	m_pTimeStretcher = nullptr;
+
 	this->lock( RIGHT_HERE );
 	AE_INFOLOG( "*** Hydrogen audio engine shutdown ***" );
 
@@ -173,6 +184,8 @@ AudioEngine::~AudioEngine()
 #endif
 
 	delete m_pSampler;
+	delete m_pReclaimer;
+	delete m_pProfiler;
 }
 
 Sampler* AudioEngine::getSampler() const
@@ -316,7 +329,14 @@ void AudioEngine::startPlayback()
 	}
 
 	setState( State::Playing );
-	
+
+	// Songs carrying a seed for humanization are rendered the same way
+	// each time transport is started.
+	const auto& pSong = Hydrogen::get_instance()->getSong();
+	if ( pSong != nullptr && pSong->getHumanizeSeed() != 0 ) {
+		Random::setSeed( pSong->getHumanizeSeed() );
+	}
+
 	handleSelectedPattern();
 }
 
@@ -842,7 +862,7 @@ void AudioEngine::clearAudioBuffers( uint32_t nFrames )
 		JackAudioDriver* pJackAudioDriver = static_cast<JackAudioDriver*>(m_pAudioDriver);
 	
 		if ( pJackAudioDriver != nullptr ) {
-			pJackAudioDriver->clearPerTrackAudioBuffers( nFrames );
+			pJackAudioDriver->resolveTrackOutputs( nFrames );
 		}
 	}
 #endif
@@ -934,6 +954,14 @@ AudioOutput* AudioEngine::createAudioDriver( const Preferences::AudioDriver& dri
 		return nullptr;
 	}
 
+	// Samples have to match the new rate before the driver starts
+	// calling the process callback. The rate of the DiskWriterDriver
+	// is set afterwards by Hydrogen::startExportSession() which
+	// converts the samples itself.
+	if ( driver != Preferences::AudioDriver::Disk ) {
+		updateTargetSampleRate( pAudioDriver->getSampleRate() );
+	}
+
 	this->lock( RIGHT_HERE );
 	m_MutexOutputPointer.lock();
 
@@ -970,11 +998,11 @@ AudioOutput* AudioEngine::createAudioDriver( const Preferences::AudioDriver& dri
 		return nullptr;
 	}
 
+	lock( RIGHT_HERE );
 	if ( pSong != nullptr && pHydrogen->hasJackAudioDriver() ) {
 		pHydrogen->renameJackPorts( pSong );
 	}
 
-	lock( RIGHT_HERE );
 	setupLadspaFX();
 
 	if ( pSong != nullptr ) {
@@ -1061,11 +1089,149 @@ void AudioEngine::startAudioDrivers()
 		m_pMidiDriver->setActive( true );
 #endif
 	}
+
+	RealtimeMemory::setEnabled( pPref->m_bLockRealtimeMemory );
+	m_nTotalMinorPageFaults = 0;
+	m_nTotalMajorPageFaults = 0;
+	lockRealtimeMemory();
 	
 	m_MutexOutputPointer.unlock();
 	this->unlock();
 }
 
+void AudioEngine::lockRealtimeMemory() {
+	if ( ! RealtimeMemory::isEnabled() ) {
+		return;
+	}
+
+	m_pSampler->lockMemory();
+
+	// JACK takes care of its own port buffers.
+	if ( m_pAudioDriver != nullptr &&
+		 dynamic_cast<JackAudioDriver*>(m_pAudioDriver) == nullptr ) {
+		const size_t nBytes = m_pAudioDriver->getBufferSize() * sizeof( float );
+		for ( auto ppBuffer : { m_pAudioDriver->getOut_L(),
+								m_pAudioDriver->getOut_R() } ) {
+			if ( RealtimeMemory::lock( ppBuffer, nBytes ) ) {
+				m_lockedDriverBuffers.push_back( { ppBuffer, nBytes } );
+			}
+		}
+	}
+
+	// Samples loaded before locking was enabled.
+	auto lockInstrument = []( std::shared_ptr<Instrument> pInstrument ) {
+		if ( pInstrument == nullptr ) {
+			return;
+		}
+		for ( const auto& pComponent : *pInstrument->get_components() ) {
+			if ( pComponent == nullptr ) {
+				continue;
+			}
+			for ( const auto& pLayer : *pComponent ) {
+				if ( pLayer != nullptr && pLayer->get_sample() != nullptr &&
+					 pLayer->get_sample()->isLoaded() ) {
+					pLayer->get_sample()->lockMemory();
+				}
+			}
+		}
+	};
+
+	lockInstrument( m_pMetronomeInstrument );
+	const auto pSong = Hydrogen::get_instance()->getSong();
+	if ( pSong != nullptr && pSong->getDrumkit() != nullptr ) {
+		for ( const auto& pInstrument : *pSong->getDrumkit()->getInstruments() ) {
+			lockInstrument( pInstrument );
+		}
+	}
+
+	AE_INFOLOG( QString( "[%1] bytes locked into memory" )
+				.arg( RealtimeMemory::getLockedBytes() ) );
+}
+
+void AudioEngine::unlockRealtimeMemory() {
+	for ( const auto& [ ppBuffer, nBytes ] : m_lockedDriverBuffers ) {
+		RealtimeMemory::unlock( ppBuffer, nBytes );
+	}
+	m_lockedDriverBuffers.clear();
+}
+
+void AudioEngine::updateTargetSampleRate( int nDriverSampleRate ) {
+	const int nTargetSampleRate =
+		Preferences::get_instance()->m_bResampleSamplesOnLoad ?
+		nDriverSampleRate : 0;
+	if ( nTargetSampleRate == Sample::getTargetSampleRate() ) {
+		return;
+	}
+
+	AE_INFOLOG( QString( "Converting samples to [%1] Hz" )
+				.arg( nTargetSampleRate > 0 ?
+					  QString::number( nTargetSampleRate ) : "native" ) );
+	Sample::setTargetSampleRate( nTargetSampleRate );
+
+	// Variants rendered for the previous rate won't be handed out
+	// anymore.
+	m_pTimeStretcher->clear();
+
+	// Samples are decoded and converted into fresh objects without
+	// holding the lock. Only swapping them in requires it.
+	struct Reloaded {
+		std::shared_ptr<InstrumentLayer> pLayer;
+		std::shared_ptr<Sample> pOldSample;
+		std::shared_ptr<Sample> pNewSample;
+	};
+	std::vector<Reloaded> reloaded;
+
+	const float fBpm = m_pTransportPosition->getBpm();
+	auto reloadInstrument = [&]( std::shared_ptr<Instrument> pInstrument ) {
+		if ( pInstrument == nullptr ) {
+			return;
+		}
+		for ( const auto& pComponent : *pInstrument->get_components() ) {
+			if ( pComponent == nullptr ) {
+				continue;
+			}
+			for ( const auto& pLayer : *pComponent ) {
+				// Samples not loaded yet will be converted once they
+				// are.
+				if ( pLayer == nullptr || pLayer->get_sample() == nullptr ||
+					 ! pLayer->get_sample()->isLoaded() ) {
+					continue;
+				}
+				const auto pOldSample = pLayer->get_sample();
+				auto pNewSample = std::make_shared<Sample>(
+					pOldSample->get_filepath(), pOldSample->getLicense() );
+				pNewSample->set_loops( pOldSample->get_loops() );
+				pNewSample->set_rubberband( pOldSample->get_rubberband() );
+				pNewSample->set_pan_envelope( pOldSample->get_pan_envelope() );
+				pNewSample->set_velocity_envelope(
+					pOldSample->get_velocity_envelope() );
+				pNewSample->set_is_modified( pOldSample->get_is_modified() );
+				if ( pNewSample->load( fBpm ) ) {
+					reloaded.push_back( { pLayer, pOldSample, pNewSample } );
+				}
+			}
+		}
+	};
+
+	reloadInstrument( m_pMetronomeInstrument );
+	const auto pSong = Hydrogen::get_instance()->getSong();
+	if ( pSong != nullptr && pSong->getDrumkit() != nullptr ) {
+		for ( const auto& pInstrument : *pSong->getDrumkit()->getInstruments() ) {
+			reloadInstrument( pInstrument );
+		}
+	}
+
+	lock( RIGHT_HERE );
+	for ( const auto& [ pLayer, pOldSample, pNewSample ] : reloaded ) {
+		// The layer might have been assigned a different sample in the
+		// meantime.
+		if ( pLayer->get_sample() == pOldSample ) {
+			pLayer->set_sample( pNewSample, m_pReclaimer );
+		}
+	}
+	unlock();
+}
+
 void AudioEngine::stopAudioDrivers()
 {
 	AE_INFOLOG( "" );
@@ -1097,6 +1263,7 @@ void AudioEngine::stopAudioDrivers()
 	if ( m_pAudioDriver != nullptr ) {
 		m_pAudioDriver->disconnect();
 		m_MutexOutputPointer.lock();
+		unlockRealtimeMemory();
 		delete m_pAudioDriver;
 		m_pAudioDriver = nullptr;
 		m_MutexOutputPointer.unlock();
@@ -1317,7 +1484,7 @@ void AudioEngine::processPlayNotes( unsigned long nframes )
 			float fNoteProbability = pNote->get_probability();
 			if ( fNoteProbability != 1. ) {
 				// Current note is skipped with a certain probability.
-				if ( fNoteProbability < (float) rand() / (float) RAND_MAX ) {
+				if ( fNoteProbability < Random::getUniform() ) {
 					m_songNoteQueue.pop();
 					pNote->get_instrument()->dequeue( pNote );
 					continue;
@@ -1439,10 +1606,31 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 		 dynamic_cast<JackAudioDriver*>(pAudioEngine->m_pAudioDriver) != nullptr ) {
 		return 0;
 	}
-	timeval startTimeval = currentTime2();
+
+	// Instruments, components, and samples are accessed via plain
+	// pointers during rendering. Objects retired in the meantime are
+	// only released once this cycle is over.
+	EpochReclaimer::Cycle cycle( pAudioEngine->m_pReclaimer );
+
+	// Touch the stack of the audio thread once so deep call chains
+	// later on do not fault in new pages.
+	static thread_local bool bStackPrefaulted = false;
+	if ( ! bStackPrefaulted && RealtimeMemory::isEnabled() ) {
+		RealtimeMemory::prefaultStack();
+		bStackPrefaulted = true;
+	}
+
+	long nMinorFaultsStart, nMajorFaultsStart;
+	const bool bPageFaults = pAudioEngine->isPageFaultStatisticsEnabled() &&
+		RealtimeMemory::getPageFaults( nMinorFaultsStart, nMajorFaultsStart );
+
+	ProcessProfiler* pProfiler = pAudioEngine->m_pProfiler;
+	const int64_t nCycleStart = ProcessProfiler::now();
 	const auto sDrivers = pAudioEngine->getDriverNames();
 
 	pAudioEngine->clearAudioBuffers( nframes );
+	int64_t nStageStart = pProfiler->lap( ProcessProfiler::Stage::Buffers,
+										  nCycleStart );
 
 	// Calculate maximum time to wait for audio engine lock. Using the
 	// last calculated processing time as an estimate of the expected
@@ -1478,6 +1666,7 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 
 		return 0;
 	}
+	nStageStart = pProfiler->lap( ProcessProfiler::Stage::Lock, nStageStart );
 
 	// Now that the engine is locked we properly check its state.
 	if ( ! ( pAudioEngine->getState() == AudioEngine::State::Ready ||
@@ -1526,9 +1715,13 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 										 static_cast<long long>(nframes) );
 	}
 
+	nStageStart = pProfiler->lap( ProcessProfiler::Stage::Transport,
+								  nStageStart );
+
 	// always update note queue.. could come from pattern or realtime input
 	// (midi, keyboard)
 	pAudioEngine->updateNoteQueue( nframes );
+	pProfiler->lap( ProcessProfiler::Stage::NoteQueue, nStageStart );
 
 	pAudioEngine->processAudio( nframes );
 
@@ -1569,10 +1762,18 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 		}
 	}
 
-	timeval finishTimeval = currentTime2();
-	pAudioEngine->m_fProcessTime =
-			( finishTimeval.tv_sec - startTimeval.tv_sec ) * 1000.0
-			+ ( finishTimeval.tv_usec - startTimeval.tv_usec ) / 1000.0;
+	const int64_t nCycleDuration = ProcessProfiler::now() - nCycleStart;
+	pProfiler->record( ProcessProfiler::Stage::Total, nCycleDuration );
+	pAudioEngine->m_fProcessTime = nCycleDuration / 1e6;
+
+	long nMinorFaultsEnd, nMajorFaultsEnd;
+	if ( bPageFaults &&
+		 RealtimeMemory::getPageFaults( nMinorFaultsEnd, nMajorFaultsEnd ) ) {
+		pAudioEngine->m_nMinorPageFaults = nMinorFaultsEnd - nMinorFaultsStart;
+		pAudioEngine->m_nMajorPageFaults = nMajorFaultsEnd - nMajorFaultsStart;
+		pAudioEngine->m_nTotalMinorPageFaults += pAudioEngine->m_nMinorPageFaults;
+		pAudioEngine->m_nTotalMajorPageFaults += pAudioEngine->m_nMajorPageFaults;
+	}
 	
 #ifdef CONFIG_DEBUG
 	if ( pAudioEngine->m_fProcessTime > pAudioEngine->m_fMaxProcessTime ) {
@@ -1584,6 +1785,11 @@ int AudioEngine::audioEngine_process( uint32_t nframes, void* /*arg*/ )
 					   .arg( pAudioEngine->m_fProcessTime )
 					   .arg( pAudioEngine->m_fMaxProcessTime ) );
 		___WARNINGLOG( QString( "Ladspa process time = %1" ).arg( fLadspaTime ) );
+		if ( bPageFaults ) {
+			___WARNINGLOG( QString( "Page faults: minor = %1, major = %2" )
+						   .arg( pAudioEngine->m_nMinorPageFaults )
+						   .arg( pAudioEngine->m_nMajorPageFaults ) );
+		}
 		___WARNINGLOG( "------------" );
 		___WARNINGLOG( "" );
 		
@@ -1603,7 +1809,11 @@ void AudioEngine::processAudio( uint32_t nFrames ) {
 		return;
 	}
 
+	int64_t nStageStart = ProcessProfiler::now();
+
 	processPlayNotes( nFrames );
+	nStageStart = m_pProfiler->lap( ProcessProfiler::Stage::PlayNotes,
+									nStageStart );
 
 	float *pBuffer_L = m_pAudioDriver->getOut_L(),
 		*pBuffer_R = m_pAudioDriver->getOut_R();
@@ -1616,10 +1826,10 @@ void AudioEngine::processAudio( uint32_t nFrames ) {
 		pBuffer_L[ i ] += out_L[ i ];
 		pBuffer_R[ i ] += out_R[ i ];
 	}
+	nStageStart = m_pProfiler->lap( ProcessProfiler::Stage::Sampler,
+									nStageStart );
 
 #ifdef H2CORE_HAVE_LADSPA
-	timeval ladspaTime_start = currentTime2();
-
 	for ( unsigned nFX = 0; nFX < MAX_FX; ++nFX ) {
 		LadspaFX *pFX = Effects::get_instance()->getLadspaFX( nFX );
 		if ( ( pFX ) && ( pFX->isEnabled() ) ) {
@@ -1648,10 +1858,10 @@ void AudioEngine::processAudio( uint32_t nFrames ) {
 		}
 	}
 
-	timeval ladspaTime_end = currentTime2();
-	m_fLadspaTime =
-			( ladspaTime_end.tv_sec - ladspaTime_start.tv_sec ) * 1000.0
-			+ ( ladspaTime_end.tv_usec - ladspaTime_start.tv_usec ) / 1000.0;
+	const int64_t nEffectsEnd =
+		m_pProfiler->lap( ProcessProfiler::Stage::Effects, nStageStart );
+	m_fLadspaTime = ( nEffectsEnd - nStageStart ) / 1e6;
+	nStageStart = nEffectsEnd;
 #else
 	m_fLadspaTime = 0.0;
 #endif
@@ -1664,6 +1874,7 @@ void AudioEngine::processAudio( uint32_t nFrames ) {
 
 	m_fMasterPeak_L = fPeak_L;
 	m_fMasterPeak_R = fPeak_R;
+	m_pProfiler->lap( ProcessProfiler::Stage::Metering, nStageStart );
 }
 
 void AudioEngine::setState( const AudioEngine::State& state ) {
@@ -1705,6 +1916,10 @@ void AudioEngine::setSong( std::shared_ptr<Song> pNewSong )
 	// Reset (among other things) the transport position. This causes
 	// the locate() call below to update the playing patterns.
 	reset( false );
+
+	// Stretched variants of the previous song's samples are of no use
+	// anymore.
+	m_pTimeStretcher->clear();
 	if ( pNewSong != nullptr ) {
 		setNextBpm( pNewSong->getBpm() );
 		m_fSongSizeInTicks = static_cast<double>( pNewSong->lengthInTicks() );
@@ -1716,6 +1931,9 @@ void AudioEngine::setSong( std::shared_ptr<Song> pNewSong )
 
 	pHydrogen->renameJackPorts( pNewSong );
 
+	// Required by locate() to pick the playing patterns.
+	updateColumnPatterns();
+
 	setState( State::Ready );
 	// Will also adapt the audio engine to the new song's BPM.
 	locate( 0 );
@@ -1754,6 +1972,8 @@ void AudioEngine::updateSongSize() {
 	auto pHydrogen = Hydrogen::get_instance();
 	auto pSong = pHydrogen->getSong();
 
+	updateColumnPatterns();
+
 	if ( pSong == nullptr ) {
 		AE_ERRORLOG( "No song set yet" );
 		return;
@@ -2055,9 +2275,22 @@ void AudioEngine::updatePlayingPatternsPos( std::shared_ptr<TransportPosition> p
 			nColumn = 0;
 		}
 
-		for ( const auto& ppattern : *( *( pSong->getPatternGroupVector() ) )[ nColumn ] ) {
-			if ( ppattern != nullptr ) {
-				pPlayingPatterns->add( ppattern, true );
+		const auto pColumn = ( *pSong->getPatternGroupVector() )[ nColumn ];
+		if ( nColumn < m_columnPatterns.size() &&
+			 m_columnPatterns[ nColumn ].pColumn == pColumn &&
+			 m_columnPatterns[ nColumn ].nRevision == pColumn->getRevision() ) {
+			// Virtual patterns were already resolved when the song
+			// structure changed.
+			pPlayingPatterns->assign( m_columnPatterns[ nColumn ].patterns );
+		}
+		else {
+			// Logging is not realtime-safe. The misses are reported
+			// the next time the cache is rebuilt.
+			++m_nColumnPatternsMisses;
+			for ( const auto& ppattern : *pColumn ) {
+				if ( ppattern != nullptr ) {
+					pPlayingPatterns->add( ppattern, true );
+				}
 			}
 		}
 
@@ -2198,8 +2431,52 @@ void AudioEngine::flushAndAddNextPattern( int nPatternNumber ) {
 	flushAndAddNext( m_pQueuingPosition );
 }
 
+void AudioEngine::updateColumnPatterns() {
+	auto pSong = Hydrogen::get_instance()->getSong();
+
+	const int nMisses = m_nColumnPatternsMisses.exchange( 0 );
+	if ( nMisses > 0 ) {
+		AE_WARNINGLOG( QString( "Cached patterns were out of sync with the song on [%1] column change(s) and had to be resolved on the fly." )
+					   .arg( nMisses ) );
+	}
+
+	m_columnPatterns.clear();
+	if ( pSong == nullptr ) {
+		return;
+	}
+
+	const auto pColumns = pSong->getPatternGroupVector();
+	m_columnPatterns.reserve( pColumns->size() );
+
+	// Use the same routine as for the stacked pattern mode in order to
+	// get identical virtual pattern resolution.
+	PatternList resolvedPatterns;
+	int nMaxPatterns = 0;
+	for ( const auto& ppColumn : *pColumns ) {
+		for ( const auto& ppPattern : *ppColumn ) {
+			if ( ppPattern != nullptr ) {
+				resolvedPatterns.add( ppPattern, true );
+			}
+		}
+		m_columnPatterns.push_back(
+			{ ppColumn, ppColumn->getRevision(),
+			  std::vector<Pattern*>( resolvedPatterns.begin(),
+									 resolvedPatterns.end() ) } );
+		nMaxPatterns = std::max( nMaxPatterns, resolvedPatterns.size() );
+
+		// PatternList does own its patterns.
+		resolvedPatterns.clear();
+	}
+
+	// Switching columns must not allocate memory in the audio thread.
+	m_pTransportPosition->getPlayingPatterns()->reserve( nMaxPatterns );
+	m_pQueuingPosition->getPlayingPatterns()->reserve( nMaxPatterns );
+}
+
 void AudioEngine::updateVirtualPatterns() {
 
+	updateColumnPatterns();
+
 	if ( Hydrogen::get_instance()->getPatternMode() == Song::PatternMode::Stacked ) {
 		auto copyPlayingPatterns = [&]( std::shared_ptr<TransportPosition> pPos ) {
 			auto pPlayingPatterns = pPos->getPlayingPatterns();
@@ -2862,6 +3139,10 @@ QString AudioEngine::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( m_fProcessTime ) )
 			.append( QString( "%1%2m_fMaxProcessTime: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_fMaxProcessTime ) )
+			.append( QString( "%1%2m_nMinorPageFaults: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nMinorPageFaults ) )
+			.append( QString( "%1%2m_nMajorPageFaults: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nMajorPageFaults ) )
 			.append( QString( "%1%2m_fLadspaTime: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_fLadspaTime ) )
 			.append( QString( "%1%2m_pTransportPosition:\n").arg( sPrefix ).arg( s ) );
@@ -2966,6 +3247,10 @@ QString AudioEngine::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( m_fProcessTime ) )
 			.append( QString( ", m_fMaxProcessTime: %1" )
 					 .arg( m_fMaxProcessTime ) )
+			.append( QString( ", m_nMinorPageFaults: %1" )
+					 .arg( m_nMinorPageFaults ) )
+			.append( QString( ", m_nMajorPageFaults: %1" )
+					 .arg( m_nMajorPageFaults ) )
 			.append( QString( ", m_fLadspaTime: %1" )
 					 .arg( m_fLadspaTime ) )
 			.append( ", m_pTransportPosition: ");
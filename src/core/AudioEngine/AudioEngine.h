@@ -24,6 +24,8 @@
 #define AUDIO_ENGINE_H
 
 #include <core/AudioEngine/AudioEngineTests.h>
+#include <core/AudioEngine/EpochReclaimer.h>
+#include <core/AudioEngine/ProcessProfiler.h>
 #include <core/config.h>
 #include <core/CoreActionController.h>
 #include <core/Hydrogen.h>
@@ -34,8 +36,10 @@
 #include <core/Object.h>
 #include <core/Preferences/Preferences.h>
 #include <core/Sampler/Sampler.h>
+#include <core/Sampler/TimeStretcher.h>
 
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <cassert>
@@ -44,6 +48,7 @@
 #include <chrono>
 #include <deque>
 #include <queue>
+#include <vector>
 #include <QString>
 
 /** \def RIGHT_HERE
@@ -273,6 +278,14 @@ public:
 	static double computeDoubleTickSize(const int nSampleRate, const float fBpm, const int nResolution);
 
 	Sampler*		getSampler() const;
+	/** Releases instruments and samples no longer used by the audio
+	 * thread. */
+	EpochReclaimer*	getReclaimer() const;
+	/** Renders Rubber Band variants of samples in the background. */
+	TimeStretcher*	getTimeStretcher() const;
+	/** Timing statistics of the individual stages of
+	 * audioEngine_process(). */
+	ProcessProfiler*	getProfiler() const;
 
 	/** \return Time passed since the beginning of the song*/
 	float			getElapsedTime() const;	
@@ -324,6 +337,19 @@ public:
 
 	float			getProcessTime() const;
 	float			getMaxProcessTime() const;
+	/** Page faults of the audio thread during the last process
+	 * cycle. */
+	long			getMinorPageFaults() const;
+	long			getMajorPageFaults() const;
+	/** Page faults of the audio thread accumulated across all process
+	 * cycles since the audio driver was started. */
+	long			getTotalMinorPageFaults() const;
+	long			getTotalMajorPageFaults() const;
+	/** Querying the page faults of the audio thread costs a system
+	 * call per process cycle. It is only done while enabled, e.g. by
+	 * a dialog displaying them. */
+	void			setPageFaultStatisticsEnabled( bool bEnabled );
+	bool			isPageFaultStatisticsEnabled() const;
 
 	const std::shared_ptr<TransportPosition> getTransportPosition() const;
 
@@ -454,6 +480,8 @@ public:
 	friend void Hydrogen::updateSelectedPattern( bool );
 	/** Uses handleTimelineChange() */
 	friend void Hydrogen::setIsTimelineActivated( bool );
+	/** Uses updateTargetSampleRate() for the export sample rate. */
+	friend bool Hydrogen::startExportSession( int, int );
 	/** Uses handleTimelineChange() */
 	friend bool CoreActionController::addTempoMarker( int, float );
 	/** Uses handleTimelineChange() */
@@ -470,6 +498,8 @@ public:
 	friend int FakeDriver::connect();
 
 	friend class AudioEngineTests;
+	/** Times updateNoteQueue() and the transport in isolation. */
+	friend class AudioEngineBenchmark;
 		friend class JackAudioDriver;
 private:
 
@@ -523,6 +553,45 @@ private:
     
 	void			setRealtimeFrame( long long nFrame );
 	void updatePlayingPatternsPos( std::shared_ptr<TransportPosition> pPos );
+	/**
+	 * Resolves the virtual patterns of all columns of the current
+	 * song and stores the resulting flattened pattern sets in
+	 * #m_columnPatterns.
+	 *
+	 * Has to be called with the audio engine being locked whenever
+	 * the pattern group vector or the virtual patterns of the song
+	 * change.
+	 */
+	void updateColumnPatterns();
+
+	/**
+	 * Locks the buffers of the Sampler and the audio driver as well
+	 * as the samples of the current drumkit into memory in case
+	 * Preferences::m_bLockRealtimeMemory is set.
+	 *
+	 * Has to be called with the audio engine being locked.
+	 */
+	void lockRealtimeMemory();
+	/** Counterpart of lockRealtimeMemory() for the audio driver
+	 * buffers. */
+	void unlockRealtimeMemory();
+
+	/**
+	 * Sets the rate samples are converted to while loading them (see
+	 * Sample::setTargetSampleRate()) according to
+	 * Preferences::m_bResampleSamplesOnLoad and reloads the samples of
+	 * the current drumkit and the metronome in case it changed.
+	 *
+	 * The samples are decoded into new Sample objects without holding
+	 * the lock of the audio engine, which is only acquired to swap
+	 * them into their layers.
+	 *
+	 * Must not be called while an audio driver is processing.
+	 *
+	 * \param nDriverSampleRate Sample rate of the freshly initialized
+	 *   audio driver.
+	 */
+	void updateTargetSampleRate( int nDriverSampleRate );
 	
 	void			setSong( std::shared_ptr<Song>pNewSong );
 	void 			setState( const State& state );
@@ -597,6 +666,9 @@ private:
 	QString getDriverNames() const;
 
 	Sampler* 			m_pSampler;
+	EpochReclaimer*		m_pReclaimer;
+	TimeStretcher*		m_pTimeStretcher;
+	ProcessProfiler*	m_pProfiler;
 	AudioOutput *		m_pAudioDriver;
 	MidiInput *			m_pMidiDriver;
 	MidiOutput *		m_pMidiDriverOut;
@@ -653,6 +725,13 @@ private:
 	float				m_fProcessTime;
 	float				m_fMaxProcessTime;
 	float				m_fLadspaTime;
+	long				m_nMinorPageFaults;
+	long				m_nMajorPageFaults;
+	long				m_nTotalMinorPageFaults;
+	long				m_nTotalMajorPageFaults;
+	std::atomic<bool>	m_bPageFaultStatistics;
+	/** Driver buffers locked by lockRealtimeMemory() */
+	std::vector<std::pair<float*, size_t>> m_lockedDriverBuffers;
 
 	std::shared_ptr<TransportPosition> m_pTransportPosition;
 	std::shared_ptr<TransportPosition> m_pQueuingPosition;
@@ -660,6 +739,30 @@ private:
 	/** Set to the total number of ticks in a Song.*/
 	double				m_fSongSizeInTicks;
 
+	struct ColumnPatterns {
+		/** Column of Song::m_pPatternGroupSequence the patterns were
+		 * resolved from. */
+		const PatternList* pColumn;
+		/** PatternList::getRevision() of #pColumn at that time. */
+		uint64_t nRevision;
+		std::vector<Pattern*> patterns;
+	};
+	/**
+	 * Patterns played in each column of the current song with all
+	 * virtual patterns already resolved.
+	 *
+	 * This way entering a new column in Song::Mode::Song boils down
+	 * to copying a couple of pointers in updatePlayingPatternsPos().
+	 * Entries whose column was changed after they were resolved are
+	 * ignored.
+	 */
+	std::vector<ColumnPatterns> m_columnPatterns;
+	/** Number of column changes since the last call to
+	 * updateColumnPatterns() which found their entry in
+	 * #m_columnPatterns out of sync with the song. Incremented in the
+	 * audio thread and reported outside of it. */
+	std::atomic<int>	m_nColumnPatternsMisses;
+
 	/**
 	 * Variable keeping track of the transport position in realtime.
 	 *
@@ -775,6 +878,25 @@ inline float AudioEngine::getMaxProcessTime() const {
 	return m_fMaxProcessTime;
 }
 
+inline long AudioEngine::getMinorPageFaults() const {
+	return m_nMinorPageFaults;
+}
+inline long AudioEngine::getMajorPageFaults() const {
+	return m_nMajorPageFaults;
+}
+inline long AudioEngine::getTotalMinorPageFaults() const {
+	return m_nTotalMinorPageFaults;
+}
+inline long AudioEngine::getTotalMajorPageFaults() const {
+	return m_nTotalMajorPageFaults;
+}
+inline void AudioEngine::setPageFaultStatisticsEnabled( bool bEnabled ) {
+	m_bPageFaultStatistics.store( bEnabled );
+}
+inline bool AudioEngine::isPageFaultStatisticsEnabled() const {
+	return m_bPageFaultStatistics.load( std::memory_order_relaxed );
+}
+
 inline const AudioEngine::State& AudioEngine::getState() const {
 	return m_state;
 }
@@ -817,6 +939,15 @@ inline std::shared_ptr<Instrument> AudioEngine::getMetronomeInstrument() const {
 inline int AudioEngine::getEnqueuedNotesNumber() const {
 	return m_songNoteQueue.size();
 }
+inline EpochReclaimer* AudioEngine::getReclaimer() const {
+	return m_pReclaimer;
+}
+inline TimeStretcher* AudioEngine::getTimeStretcher() const {
+	return m_pTimeStretcher;
+}
+inline ProcessProfiler* AudioEngine::getProfiler() const {
+	return m_pProfiler;
+}
 };
 
 #endif
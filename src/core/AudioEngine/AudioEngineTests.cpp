@@ -838,6 +838,84 @@ void AudioEngineTests::testSongSizeChangeInLoopMode() {
 	pAE->unlock();
 }
 
+void AudioEngineTests::testColumnPatterns() {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pSong = pHydrogen->getSong();
+	auto pAE = pHydrogen->getAudioEngine();
+	auto pColumns = pSong->getPatternGroupVector();
+
+	CoreActionController::activateSongMode( true );
+
+	pAE->lock( RIGHT_HERE );
+	pAE->reset( true );
+	pAE->m_fSongSizeInTicks = pSong->lengthInTicks();
+	pAE->locate( 0 );
+
+	if ( pColumns->size() == 0 ) {
+		throwException( "[testColumnPatterns] song has no columns" );
+	}
+	auto pColumn = ( *pColumns )[ 0 ];
+
+	// Pick a pattern not played in the first column.
+	Pattern* pPattern = nullptr;
+	for ( const auto& ppPattern : *pSong->getPatternList() ) {
+		if ( pAE->m_pTransportPosition->getPlayingPatterns()->index(
+				 ppPattern ) == -1 ) {
+			pPattern = ppPattern;
+			break;
+		}
+	}
+	if ( pPattern == nullptr ) {
+		throwException( "[testColumnPatterns] no pattern left to add" );
+	}
+
+	// Fill and clear the column the way the SongEditor did before
+	// calling updateSongSize(). The number of columns stays the same.
+	const int nColumns = pColumns->size();
+	pColumn->add( pPattern );
+	pAE->updatePlayingPatterns();
+	if ( pColumns->size() != nColumns ||
+		 pAE->m_pTransportPosition->getPlayingPatterns()->index(
+			 pPattern ) == -1 ||
+		 pAE->m_pQueuingPosition->getPlayingPatterns()->index(
+			 pPattern ) == -1 ) {
+		throwException( QString( "[testColumnPatterns] added pattern [%1] not playing:\n%2" )
+						.arg( pPattern->get_name() )
+						.arg( pAE->m_pTransportPosition->toQString() ) );
+	}
+
+	pColumn->del( pPattern );
+	pAE->updatePlayingPatterns();
+	if ( pAE->m_pTransportPosition->getPlayingPatterns()->index(
+			 pPattern ) != -1 ||
+		 pAE->m_pQueuingPosition->getPlayingPatterns()->index(
+			 pPattern ) != -1 ) {
+		throwException( QString( "[testColumnPatterns] removed pattern [%1] still playing:\n%2" )
+						.arg( pPattern->get_name() )
+						.arg( pAE->m_pTransportPosition->toQString() ) );
+	}
+	if ( pAE->m_nColumnPatternsMisses == 0 ) {
+		throwException( "[testColumnPatterns] out of sync cache not counted" );
+	}
+
+	// Once the cache was refreshed, it has to be used again.
+	pColumn->add( pPattern );
+	pAE->updateSongSize();
+	pAE->updatePlayingPatterns();
+	if ( pAE->m_columnPatterns[ 0 ].nRevision != pColumn->getRevision() ||
+		 pAE->m_nColumnPatternsMisses != 0 ||
+		 pAE->m_pTransportPosition->getPlayingPatterns()->index(
+			 pPattern ) == -1 ) {
+		throwException( QString( "[testColumnPatterns] refreshed cache not used:\n%1" )
+						.arg( pAE->m_pTransportPosition->toQString() ) );
+	}
+	pColumn->del( pPattern );
+	pAE->updateSongSize();
+
+	pAE->reset( true );
+	pAE->unlock();
+}
+
 void AudioEngineTests::testNoteEnqueuing() {
 	auto pHydrogen = Hydrogen::get_instance();
 	auto pSong = pHydrogen->getSong();
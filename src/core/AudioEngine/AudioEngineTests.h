@@ -80,6 +80,11 @@ public:
 	 * by toggling a pattern.
 	 */
 	static void testSongSizeChangeInLoopMode();
+	/**
+	 * Checks that changing the patterns of a column without updating
+	 * the song size still takes effect on the playing patterns.
+	 */
+	static void testColumnPatterns();
 	/** 
 	 * Unit test checking that all notes in a song are picked up once.
 	 */
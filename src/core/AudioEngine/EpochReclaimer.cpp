@@ -0,0 +1,173 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/AudioEngine/EpochReclaimer.h>
+
+#include <chrono>
+
+namespace H2Core
+{
+
+EpochReclaimer::EpochReclaimer()
+	: m_nEpoch( 0 )
+	, m_bShutdown( false )
+{
+	m_thread = std::thread( &EpochReclaimer::run, this );
+}
+
+EpochReclaimer::~EpochReclaimer() {
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_bShutdown = true;
+	}
+	m_condition.notify_all();
+	if ( m_thread.joinable() ) {
+		m_thread.join();
+	}
+
+	// The audio engine is not running anymore. Everything left can be
+	// released right away.
+	for ( auto& rretired : m_retired ) {
+		if ( rretired.release ) {
+			rretired.release();
+		}
+	}
+	m_retired.clear();
+}
+
+void EpochReclaimer::retire( std::shared_ptr<void> pObject,
+							 std::function<bool()> isReleasable,
+							 std::function<void()> release ) {
+	if ( pObject == nullptr ) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		for ( const auto& rretired : m_retired ) {
+			if ( rretired.pObject == pObject ) {
+				// Already retired.
+				return;
+			}
+		}
+
+		m_retired.push_back( { std::move( pObject ), getEpoch(),
+				std::move( isReleasable ), std::move( release ) } );
+	}
+	m_condition.notify_all();
+}
+
+bool EpochReclaimer::revive( const std::shared_ptr<void>& pObject ) {
+	std::lock_guard<std::mutex> lock( m_mutex );
+	for ( auto it = m_retired.begin(); it != m_retired.end(); ++it ) {
+		if ( it->pObject == pObject ) {
+			m_retired.erase( it );
+			return true;
+		}
+	}
+	return false;
+}
+
+bool EpochReclaimer::isRetired( const std::shared_ptr<void>& pObject ) const {
+	std::lock_guard<std::mutex> lock( m_mutex );
+	for ( const auto& rretired : m_retired ) {
+		if ( rretired.pObject == pObject ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool EpochReclaimer::hasPassed( uint64_t nEpoch ) const {
+	// An even epoch at the time of retirement means no cycle was
+	// running. Since objects are unlinked before being retired, later
+	// cycles are unable to reach them.
+	return nEpoch % 2 == 0 || getEpoch() > nEpoch;
+}
+
+void EpochReclaimer::synchronize() const {
+	const uint64_t nEpoch = getEpoch();
+	while ( ! hasPassed( nEpoch ) ) {
+		std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+	}
+}
+
+int EpochReclaimer::reclaim() {
+	// Objects are released while holding the mutex. This way revive()
+	// can not interfere with an ongoing release.
+	std::lock_guard<std::mutex> lock( m_mutex );
+	for ( auto it = m_retired.begin(); it != m_retired.end(); ) {
+		if ( hasPassed( it->nEpoch ) &&
+			 ( ! it->isReleasable || it->isReleasable() ) ) {
+			if ( it->release ) {
+				it->release();
+			}
+			it = m_retired.erase( it );
+		}
+		else {
+			++it;
+		}
+	}
+
+	return static_cast<int>(m_retired.size());
+}
+
+void EpochReclaimer::run() {
+	std::unique_lock<std::mutex> lock( m_mutex );
+	while ( ! m_bShutdown ) {
+		if ( m_retired.empty() ) {
+			m_condition.wait( lock );
+			continue;
+		}
+
+		m_condition.wait_for( lock,
+							  std::chrono::milliseconds( nPollIntervalMs ) );
+		if ( m_bShutdown ) {
+			break;
+		}
+
+		lock.unlock();
+		reclaim();
+		lock.lock();
+	}
+}
+
+QString EpochReclaimer::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	std::lock_guard<std::mutex> lock( m_mutex );
+	if ( ! bShort ) {
+		sOutput = QString( "%1[EpochReclaimer]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_nEpoch: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( getEpoch() ) )
+			.append( QString( "%1%2m_retired: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_retired.size() ) );
+	}
+	else {
+		sOutput = QString( "[EpochReclaimer]" )
+			.append( QString( " m_nEpoch: %1" ).arg( getEpoch() ) )
+			.append( QString( ", m_retired: %1" ).arg( m_retired.size() ) );
+	}
+
+	return sOutput;
+}
+
+};
@@ -0,0 +1,164 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+#ifndef EPOCH_RECLAIMER_H
+#define EPOCH_RECLAIMER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <core/Object.h>
+
+namespace H2Core
+{
+
+/**
+ * Epoch-based reclamation of objects accessed by the audio thread.
+ *
+ * Within a process cycle the audio thread accesses instruments, their
+ * components, and samples using plain pointers. Instead of keeping
+ * them alive by copying shared pointers (which involves atomic
+ * reference counting on each access), objects no longer used by the
+ * current song are handed over to retire(). They are released by a
+ * dedicated, non-realtime thread as soon as
+ *
+ * - every process cycle which might have seen them has finished and
+ * - the optional predicate provided on retirement holds (e.g. no
+ *   note referencing the object is left in one of the queues).
+ *
+ * The audio thread itself only increments #m_nEpoch twice per cycle.
+ * An odd epoch indicates a cycle in progress.
+ */
+class EpochReclaimer : public H2Core::Object<EpochReclaimer>
+{
+	H2_OBJECT(EpochReclaimer)
+public:
+
+	/** Marks the current process cycle for its whole scope. */
+	class Cycle {
+	public:
+		Cycle( EpochReclaimer* pReclaimer ) : m_pReclaimer( pReclaimer ) {
+			m_pReclaimer->m_nEpoch.fetch_add( 1, std::memory_order_acq_rel );
+		}
+		~Cycle() {
+			m_pReclaimer->m_nEpoch.fetch_add( 1, std::memory_order_release );
+		}
+	private:
+		EpochReclaimer* m_pReclaimer;
+	};
+
+	EpochReclaimer();
+	~EpochReclaimer();
+
+	/**
+	 * Hands over @a pObject for deferred release.
+	 *
+	 * \param pObject Object to release.
+	 * \param isReleasable Predicate which has to hold in addition to
+	 *   all readers having passed. If `nullptr`, only the epoch is
+	 *   checked.
+	 * \param release Called on the reclaimer thread right before the
+	 *   reference to @a pObject is dropped. Since the object might still
+	 *   be referenced elsewhere (e.g. in the undo stack), this is the
+	 *   place to release its heavy-weight resources.
+	 */
+	void retire( std::shared_ptr<void> pObject,
+				 std::function<bool()> isReleasable = nullptr,
+				 std::function<void()> release = nullptr );
+	/**
+	 * Withdraws @a pObject from reclamation in case it was retired
+	 * before, e.g. when undoing the removal of an instrument.
+	 *
+	 * \return whether @a pObject was retired.
+	 */
+	bool revive( const std::shared_ptr<void>& pObject );
+	/** Whether @a pObject was retired and is not released yet. */
+	bool isRetired( const std::shared_ptr<void>& pObject ) const;
+
+	/**
+	 * Releases all retired objects which are safe to release.
+	 *
+	 * This is done periodically by the reclaimer thread but can be
+	 * triggered manually, e.g. after the audio engine was stopped.
+	 *
+	 * \return number of objects still waiting.
+	 */
+	int reclaim();
+
+	/**
+	 * Blocks until all process cycles running at the time of the call
+	 * have finished. Objects unlinked from the audio thread prior to
+	 * calling this function can be released right afterwards.
+	 *
+	 * Must not be called from within a process cycle.
+	 */
+	void synchronize() const;
+
+	uint64_t getEpoch() const;
+
+	/** Interval in which the reclaimer thread checks pending objects. */
+	static constexpr int nPollIntervalMs = 20;
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	struct Retired {
+		std::shared_ptr<void> pObject;
+		/** Epoch at the time of retirement. */
+		uint64_t nEpoch;
+		std::function<bool()> isReleasable;
+		std::function<void()> release;
+	};
+
+	/** Whether no process cycle which started before @a nEpoch is
+	 * still running. */
+	bool hasPassed( uint64_t nEpoch ) const;
+	void run();
+
+	std::atomic<uint64_t> m_nEpoch;
+
+	std::list<Retired> m_retired;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condition;
+	bool m_bShutdown;
+	std::thread m_thread;
+};
+
+inline uint64_t EpochReclaimer::getEpoch() const {
+	return m_nEpoch.load( std::memory_order_acquire );
+}
+
+};
+
+#endif
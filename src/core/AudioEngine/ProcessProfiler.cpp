@@ -0,0 +1,234 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/AudioEngine/ProcessProfiler.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace H2Core
+{
+
+ProcessProfiler::ProcessProfiler() {
+	reset();
+}
+
+int64_t ProcessProfiler::now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+int ProcessProfiler::bin( int64_t nNanoseconds ) {
+	int64_t nMicroseconds = nNanoseconds / 1000;
+	int nBin = 0;
+	while ( nMicroseconds > 0 && nBin < nBins - 1 ) {
+		nMicroseconds >>= 1;
+		++nBin;
+	}
+	return nBin;
+}
+
+void ProcessProfiler::record( Stage stage, int64_t nNanoseconds ) {
+	auto& entry = m_entries[ static_cast<int>(stage) ];
+
+	// Each stage has just a single writer. There is no need for
+	// read-modify-write operations.
+	entry.nLast.store( nNanoseconds, std::memory_order_relaxed );
+	if ( nNanoseconds > entry.nMax.load( std::memory_order_relaxed ) ) {
+		entry.nMax.store( nNanoseconds, std::memory_order_relaxed );
+	}
+	entry.nSum.store( entry.nSum.load( std::memory_order_relaxed ) +
+					  nNanoseconds, std::memory_order_relaxed );
+	auto& nBinCount = entry.histogram[ bin( nNanoseconds ) ];
+	nBinCount.store( nBinCount.load( std::memory_order_relaxed ) + 1,
+					 std::memory_order_relaxed );
+	entry.nCount.store( entry.nCount.load( std::memory_order_relaxed ) + 1,
+						std::memory_order_release );
+}
+
+int64_t ProcessProfiler::lap( Stage stage, int64_t nStart ) {
+	const int64_t nNow = now();
+	record( stage, nNow - nStart );
+	return nNow;
+}
+
+ProcessProfiler::Statistics ProcessProfiler::getStatistics( Stage stage ) const {
+	const auto& entry = m_entries[ static_cast<int>(stage) ];
+
+	Statistics statistics;
+	statistics.nCount = entry.nCount.load( std::memory_order_acquire );
+	statistics.fLast = entry.nLast.load( std::memory_order_relaxed ) / 1e6;
+	statistics.fMax = entry.nMax.load( std::memory_order_relaxed ) / 1e6;
+	statistics.fMean = 0;
+	if ( statistics.nCount > 0 ) {
+		statistics.fMean = entry.nSum.load( std::memory_order_relaxed ) /
+			static_cast<double>(statistics.nCount) / 1e6;
+	}
+
+	uint64_t nTotal = 0;
+	for ( int ii = 0; ii < nBins; ++ii ) {
+		statistics.histogram[ ii ] =
+			entry.histogram[ ii ].load( std::memory_order_relaxed );
+		nTotal += statistics.histogram[ ii ];
+	}
+
+	statistics.fPercentile99 = 0;
+	uint64_t nCumulative = 0;
+	for ( int ii = 0; ii < nBins && nTotal > 0; ++ii ) {
+		nCumulative += statistics.histogram[ ii ];
+		if ( nCumulative * 100 >= nTotal * 99 ) {
+			// Upper bin bound in milliseconds.
+			statistics.fPercentile99 =
+				std::min( static_cast<float>( ( int64_t( 1 ) << ii ) / 1e3 ),
+						  statistics.fMax );
+			break;
+		}
+	}
+
+	return statistics;
+}
+
+void ProcessProfiler::recordSilencedVoice( int64_t nFrames ) {
+	// Single writer as well.
+	m_nSilencedFrames.store( m_nSilencedFrames.load( std::memory_order_relaxed ) +
+							 static_cast<uint64_t>( std::max( nFrames, int64_t( 0 ) ) ),
+							 std::memory_order_relaxed );
+	m_nSilencedVoices.store( m_nSilencedVoices.load( std::memory_order_relaxed ) + 1,
+							 std::memory_order_release );
+}
+
+uint64_t ProcessProfiler::getSilencedVoices() const {
+	return m_nSilencedVoices.load( std::memory_order_acquire );
+}
+
+uint64_t ProcessProfiler::getSilencedFrames() const {
+	return m_nSilencedFrames.load( std::memory_order_relaxed );
+}
+
+void ProcessProfiler::reset() {
+	for ( auto& entry : m_entries ) {
+		entry.nCount.store( 0 );
+		entry.nLast.store( 0 );
+		entry.nMax.store( 0 );
+		entry.nSum.store( 0 );
+		for ( auto& nBinCount : entry.histogram ) {
+			nBinCount.store( 0 );
+		}
+	}
+	m_nSilencedVoices.store( 0 );
+	m_nSilencedFrames.store( 0 );
+}
+
+QString ProcessProfiler::StageToQString( Stage stage ) {
+	switch ( stage ) {
+	case Stage::Lock:
+		return "Lock";
+	case Stage::Buffers:
+		return "Buffers";
+	case Stage::Transport:
+		return "Transport";
+	case Stage::NoteQueue:
+		return "NoteQueue";
+	case Stage::PlayNotes:
+		return "PlayNotes";
+	case Stage::Sampler:
+		return "Sampler";
+	case Stage::Effects:
+		return "Effects";
+	case Stage::Metering:
+		return "Metering";
+	case Stage::DriverIO:
+		return "DriverIO";
+	case Stage::Total:
+		return "Total";
+	default:
+		return QString( "Unknown stage [%1]" ).arg( static_cast<int>(stage) );
+	}
+}
+
+QString ProcessProfiler::format() const {
+	QString sOutput = QString( "%1 %2 %3 %4 %5 %6\n" )
+		.arg( "Stage", -10 ).arg( "cycles", 9 ).arg( "last [ms]", 10 )
+		.arg( "mean [ms]", 10 ).arg( "p99 [ms]", 10 ).arg( "max [ms]", 10 );
+
+	for ( int ii = 0; ii < nStages; ++ii ) {
+		const auto stage = static_cast<Stage>(ii);
+		const auto statistics = getStatistics( stage );
+		if ( statistics.nCount == 0 ) {
+			continue;
+		}
+		sOutput.append( QString( "%1 %2 %3 %4 %5 %6\n" )
+						.arg( StageToQString( stage ), -10 )
+						.arg( statistics.nCount, 9 )
+						.arg( statistics.fLast, 10, 'f', 3 )
+						.arg( statistics.fMean, 10, 'f', 3 )
+						.arg( statistics.fPercentile99, 10, 'f', 3 )
+						.arg( statistics.fMax, 10, 'f', 3 ) );
+	}
+
+	const uint64_t nSilencedVoices = getSilencedVoices();
+	if ( nSilencedVoices > 0 ) {
+		sOutput.append( QString( "Silenced voices: %1 (%2 frames skipped)\n" )
+						.arg( nSilencedVoices ).arg( getSilencedFrames() ) );
+	}
+
+	return sOutput;
+}
+
+QString ProcessProfiler::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[ProcessProfiler]\n" ).arg( sPrefix );
+		for ( int ii = 0; ii < nStages; ++ii ) {
+			const auto stage = static_cast<Stage>(ii);
+			const auto statistics = getStatistics( stage );
+			sOutput.append( QString( "%1%2%3: count: %4, last: %5, mean: %6, p99: %7, max: %8\n" )
+							.arg( sPrefix ).arg( s ).arg( StageToQString( stage ) )
+							.arg( statistics.nCount ).arg( statistics.fLast )
+							.arg( statistics.fMean ).arg( statistics.fPercentile99 )
+							.arg( statistics.fMax ) );
+		}
+		sOutput.append( QString( "%1%2m_nSilencedVoices: %3\n" ).arg( sPrefix ).arg( s )
+						.arg( getSilencedVoices() ) )
+			.append( QString( "%1%2m_nSilencedFrames: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( getSilencedFrames() ) );
+	}
+	else {
+		sOutput = QString( "[ProcessProfiler]" );
+		for ( int ii = 0; ii < nStages; ++ii ) {
+			const auto stage = static_cast<Stage>(ii);
+			const auto statistics = getStatistics( stage );
+			sOutput.append( QString( "%1 %2: [%3, %4, %5, %6]" )
+							.arg( ii == 0 ? "" : "," )
+							.arg( StageToQString( stage ) )
+							.arg( statistics.fLast ).arg( statistics.fMean )
+							.arg( statistics.fPercentile99 )
+							.arg( statistics.fMax ) );
+		}
+		sOutput.append( QString( ", m_nSilencedVoices: %1" ).arg( getSilencedVoices() ) )
+			.append( QString( ", m_nSilencedFrames: %1" ).arg( getSilencedFrames() ) );
+	}
+
+	return sOutput;
+}
+
+};
@@ -0,0 +1,158 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+#ifndef PROCESS_PROFILER_H
+#define PROCESS_PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <QString>
+
+#include <core/Object.h>
+
+namespace H2Core
+{
+
+/**
+ * Timing statistics of the individual stages of
+ * AudioEngine::audioEngine_process().
+ *
+ * For each stage the duration of every cycle is recorded into a
+ * histogram with logarithmically spaced bins along with its last,
+ * maximum, and accumulated value. Recording neither locks nor
+ * allocates. All members are atomics and each stage is only written by
+ * a single thread - the one running the process cycle - while any other
+ * thread can read the statistics at any time.
+ *
+ * Durations are measured using a monotonic clock.
+ */
+class ProcessProfiler : public H2Core::Object<ProcessProfiler>
+{
+	H2_OBJECT(ProcessProfiler)
+public:
+	enum class Stage {
+		/** Waiting for the audio engine lock. */
+		Lock = 0,
+		/** Fetching and clearing the output buffers of the driver. */
+		Buffers = 1,
+		/** Transport synchronization, tempo and state updates. */
+		Transport = 2,
+		/** AudioEngine::updateNoteQueue() */
+		NoteQueue = 3,
+		/** AudioEngine::processPlayNotes() */
+		PlayNotes = 4,
+		/** Sampler::process() rendering all voices and mixing them into
+		 * the output buffers. */
+		Sampler = 5,
+		/** LADSPA effects. */
+		Effects = 6,
+		/** Peak metering of the master output. */
+		Metering = 7,
+		/** Converting the rendered buffers into the sample format of
+		 * the device and handing them over to it. Only recorded by
+		 * drivers doing so in their own thread (ALSA). Time spent
+		 * waiting for the device to become ready is excluded. */
+		DriverIO = 8,
+		/** Whole process cycle. */
+		Total = 9
+	};
+	static constexpr int nStages = 10;
+
+	/** Bin 0 holds all durations below 1us and bin n > 0 those within
+	 * [2^(n-1), 2^n) us. The last bin holds everything above. */
+	static constexpr int nBins = 24;
+
+	struct Statistics {
+		uint64_t nCount;
+		/** All durations in milliseconds. */
+		float fLast;
+		float fMean;
+		float fMax;
+		/** Upper bound of the histogram bin the 99th percentile
+		 * resides in. */
+		float fPercentile99;
+		std::array<uint64_t, nBins> histogram;
+	};
+
+	ProcessProfiler();
+
+	/** Timestamp of the monotonic clock in nanoseconds. */
+	static int64_t now();
+
+	/** Has to be called by the thread running the process cycle. */
+	void record( Stage stage, int64_t nNanoseconds );
+	/**
+	 * Records the time passed since @a nStart for @a stage.
+	 *
+	 * \return Current timestamp to be used as start of the next stage.
+	 */
+	int64_t lap( Stage stage, int64_t nStart );
+
+	Statistics getStatistics( Stage stage ) const;
+
+	/** Records a voice ended by the Sampler before reaching the end of
+	 * its sample since the remainder would have been inaudible.
+	 * @a nFrames is the number of frames not rendered because of it.
+	 *
+	 * Has to be called by the thread running the process cycle. */
+	void recordSilencedVoice( int64_t nFrames );
+	uint64_t getSilencedVoices() const;
+	uint64_t getSilencedFrames() const;
+
+	/** Drops all recorded durations and counters. */
+	void reset();
+
+	/** Table of all stages containing at least one recorded duration
+	 * suitable for display in a monospace font. */
+	QString format() const;
+
+	static QString StageToQString( Stage stage );
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	struct Entry {
+		std::atomic<uint64_t> nCount;
+		std::atomic<int64_t> nLast;
+		std::atomic<int64_t> nMax;
+		std::atomic<int64_t> nSum;
+		std::array<std::atomic<uint64_t>, nBins> histogram;
+	};
+
+	static int bin( int64_t nNanoseconds );
+
+	std::array<Entry, nStages> m_entries;
+	std::atomic<uint64_t> m_nSilencedVoices;
+	std::atomic<uint64_t> m_nSilencedFrames;
+};
+
+};
+
+#endif
@@ -133,9 +133,11 @@ void TransportPosition::setBpm( float fNewBpm ) {
 		fNewBpm = MIN_BPM;
 	}
 	
+	const bool bTempoChanged = fNewBpm != m_fBpm;
 	m_fBpm = fNewBpm;
 
-	if ( Preferences::get_instance()->getRubberBandBatchMode() ) {
+	if ( bTempoChanged &&
+		 Preferences::get_instance()->getRubberBandBatchMode() ) {
 		auto pHydrogen = Hydrogen::get_instance();
 		auto pSong = pHydrogen->getSong();
 		if ( pSong == nullptr ) {
@@ -146,7 +148,16 @@ void TransportPosition::setBpm( float fNewBpm ) {
 			return;
 		}
 
-		pDrumkit->recalculateRubberband( getBpm() );
+		if ( pHydrogen->getIsExportSessionActive() ) {
+			// There are no realtime constraints during export but the
+			// stretched samples have to be present right away.
+			pDrumkit->recalculateRubberband( getBpm() );
+		}
+		else {
+			// The previous variants keep playing till the new ones are
+			// ready.
+			pHydrogen->getAudioEngine()->getTimeStretcher()->request( getBpm() );
+		}
 	}
 }
  
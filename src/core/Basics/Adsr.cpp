@@ -22,6 +22,8 @@
 
 #include <core/Basics/Adsr.h>
 
+#include <algorithm>
+
 namespace H2Core
 {
 
@@ -185,9 +187,10 @@ bool ADSR::applyADSR( float *pLeft, float *pRight, int nFinalBufferPos, int nRel
 
 	if ( m_state == State::Attack ) {
 		int nAttackFrames = std::min( nFinalBufferPos, nReleaseFrame );
-		if ( nAttackFrames * fStep > m_nAttack ) {
-			// Attack must end before nFinalBufferPos, so trim it
-			nAttackFrames = ceil( m_nAttack / fStep );
+		if ( nAttackFrames * fStep > m_nAttack - m_fFramesInState ) {
+			// Attack must end before nFinalBufferPos, so trim it. Only the
+			// part not covered in previous calls is left.
+			nAttackFrames = ceil( ( m_nAttack - m_fFramesInState ) / fStep );
 		}
 
 		m_fQ = applyExponential( fAttackExponent, fAttackInit, 0.0, -1.0,
@@ -207,8 +210,8 @@ bool ADSR::applyADSR( float *pLeft, float *pRight, int nFinalBufferPos, int nRel
 
 	if ( m_state == State::Decay ) {
 		int nDecayFrames = std::min( nFinalBufferPos, nReleaseFrame ) - nBufferPos;
-		if ( nDecayFrames * fStep > m_nDecay ) {
-			nDecayFrames = ceil( m_nDecay / fStep );
+		if ( nDecayFrames * fStep > m_nDecay - m_fFramesInState ) {
+			nDecayFrames = ceil( ( m_nDecay - m_fFramesInState ) / fStep );
 		}
 
 		m_fQ = applyExponential( fDecayExponent, -fDecayYOffset, m_fSustain, (1.0-m_fSustain),
@@ -248,8 +251,8 @@ bool ADSR::applyADSR( float *pLeft, float *pRight, int nFinalBufferPos, int nRel
 	if ( m_state == State::Release ) {
 
 		int nReleaseFrames = nFinalBufferPos - nBufferPos;
-		if ( nReleaseFrames * fStep > m_nRelease ) {
-			nReleaseFrames = ceil( m_nRelease / fStep );
+		if ( nReleaseFrames * fStep > m_nRelease - m_fFramesInState ) {
+			nReleaseFrames = ceil( ( m_nRelease - m_fFramesInState ) / fStep );
 		}
 
 		m_fQ = applyExponential( fDecayExponent, -fDecayYOffset, 0.0, m_fReleaseValue,
@@ -295,6 +298,28 @@ float ADSR::release()
 	return m_fReleaseValue;
 }
 
+void ADSR::fadeOut( unsigned int nFrames )
+{
+	if ( m_state == State::Idle ) {
+		return;
+	}
+
+	if ( m_state == State::Release ) {
+		const float fRemaining = static_cast<float>(m_nRelease) - m_fFramesInState;
+		if ( fRemaining <= static_cast<float>(nFrames) ) {
+			return;
+		}
+	}
+
+	// Restart the release from the current value but over a shorter
+	// period.
+	m_fReleaseValue = m_fValue;
+	m_nRelease = std::max( nFrames, 1u );
+	m_state = State::Release;
+	m_fFramesInState = 0;
+	m_fQ = fDecayInit;
+}
+
 QString ADSR::StateToQString( const State& state ) {
 	switch( state ) {
 	case State::Attack:
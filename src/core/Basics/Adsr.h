@@ -75,6 +75,16 @@ class ADSR : public Object<ADSR>
 		 * State setting is only applied if the ADSR is not in #State::Idle.
 		 * */
 		float release();
+		/**
+		 * Like release() but ensures the release phase ends after at
+		 * most @a nFrames frames. Used to silence voices stolen by the
+		 * #H2Core::Sampler without clicks and without waiting for a
+		 * potentially long release of the instrument.
+		 *
+		 * Since each note holds its own copy of the ADSR, the release
+		 * of the instrument is not altered.
+		 */
+		void fadeOut( unsigned int nFrames );
 
 		/**
 		 * Compute and apply successive ADSR values to stereo buffers.
@@ -117,6 +127,8 @@ class ADSR : public Object<ADSR>
 	static QString StateToQString( const State& state );
 
 		const State& getState() const;
+		/** Most recent value of the envelope. */
+		float getValue() const;
 
 		/** Formatted string version for debugging purposes.
 		 * \param sPrefix String prefix which will be added in front of
@@ -198,6 +210,9 @@ inline unsigned int ADSR::getRelease() const
 inline const ADSR::State& ADSR::getState() const {
 	return m_state;
 }
+inline float ADSR::getValue() const {
+	return m_fValue;
+}
 
 };
 
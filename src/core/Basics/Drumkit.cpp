@@ -21,6 +21,7 @@
  */
 
 #include <QFile>
+#include <QXmlStreamReader>
 #include <QDataStream>
 
 #include <core/Basics/Drumkit.h>
@@ -37,6 +38,7 @@
   #endif
 #endif
 
+#include <core/AudioEngine/AudioEngine.h>
 #include <core/Basics/Sample.h>
 #include <core/Basics/DrumkitMap.h>
 #include <core/Basics/Instrument.h>
@@ -105,7 +107,8 @@ std::shared_ptr<Drumkit> Drumkit::getEmptyDrumkit() {
 	return pDrumkit;
 }
 
-std::shared_ptr<Drumkit> Drumkit::load( const QString& sDrumkitPath, bool bUpgrade, bool bSilent )
+std::shared_ptr<Drumkit> Drumkit::load( const QString& sDrumkitPath, bool bUpgrade,
+									   bool bSilent, bool* pbUpgradeRequired )
 {
 	if ( ! Filesystem::drumkit_valid( sDrumkitPath ) ) {
 		ERRORLOG( QString( "[%1] is not valid drumkit folder" ).arg( sDrumkitPath ) );
@@ -113,30 +116,33 @@ std::shared_ptr<Drumkit> Drumkit::load( const QString& sDrumkitPath, bool bUpgra
 	}
 
 	QString sDrumkitFile = Filesystem::drumkit_file( sDrumkitPath );
-	
-	bool bReadingSuccessful = true;
-	
-	XMLDoc doc;
-	if ( !doc.read( sDrumkitFile, Filesystem::drumkit_xsd_path(), true ) ) {
-		// Drumkit does not comply with the XSD schema
-		// definition. It's probably an old one. load_from() will try
-		// to handle it regardlessly but we should upgrade it in order
-		// to avoid this in future loads.
-		doc.read( sDrumkitFile, nullptr, bSilent );
-		
-		bReadingSuccessful = false;
-	}
-	
-	XMLNode root = doc.firstChildElement( "drumkit_info" );
-	if ( root.isNull() ) {
-		ERRORLOG( "drumkit_info node not found" );
-		return nullptr;
+	const QString sDrumkitDir =
+		sDrumkitFile.left( sDrumkitFile.lastIndexOf( "/" ) );
+
+	// Kits complying with the current format are streamed and checked
+	// while being read. Only older ones are parsed into a DOM and
+	// validated against the XSD file.
+	auto pDrumkit = loadStream( sDrumkitFile, sDrumkitDir, bSilent );
+	bool bReadingSuccessful = pDrumkit != nullptr;
+
+	if ( pDrumkit == nullptr ) {
+		XMLDoc doc;
+		// Drumkit does not comply with the XSD schema definition in case
+		// read() fails. It's probably an old one. loadFrom() will try to
+		// handle it regardlessly (the document was parsed anyway) but we
+		// should upgrade it in order to avoid this in future loads.
+		bReadingSuccessful =
+			doc.read( sDrumkitFile, Filesystem::drumkit_xsd_path(), true );
+
+		XMLNode root = doc.firstChildElement( "drumkit_info" );
+		if ( root.isNull() ) {
+			ERRORLOG( "drumkit_info node not found" );
+			return nullptr;
+		}
+
+		pDrumkit = Drumkit::loadFrom( root, sDrumkitDir, "", false, bSilent );
 	}
 
-	auto pDrumkit =
-		Drumkit::loadFrom( root, sDrumkitFile.left( sDrumkitFile.lastIndexOf( "/" ) ),
-						   "", false, bSilent );
-	
 	if ( pDrumkit == nullptr ) {
 		ERRORLOG( QString( "Unable to load drumkit [%1]" ).arg( sDrumkitFile ) );
 		return nullptr;
@@ -144,6 +150,9 @@ std::shared_ptr<Drumkit> Drumkit::load( const QString& sDrumkitPath, bool bUpgra
 
 	pDrumkit->setContext( DetermineContext( pDrumkit->getPath() ) );
 
+	if ( pbUpgradeRequired != nullptr ) {
+		*pbUpgradeRequired = ! bReadingSuccessful;
+	}
 	if ( ! bReadingSuccessful && bUpgrade ) {
 		pDrumkit->upgrade( bSilent );
 	}
@@ -151,11 +160,129 @@ std::shared_ptr<Drumkit> Drumkit::load( const QString& sDrumkitPath, bool bUpgra
 	return pDrumkit;
 }
 
+std::shared_ptr<Drumkit> Drumkit::loadStream( const QString& sDrumkitFile,
+											  const QString& sDrumkitPath,
+											  bool bSilent )
+{
+	QFile file( sDrumkitFile );
+	if ( ! file.open( QIODevice::ReadOnly ) ||
+		 Legacy::checkTinyXMLCompatMode( &file, bSilent ) ||
+		 ! file.seek( 0 ) ) {
+		return nullptr;
+	}
+
+	QXmlStreamReader reader( &file );
+	if ( ! reader.readNextStartElement() ||
+		 reader.name() != QLatin1String( "drumkit_info" ) ) {
+		return nullptr;
+	}
+
+	// Elements of <drumkit_info> in the order defined in drumkit.xsd.
+	// All but the optional versions have to be present.
+	const QStringList properties = { "formatVersion", "name", "userVersion",
+									 "author", "info", "license", "image",
+									 "imageLicense" };
+	const QStringList optionalProperties = { "formatVersion", "userVersion" };
+
+	// Holds the properties read so far. The instruments are read into
+	// documents of their own one at a time.
+	XMLDoc doc;
+	XMLNode root = doc.createElement( "drumkit_info" );
+	doc.appendChild( root );
+	int nLastProperty = -1;
+	std::shared_ptr<Drumkit> pDrumkit = nullptr;
+	std::shared_ptr<InstrumentList> pInstrumentList = nullptr;
+	bool bCurrentFormat = true;
+
+	while ( bCurrentFormat && reader.readNextStartElement() ) {
+		if ( reader.name() == QLatin1String( "instrumentList" ) &&
+			 pDrumkit == nullptr ) {
+			for ( const auto& sProperty : properties ) {
+				if ( ! optionalProperties.contains( sProperty ) &&
+					 root.firstChildElement( sProperty ).isNull() ) {
+					bCurrentFormat = false;
+				}
+			}
+			if ( ! bCurrentFormat ) {
+				break;
+			}
+
+			pDrumkit = loadPropertiesFrom( root, sDrumkitPath, bSilent );
+			if ( pDrumkit == nullptr ) {
+				return nullptr;
+			}
+
+			pInstrumentList = InstrumentList::loadFrom(
+				reader, sDrumkitPath, pDrumkit->m_sName, pDrumkit->m_license,
+				&bCurrentFormat, false );
+			continue;
+		}
+
+		const int nProperty = properties.indexOf( reader.name().toString() );
+		if ( pDrumkit != nullptr || nProperty <= nLastProperty ) {
+			// Unknown, duplicate, or misplaced element, like the
+			// <componentList> of kits created prior to version 1.3.0.
+			bCurrentFormat = false;
+			break;
+		}
+		nLastProperty = nProperty;
+
+		if ( doc.readElement( reader, root ).isNull() ) {
+			break;
+		}
+	}
+
+	if ( reader.hasError() ) {
+		ERRORLOG( QString( "Unable to stream drumkit [%1]: %2" )
+				  .arg( sDrumkitFile ).arg( reader.errorString() ) );
+		return nullptr;
+	}
+	// drumkit.xsd requires at least one instrument to be present.
+	if ( ! bCurrentFormat || pDrumkit == nullptr ||
+		 pInstrumentList == nullptr ) {
+		return nullptr;
+	}
+
+	pDrumkit->finishLoading( pInstrumentList, false, bSilent );
+
+	return pDrumkit;
+}
+
 std::shared_ptr<Drumkit> Drumkit::loadFrom( const XMLNode& node,
 											const QString& sDrumkitPath,
 											const QString& sSongPath,
 											bool bSongKit,
 											bool bSilent )
+{
+	auto pDrumkit = loadPropertiesFrom( node, sDrumkitPath, bSilent );
+	if ( pDrumkit == nullptr ) {
+		return nullptr;
+	}
+
+	auto pInstrumentList = InstrumentList::load_from(
+		node, sDrumkitPath, pDrumkit->m_sName, sSongPath, pDrumkit->m_license,
+		bSongKit, false );
+	// Required to assure backward compatibility.
+	if ( pInstrumentList == nullptr ) {
+		WARNINGLOG( "instrument list could not be loaded. Using empty one." );
+		pInstrumentList = std::make_shared<InstrumentList>();
+	}
+
+	// For kits created between 0.9.7 and 1.2.X, retrieve InstrumentComponent
+	// names from former DrumkitComponents.
+	XMLNode componentListNode = node.firstChildElement( "componentList" );
+	if ( ! componentListNode.isNull() ) {
+		Legacy::loadComponentNames( pInstrumentList, node );
+	}
+
+	pDrumkit->finishLoading( pInstrumentList, bSongKit, bSilent );
+
+	return pDrumkit;
+}
+
+std::shared_ptr<Drumkit> Drumkit::loadPropertiesFrom( const XMLNode& node,
+													  const QString& sDrumkitPath,
+													  bool bSilent )
 {
 	QString sDrumkitName = node.read_string( "name", "", false, false, bSilent );
 	if ( sDrumkitName.isEmpty() ) {
@@ -189,28 +316,19 @@ std::shared_ptr<Drumkit> Drumkit::loadFrom( const XMLNode& node,
 						  pDrumkit->m_sAuthor );
 	pDrumkit->setImageLicense( imageLicense );
 
-	auto pInstrumentList = InstrumentList::load_from(
-		node, sDrumkitPath, sDrumkitName, sSongPath, license, bSongKit, false );
-	// Required to assure backward compatibility.
-	if ( pInstrumentList == nullptr ) {
-		WARNINGLOG( "instrument list could not be loaded. Using empty one." );
-		pInstrumentList = std::make_shared<InstrumentList>();
-	}
+	return pDrumkit;
+}
 
-	// For kits created between 0.9.7 and 1.2.X, retrieve InstrumentComponent
-	// names from former DrumkitComponents.
-	XMLNode componentListNode = node.firstChildElement( "componentList" );
-	if ( ! componentListNode.isNull() ) {
-		Legacy::loadComponentNames( pInstrumentList, node );
-	}
-		
-	pDrumkit->setInstruments( pInstrumentList );
+void Drumkit::finishLoading( std::shared_ptr<InstrumentList> pInstrumentList,
+							 bool bSongKit, bool bSilent )
+{
+	setInstruments( pInstrumentList );
 
 	if ( ! bSongKit ) {
 		// Instead of making the *::load_from() functions more complex by
 		// passing the license down to each sample, we will make the
 		// drumkit assign its license to each sample in here.
-		pDrumkit->propagateLicense();
+		propagateLicense();
 	}
 
 	// Sanity checks
@@ -219,7 +337,7 @@ std::shared_ptr<Drumkit> Drumkit::loadFrom( const XMLNode& node,
 	// every but the first occurrence by an empty string.
 	std::set<DrumkitMap::Type> types;
 	QStringList duplicates;
-	for ( const auto& ppInstrument : *pDrumkit->m_pInstruments ) {
+	for ( const auto& ppInstrument : *m_pInstruments ) {
 		if ( ppInstrument != nullptr && ! ppInstrument->getType().isEmpty() ) {
 			const auto [ _, bSuccess ] = types.insert( ppInstrument->getType() );
 			if ( ! bSuccess ) {
@@ -233,9 +351,7 @@ std::shared_ptr<Drumkit> Drumkit::loadFrom( const XMLNode& node,
 				  .arg( duplicates.join( ", " ) ) );
 	}
 
-	pDrumkit->fixupTypes( bSilent );
-
-	return pDrumkit;
+	fixupTypes( bSilent );
 }
 
 void Drumkit::fixupTypes( bool bSilent ) {
@@ -1200,6 +1316,9 @@ void Drumkit::recalculateRubberband( float fBpm ) {
 		return;
 	}
 
+	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+	auto pTimeStretcher = pAudioEngine->getTimeStretcher();
+
 	if ( m_pInstruments != nullptr ) {
 		for ( unsigned nnInstr = 0; nnInstr < m_pInstruments->size(); ++nnInstr ) {
 			auto pInstr = m_pInstruments->get( nnInstr );
@@ -1220,14 +1339,12 @@ void Drumkit::recalculateRubberband( float fBpm ) {
 							auto pSample = pLayer->get_sample();
 							if ( pSample != nullptr ) {
 								if( pSample->get_rubberband().use ) {
-									auto pNewSample = std::make_shared<Sample>( pSample );
-
-									if ( ! pNewSample->load( fBpm ) ){
+									auto pNewSample = pTimeStretcher->stretch( pSample, fBpm );
+									if ( pNewSample == nullptr ) {
 										continue;
 									}
 
-									// insert new sample from newInstrument
-									pLayer->set_sample( pNewSample );
+									pLayer->set_sample( pNewSample, pAudioEngine->getReclaimer() );
 								}
 							}
 						}
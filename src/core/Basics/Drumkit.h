@@ -98,12 +98,24 @@ class Drumkit : public H2Core::Object<Drumkit>
 		 * with the current XSD file.
 		 * \param bSilent if set to true, all log messages except of
 		 * errors and warnings are suppressed.
+		 * \param pbUpgradeRequired If not `nullptr`, it is set to whether
+		 *   the kit did not comply with the current XSD file. This allows
+		 *   to defer the upgrade, e.g. when loading several kits in
+		 *   parallel.
 		 *
 		 * \return A Drumkit on success, nullptr otherwise.
 		 */
 		static std::shared_ptr<Drumkit> load( const QString& sDrumkitDir,
 											  bool bUpgrade = true,
-											  bool bSilent = false );
+											  bool bSilent = false,
+											  bool* pbUpgradeRequired = nullptr );
+		/**
+		 * Upgrades the drumkit by saving the latest version.
+		 *
+		 * This is a wrapper around #H2Core::Drumkit::save() which also creates
+		 * a backup of the drumkit definition.
+		 */
+		void upgrade( bool bSilent = false );
 
 		/**
 		 * load a drumkit from an XMLNode
@@ -289,6 +301,11 @@ class Drumkit : public H2Core::Object<Drumkit>
 		/** Recalculates all Samples using RubberBand for a specific
 		* tempo @a fBpm.
 		*
+		* Variants not already cached by the #TimeStretcher are
+		* rendered in the calling thread. Use
+		* TimeStretcher::request() to do so in the background
+		* instead.
+		*
 		* This function requires the calling function to lock the
 		* #AudioEngine first.
 		*/
@@ -364,13 +381,6 @@ class Drumkit : public H2Core::Object<Drumkit>
 		 */
 	bool saveSamples( const QString& dk_dir, bool bSilent = false ) const;
 
-		/**
-		 * Upgrades the drumkit by saving the latest version.
-		 *
-		 * This is a wrapper around #H2Core::Drumkit::save() which also creates
-		 * a backup of the drumkit definition.
-		 */
-		void upgrade( bool bSilent = false );
 
 	/**
 	 * Assign the license stored in #m_license to all samples
@@ -378,6 +388,38 @@ class Drumkit : public H2Core::Object<Drumkit>
 	 */
 	void propagateLicense();
 
+		/**
+		 * Reads a drumkit.xml file in a single pass. Instead of
+		 * validating it against the XSD file beforehand, it is checked
+		 * to comply with the current format while being read.
+		 *
+		 * \param sDrumkitFile path to the drumkit.xml file
+		 * \param sDrumkitPath the directory holding the drumkit data
+		 * \param bSilent if set to true, all log messages except of
+		 * errors and warnings are suppressed.
+		 *
+		 * \return `nullptr` in case the file could not be streamed or
+		 *   does not comply with the current format. It has to be read
+		 *   into a DOM and handled by loadFrom() instead.
+		 */
+		static std::shared_ptr<Drumkit> loadStream( const QString& sDrumkitFile,
+													const QString& sDrumkitPath,
+													bool bSilent = false );
+		/**
+		 * Reads all properties of the kit but its instruments.
+		 *
+		 * \return `nullptr` in case the kit has no name.
+		 */
+		static std::shared_ptr<Drumkit> loadPropertiesFrom( const XMLNode& node,
+															const QString& sDrumkitPath,
+															bool bSilent = false );
+		/**
+		 * Assigns @a pInstrumentList to the freshly loaded kit and
+		 * performs the sanity checks shared by all loading routines.
+		 */
+		void finishLoading( std::shared_ptr<InstrumentList> pInstrumentList,
+							bool bSongKit, bool bSilent = false );
+
 		/** Used to indicate changes in the underlying XSD file. */
 		static constexpr int nCurrentFormatVersion = 2;
 
@@ -50,7 +50,7 @@ std::shared_ptr<DrumkitMap> DrumkitMap::load( const QString& sPath, bool bSilent
 		WARNINGLOG( QString( "Mapping file [%1] is not valid with respect to [%2]. Loading might fail." )
 					.arg( sPath )
 					.arg( Filesystem::drumkit_map_xsd_path() ) );
-		if ( ! doc.read( sPath, nullptr, bSilent ) ) {
+		if ( doc.documentElement().isNull() ) {
 			WARNINGLOG( QString( "Mapping file [%1] could not be loaded cleanly without XSD file either" )
 						.arg( sPath ) );
 		}
@@ -58,18 +58,24 @@ Instrument::Instrument( const int id, const QString& name, std::shared_ptr<ADSR>
 	, __filter_active( false )
 	, __filter_cutoff( 1.0 )
 	, __filter_resonance( 0.0 )
+	, m_filterMode( ResonantFilter::Mode::LowPass )
 	, __pitch_offset( 0.0 )
 	, __random_pitch_factor( 0.0 )
 	, __midi_out_note( MidiMessage::instrumentOffset + id )
 	, __midi_out_channel( -1 )
 	, __stop_notes( false )
 	, __sample_selection_alg( VELOCITY )
+	, m_bCustomInterpolateMode( false )
+	, m_interpolateMode( Interpolation::InterpolateMode::Linear )
 	, __active( true )
 	, __soloed( false )
 	, __muted( false )
 	, __mute_group( -1 )
+	, m_nChokeGroup( -1 )
+	, m_nMaxVoices( 0 )
+	, m_voiceStealing( VoiceStealing::Oldest )
+	, m_nVoices( 0 )
 	, __queued( 0 )
-	  , m_enqueuedBy( QStringList() )
 	, __hihat_grp( -1 )
 	, __lower_cc( 0 )
 	, __higher_cc( 127 )
@@ -123,18 +129,24 @@ Instrument::Instrument( std::shared_ptr<Instrument> other )
 	, __filter_active( other->is_filter_active() )
 	, __filter_cutoff( other->get_filter_cutoff() )
 	, __filter_resonance( other->get_filter_resonance() )
+	, m_filterMode( other->getFilterMode() )
 	, __random_pitch_factor( other->get_random_pitch_factor() )
 	, __pitch_offset( other->get_pitch_offset() )
 	, __midi_out_note( other->get_midi_out_note() )
 	, __midi_out_channel( other->get_midi_out_channel() )
 	, __stop_notes( other->is_stop_notes() )
 	, __sample_selection_alg( other->sample_selection_alg() )
+	, m_bCustomInterpolateMode( other->hasCustomInterpolateMode() )
+	, m_interpolateMode( other->getInterpolateMode() )
 	, __active( other->is_active() )
 	, __soloed( other->is_soloed() )
 	, __muted( other->is_muted() )
 	, __mute_group( other->get_mute_group() )
+	, m_nChokeGroup( other->getChokeGroup() )
+	, m_nMaxVoices( other->getMaxVoices() )
+	, m_voiceStealing( other->getVoiceStealing() )
+	, m_nVoices( 0 )
 	, __queued( 0 )
-	  , m_enqueuedBy( QStringList() )
 	, __hihat_grp( other->get_hihat_grp() )
 	, __lower_cc( other->get_lower_cc() )
 	, __higher_cc( other->get_higher_cc() )
@@ -157,9 +169,8 @@ Instrument::Instrument( std::shared_ptr<Instrument> other )
 
 Instrument::~Instrument() {
 	if ( __queued > 0 ) {
-		WARNINGLOG( QString( "Instrument [%1] is destroyed while still being enqueued! __queued: %2,\nm_enqueuedNotes:\n\t%3" )
-					.arg( __name ).arg( __queued )
-					.arg( m_enqueuedBy.join( "\n\t" ) ) );
+		WARNINGLOG( QString( "Instrument [%1] is destroyed while still being enqueued! __queued: %2" )
+					.arg( __name ).arg( __queued.load() ) );
 	}
 }
 
@@ -330,6 +341,21 @@ std::shared_ptr<Instrument> Instrument::load_from( const XMLNode& node,
 													  true, false, bSilent ) );
 	pInstrument->set_filter_resonance( node.read_float( "filterResonance", 0.0f,
 														 true, false, bSilent ) );
+	// Optional. Absent for the low-pass filter.
+	const QString sFilterMode = node.read_string(
+		"filterMode", "", false, true, true );
+	if ( ! sFilterMode.isEmpty() ) {
+		bool bOk;
+		const auto filterMode =
+			ResonantFilter::ModeFromQString( sFilterMode, &bOk );
+		if ( bOk ) {
+			pInstrument->setFilterMode( filterMode );
+		}
+		else {
+			WARNINGLOG( QString( "Unknown filter mode [%1]" )
+						.arg( sFilterMode ) );
+		}
+	}
 	pInstrument->set_pitch_offset( node.read_float( "pitchOffset", 0.0f,
 													 true, false, true ) );
 	pInstrument->set_random_pitch_factor( node.read_float( "randomPitchFactor", 0.0f,
@@ -338,6 +364,26 @@ std::shared_ptr<Instrument> Instrument::load_from( const XMLNode& node,
 											 true, false, bSilent ) );
 	pInstrument->set_mute_group( node.read_int( "muteGroup", -1,
 												 true, false, bSilent ) );
+	// Optional. Absent in case no polyphony limit or choke group was
+	// set.
+	pInstrument->setChokeGroup( node.read_int( "chokeGroup", -1,
+												true, false, bSilent ) );
+	pInstrument->setMaxVoices( node.read_int( "maxVoices", 0,
+											   true, false, bSilent ) );
+	const QString sVoiceStealing = node.read_string(
+		"voiceStealing", "", true, true, bSilent );
+	if ( ! sVoiceStealing.isEmpty() ) {
+		bool bOk;
+		const auto voiceStealing =
+			VoiceStealingFromQString( sVoiceStealing, &bOk );
+		if ( bOk ) {
+			pInstrument->setVoiceStealing( voiceStealing );
+		}
+		else {
+			WARNINGLOG( QString( "Unknown voice stealing policy [%1]" )
+						.arg( sVoiceStealing ) );
+		}
+	}
 	pInstrument->set_midi_out_channel( node.read_int( "midiOutChannel", -1,
 													   true, false, bSilent ) );
 	pInstrument->set_midi_out_note( node.read_int( "midiOutNote", pInstrument->__midi_out_note,
@@ -357,6 +403,22 @@ std::shared_ptr<Instrument> Instrument::load_from( const XMLNode& node,
 		pInstrument->set_sample_selection_alg( RANDOM );
 	}
 
+	// Optional. Absent in case the default of the Sampler is used.
+	const QString sInterpolateMode = node.read_string(
+		"interpolateMode", "", false, true, true );
+	if ( ! sInterpolateMode.isEmpty() ) {
+		bool bOk;
+		const auto interpolateMode =
+			Interpolation::ModeFromQString( sInterpolateMode, &bOk );
+		if ( bOk ) {
+			pInstrument->setInterpolateMode( interpolateMode );
+		}
+		else {
+			WARNINGLOG( QString( "Unknown interpolation mode [%1]" )
+						.arg( sInterpolateMode ) );
+		}
+	}
+
 	pInstrument->set_hihat_grp( node.read_int( "isHihat", -1,
 												true, true, bSilent ) );
 	pInstrument->set_lower_cc( node.read_int( "lower_cc", 0,
@@ -535,11 +597,23 @@ void Instrument::save_to( XMLNode& node, bool bSongKit ) const
 	InstrumentNode.write_bool( "filterActive", __filter_active );
 	InstrumentNode.write_float( "filterCutoff", __filter_cutoff );
 	InstrumentNode.write_float( "filterResonance", __filter_resonance );
+	if ( m_filterMode != ResonantFilter::Mode::LowPass ) {
+		InstrumentNode.write_string(
+			"filterMode", ResonantFilter::ModeToQString( m_filterMode ) );
+	}
 	InstrumentNode.write_int( "Attack", __adsr->getAttack() );
 	InstrumentNode.write_int( "Decay", __adsr->getDecay() );
 	InstrumentNode.write_float( "Sustain", __adsr->getSustain() );
 	InstrumentNode.write_int( "Release", __adsr->getRelease() );
 	InstrumentNode.write_int( "muteGroup", __mute_group );
+	if ( m_nChokeGroup != -1 ) {
+		InstrumentNode.write_int( "chokeGroup", m_nChokeGroup );
+	}
+	if ( m_nMaxVoices > 0 ) {
+		InstrumentNode.write_int( "maxVoices", m_nMaxVoices );
+		InstrumentNode.write_string(
+			"voiceStealing", VoiceStealingToQString( m_voiceStealing ) );
+	}
 	InstrumentNode.write_int( "midiOutChannel", __midi_out_channel );
 	InstrumentNode.write_int( "midiOutNote", __midi_out_note );
 	InstrumentNode.write_bool( "isStopNote", __stop_notes );
@@ -555,6 +629,10 @@ void Instrument::save_to( XMLNode& node, bool bSongKit ) const
 		InstrumentNode.write_string( "sampleSelectionAlgo", "ROUND_ROBIN" );
 		break;
 	}
+	if ( m_bCustomInterpolateMode ) {
+		InstrumentNode.write_string(
+			"interpolateMode", Interpolation::ModeToQString( m_interpolateMode ) );
+	}
 
 	InstrumentNode.write_int( "isHihat", __hihat_grp );
 	InstrumentNode.write_int( "lower_cc", __lower_cc );
@@ -575,23 +653,16 @@ void Instrument::save_to( XMLNode& node, bool bSongKit ) const
 }
 
 void Instrument::enqueue( Note* pNote ) {
-	__queued++;
-
-	m_enqueuedBy.push_back( pNote->prettyName() );
+	__queued.fetch_add( 1, std::memory_order_relaxed );
 }
 
 void Instrument::dequeue( Note* pNote ) {
-	if ( __queued <= 0 ) {
+	// Release ordering ensures the reclaimer thread, which unloads the
+	// samples once the counter hit zero, sees all accesses done while
+	// rendering the note.
+	if ( __queued.fetch_sub( 1, std::memory_order_release ) <= 0 ) {
+		__queued.fetch_add( 1, std::memory_order_relaxed );
 		ERRORLOG( QString( "[%1] is not queued!" ).arg( __name ) );
-		return;
-	}
-
-	__queued--;
-
-	if ( __queued > 0 ) {
-		m_enqueuedBy.removeOne( pNote->prettyName() );
-	} else {
-		m_enqueuedBy.clear();
 	}
 }
 
@@ -696,6 +767,8 @@ QString Instrument::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( __filter_cutoff ) )
 			.append( QString( "%1%2filter_resonance: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( __filter_resonance ) )
+			.append( QString( "%1%2m_filterMode: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( ResonantFilter::ModeToQString( m_filterMode ) ) )
 			.append( QString( "%1%2random_pitch_factor: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( __random_pitch_factor ) )
 			.append( QString( "%1%2pitch_offset: %3\n" ).arg( sPrefix ).arg( s )
@@ -708,6 +781,10 @@ QString Instrument::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( __stop_notes ) )
 			.append( QString( "%1%2sample_selection_alg: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( SampleSelectionAlgoToQString( __sample_selection_alg ) ) )
+			.append( QString( "%1%2m_bCustomInterpolateMode: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_bCustomInterpolateMode ) )
+			.append( QString( "%1%2m_interpolateMode: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( Interpolation::ModeToQString( m_interpolateMode ) ) )
 			.append( QString( "%1%2active: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( __active ) )
 			.append( QString( "%1%2soloed: %3\n" ).arg( sPrefix ).arg( s )
@@ -716,10 +793,16 @@ QString Instrument::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( __muted ) )
 			.append( QString( "%1%2mute_group: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( __mute_group ) )
+			.append( QString( "%1%2m_nChokeGroup: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nChokeGroup ) )
+			.append( QString( "%1%2m_nMaxVoices: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nMaxVoices ) )
+			.append( QString( "%1%2m_voiceStealing: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( VoiceStealingToQString( m_voiceStealing ) ) )
+			.append( QString( "%1%2m_nVoices: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nVoices ) )
 			.append( QString( "%1%2queued: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( __queued ) )
-			.append( QString( "%1%2m_enqueuedBy: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( m_enqueuedBy.join( "\n" + sPrefix + s + s  ) ) );
+					 .arg( __queued.load() ) );
 		sOutput.append( QString( "%1%2fx_level: [ " ).arg( sPrefix ).arg( s ) );
 		for ( const auto& ff : __fx_level ) {
 			sOutput.append( QString( "%1 " ).arg( ff ) );
@@ -764,6 +847,8 @@ QString Instrument::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( ", filter_active: %1" ).arg( __filter_active ) )
 			.append( QString( ", filter_cutoff: %1" ).arg( __filter_cutoff ) )
 			.append( QString( ", filter_resonance: %1" ).arg( __filter_resonance ) )
+			.append( QString( ", m_filterMode: %1" )
+					 .arg( ResonantFilter::ModeToQString( m_filterMode ) ) )
 			.append( QString( ", random_pitch_factor: %1" ).arg( __random_pitch_factor ) )
 			.append( QString( ", pitch_offset: %1" ).arg( __pitch_offset ) )
 			.append( QString( ", midi_out_note: %1" ).arg( __midi_out_note ) )
@@ -771,13 +856,20 @@ QString Instrument::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( ", stop_notes: %1" ).arg( __stop_notes ) )
 			.append( QString( ", sample_selection_alg: %1" )
 					 .arg( SampleSelectionAlgoToQString( __sample_selection_alg ) ) )
+			.append( QString( ", m_bCustomInterpolateMode: %1" )
+					 .arg( m_bCustomInterpolateMode ) )
+			.append( QString( ", m_interpolateMode: %1" )
+					 .arg( Interpolation::ModeToQString( m_interpolateMode ) ) )
 			.append( QString( ", active: %1" ).arg( __active ) )
 			.append( QString( ", soloed: %1" ).arg( __soloed ) )
 			.append( QString( ", muted: %1" ).arg( __muted ) )
 			.append( QString( ", mute_group: %1" ).arg( __mute_group ) )
-			.append( QString( ", queued: %1" ).arg( __queued ) )
-			.append( QString( ", m_enqueuedBy: [%1]" )
-					 .arg( m_enqueuedBy.join( " ; " ) ) );
+			.append( QString( ", m_nChokeGroup: %1" ).arg( m_nChokeGroup ) )
+			.append( QString( ", m_nMaxVoices: %1" ).arg( m_nMaxVoices ) )
+			.append( QString( ", m_voiceStealing: %1" )
+					 .arg( VoiceStealingToQString( m_voiceStealing ) ) )
+			.append( QString( ", m_nVoices: %1" ).arg( m_nVoices ) )
+			.append( QString( ", queued: %1" ).arg( __queued.load() ) );
 		sOutput.append( QString( ", fx_level: [ " ) );
 		for ( const auto& ff : __fx_level ) {
 			sOutput.append( QString( "%1 " ).arg( ff ) );
@@ -817,6 +909,40 @@ QString Instrument::SampleSelectionAlgoToQString( const SampleSelectionAlgo& sam
 	}
 }
 
+QString Instrument::VoiceStealingToQString( const VoiceStealing& voiceStealing ) {
+	switch( voiceStealing ) {
+	case VoiceStealing::Oldest:
+		return "Oldest";
+	case VoiceStealing::Quietest:
+		return "Quietest";
+	case VoiceStealing::LowestVelocity:
+		return "LowestVelocity";
+	default:
+		return QString( "Unknown voiceStealing [%1]" )
+			.arg( static_cast<int>(voiceStealing) );
+	}
+}
+
+Instrument::VoiceStealing Instrument::VoiceStealingFromQString( const QString& sVoiceStealing,
+																bool* pOk ) {
+	if ( pOk != nullptr ) {
+		*pOk = true;
+	}
+	for ( const auto& voiceStealing : { VoiceStealing::Oldest,
+										VoiceStealing::Quietest,
+										VoiceStealing::LowestVelocity } ) {
+		if ( sVoiceStealing.compare( VoiceStealingToQString( voiceStealing ),
+									 Qt::CaseInsensitive ) == 0 ) {
+			return voiceStealing;
+		}
+	}
+
+	if ( pOk != nullptr ) {
+		*pOk = false;
+	}
+	return VoiceStealing::Oldest;
+}
+
 
 };
 
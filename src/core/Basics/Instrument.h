@@ -23,6 +23,7 @@
 #ifndef H2C_INSTRUMENT_H
 #define H2C_INSTRUMENT_H
 
+#include <atomic>
 #include <cassert>
 #include <memory>
 
@@ -31,6 +32,8 @@
 #include <core/Basics/DrumkitMap.h>
 #include <core/Helpers/Filesystem.h>
 #include <core/License.h>
+#include <core/Sampler/Interpolation.h>
+#include <core/Sampler/ResonantFilter.h>
 
 #define EMPTY_INSTR_ID          -1
 /** Created Instrument will be used as metronome. */
@@ -63,6 +66,23 @@ class Instrument : public H2Core::Object<Instrument>
 		};
 		static QString SampleSelectionAlgoToQString( const SampleSelectionAlgo& algo );
 
+		/** Which voice the #Sampler stops once the polyphony limit of
+		 * the instrument is reached. */
+		enum class VoiceStealing {
+			/** The voice started first. */
+			Oldest = 0,
+			/** The voice with the lowest product of velocity and
+			 * current ADSR value. */
+			Quietest = 1,
+			LowestVelocity = 2
+		};
+		static QString VoiceStealingToQString( const VoiceStealing& voiceStealing );
+		/** Inverse of VoiceStealingToQString(). @a pOk is set to false
+		 * and #VoiceStealing::Oldest is returned in case @a sVoiceStealing
+		 * can not be parsed. */
+		static VoiceStealing VoiceStealingFromQString( const QString& sVoiceStealing,
+													   bool* pOk = nullptr );
+
 		/**
 		 * constructor
 		 * \param id the id of this instrument
@@ -155,6 +175,28 @@ class Instrument : public H2Core::Object<Instrument>
 		/** get the mute group of the instrument */
 		int get_mute_group() const;
 
+		/** Starting a note of this instrument fades out all voices of
+		 * other instruments in the same choke group within a couple of
+		 * milliseconds. In contrast to the mute group the release of
+		 * the silenced instruments is not used. -1 for none. */
+		void setChokeGroup( int nGroup );
+		int getChokeGroup() const;
+
+		/** Maximum number of voices of this instrument played at the
+		 * same time. Once exceeded, the voice selected by
+		 * getVoiceStealing() is faded out. 0 for no limit. */
+		void setMaxVoices( int nMaxVoices );
+		int getMaxVoices() const;
+		void setVoiceStealing( VoiceStealing voiceStealing );
+		VoiceStealing getVoiceStealing() const;
+
+		/** Number of voices of the instrument currently rendered by the
+		 * #Sampler and not yet stolen. Only accessed by the Sampler
+		 * while holding the lock of the #AudioEngine. */
+		int getVoices() const;
+		void addVoice();
+		void removeVoice();
+
 		/** set the midi out channel of the instrument */
 		void set_midi_out_channel( int channel );
 		/** get the midi out channel of the instrument */
@@ -208,6 +250,11 @@ class Instrument : public H2Core::Object<Instrument>
 		/** get the filter cutoff of the instrument */
 		float get_filter_cutoff() const;
 
+		/** set which response of the filter is used */
+		void setFilterMode( ResonantFilter::Mode mode );
+		/** get which response of the filter is used */
+		ResonantFilter::Mode getFilterMode() const;
+
 		/** set the left peak of the instrument */
 		void set_peak_l( float val );
 		/** get the left peak of the instrument */
@@ -248,7 +295,6 @@ class Instrument : public H2Core::Object<Instrument>
 		void dequeue( Note* pNote );
 		/** get the queued status of the instrument */
 		bool is_queued() const;
-		const QStringList& getEnqueuedBy() const;
 
 		/** set the stop notes status of the instrument */
 		void set_stop_notes( bool stopnotes );
@@ -258,6 +304,14 @@ class Instrument : public H2Core::Object<Instrument>
 		void set_sample_selection_alg( SampleSelectionAlgo selected_algo);
 		SampleSelectionAlgo sample_selection_alg() const;
 
+		/** Interpolation used for rendering notes of this instrument
+		 * instead of the default one of the Sampler. */
+		void setInterpolateMode( Interpolation::InterpolateMode mode );
+		/** Use the default interpolation of the Sampler again. */
+		void resetInterpolateMode();
+		bool hasCustomInterpolateMode() const;
+		Interpolation::InterpolateMode getInterpolateMode() const;
+
 		void set_hihat_grp( int hihat_grp );
 		int get_hihat_grp() const;
 
@@ -284,7 +338,7 @@ class Instrument : public H2Core::Object<Instrument>
 		void set_is_metronome_instrument(bool isMetronome);
 		bool is_metronome_instrument() const;
 
-		std::shared_ptr<std::vector<std::shared_ptr<InstrumentComponent>>> get_components() const;
+		const std::shared_ptr<std::vector<std::shared_ptr<InstrumentComponent>>>& get_components() const;
 		/** Select a component via its index in the corresponding vector. */
 		std::shared_ptr<InstrumentComponent> get_component( int nIdx ) const;
 		void addComponent( std::shared_ptr<InstrumentComponent> pComponent );
@@ -356,6 +410,7 @@ class Instrument : public H2Core::Object<Instrument>
 		bool					__filter_active;		///< is filter active?
 		float					__filter_cutoff;		///< filter cutoff (0..1)
 		float					__filter_resonance;		///< filter resonant frequency (0..1)
+		ResonantFilter::Mode	m_filterMode;			///< low-, high-, or band-pass
 	/**
 	 * Factor to scale the random contribution when humanizing pitch
 	 * between 0 and #AudioEngine::fHumanizePitchSD.
@@ -368,14 +423,20 @@ class Instrument : public H2Core::Object<Instrument>
 		int						__midi_out_channel;		///< midi out channel
 		bool					__stop_notes;			///< will the note automatically generate a note off after being on
 		SampleSelectionAlgo		__sample_selection_alg;	///< how Hydrogen will chose the sample to use
+		/** Whether #m_interpolateMode overrides the interpolation mode of
+		 * the Sampler. Allows to spend expensive interpolation only on
+		 * instruments for which it is audible. */
+		bool					m_bCustomInterpolateMode;
+		Interpolation::InterpolateMode m_interpolateMode;
 		bool					__active;				///< is the instrument active?
 		bool					__soloed;				///< is the instrument in solo mode?
 		bool					__muted;				///< is the instrument muted?
 		int						__mute_group;			///< mute group of the instrument
-		int						__queued;				///< count the number of notes queued within Sampler::__playing_notes_queue or std::priority_queue m_songNoteQueue
-		/** List of short string representations of notes for which this
-		 * instrument was enqueued. */
-		QStringList				m_enqueuedBy;
+		int						m_nChokeGroup;
+		int						m_nMaxVoices;
+		VoiceStealing			m_voiceStealing;
+		int						m_nVoices;
+		std::atomic<int>		__queued;				///< count the number of notes queued within Sampler::__playing_notes_queue or std::priority_queue m_songNoteQueue
 		float					__fx_level[MAX_FX];		///< Ladspa FX level array
 		int						__hihat_grp;			///< the instrument is part of a hihat
 		int						__lower_cc;				///< lower cc level
@@ -434,6 +495,53 @@ inline int Instrument::get_mute_group() const
 	return __mute_group;
 }
 
+inline void Instrument::setChokeGroup( int nGroup )
+{
+	m_nChokeGroup = ( nGroup < -1 ? -1 : nGroup );
+}
+
+inline int Instrument::getChokeGroup() const
+{
+	return m_nChokeGroup;
+}
+
+inline void Instrument::setMaxVoices( int nMaxVoices )
+{
+	m_nMaxVoices = ( nMaxVoices < 0 ? 0 : nMaxVoices );
+}
+
+inline int Instrument::getMaxVoices() const
+{
+	return m_nMaxVoices;
+}
+
+inline void Instrument::setVoiceStealing( VoiceStealing voiceStealing )
+{
+	m_voiceStealing = voiceStealing;
+}
+
+inline Instrument::VoiceStealing Instrument::getVoiceStealing() const
+{
+	return m_voiceStealing;
+}
+
+inline int Instrument::getVoices() const
+{
+	return m_nVoices;
+}
+
+inline void Instrument::addVoice()
+{
+	++m_nVoices;
+}
+
+inline void Instrument::removeVoice()
+{
+	if ( m_nVoices > 0 ) {
+		--m_nVoices;
+	}
+}
+
 inline int Instrument::get_midi_out_channel() const
 {
 	return __midi_out_channel;
@@ -542,6 +650,16 @@ inline float Instrument::get_filter_cutoff() const
 	return __filter_cutoff;
 }
 
+inline void Instrument::setFilterMode( ResonantFilter::Mode mode )
+{
+	m_filterMode = mode;
+}
+
+inline ResonantFilter::Mode Instrument::getFilterMode() const
+{
+	return m_filterMode;
+}
+
 inline void Instrument::set_peak_l( float val )
 {
 	__peak_l = val;
@@ -609,11 +727,7 @@ inline bool Instrument::is_soloed() const
 
 inline bool Instrument::is_queued() const
 {
-	return ( __queued > 0 );
-}
-
-inline const QStringList& Instrument::getEnqueuedBy() const {
-	return m_enqueuedBy;
+	return ( __queued.load( std::memory_order_acquire ) > 0 );
 }
 
 inline void Instrument::set_stop_notes( bool stopnotes )
@@ -636,6 +750,27 @@ inline Instrument::SampleSelectionAlgo Instrument::sample_selection_alg() const
 	return __sample_selection_alg;
 }
 
+inline void Instrument::setInterpolateMode( Interpolation::InterpolateMode mode )
+{
+	m_interpolateMode = mode;
+	m_bCustomInterpolateMode = true;
+}
+
+inline void Instrument::resetInterpolateMode()
+{
+	m_bCustomInterpolateMode = false;
+}
+
+inline bool Instrument::hasCustomInterpolateMode() const
+{
+	return m_bCustomInterpolateMode;
+}
+
+inline Interpolation::InterpolateMode Instrument::getInterpolateMode() const
+{
+	return m_interpolateMode;
+}
+
 inline void Instrument::set_hihat_grp( int hihat_grp )
 {
 	__hihat_grp = hihat_grp;
@@ -701,7 +836,7 @@ inline void Instrument::set_is_metronome_instrument(bool isMetronome)
 	__is_metronome_instrument = isMetronome;
 }
 
-inline std::shared_ptr<std::vector<std::shared_ptr<InstrumentComponent>>> Instrument::get_components() const
+inline const std::shared_ptr<std::vector<std::shared_ptr<InstrumentComponent>>>& Instrument::get_components() const
 {
 	return __components;
 }
@@ -58,7 +58,7 @@ class InstrumentComponent : public H2Core::Object<InstrumentComponent>
 		const QString&		getName() const;
 
 		std::shared_ptr<InstrumentLayer>	operator[]( int ix ) const;
-		std::shared_ptr<InstrumentLayer>	getLayer( int idx ) const;
+		const std::shared_ptr<InstrumentLayer>&	getLayer( int idx ) const;
 	/**
 	 * Get all initialized layers.
 	 *
@@ -152,7 +152,7 @@ inline std::shared_ptr<InstrumentLayer> InstrumentComponent::operator[]( int idx
 	return m_layers[ idx ];
 }
 
-inline std::shared_ptr<InstrumentLayer> InstrumentComponent::getLayer( int idx ) const
+inline const std::shared_ptr<InstrumentLayer>& InstrumentComponent::getLayer( int idx ) const
 {
 	assert( idx >= 0 && idx < m_nMaxLayers );
 	return m_layers[ idx ];
@@ -28,6 +28,7 @@
 #include <core/Helpers/Xml.h>
 #include <core/License.h>
 #include <core/Hydrogen.h>
+#include <core/AudioEngine/EpochReclaimer.h>
 #include <core/NsmClient.h>
 #include <core/Preferences/Preferences.h>
 
@@ -74,8 +75,15 @@ InstrumentLayer::~InstrumentLayer()
 {
 }
 
-void InstrumentLayer::set_sample( std::shared_ptr<Sample> sample )
+void InstrumentLayer::set_sample( std::shared_ptr<Sample> sample,
+								  EpochReclaimer* pReclaimer )
 {
+	// The audio thread might still access the previous sample using a
+	// plain pointer in the ongoing process cycle.
+	if ( __sample != nullptr && __sample != sample && pReclaimer != nullptr ) {
+		pReclaimer->retire( __sample );
+	}
+
 	__sample = sample;
 }
 
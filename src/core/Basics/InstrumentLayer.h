@@ -32,6 +32,7 @@ namespace H2Core
 
 	class XMLNode;
 	class Sample;
+	class EpochReclaimer;
 
 	/**
 	 * InstrumentLayer is part of an instrument
@@ -92,10 +93,19 @@ namespace H2Core
 		void				setIsSoloed( bool bIsSoloed );
 		bool				getIsSoloed() const;
 
-		/** set the sample of the layer */
-		void set_sample( std::shared_ptr<Sample> sample );
+		/** set the sample of the layer
+		 *
+		 * \param sample New sample.
+		 * \param pReclaimer Reclaimer of the audio engine the previous
+		 *   sample is handed to since it might still be rendered. Passed
+		 *   in by the caller to not access the Hydrogen singleton from
+		 *   worker threads. If `nullptr`, the previous sample is dropped
+		 *   right away, which is only safe for layers not known to the
+		 *   audio engine. */
+		void set_sample( std::shared_ptr<Sample> sample,
+						 EpochReclaimer* pReclaimer );
 		/** get the sample of the layer */
-		std::shared_ptr<Sample> get_sample() const;
+		const std::shared_ptr<Sample>& get_sample() const;
 
 		/**
 		 * Calls the #H2Core::Sample::load()
@@ -212,7 +222,7 @@ inline bool InstrumentLayer::getIsSoloed() const {
 	return m_bIsSoloed;
 }
 
-	inline std::shared_ptr<Sample> InstrumentLayer::get_sample() const
+	inline const std::shared_ptr<Sample>& InstrumentLayer::get_sample() const
 	{
 		return __sample;
 	}
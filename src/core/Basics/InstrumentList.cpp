@@ -31,11 +31,146 @@
 #include <core/IO/MidiCommon.h>
 #include <core/License.h>
 
+#include <map>
 #include <set>
 
+#include <QLocale>
+
 namespace H2Core
 {
 
+namespace {
+
+enum class ValueType {
+	Integer,
+	NonNegativeInteger,
+	Float,
+	/** Float within [0, 1] */
+	UnitFloat,
+	/** Float within [-1, 1] */
+	SymmetricUnitFloat,
+	Bool
+};
+
+/** Types of the instrument, component, and layer properties as defined
+ * in drumkit.xsd. */
+const std::map<QString, ValueType> valueTypes = {
+	{ "id", ValueType::Integer },
+	{ "volume", ValueType::Float },
+	{ "isMuted", ValueType::Bool },
+	{ "isSoloed", ValueType::Bool },
+	{ "pan_L", ValueType::UnitFloat },
+	{ "pan_R", ValueType::UnitFloat },
+	{ "pan", ValueType::SymmetricUnitFloat },
+	{ "pitchOffset", ValueType::Float },
+	{ "randomPitchFactor", ValueType::UnitFloat },
+	{ "gain", ValueType::Float },
+	{ "applyVelocity", ValueType::Bool },
+	{ "filterActive", ValueType::Bool },
+	{ "filterCutoff", ValueType::UnitFloat },
+	{ "filterResonance", ValueType::UnitFloat },
+	{ "Attack", ValueType::NonNegativeInteger },
+	{ "Decay", ValueType::NonNegativeInteger },
+	{ "Sustain", ValueType::UnitFloat },
+	{ "Release", ValueType::NonNegativeInteger },
+	{ "muteGroup", ValueType::Integer },
+	{ "chokeGroup", ValueType::Integer },
+	{ "maxVoices", ValueType::NonNegativeInteger },
+	{ "midiOutChannel", ValueType::Integer },
+	{ "midiOutNote", ValueType::Integer },
+	{ "isStopNote", ValueType::Bool },
+	{ "isHihat", ValueType::Integer },
+	{ "lower_cc", ValueType::Integer },
+	{ "higher_cc", ValueType::Integer },
+	{ "FX1Level", ValueType::Float },
+	{ "FX2Level", ValueType::Float },
+	{ "FX3Level", ValueType::Float },
+	{ "FX4Level", ValueType::Float },
+	{ "min", ValueType::Float },
+	{ "max", ValueType::Float },
+	{ "pitch", ValueType::Float },
+	{ "ismodified", ValueType::Bool },
+	{ "startframe", ValueType::NonNegativeInteger },
+	{ "loopframe", ValueType::NonNegativeInteger },
+	{ "loops", ValueType::NonNegativeInteger },
+	{ "endframe", ValueType::NonNegativeInteger },
+	{ "userubber", ValueType::NonNegativeInteger },
+	{ "rubberdivider", ValueType::Float },
+	{ "rubberCsettings", ValueType::NonNegativeInteger },
+	{ "rubberPitch", ValueType::Float },
+	{ "volume-position", ValueType::NonNegativeInteger },
+	{ "volume-value", ValueType::NonNegativeInteger },
+	{ "pan-position", ValueType::NonNegativeInteger },
+	{ "pan-value", ValueType::NonNegativeInteger } };
+
+/** Child elements drumkit.xsd requires to be present. */
+const std::map<QString, QStringList> requiredElements = {
+	{ "instrument", { "id", "name", "volume", "isMuted", "isSoloed",
+					  "pitchOffset", "randomPitchFactor", "gain",
+					  "applyVelocity", "filterActive", "filterCutoff",
+					  "filterResonance", "Attack", "Decay", "Sustain",
+					  "Release", "muteGroup", "sampleSelectionAlgo",
+					  "isHihat", "lower_cc", "higher_cc" } },
+	{ "instrumentComponent", { "name", "gain", "isMuted", "isSoloed" } },
+	{ "layer", { "filename", "min", "max", "gain", "pitch", "isMuted",
+				 "isSoloed" } } };
+
+bool isValidValue( const QString& sValue, ValueType type ) {
+	const QLocale cLocale = QLocale::c();
+	bool bOk = false;
+	switch ( type ) {
+	case ValueType::Integer:
+		cLocale.toInt( sValue, &bOk );
+		return bOk;
+	case ValueType::NonNegativeInteger:
+		return cLocale.toInt( sValue, &bOk ) >= 0 && bOk;
+	case ValueType::Float:
+		cLocale.toFloat( sValue, &bOk );
+		return bOk;
+	case ValueType::UnitFloat: {
+		const float fValue = cLocale.toFloat( sValue, &bOk );
+		return bOk && fValue >= 0 && fValue <= 1;
+	}
+	case ValueType::SymmetricUnitFloat: {
+		const float fValue = cLocale.toFloat( sValue, &bOk );
+		return bOk && fValue >= -1 && fValue <= 1;
+	}
+	case ValueType::Bool:
+		return sValue == "true" || sValue == "false";
+	}
+	return false;
+}
+
+/** Checks the values and the presence of required elements within
+ * @a element and all its children. */
+bool compliesWithFormat( const QDomElement& element ) {
+	const auto requiredIt = requiredElements.find( element.tagName() );
+	if ( requiredIt != requiredElements.end() ) {
+		for ( const auto& sRequired : requiredIt->second ) {
+			if ( element.firstChildElement( sRequired ).isNull() ) {
+				return false;
+			}
+		}
+	}
+
+	QDomElement child = element.firstChildElement();
+	if ( child.isNull() ) {
+		const auto typeIt = valueTypes.find( element.tagName() );
+		return typeIt == valueTypes.end() ||
+			isValidValue( element.text(), typeIt->second );
+	}
+	while ( ! child.isNull() ) {
+		if ( ! compliesWithFormat( child ) ) {
+			return false;
+		}
+		child = child.nextSiblingElement();
+	}
+
+	return true;
+}
+
+}//anonymous namespace
+
 InstrumentList::InstrumentList()
 {
 }
@@ -116,6 +251,85 @@ std::shared_ptr<InstrumentList> InstrumentList::load_from(
 	return pInstrumentList;
 }
 
+std::shared_ptr<InstrumentList> InstrumentList::loadFrom(
+	QXmlStreamReader& reader,
+	const QString& sDrumkitPath,
+	const QString& sDrumkitName,
+	const License& license,
+	bool* pbCurrentFormat,
+	bool bSilent )
+{
+	// Child elements permitted by drumkit.xsd.
+	static const std::map<QString, QStringList> format = {
+		{ "instrument", { "id", "name", "type", "drumkitPath", "drumkit",
+						  "volume", "isMuted", "isSoloed", "pan_L", "pan_R",
+						  "pan", "pitchOffset", "randomPitchFactor", "gain",
+						  "applyVelocity", "filterActive", "filterCutoff",
+						  "filterResonance", "filterMode", "Attack", "Decay",
+						  "Sustain", "Release", "muteGroup", "chokeGroup",
+						  "maxVoices", "voiceStealing", "midiOutChannel",
+						  "midiOutNote", "isStopNote", "sampleSelectionAlgo",
+						  "interpolateMode", "isHihat", "lower_cc", "higher_cc",
+						  "FX1Level", "FX2Level", "FX3Level", "FX4Level",
+						  "instrumentComponent" } },
+		{ "instrumentComponent", { "name", "gain", "isMuted", "isSoloed",
+								   "layer" } },
+		{ "layer", { "filename", "min", "max", "gain", "pitch", "isMuted",
+					 "isSoloed", "ismodified", "smode", "startframe",
+					 "loopframe", "loops", "endframe", "userubber",
+					 "rubberdivider", "rubberCsettings", "rubberPitch",
+					 "volume", "pan" } },
+		{ "volume", { "volume-position", "volume-value" } },
+		{ "pan", { "pan-position", "pan-value" } } };
+
+	auto pInstrumentList = std::make_shared<InstrumentList>();
+	int nCount = 0;
+	while ( reader.readNextStartElement() ) {
+		if ( reader.name() != QLatin1String( "instrument" ) ) {
+			*pbCurrentFormat = false;
+			return nullptr;
+		}
+
+		nCount++;
+		if ( nCount > MAX_INSTRUMENTS ) {
+			ERRORLOG( QString( "instrument nCount >= %1 (MAX_INSTRUMENTS), stop reading instruments" )
+					  .arg( MAX_INSTRUMENTS ) );
+			reader.skipCurrentElement();
+			while ( reader.readNextStartElement() ) {
+				reader.skipCurrentElement();
+			}
+			break;
+		}
+
+		XMLDoc doc;
+		const XMLNode instrumentNode = doc.readElement( reader, doc, &format );
+		if ( instrumentNode.isNull() ||
+			 ! compliesWithFormat( instrumentNode.toElement() ) ) {
+			*pbCurrentFormat = false;
+			return nullptr;
+		}
+
+		auto pInstrument = Instrument::load_from(
+			instrumentNode, sDrumkitPath, sDrumkitName, "", license, false,
+			bSilent );
+		if ( pInstrument != nullptr ) {
+			( *pInstrumentList ) << pInstrument;
+		}
+		else {
+			ERRORLOG( QString( "Unable to load instrument [%1]. The drumkit is corrupted. Skipping instrument" )
+					  .arg( nCount ) );
+			nCount--;
+		}
+	}
+
+	if ( nCount == 0 ) {
+		ERRORLOG( "Newly created instrument list does not contain any instruments. Aborting." );
+		return nullptr;
+	}
+
+	return pInstrumentList;
+}
+
 void InstrumentList::save_to( XMLNode& node, bool bSongKit ) const
 {
 	XMLNode instruments_node = node.createNode( "instrumentList" );
@@ -25,6 +25,7 @@
 
 #include <vector>
 #include <memory>
+#include <QXmlStreamReader>
 #include <core/License.h>
 #include <core/Object.h>
 
@@ -210,6 +211,30 @@ class InstrumentList : public H2Core::Object<InstrumentList>
 													  const License& license = License(),
 													  bool bSongKit = false,
 													  bool bSilent = false );
+	/**
+	 * Loads the instrument list of a drumkit.xml file from a stream of
+	 * XML tokens.
+	 *
+	 * Only a single instrument at a time is copied into a DOM to be
+	 * handled by Instrument::load_from() and it is checked to comply
+	 * with the current format while doing so.
+	 *
+	 * \param reader positioned at the start element of
+	 *   `<instrumentList>`. It will be placed at the corresponding end
+	 *   element afterwards.
+	 * \param pbCurrentFormat set to `false` in case an element not part
+	 *   of the current format was encountered. The list is incomplete
+	 *   in that case and the reader is left at this element.
+	 *
+	 * \return a new InstrumentList instance or `nullptr` in case it
+	 *   does not contain any instruments.
+	 */
+	static std::shared_ptr<InstrumentList> loadFrom( QXmlStreamReader& reader,
+													 const QString& sDrumkitPath,
+													 const QString& sDrumkitName,
+													 const License& license,
+													 bool* pbCurrentFormat,
+													 bool bSilent = false );
 	/**
 	 * Returns vector of lists containing instrument name, component
 	 * name, file name, the license of all associated samples.
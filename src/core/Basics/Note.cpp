@@ -59,10 +59,6 @@ Note::Note( std::shared_ptr<Instrument> pInstrument, int nPosition, float fVeloc
 	  __cut_off( 1.0 ),
 	  __resonance( 0.0 ),
 	  __humanize_delay( 0 ),
-	  __bpfb_l( 0.0 ),
-	  __bpfb_r( 0.0 ),
-	  __lpfb_l( 0.0 ),
-	  __lpfb_r( 0.0 ),
 	  __pattern_idx( 0 ),
 	  __midi_msg( -1 ),
 	  __note_off( false ),
@@ -71,6 +67,7 @@ Note::Note( std::shared_ptr<Instrument> pInstrument, int nPosition, float fVeloc
 	  m_nNoteStart( 0 ),
 	  m_fUsedTickSize( std::nan("") ),
 	  m_nSpecificCompoIdx( -1 ),
+	  m_bStolen( false ),
 	  __instrument( pInstrument )
 {
 	if ( pInstrument != nullptr ) {
@@ -115,10 +112,7 @@ Note::Note( Note* other, std::shared_ptr<Instrument> pInstrument )
 	  __cut_off( other->get_cut_off() ),
 	  __resonance( other->get_resonance() ),
 	  __humanize_delay( other->get_humanize_delay() ),
-	  __bpfb_l( other->get_bpfb_l() ),
-	  __bpfb_r( other->get_bpfb_r() ),
-	  __lpfb_l( other->get_lpfb_l() ),
-	  __lpfb_r( other->get_lpfb_r() ),
+	  __filter_state( other->get_filter_state() ),
 	  __pattern_idx( other->get_pattern_idx() ),
 	  __midi_msg( other->get_midi_msg() ),
 	  __note_off( other->get_note_off() ),
@@ -127,6 +121,7 @@ Note::Note( Note* other, std::shared_ptr<Instrument> pInstrument )
 	  m_nNoteStart( other->getNoteStart() ),
 	  m_fUsedTickSize( other->getUsedTickSize() ),
 	  m_nSpecificCompoIdx( other->m_nSpecificCompoIdx ),
+	  m_bStolen( false ),
 	  __instrument( other->get_instrument() )
 {
 	if ( pInstrument != nullptr ) {
@@ -311,16 +306,22 @@ void Note::computeNoteStart() {
 	}
 }
 
-std::shared_ptr<Sample> Note::getSample( int nComponentIdx, int nSelectedLayer ) const {
+Sample* Note::getSample( int nComponentIdx, int nSelectedLayer ) const {
 
-	std::shared_ptr<Sample> pSample;
+	Sample* pSample = nullptr;
 	
 	if ( __instrument == nullptr ) {
 		ERRORLOG( "Sample does not hold an instrument" );
 		return nullptr;
 	}
 
-	auto pInstrCompo = __instrument->get_component( nComponentIdx );
+	// Accessed via plain pointers to avoid reference counting within the
+	// audio thread.
+	const auto& pComponents = __instrument->get_components();
+	InstrumentComponent* pInstrCompo = nullptr;
+	if ( nComponentIdx >= 0 && nComponentIdx < pComponents->size() ) {
+		pInstrCompo = pComponents->at( nComponentIdx ).get();
+	}
 	if ( pInstrCompo == nullptr ) {
 		ERRORLOG( QString( "Unable to retrieve component [%1] of instrument [%2]" )
 				  .arg( nComponentIdx ).arg( __instrument->get_name() ) );
@@ -351,7 +352,7 @@ std::shared_ptr<Sample> Note::getSample( int nComponentIdx, int nSelectedLayer )
 						.arg( nSelectedLayer ) );
 		}
 		
-		auto pLayer = pInstrCompo->getLayer( nLayer );
+		const auto& pLayer = pInstrCompo->getLayer( nLayer );
 		if ( pLayer == nullptr ) {
 			ERRORLOG( QString( "Unable to retrieve layer [%1] selected for component [%2] of instrument [%3]" )
 					  .arg( nLayer ).arg( pInstrCompo->getName() )
@@ -359,7 +360,7 @@ std::shared_ptr<Sample> Note::getSample( int nComponentIdx, int nSelectedLayer )
 			return nullptr;
 		}
 		
-		pSample = pLayer->get_sample();
+		pSample = pLayer->get_sample().get();
 			
 	}
 	else {
@@ -367,10 +368,10 @@ std::shared_ptr<Sample> Note::getSample( int nComponentIdx, int nSelectedLayer )
 		std::vector<int> possibleLayersVector;
 		int nLayersEncountered = 0;
 		float fRoundRobinID;
-		auto pSong = Hydrogen::get_instance()->getSong();
+		Song* pSong = Hydrogen::get_instance()->getSong().get();
 		
 		for ( unsigned nLayer = 0; nLayer < InstrumentComponent::getMaxLayers(); ++nLayer ) {
-			auto pLayer = pInstrCompo->getLayer( nLayer );
+			const auto& pLayer = pInstrCompo->getLayer( nLayer );
 			if ( pLayer == nullptr ) {
 				continue;
 			}
@@ -405,7 +406,7 @@ std::shared_ptr<Sample> Note::getSample( int nComponentIdx, int nSelectedLayer )
 			float shortestDistance = 1.0f;
 			int nearestLayer = -1;
 			for ( unsigned nLayer = 0; nLayer < InstrumentComponent::getMaxLayers(); ++nLayer ){
-				auto pLayer = pInstrCompo->getLayer( nLayer );
+				const auto& pLayer = pInstrCompo->getLayer( nLayer );
 				if ( pLayer == nullptr ){
 					continue;
 				}
@@ -444,8 +445,8 @@ std::shared_ptr<Sample> Note::getSample( int nComponentIdx, int nSelectedLayer )
 				break;
 				
 			case Instrument::RANDOM:
-				nLayerPicked = possibleLayersVector[ rand() %
-													 possibleLayersVector.size() ];
+				nLayerPicked = possibleLayersVector[
+					Random::getInt( possibleLayersVector.size() ) ];
 				break;
 
 			case Instrument::ROUND_ROBIN: {
@@ -468,8 +469,8 @@ std::shared_ptr<Sample> Note::getSample( int nComponentIdx, int nSelectedLayer )
 			} 
 
 			pSelectedLayer->nSelectedLayer = nLayerPicked;
-			auto pLayer = pInstrCompo->getLayer( nLayerPicked );
-			pSample = pLayer->get_sample();
+			const auto& pLayer = pInstrCompo->getLayer( nLayerPicked );
+			pSample = pLayer->get_sample().get();
 
 		} else {
 			ERRORLOG( "No samples found during random layer selection. This is a bug and shoul dn't happen!" );
@@ -493,7 +494,7 @@ void Note::humanize() {
 	// Due to the nature of the Gaussian distribution, the factors
 	// will also scale the standard deviations of the generated random
 	// variables.
-	const auto pSong = Hydrogen::get_instance()->getSong();
+	const auto& pSong = Hydrogen::get_instance()->getSong();
 	if ( pSong != nullptr ) {
 		const float fRandomVelocityFactor = pSong->getHumanizeVelocityValue();
 		if ( fRandomVelocityFactor != 0 ) {
@@ -593,6 +594,100 @@ Note* Note::load_from( const XMLNode& node, bool bSilent )
 	return note;
 }
 
+Note* Note::loadFrom( QXmlStreamReader& reader, bool bSilent )
+{
+	const QLocale cLocale = QLocale::c();
+
+	int nPosition = 0;
+	float fVelocity = 0.8f;
+	float fPan = 0.f;
+	float fPanL = 1.f;
+	float fPanR = 1.f;
+	bool bPanFound = false;
+	bool bPanLFound = false;
+	bool bPanRFound = false;
+	int nLength = -1;
+	float fPitch = 0.0f;
+	float fLeadLag = 0;
+	QString sKey( "C0" );
+	bool bNoteOff = false;
+	int nInstrumentId = EMPTY_INSTR_ID;
+	QString sType;
+	float fProbability = 1.0f;
+
+	while ( reader.readNextStartElement() ) {
+		const QStringRef sElement = reader.name();
+		const QString sText =
+			reader.readElementText( QXmlStreamReader::SkipChildElements );
+		if ( sText.isEmpty() ) {
+			continue;
+		}
+
+		if ( sElement == QLatin1String( "position" ) ) {
+			nPosition = cLocale.toInt( sText );
+		}
+		else if ( sElement == QLatin1String( "leadlag" ) ) {
+			fLeadLag = cLocale.toFloat( sText );
+		}
+		else if ( sElement == QLatin1String( "velocity" ) ) {
+			fVelocity = cLocale.toFloat( sText );
+		}
+		else if ( sElement == QLatin1String( "pan" ) ) {
+			fPan = cLocale.toFloat( sText );
+			bPanFound = true;
+		}
+		else if ( sElement == QLatin1String( "pan_L" ) ) {
+			fPanL = cLocale.toFloat( sText );
+			bPanLFound = true;
+		}
+		else if ( sElement == QLatin1String( "pan_R" ) ) {
+			fPanR = cLocale.toFloat( sText );
+			bPanRFound = true;
+		}
+		else if ( sElement == QLatin1String( "pitch" ) ) {
+			fPitch = cLocale.toFloat( sText );
+		}
+		else if ( sElement == QLatin1String( "key" ) ) {
+			sKey = sText;
+		}
+		else if ( sElement == QLatin1String( "length" ) ) {
+			nLength = cLocale.toInt( sText );
+		}
+		else if ( sElement == QLatin1String( "instrument" ) ) {
+			nInstrumentId = cLocale.toInt( sText );
+		}
+		else if ( sElement == QLatin1String( "type" ) ) {
+			sType = sText;
+		}
+		else if ( sElement == QLatin1String( "note_off" ) ) {
+			bNoteOff = sText == "true";
+		}
+		else if ( sElement == QLatin1String( "probability" ) ) {
+			fProbability = cLocale.toFloat( sText );
+		}
+	}
+
+	if ( ! bPanFound ) {
+		// check if pan is expressed in the old fashion (version <=
+		// 1.1 ) with the pair (pan_L, pan_R)
+		if ( bPanLFound && bPanRFound ) {
+			fPan = Sampler::getRatioPan( fPanL, fPanR );  // convert to single pan parameter
+		} else if ( ! bSilent ) {
+			WARNINGLOG( QString( "Neither `pan` nor `pan_L` and `pan_R` were found. Falling back to `pan = 0`" ) );
+		}
+	}
+
+	Note* pNote = new Note( nullptr, nPosition, fVelocity, fPan, nLength, fPitch );
+	pNote->set_lead_lag( fLeadLag );
+	pNote->set_key_octave( sKey );
+	pNote->set_note_off( bNoteOff );
+	pNote->set_instrument_id( nInstrumentId );
+	pNote->setType( sType );
+	pNote->set_probability( fProbability );
+
+	return pNote;
+}
+
 QString Note::prettyName() const {
 	QString sInstrument, sPattern;
 
@@ -657,13 +752,13 @@ QString Note::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( "%1%2humanize_delay: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( __humanize_delay ) )
 			.append( QString( "%1%2bpfb_l: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( __bpfb_l ) )
+					 .arg( __filter_state.bp[ 0 ] ) )
 			.append( QString( "%1%2bpfb_r: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( __bpfb_r ) )
+					 .arg( __filter_state.bp[ 1 ] ) )
 			.append( QString( "%1%2lpfb_l: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( __lpfb_l ) )
+					 .arg( __filter_state.lp[ 0 ] ) )
 			.append( QString( "%1%2lpfb_r: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( __lpfb_r ) )
+					 .arg( __filter_state.lp[ 1 ] ) )
 			.append( QString( "%1%2pattern_idx: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( __pattern_idx ) )
 			.append( QString( "%1%2midi_msg: %3\n" ).arg( sPrefix ).arg( s )
@@ -685,6 +780,8 @@ QString Note::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( m_fUsedTickSize ) )
 			.append( QString( "%1%2m_nSpecificCompoIdx: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_nSpecificCompoIdx ) )
+			.append( QString( "%1%2m_bStolen: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_bStolen ) )
 			.append( QString( "%1%2layers_selected:\n" ).arg( sPrefix ).arg( s ) );
 		for ( const auto& ppLayer : __layers_selected ) {
 			if ( ppLayer != nullptr ) {
@@ -727,10 +824,10 @@ QString Note::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( ", cut_off: %1" ).arg( __cut_off ) )
 			.append( QString( ", resonance: %1" ).arg( __resonance ) )
 			.append( QString( ", humanize_delay: %1" ).arg( __humanize_delay ) )
-			.append( QString( ", bpfb_l: %1" ).arg( __bpfb_l ) )
-			.append( QString( ", bpfb_r: %1" ).arg( __bpfb_r ) )
-			.append( QString( ", lpfb_l: %1" ).arg( __lpfb_l ) )
-			.append( QString( ", lpfb_r: %1" ).arg( __lpfb_r ) )
+			.append( QString( ", bpfb_l: %1" ).arg( __filter_state.bp[ 0 ] ) )
+			.append( QString( ", bpfb_r: %1" ).arg( __filter_state.bp[ 1 ] ) )
+			.append( QString( ", lpfb_l: %1" ).arg( __filter_state.lp[ 0 ] ) )
+			.append( QString( ", lpfb_r: %1" ).arg( __filter_state.lp[ 1 ] ) )
 			.append( QString( ", pattern_idx: %1" ).arg( __pattern_idx ) )
 			.append( QString( ", midi_msg: %1" ).arg( __midi_msg ) )
 			.append( QString( ", note_off: %1" ).arg( __note_off ) )
@@ -745,6 +842,7 @@ QString Note::toQString( const QString& sPrefix, bool bShort ) const {
 			.append( QString( ", m_fUsedTickSize: %1" ).arg( m_fUsedTickSize ) )
 			.append( QString( ", m_nSpecificCompoIdx: %1" )
 					 .arg( m_nSpecificCompoIdx ) )
+			.append( QString( ", m_bStolen: %1" ).arg( m_bStolen ) )
 			.append( QString( ", layers_selected: " ) );
 		for ( const auto& ppLayer : __layers_selected ) {
 			if ( ppLayer != nullptr ) {
@@ -25,12 +25,15 @@
 
 #include <memory>
 
+#include <QXmlStreamReader>
+
 #include <core/Object.h>
 #include <core/Basics/DrumkitMap.h>
 #include <core/Basics/Instrument.h>
 #include <core/Basics/Sample.h>
 
 #include <core/IO/MidiCommon.h>
+#include <core/Sampler/ResonantFilter.h>
 
 #define KEY_MIN                 0
 #define KEY_MAX                 11
@@ -145,6 +148,15 @@ class Note : public H2Core::Object<Note>
 		 * \return a new Note instance
 		 */
 	static Note* load_from( const XMLNode& node, bool bSilent = false );
+		/**
+		 * load a note from a stream of XML tokens
+		 * \param reader positioned at the start element of the `<note>`. It
+		 * will be placed at the corresponding end element afterwards.
+		 * \param bSilent Whether infos, warnings, and errors should
+		 * be logged.
+		 * \return a new Note instance
+		 */
+	static Note* loadFrom( QXmlStreamReader& reader, bool bSilent = false );
 
 		/**
 		 * Find the instrument corresponding to `m_sType` and assign it as
@@ -154,7 +166,7 @@ class Note : public H2Core::Object<Note>
 		 */
 		void mapTo( std::shared_ptr<Drumkit> pDrumkit );
 		/** #__instrument accessor */
-		std::shared_ptr<Instrument> get_instrument() const;
+		const std::shared_ptr<Instrument>& get_instrument() const;
 		/** return true if #__instrument is set */
 		bool has_instrument() const;
 		/**
@@ -170,6 +182,8 @@ class Note : public H2Core::Object<Note>
 
 		void setSpecificCompoIdx( int value );
 		int getSpecificCompoIdx() const;
+		void setStolen( bool bStolen );
+		bool isStolen() const;
 		/**
 		 * #__position setter
 		 * \param value the new value
@@ -243,7 +257,10 @@ class Note : public H2Core::Object<Note>
 		/** #__just_recorded accessor */
 		bool get_just_recorded() const;
 
-	std::shared_ptr<SelectedLayerInfo> get_layer_selected( int nIdx ) const;
+	/** Plain pointer to the layer selection for component @a nIdx or
+	 * `nullptr` if out of bound. It is valid as long as the note
+	 * exists. */
+	SelectedLayerInfo* get_layer_selected( int nIdx ) const;
 
 		void set_probability( float value );
 		float get_probability() const;
@@ -259,14 +276,29 @@ class Note : public H2Core::Object<Note>
 		float get_cut_off() const;
 		/** #__resonance accessor */
 		float get_resonance() const;
-		/** #__bpfb_l accessor */
-		float get_bpfb_l() const;
-		/** #__bpfb_r accessor */
-		float get_bpfb_r() const;
-		/** #__lpfb_l accessor */
-		float get_lpfb_l() const;
-		/** #__lpfb_r accessor */
-		float get_lpfb_r() const;
+		/** #__filter_state accessor */
+		const ResonantFilter::State& get_filter_state() const;
+		/** #__filter_state accessor */
+		ResonantFilter::State& get_filter_state();
+
+		/** Channel gains resulting from the pan of the note and its
+		 * instrument. Filled by the Sampler and only recomputed in
+		 * case one of the pans or the pan law changed. */
+		struct PanGains {
+			float fInstrumentPan = 0;
+			float fNotePan = 0;
+			/** PanLawTable::getVersion() used to compute the gains. -1
+			 * if they were not computed yet. */
+			int nPanLawVersion = -1;
+			/** Gains of the combined pan of note and instrument. */
+			float fPan_L = 0;
+			float fPan_R = 0;
+			/** Gains of the pan of the note alone. */
+			float fNotePan_L = 0;
+			float fNotePan_R = 0;
+		};
+		/** #m_panGains accessor */
+		PanGains& getPanGains();
 		/** Filter output is sustaining note */
 		bool filter_sustain() const;
 		/** #__key accessor */
@@ -314,7 +346,7 @@ class Note : public H2Core::Object<Note>
 		void set_midi_info( Key key, Octave octave, int msg );
 
 		/** get the ADSR of the note */
-		std::shared_ptr<ADSR> get_adsr() const;
+		const std::shared_ptr<ADSR>& get_adsr() const;
 
 		/** return true if instrument, key and octave matches with internal
 		 * \param instrument the instrument to match with #__instrument
@@ -327,13 +359,6 @@ class Note : public H2Core::Object<Note>
 		bool match( const Note *pNote ) const;
 		bool match( const std::shared_ptr<Note> pNote ) const;
 
-		/**
-		 * compute left and right output based on filters
-		 * \param val_l the left channel value
-		 * \param val_r the right channel value
-		 */
-		void compute_lr_values( float* val_l, float* val_r );
-
 	long long getNoteStart() const;
 	float getUsedTickSize() const;
 
@@ -419,8 +444,12 @@ class Note : public H2Core::Object<Note>
 	 * The function stores the selected layer in #__layers_selected
 	 * and will reuse this parameter in every following call while
 	 * disregarding the provided @a nSelectedLayer.
+	 *
+	 * The returned plain pointer is only valid within the current
+	 * process cycle of the audio engine. Replaced samples are released
+	 * via the #EpochReclaimer once all cycles using them are done.
 	 */
-	std::shared_ptr<Sample> getSample( int nComponentIdx, int nSelectedLayer = -1 ) const;
+	Sample* getSample( int nComponentIdx, int nSelectedLayer = -1 ) const;
 
 	private:
 		int				__instrument_id;        ///< the id of the instrument played by this note
@@ -457,10 +486,8 @@ class Note : public H2Core::Object<Note>
 		 * It is incorporated in the #m_nNoteStart.
 		 */
 		int				__humanize_delay;
-		float			__bpfb_l;             ///< left band pass filter buffer
-		float			__bpfb_r;             ///< right band pass filter buffer
-		float			__lpfb_l;             ///< left low pass filter buffer
-		float			__lpfb_r;             ///< right low pass filter buffer
+		ResonantFilter::State	__filter_state; ///< state of the resonant filter
+		PanGains		m_panGains;
 		int				__pattern_idx;          ///< index of the pattern holding this note for undo actions
 		int				__midi_msg;             ///< TODO
 		bool			__note_off;            ///< note type on|off
@@ -493,6 +520,11 @@ class Note : public H2Core::Object<Note>
 		/** Play a specific component, -1 if playing all */
 		int				m_nSpecificCompoIdx;
 
+		/** Whether the #Sampler stole this voice (or choked it) and
+		 * it is fading out. Such voices do not count towards the
+		 * polyphony limits anymore. Not written to disk. */
+		bool			m_bStolen;
+
 		/** One #SelectedLayerInfo for each #InstrumentComponent in
 		 * #__instrument. It assumes the same order as
 		 * #Instrument::__components. */
@@ -504,12 +536,12 @@ class Note : public H2Core::Object<Note>
 
 // DEFINITIONS
 
-inline std::shared_ptr<ADSR> Note::get_adsr() const
+inline const std::shared_ptr<ADSR>& Note::get_adsr() const
 {
 	return __adsr;
 }
 
-inline std::shared_ptr<Instrument> Note::get_instrument() const
+inline const std::shared_ptr<Instrument>& Note::get_instrument() const
 {
 	return __instrument;
 }
@@ -546,6 +578,16 @@ inline int Note::getSpecificCompoIdx() const
 	return m_nSpecificCompoIdx;
 }
 
+inline void Note::setStolen( bool bStolen )
+{
+	m_bStolen = bStolen;
+}
+
+inline bool Note::isStolen() const
+{
+	return m_bStolen;
+}
+
 inline void Note::set_position( int value )
 {
 	__position = value;
@@ -636,12 +678,12 @@ inline void Note::set_probability( float value )
 	__probability = value;
 }
 
-inline std::shared_ptr<SelectedLayerInfo> Note::get_layer_selected( int nCompoIdx ) const
+inline SelectedLayerInfo* Note::get_layer_selected( int nCompoIdx ) const
 {
 	if ( nCompoIdx < 0 || nCompoIdx >= __layers_selected.size() ) {
 		return nullptr;
 	}
-	return __layers_selected.at( nCompoIdx );
+	return __layers_selected.at( nCompoIdx ).get();
 }
 
 inline int Note::get_humanize_delay() const
@@ -659,31 +701,24 @@ inline float Note::get_resonance() const
 	return __resonance;
 }
 
-inline float Note::get_bpfb_l() const
+inline const ResonantFilter::State& Note::get_filter_state() const
 {
-	return __bpfb_l;
+	return __filter_state;
 }
 
-inline float Note::get_bpfb_r() const
+inline ResonantFilter::State& Note::get_filter_state()
 {
-	return __bpfb_r;
+	return __filter_state;
 }
 
-inline float Note::get_lpfb_l() const
+inline Note::PanGains& Note::getPanGains()
 {
-	return __lpfb_l;
-}
-
-inline float Note::get_lpfb_r() const
-{
-	return __lpfb_r;
+	return m_panGains;
 }
 
 inline bool Note::filter_sustain() const
 {
-	const double fLimit = 0.001;
-	return ( fabs( __lpfb_l ) > fLimit || fabs( __lpfb_r ) > fLimit ||
-			 fabs( __bpfb_l ) > fLimit || fabs( __bpfb_r ) > fLimit );
+	return __filter_state.isRinging();
 }
 
 inline Note::Key Note::get_key() const
@@ -743,25 +778,6 @@ inline bool Note::match( const std::shared_ptr<Note> pNote ) const
 	return match( pNote->__instrument, pNote->__key, pNote->__octave );
 }
 
-inline void Note::compute_lr_values( float* val_l, float* val_r )
-{
-	if ( __instrument == nullptr ) {
-		*val_l = 0.0f;
-		*val_r = 0.0f;
-		return;
-	}
-	else {
-		const float fCutOff = __instrument->get_filter_cutoff();
-		const float fResonance = __instrument->get_filter_resonance();
-		__bpfb_l  =  fResonance * __bpfb_l  + fCutOff * ( *val_l - __lpfb_l );
-		__lpfb_l +=  fCutOff   * __bpfb_l;
-		__bpfb_r  =  fResonance * __bpfb_r  + fCutOff * ( *val_r - __lpfb_r );
-		__lpfb_r +=  fCutOff   * __bpfb_r;
-		*val_l = __lpfb_l;
-		*val_r = __lpfb_r;
-	}
-}
-
 inline long long Note::getNoteStart() const {
 	return m_nNoteStart;
 }
@@ -24,6 +24,9 @@
 
 #include <cassert>
 
+#include <QFile>
+#include <QLocale>
+
 #include <core/AudioEngine/AudioEngine.h>
 #include <core/Basics/Drumkit.h>
 #include <core/Basics/Note.h>
@@ -84,7 +87,7 @@ bool Pattern::loadDoc( const QString& sPatternPath, XMLDoc* pDoc, bool bSilent )
 	bool bReadingSuccessful = true;
 	
 	if ( ! pDoc->read( sPatternPath, Filesystem::pattern_xsd_path() ) ) {
-		if ( ! pDoc->read( sPatternPath, nullptr ) ) {
+		if ( pDoc->documentElement().isNull() ) {
 			ERRORLOG( QString( "Unable to read pattern [%1]" )
 					  .arg( sPatternPath ) );
 			return false;
@@ -119,6 +122,56 @@ Pattern* Pattern::load_file( const QString& sPatternPath )
 {
 	INFOLOG( QString( "Load pattern %1" ).arg( sPatternPath ) );
 
+	// Patterns complying with the current format are streamed directly
+	// without building up a DOM first. This is considerably faster and
+	// lighter on memory for patterns containing lots of notes. The
+	// format is checked while reading and only legacy or broken files
+	// are handed over to the DOM-based code below.
+	QFile file( sPatternPath );
+	if ( Filesystem::file_readable( sPatternPath, true ) &&
+		 file.open( QIODevice::ReadOnly ) ) {
+		QString sDrumkitName;
+		Pattern* pPattern = nullptr;
+		bool bCurrentFormat = true;
+
+		QXmlStreamReader reader( &file );
+		if ( reader.readNextStartElement() &&
+			 reader.name() == QLatin1String( "drumkit_pattern" ) ) {
+			while ( reader.readNextStartElement() ) {
+				if ( reader.name() == QLatin1String( "drumkit_name" ) ) {
+					sDrumkitName = reader.readElementText(
+						QXmlStreamReader::SkipChildElements );
+				}
+				else if ( reader.name() == QLatin1String( "pattern" ) &&
+						  pPattern == nullptr ) {
+					pPattern = loadFrom( reader, false, &bCurrentFormat );
+				}
+				else {
+					// e.g. author and license stored in here by versions
+					// prior to 1.3.0.
+					bCurrentFormat = false;
+					break;
+				}
+			}
+		}
+
+		if ( reader.hasError() || pPattern == nullptr || ! bCurrentFormat ) {
+			if ( reader.hasError() ) {
+				ERRORLOG( QString( "Unable to stream pattern [%1]: %2" )
+						  .arg( sPatternPath ).arg( reader.errorString() ) );
+			}
+			if ( pPattern != nullptr ) {
+				delete pPattern;
+			}
+		}
+		else {
+			pPattern->setDrumkitName( sDrumkitName );
+			pPattern->fixupTypes();
+			return pPattern;
+		}
+	}
+	file.close();
+
 	XMLDoc doc;
 	if ( ! loadDoc( sPatternPath, &doc, false ) ) {
 		// Try former pattern version
@@ -132,6 +185,78 @@ Pattern* Pattern::load_file( const QString& sPatternPath )
 	return load_from( pattern_node, sDrumkitName );
 }
 
+Pattern* Pattern::loadFrom( QXmlStreamReader& reader, bool bSilent,
+							bool* pbCurrentFormat )
+{
+	const QLocale cLocale = QLocale::c();
+
+	Pattern* pPattern = new Pattern( QString(), "", "unknown", -1, 4 );
+	bool bNameFound = false;
+
+	while ( reader.readNextStartElement() ) {
+		const QStringRef sElement = reader.name();
+
+		if ( sElement == QLatin1String( "noteList" ) ) {
+			while ( reader.readNextStartElement() ) {
+				if ( reader.name() == QLatin1String( "note" ) ) {
+					Note* pNote = Note::loadFrom( reader, bSilent );
+					assert( pNote );
+					if ( pNote != nullptr ) {
+						pPattern->insert_note( pNote );
+					}
+				}
+				else {
+					if ( pbCurrentFormat != nullptr ) {
+						*pbCurrentFormat = false;
+					}
+					reader.skipCurrentElement();
+				}
+			}
+			continue;
+		}
+
+		const QString sText =
+			reader.readElementText( QXmlStreamReader::SkipChildElements );
+
+		if ( sElement == QLatin1String( "name" ) ) {
+			pPattern->__name = sText;
+			bNameFound = true;
+		}
+		else if ( sElement == QLatin1String( "info" ) ) {
+			pPattern->__info = sText;
+		}
+		else if ( sElement == QLatin1String( "category" ) ) {
+			pPattern->__category = sText.isEmpty() ? "unknown" : sText;
+		}
+		else if ( sElement == QLatin1String( "size" ) ) {
+			pPattern->__length = cLocale.toInt( sText );
+		}
+		else if ( sElement == QLatin1String( "denominator" ) ) {
+			pPattern->__denominator = cLocale.toInt( sText );
+		}
+		else if ( sElement == QLatin1String( "userVersion" ) ) {
+			pPattern->m_nVersion = cLocale.toInt( sText );
+		}
+		else if ( sElement == QLatin1String( "author" ) ) {
+			pPattern->m_sAuthor = sText;
+		}
+		else if ( sElement == QLatin1String( "license" ) ) {
+			pPattern->setLicense( License( sText ) );
+		}
+		else if ( sElement != QLatin1String( "formatVersion" ) &&
+				  pbCurrentFormat != nullptr ) {
+			// e.g. `pattern_name` used prior to version 0.9.7.
+			*pbCurrentFormat = false;
+		}
+	}
+
+	if ( ! bNameFound && pbCurrentFormat != nullptr ) {
+		*pbCurrentFormat = false;
+	}
+
+	return pPattern;
+}
+
 Pattern* Pattern::load_from( const XMLNode& node, const QString& sDrumkitName,
 							 bool bSilent )
 {
@@ -166,6 +291,13 @@ Pattern* Pattern::load_from( const XMLNode& node, const QString& sDrumkitName,
 		}
 	}
 
+	pPattern->fixupTypes( bSilent );
+
+	return pPattern;
+}
+
+void Pattern::fixupTypes( bool bSilent )
+{
 	// Sanity checks
 	//
 	// In case no instrument type is assigned to any of the notes contained, we
@@ -174,7 +306,7 @@ Pattern* Pattern::load_from( const XMLNode& node, const QString& sDrumkitName,
 	// instrument id -> instrument type mapping in there we can use it as a
 	// fallback to obtain types.
 	bool bMissingType = false;
-	for ( const auto& [ _ , ppNote ] : pPattern->__notes ) {
+	for ( const auto& [ _ , ppNote ] : __notes ) {
 		if ( ppNote != nullptr && ppNote->getType().isEmpty() ) {
 			bMissingType = true;
 			break;
@@ -183,14 +315,14 @@ Pattern* Pattern::load_from( const XMLNode& node, const QString& sDrumkitName,
 
 	if ( bMissingType ) {
 		const QString sMapFile =
-			Filesystem::getDrumkitMap( pPattern->getDrumkitName(), bSilent );
+			Filesystem::getDrumkitMap( m_sDrumkitName, bSilent );
 
 		if ( ! sMapFile.isEmpty() ) {
 			const auto pDrumkitMap = DrumkitMap::load( sMapFile, bSilent );
 			if ( pDrumkitMap != nullptr ) {
 				// We do not replace any type but only set those not defined
 				// yet.
-				for ( const auto& [ _, ppNote ] : pPattern->__notes ) {
+				for ( const auto& [ _, ppNote ] : __notes ) {
 					if ( ppNote != nullptr && ppNote->getType().isEmpty() &&
 						 ! pDrumkitMap->getType(
 							 ppNote->get_instrument_id() ).isEmpty() ) {
@@ -201,17 +333,15 @@ Pattern* Pattern::load_from( const XMLNode& node, const QString& sDrumkitName,
 			}
 			else {
 				ERRORLOG( QString( "Unable to load .h2map file [%1] to replace missing Types in notes for pattern [%2]" )
-						  .arg( sMapFile ).arg( pPattern->get_name() ) );
+						  .arg( sMapFile ).arg( __name ) );
 			}
 		}
 		else if ( ! bSilent ) {
 			INFOLOG( QString( "There are missing Types for notes in pattern [%1] and no corresponding .h2map file for registered drumkit [%2]." )
-					 .arg( pPattern->get_name() )
-					 .arg( pPattern->getDrumkitName() ) );
+					 .arg( __name )
+					 .arg( m_sDrumkitName ) );
 		}
 	}
-
-	return pPattern;
 }
 
 bool Pattern::save_file( const QString& drumkit_name, const QString& pattern_path, bool overwrite ) const
@@ -25,6 +25,7 @@
 
 #include <set>
 #include <memory>
+#include <QXmlStreamReader>
 #include <core/License.h>
 #include <core/Object.h>
 #include <core/Basics/DrumkitMap.h>
@@ -96,6 +97,29 @@ class Pattern : public H2Core::Object<Pattern>
 	static Pattern* load_from( const XMLNode& node,
 							   const QString& sDrumkitName,
 							   bool bSilent = false );
+	/**
+	 * Loads a pattern from a stream of XML tokens.
+	 *
+	 * \param reader positioned at the start element of `<pattern>`. It
+	 *   will be placed at the corresponding end element afterwards.
+	 *
+	 * \param pbCurrentFormat optional flag set to `false` in case an
+	 *   element not part of the current pattern format was encountered
+	 *   or the pattern does not have a name. This way the pattern is
+	 *   validated while being read instead of in a separate pass.
+	 *
+	 * Neither the drumkit name nor missing note types are handled in
+	 * here.
+	 */
+	static Pattern* loadFrom( QXmlStreamReader& reader, bool bSilent = false,
+							  bool* pbCurrentFormat = nullptr );
+	/**
+	 * In case no instrument type is assigned to some of the notes
+	 * contained, the .h2map file shipped with the application
+	 * corresponding to #m_sDrumkitName is used as a fallback to
+	 * obtain them.
+	 */
+	void fixupTypes( bool bSilent = false );
 		/**
 		 * save a pattern into an xml file
 		 * \param drumkit_name the name of the drumkit it is supposed to play with
@@ -34,11 +34,15 @@ namespace H2Core
 {
 
 
-PatternList::PatternList()
+std::atomic<uint64_t> PatternList::m_nLastRevision( 0 );
+
+PatternList::PatternList() : m_nRevision( ++m_nLastRevision )
 {
 }
 
-PatternList::PatternList( PatternList* other ) : Object( *other )
+PatternList::PatternList( PatternList* other )
+	: Object( *other )
+	, m_nRevision( ++m_nLastRevision )
 {
 	assert( __patterns.size() == 0 );
 	for ( int i=0; i<other->size(); i++ ) {
@@ -88,6 +92,24 @@ PatternList* PatternList::load_from( const XMLNode& node,
 	return pPatternList;
 }
 
+PatternList* PatternList::loadFrom( QXmlStreamReader& reader, bool bSilent ) {
+	PatternList* pPatternList = new PatternList();
+
+	while ( reader.readNextStartElement() ) {
+		if ( reader.name() == QLatin1String( "pattern" ) ) {
+			pPatternList->add( Pattern::loadFrom( reader, bSilent ) );
+		}
+		else {
+			reader.skipCurrentElement();
+		}
+	}
+	if ( pPatternList->size() == 0 && ! bSilent ) {
+		WARNINGLOG( "0 patterns?" );
+	}
+
+	return pPatternList;
+}
+
 void PatternList::save_to( XMLNode& node, const std::shared_ptr<Instrument> pInstrumentOnly ) const {
 	XMLNode patternListNode = node.createNode( "patternList" );
 	
@@ -136,12 +158,20 @@ void PatternList::add( Pattern* pPattern, bool bAddVirtuals )
 	}
 	
 	__patterns.push_back( pPattern );
+	m_nRevision = ++m_nLastRevision;
 
 	if ( bAddVirtuals ) {
 		pPattern->addFlattenedVirtualPatterns( this );
 	}
 }
 
+void PatternList::assign( const std::vector<Pattern*>& patterns )
+{
+	ASSERT_AUDIO_ENGINE_LOCKED( toQString() );
+	__patterns.assign( patterns.begin(), patterns.end() );
+	m_nRevision = ++m_nLastRevision;
+}
+
 void PatternList::insert( int nIdx, Pattern* pPattern )
 {
 	ASSERT_AUDIO_ENGINE_LOCKED( toQString() );
@@ -153,6 +183,7 @@ void PatternList::insert( int nIdx, Pattern* pPattern )
 		__patterns.resize( nIdx );
 	}
 	__patterns.insert( __patterns.begin() + nIdx, pPattern );
+	m_nRevision = ++m_nLastRevision;
 }
 
 Pattern* PatternList::get( int idx ) const
@@ -182,6 +213,7 @@ Pattern* PatternList::del( int idx )
 	if ( idx >= 0 && idx < __patterns.size() ) {
 		Pattern* pattern = __patterns[idx];
 		__patterns.erase( __patterns.begin() + idx );
+		m_nRevision = ++m_nLastRevision;
 		return pattern;
 	}
 	return nullptr;
@@ -214,6 +246,7 @@ Pattern* PatternList::replace( int idx, Pattern* pattern )
 
 	__patterns.insert( __patterns.begin() + idx, pattern );
 	__patterns.erase( __patterns.begin() + idx + 1 );
+	m_nRevision = ++m_nLastRevision;
 
 	//create return pattern after patternlist tätatä to return the right one
 	Pattern* ret = __patterns[idx];
@@ -247,6 +280,7 @@ void PatternList::move( int idx_a, int idx_b )
 	Pattern* tmp = __patterns[idx_a];
 	__patterns.erase( __patterns.begin() + idx_a );
 	__patterns.insert( __patterns.begin() + idx_b, tmp );
+	m_nRevision = ++m_nLastRevision;
 }
 
 void PatternList::flattened_virtual_patterns_compute()
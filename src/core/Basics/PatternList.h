@@ -23,8 +23,11 @@
 #ifndef H2C_PATTERN_LIST_H
 #define H2C_PATTERN_LIST_H
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <vector>
+#include <QXmlStreamReader>
 #include <core/Object.h>
 #include <core/AudioEngine/AudioEngine.h>
 #include <core/Basics/DrumkitMap.h>
@@ -69,6 +72,21 @@ class Note;
 	static PatternList* load_from( const XMLNode& pNode,
 								   const QString& sDrumkitName,
 								   bool bSilent = false );
+		/**
+		 * Loads a #PatternList from a stream of XML tokens.
+		 *
+		 * \param reader positioned at the start element of
+		 *   `<patternList>`. It will be placed at the corresponding end
+		 *   element afterwards.
+		 * \param bSilent Whether infos, warnings, and errors should
+		 * be logged.
+		 *
+		 * Similar to Pattern::loadFrom() neither the drumkit name nor
+		 * missing note types of the contained patterns are handled in
+		 * here.
+		 */
+	static PatternList* loadFrom( QXmlStreamReader& reader,
+								  bool bSilent = false );
 	void save_to( XMLNode& pNode,
 				  const std::shared_ptr<Instrument> pInstrumentOnly = nullptr ) const;
 
@@ -92,6 +110,19 @@ class Note;
 		 * @a pattern should be added too.
 		 */
 	void add( Pattern* pattern, bool bAddVirtuals = false );
+		/**
+		 * Replaces the content of the list by @a patterns.
+		 *
+		 * In contrast to add() no lookup or virtual pattern resolution
+		 * is done. The provided patterns are expected to be already
+		 * flattened, e.g. by AudioEngine::updateColumnPatterns(). As
+		 * long as the capacity of the list suffices no memory will be
+		 * allocated.
+		 */
+	void assign( const std::vector<Pattern*>& patterns );
+		/** Ensures the list can hold @a nSize patterns without
+		 * reallocation. */
+		void reserve( int nSize );
 		/**
 		 * insert a pattern into the list
 		 * \param idx the index to insert the pattern at
@@ -200,6 +231,16 @@ class Note;
 		 * \return String presentation of current object.*/
 		QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
 
+		/**
+		 * Changes whenever patterns are added, removed, or moved.
+		 *
+		 * Revisions are unique across all lists. A list allocated at the
+		 * address of a deleted one thus never reports the revision of its
+		 * predecessor. Used by AudioEngine::updatePlayingPatternsPos() in
+		 * order to detect outdated column caches.
+		 */
+		uint64_t getRevision() const;
+
 		/** Iteration */
 		std::vector<Pattern*>::iterator begin();
 		std::vector<Pattern*>::iterator end();
@@ -208,6 +249,8 @@ class Note;
 
 	private:
 		std::vector<Pattern*> __patterns;            ///< the list of patterns
+		uint64_t m_nRevision;
+		static std::atomic<uint64_t> m_nLastRevision;
 
 };
 
@@ -221,6 +264,17 @@ inline int PatternList::size() const
 inline void PatternList::clear()
 {
 	__patterns.clear();
+	m_nRevision = ++m_nLastRevision;
+}
+
+inline uint64_t PatternList::getRevision() const
+{
+	return m_nRevision;
+}
+
+inline void PatternList::reserve( int nSize )
+{
+	__patterns.reserve( nSize );
 }
 
 inline void PatternList::operator<<( Pattern* pattern )
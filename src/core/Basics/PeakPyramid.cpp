@@ -0,0 +1,216 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/Basics/PeakPyramid.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace H2Core
+{
+
+PeakPyramid::PeakPyramid( const float* pData_L, const float* pData_R,
+						  int nFrames )
+	: m_nFrames( std::max( nFrames, 0 ) ) {
+	if ( m_nFrames == 0 || pData_L == nullptr || pData_R == nullptr ) {
+		return;
+	}
+
+	const float* channels[ 2 ] = { pData_L, pData_R };
+	for ( int nChannel = 0; nChannel < 2; ++nChannel ) {
+		const float* pData = channels[ nChannel ];
+		auto& levels = m_levels[ nChannel ];
+
+		// Finest level read from the sample itself.
+		const int nBlocks = ( m_nFrames + nBaseBlockSize - 1 ) / nBaseBlockSize;
+		levels.emplace_back( nBlocks );
+		auto& base = levels.back();
+		for ( int nBlock = 0; nBlock < nBlocks; ++nBlock ) {
+			const int nStart = nBlock * nBaseBlockSize;
+			const int nEnd = std::min( nStart + nBaseBlockSize, m_nFrames );
+			float fMin = pData[ nStart ];
+			float fMax = pData[ nStart ];
+			float fSumSquares = 0;
+			for ( int ii = nStart; ii < nEnd; ++ii ) {
+				fMin = std::min( fMin, pData[ ii ] );
+				fMax = std::max( fMax, pData[ ii ] );
+				fSumSquares += pData[ ii ] * pData[ ii ];
+			}
+			base[ nBlock ] = { fMin, fMax, fSumSquares };
+		}
+
+		// Each coarser level merges pairs of blocks of the previous one.
+		while ( levels.back().size() > 1 ) {
+			const auto& finer = levels.back();
+			const int nFinerBlocks = static_cast<int>( finer.size() );
+			std::vector<Block> coarser( ( nFinerBlocks + 1 ) / 2 );
+			for ( int nBlock = 0; nBlock < static_cast<int>( coarser.size() );
+				  ++nBlock ) {
+				const Block& first = finer[ 2 * nBlock ];
+				if ( 2 * nBlock + 1 < nFinerBlocks ) {
+					const Block& second = finer[ 2 * nBlock + 1 ];
+					coarser[ nBlock ] = { std::min( first.fMin, second.fMin ),
+										  std::max( first.fMax, second.fMax ),
+										  first.fSumSquares + second.fSumSquares };
+				} else {
+					coarser[ nBlock ] = first;
+				}
+			}
+			levels.push_back( std::move( coarser ) );
+		}
+	}
+}
+
+bool PeakPyramid::pixelRange( double fStartFrame, double fFramesPerPixel,
+							  int nPixel, int nFrames, int* pStart, int* pEnd ) {
+	const double fStart = fStartFrame + nPixel * fFramesPerPixel;
+	int nStart = static_cast<int>( std::floor( fStart ) );
+	int nEnd = static_cast<int>( std::floor( fStart + fFramesPerPixel ) );
+	// Zoomed in further than a frame per pixel.
+	nEnd = std::max( nEnd, nStart + 1 );
+
+	nStart = std::max( nStart, 0 );
+	nEnd = std::min( nEnd, nFrames );
+	*pStart = nStart;
+	*pEnd = nEnd;
+
+	return nStart < nEnd;
+}
+
+void PeakPyramid::getPeaks( Channel channel, double fStartFrame,
+							double fFramesPerPixel, int nPixels,
+							Peak* pPeaks ) const {
+	if ( m_levels[ 0 ].empty() || fFramesPerPixel <= 0 ) {
+		std::fill( pPeaks, pPeaks + std::max( nPixels, 0 ), Peak{ 0, 0, 0 } );
+		return;
+	}
+
+	int nFirstChannel, nLastChannel;
+	channelRange( channel, &nFirstChannel, &nLastChannel );
+
+	int nLevel = 0;
+	while ( nLevel + 1 < getLevels() &&
+			( nBaseBlockSize << ( nLevel + 1 ) ) * nBlocksPerPixel <=
+			fFramesPerPixel ) {
+		++nLevel;
+	}
+	const int nBlockSize = nBaseBlockSize << nLevel;
+
+	for ( int nPixel = 0; nPixel < nPixels; ++nPixel ) {
+		int nStart, nEnd;
+		if ( ! pixelRange( fStartFrame, fFramesPerPixel, nPixel, m_nFrames,
+						   &nStart, &nEnd ) ) {
+			pPeaks[ nPixel ] = { 0, 0, 0 };
+			continue;
+		}
+
+		const int nFirstBlock = nStart / nBlockSize;
+		const int nLastBlock = ( nEnd - 1 ) / nBlockSize;
+		float fMin = m_levels[ nFirstChannel ][ nLevel ][ nFirstBlock ].fMin;
+		float fMax = fMin;
+		float fSumSquares = 0;
+		for ( int nChannel = nFirstChannel; nChannel <= nLastChannel; ++nChannel ) {
+			const auto& blocks = m_levels[ nChannel ][ nLevel ];
+			for ( int nBlock = nFirstBlock; nBlock <= nLastBlock; ++nBlock ) {
+				fMin = std::min( fMin, blocks[ nBlock ].fMin );
+				fMax = std::max( fMax, blocks[ nBlock ].fMax );
+				fSumSquares += blocks[ nBlock ].fSumSquares;
+			}
+		}
+		const int nCovered =
+			std::min( ( nLastBlock + 1 ) * nBlockSize, m_nFrames ) -
+			nFirstBlock * nBlockSize;
+
+		pPeaks[ nPixel ] = { fMin, fMax, std::sqrt(
+				fSumSquares / ( nCovered * ( nLastChannel - nFirstChannel + 1 ) ) ) };
+	}
+}
+
+void PeakPyramid::computePeaks( const float* pData_L, const float* pData_R,
+								int nFrames, Channel channel,
+								double fStartFrame, double fFramesPerPixel,
+								int nPixels, Peak* pPeaks ) {
+	int nFirstChannel, nLastChannel;
+	channelRange( channel, &nFirstChannel, &nLastChannel );
+	const float* channels[ 2 ] = { pData_L, pData_R };
+
+	for ( int nPixel = 0; nPixel < nPixels; ++nPixel ) {
+		int nStart, nEnd;
+		if ( pData_L == nullptr || pData_R == nullptr || fFramesPerPixel <= 0 ||
+			 ! pixelRange( fStartFrame, fFramesPerPixel, nPixel, nFrames,
+						   &nStart, &nEnd ) ) {
+			pPeaks[ nPixel ] = { 0, 0, 0 };
+			continue;
+		}
+
+		float fMin = channels[ nFirstChannel ][ nStart ];
+		float fMax = fMin;
+		float fSumSquares = 0;
+		for ( int nChannel = nFirstChannel; nChannel <= nLastChannel; ++nChannel ) {
+			const float* pData = channels[ nChannel ];
+			for ( int ii = nStart; ii < nEnd; ++ii ) {
+				fMin = std::min( fMin, pData[ ii ] );
+				fMax = std::max( fMax, pData[ ii ] );
+				fSumSquares += pData[ ii ] * pData[ ii ];
+			}
+		}
+
+		pPeaks[ nPixel ] = { fMin, fMax, std::sqrt(
+				fSumSquares / ( ( nEnd - nStart ) *
+								( nLastChannel - nFirstChannel + 1 ) ) ) };
+	}
+}
+
+void PeakPyramid::channelRange( Channel channel, int* pFirst, int* pLast ) {
+	switch ( channel ) {
+	case Channel::Left:
+		*pFirst = 0;
+		*pLast = 0;
+		break;
+	case Channel::Right:
+		*pFirst = 1;
+		*pLast = 1;
+		break;
+	default:
+		*pFirst = 0;
+		*pLast = 1;
+	}
+}
+
+QString PeakPyramid::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[PeakPyramid]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_nFrames: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nFrames ) )
+			.append( QString( "%1%2levels: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( getLevels() ) );
+	}
+	else {
+		sOutput = QString( "[PeakPyramid] m_nFrames: %1" ).arg( m_nFrames )
+			.append( QString( ", levels: %1" ).arg( getLevels() ) );
+	}
+
+	return sOutput;
+}
+
+};
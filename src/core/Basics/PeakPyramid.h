@@ -0,0 +1,141 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef H2C_PEAK_PYRAMID_H
+#define H2C_PEAK_PYRAMID_H
+
+#include <vector>
+
+#include <core/Object.h>
+
+namespace H2Core
+{
+
+/**
+ * Multi-resolution summary of the sample data used to draw waveforms.
+ *
+ * For each channel the minimum, maximum, and sum of squares of blocks
+ * of #nBaseBlockSize frames are stored. Every further level combines
+ * two adjacent blocks of the previous one until a single block covers
+ * the whole sample. A waveform spanning N pixels can thus be drawn by
+ * visiting about N blocks of the coarsest level still finer than a
+ * pixel instead of all frames of the sample.
+ *
+ * The pyramid is built once in the constructor and never altered
+ * afterwards. It is therefore safe to share it between copies of a
+ * Sample and to read it from the GUI thread.
+ *
+ * \ingroup docCore
+ */
+class PeakPyramid : public H2Core::Object<PeakPyramid>
+{
+	H2_OBJECT(PeakPyramid)
+public:
+	enum class Channel {
+		Left = 0,
+		Right = 1,
+		/** Both channels combined into a single summary. */
+		Both = 2
+	};
+
+	/** Summary of the frames covered by a single pixel. */
+	struct Peak {
+		float fMin;
+		float fMax;
+		float fRms;
+	};
+
+	PeakPyramid( const float* pData_L, const float* pData_R, int nFrames );
+
+	int getFrames() const;
+	/** Number of decimation levels per channel. */
+	int getLevels() const;
+
+	/**
+	 * Fills @a pPeaks with @a nPixels peaks of @a channel. Pixel @a i
+	 * covers the frames starting at @a fStartFrame + @a i * @a
+	 * fFramesPerPixel. Pixels outside of the sample are set to zero.
+	 *
+	 * The coarsest level with at least #nBlocksPerPixel blocks per
+	 * pixel is used. Since the pixel boundaries are rounded outwards
+	 * to the blocks of this level, a pixel may include up to one
+	 * block of each of its neighbours. Peaks are thus never missed but
+	 * slightly widened. For @a fFramesPerPixel below
+	 * #nBaseBlockSize * #nBlocksPerPixel computePeaks() should be
+	 * used instead.
+	 */
+	void getPeaks( Channel channel, double fStartFrame, double fFramesPerPixel,
+				   int nPixels, Peak* pPeaks ) const;
+
+	/** Same as getPeaks() but reads all frames in @a pData_L and @a
+	 * pData_R. */
+	static void computePeaks( const float* pData_L, const float* pData_R,
+							  int nFrames, Channel channel,
+							  double fStartFrame, double fFramesPerPixel,
+							  int nPixels, Peak* pPeaks );
+
+	/** Number of frames summarized by each block of the finest
+	 * level. */
+	static constexpr int nBaseBlockSize = 32;
+	/** Minimum number of blocks covered by each pixel. Bounds the
+	 * widening due to rounding the pixel boundaries to blocks. */
+	static constexpr int nBlocksPerPixel = 4;
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	struct Block {
+		float fMin;
+		float fMax;
+		float fSumSquares;
+	};
+
+	/** Frame range [@a nStart, @a nEnd) covered by pixel @a nPixel. */
+	static bool pixelRange( double fStartFrame, double fFramesPerPixel,
+							int nPixel, int nFrames, int* pStart, int* pEnd );
+	/** Indices of the first and last channel in #m_levels covered by
+	 * @a channel. */
+	static void channelRange( Channel channel, int* pFirst, int* pLast );
+
+	int m_nFrames;
+	/** Blocks of both channels. Level @a n holds blocks of
+	 * #nBaseBlockSize * 2^n frames. */
+	std::vector<std::vector<Block>> m_levels[ 2 ];
+};
+
+inline int PeakPyramid::getFrames() const {
+	return m_nFrames;
+}
+inline int PeakPyramid::getLevels() const {
+	return static_cast<int>( m_levels[ 0 ].size() );
+}
+
+};
+
+#endif
@@ -22,14 +22,19 @@
 
 
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <limits>
 #include <memory>
 
 #include <core/Hydrogen.h>
 #include <core/Preferences/Preferences.h>
 #include <core/Helpers/Filesystem.h>
+#include <core/Helpers/RealtimeMemory.h>
 #include <core/Basics/Sample.h>
 #include <core/Basics/Note.h>
+#include <core/Sampler/SampleRateConverter.h>
 
 #if defined(H2CORE_HAVE_RUBBERBAND) || _DOXYGEN_
 #include <rubberband/RubberBandStretcher.h>
@@ -42,6 +47,11 @@ namespace H2Core
 
 const std::vector<QString> Sample::__loop_modes = { "forward", "reverse", "pingpong" };
 
+namespace {
+/** Written by the AudioEngine and read by all threads loading samples. */
+std::atomic<int> nTargetSampleRate( 0 );
+}
+
 #if defined(H2CORE_HAVE_RUBBERBAND) || _DOXYGEN_
 static double compute_pitch_scale( const Sample::Rubberband& r );
 static RubberBand::RubberBandStretcher::Options compute_rubberband_options( const Sample::Rubberband& r );
@@ -65,6 +75,7 @@ EnvelopePoint::EnvelopePoint( const EnvelopePoint& other ) : Object(other), fram
 
 Sample::Sample( const QString& filepath, const License& license, int frames, int sample_rate, float* data_l, float* data_r ) 
   : m_bIsLoaded( false ),
+	m_nLockedFrames( 0 ),
 	__filepath( filepath ),
 	__frames( frames ),
 	__sample_rate( sample_rate ),
@@ -81,6 +92,7 @@ Sample::Sample( const QString& filepath, const License& license, int frames, int
 Sample::Sample( std::shared_ptr<Sample> pOther ) :
 	Object( *pOther ),
 	m_bIsLoaded( pOther->m_bIsLoaded ),
+	m_nLockedFrames( 0 ),
 	__filepath( pOther->get_filepath() ),
 	__frames( pOther->get_frames() ),
 	__sample_rate( pOther->get_sample_rate() ),
@@ -89,6 +101,8 @@ Sample::Sample( std::shared_ptr<Sample> pOther ) :
 	__is_modified( pOther->get_is_modified() ),
 	__loops( pOther->__loops ),
 	__rubberband( pOther->__rubberband ),
+	m_tailPeaks( pOther->m_tailPeaks ),
+	m_pPeakPyramid( pOther->m_pPeakPyramid ),
 	m_license( pOther->m_license )
 {
 
@@ -111,10 +125,15 @@ Sample::Sample( std::shared_ptr<Sample> pOther ) :
 	for( int i=0; i<pVelocity.size(); i++ ) {
 		__velocity_envelope.push_back( pVelocity.at(i) );
 	}
+
+	if ( m_bIsLoaded ) {
+		lockMemory();
+	}
 }
 
 Sample::~Sample()
 {
+	unlockMemory();
 	if ( __data_l != nullptr ) {
 		delete[] __data_l;
 	}
@@ -136,7 +155,8 @@ const QString& Sample::get_filepath() const
 	return __filepath;
 }
 
-std::shared_ptr<Sample> Sample::load( const QString& sFilepath, const License& license )
+std::shared_ptr<Sample> Sample::load( const QString& sFilepath, const License& license,
+									  bool bResample )
 {
 	std::shared_ptr<Sample> pSample;
 	
@@ -149,14 +169,14 @@ std::shared_ptr<Sample> Sample::load( const QString& sFilepath, const License& l
 
 	// Samples loaded this way have no loops, rubberband, or envelopes
 	// set. Therefore, we do not have to pass a tempo in here.
-	if( !pSample->load() ) {
+	if( !pSample->load( 120, bResample ) ) {
 		return nullptr;
 	}
 	
 	return pSample;
 }
 
-bool Sample::load( float fBpm )
+bool Sample::load( float fBpm, bool bResample )
 {
 	// Will contain a bunch of metadata about the loaded sample.
 	SF_INFO sound_info = {0};
@@ -258,6 +278,17 @@ bool Sample::load( float fBpm )
 	}
 #endif
 
+	// Conversion comes last since loops, envelopes, and the Rubber
+	// Band settings all refer to frames at the native rate.
+	if ( bResample ) {
+		resampleToTargetRate();
+	}
+	computeTailPeaks();
+	computePeakPyramid();
+
+	// Ensure the sample is resident before it becomes playable.
+	lockMemory();
+
 	m_bIsLoaded = true;
 
 	return true;
@@ -265,6 +296,7 @@ bool Sample::load( float fBpm )
 
 void Sample::unload()
 {
+	unlockMemory();
 	if ( __data_l != nullptr ) {
 		delete [] __data_l;
 	}
@@ -277,10 +309,122 @@ void Sample::unload()
 	    velocity, loop and rubberband are kept unchanged */
 
 	__data_l = __data_r = nullptr;
+	m_tailPeaks.clear();
+	m_pPeakPyramid = nullptr;
 
 	m_bIsLoaded = false;
 }
 
+void Sample::lockMemory() {
+	if ( m_nLockedFrames > 0 || __frames <= 0 ||
+		 ! RealtimeMemory::isEnabled() ) {
+		return;
+	}
+
+	const size_t nBytes = static_cast<size_t>(__frames) * sizeof( float );
+	const bool bLocked_L = RealtimeMemory::lock( __data_l, nBytes );
+	const bool bLocked_R = RealtimeMemory::lock( __data_r, nBytes );
+	if ( bLocked_L && bLocked_R ) {
+		m_nLockedFrames = __frames;
+	}
+	else {
+		// Prefaulted but not locked.
+		if ( bLocked_L ) {
+			RealtimeMemory::unlock( __data_l, nBytes );
+		}
+		if ( bLocked_R ) {
+			RealtimeMemory::unlock( __data_r, nBytes );
+		}
+	}
+}
+
+void Sample::unlockMemory() {
+	if ( m_nLockedFrames <= 0 ) {
+		return;
+	}
+
+	const size_t nBytes = static_cast<size_t>(m_nLockedFrames) * sizeof( float );
+	RealtimeMemory::unlock( __data_l, nBytes );
+	RealtimeMemory::unlock( __data_r, nBytes );
+	m_nLockedFrames = 0;
+}
+
+void Sample::setTargetSampleRate( int nSampleRate ) {
+	nTargetSampleRate.store( std::max( nSampleRate, 0 ) );
+}
+
+int Sample::getTargetSampleRate() {
+	return nTargetSampleRate.load();
+}
+
+void Sample::resampleToTargetRate() {
+	const int nTarget = getTargetSampleRate();
+	if ( nTarget <= 0 || __sample_rate <= 0 || __sample_rate == nTarget ||
+		 __frames <= 0 ) {
+		return;
+	}
+
+	SampleRateConverter converter( __sample_rate, nTarget );
+	const int nFrames = converter.getOutputFrames( __frames );
+	float* pData_L = new float[ nFrames ];
+	float* pData_R = new float[ nFrames ];
+	converter.process( __data_l, __frames, pData_L );
+	converter.process( __data_r, __frames, pData_R );
+
+	delete[] __data_l;
+	delete[] __data_r;
+	__data_l = pData_L;
+	__data_r = pData_R;
+	__frames = nFrames;
+	__sample_rate = nTarget;
+}
+
+void Sample::computeTailPeaks() {
+	m_tailPeaks.clear();
+	if ( __frames <= 0 || __data_l == nullptr || __data_r == nullptr ) {
+		return;
+	}
+
+	const int nBlocks = ( __frames + nTailBlockSize - 1 ) / nTailBlockSize;
+	m_tailPeaks.resize( nBlocks );
+
+	// Accumulate from the end of the sample towards its beginning.
+	float fPeak = 0;
+	for ( int nBlock = nBlocks - 1; nBlock >= 0; --nBlock ) {
+		const int nStart = nBlock * nTailBlockSize;
+		const int nEnd = std::min( nStart + nTailBlockSize, __frames );
+		for ( int ii = nStart; ii < nEnd; ++ii ) {
+			fPeak = std::max( fPeak, std::max( std::abs( __data_l[ ii ] ),
+											   std::abs( __data_r[ ii ] ) ) );
+		}
+		m_tailPeaks[ nBlock ] = fPeak;
+	}
+}
+
+void Sample::computePeakPyramid() {
+	if ( __frames <= 0 || __data_l == nullptr || __data_r == nullptr ) {
+		m_pPeakPyramid = nullptr;
+		return;
+	}
+
+	m_pPeakPyramid = std::make_shared<PeakPyramid>( __data_l, __data_r, __frames );
+}
+
+void Sample::getPeaks( PeakPyramid::Channel channel, double fStartFrame,
+					   double fFramesPerPixel, int nPixels,
+					   PeakPyramid::Peak* pPeaks ) const {
+	if ( m_pPeakPyramid != nullptr &&
+		 fFramesPerPixel >= PeakPyramid::nBaseBlockSize *
+		 PeakPyramid::nBlocksPerPixel ) {
+		m_pPeakPyramid->getPeaks( channel, fStartFrame, fFramesPerPixel,
+								  nPixels, pPeaks );
+		return;
+	}
+
+	PeakPyramid::computePeaks( __data_l, __data_r, __frames, channel,
+							   fStartFrame, fFramesPerPixel, nPixels, pPeaks );
+}
+
 bool Sample::apply_loops()
 {
 	if( __loops.start_frame == 0 && __loops.loop_frame == 0 &&
@@ -636,8 +780,10 @@ bool Sample::exec_rubberband_cli( float fBpm )
 		return false;
 	}
 
-	QString outfilePath =  QDir::tempPath() + "/tmp_rb_outfile.wav";
+	// Samples might be stretched by several threads at once.
+	QString outfilePath = Filesystem::tmp_file_path( "tmp_rb_outfile.wav" );
 	if( !write( outfilePath ) ) {
+		QFile( outfilePath ).remove();
 		ERRORLOG( "unable to write sample" );
 		return false;
 	};
@@ -660,7 +806,7 @@ bool Sample::exec_rubberband_cli( float fBpm )
 	QString rCs = QString( " %1" ).arg( __rubberband.c_settings );
 	float fFrequency = Note::pitchToFrequency( ( double )__rubberband.pitch );
 	QString rFs = QString( " %1" ).arg( fFrequency );
-	QString rubberResultPath = QDir::tempPath() + "/tmp_rb_result_file.wav";
+	QString rubberResultPath = Filesystem::tmp_file_path( "tmp_rb_result_file.wav" );
 
 	arguments << "-D" << QString( " %1" ).arg( durationtime ) 	//stretch or squash to make output file X seconds long
 			  << "--threads"					//assume multi-CPU even if only one CPU is identified
@@ -678,22 +824,25 @@ bool Sample::exec_rubberband_cli( float fBpm )
 	}
 
 	delete pRubberbandProc;
+	QFile( outfilePath ).remove();
 	if ( QFile( rubberResultPath ).exists() == false ) {
 		_ERRORLOG( QString( "Rubberband reimporter File %1 not found" ).arg( rubberResultPath ) );
 		return false;
 	}
 
-	auto p_Rubberbanded = Sample::load( rubberResultPath );
+	// Conversion to the target rate is done by our caller.
+	auto p_Rubberbanded = Sample::load( rubberResultPath, License(), false );
+	QFile( rubberResultPath ).remove();
 	if( p_Rubberbanded == nullptr ) {
 		return false;
 	}
 
-	QFile( outfilePath ).remove();
-
-	QFile( rubberResultPath ).remove();
-
 	__frames = p_Rubberbanded->get_frames();
+	// Locking is redone once loading is complete.
+	p_Rubberbanded->unlockMemory();
 
+	delete [] __data_l;
+	delete [] __data_r;
 	__data_l = p_Rubberbanded->get_data_l();
 	__data_r = p_Rubberbanded->get_data_r();
 	p_Rubberbanded->__data_l = nullptr;
@@ -23,10 +23,13 @@
 #ifndef H2C_SAMPLE_H
 #define H2C_SAMPLE_H
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <vector>
 #include <sndfile.h>
 
+#include <core/Basics/PeakPyramid.h>
 #include <core/License.h>
 #include <core/Object.h>
 
@@ -165,6 +168,10 @@ class Sample : public H2Core::Object<Sample>
 		 *
 		 * \param filepath the file to load audio data from
 		 * \param license associated with the sample
+		 * \param bResample Whether to convert the sample to the
+		 *   rate set via setTargetSampleRate(). Editors working with
+		 *   frames at the native rate, like loops and envelopes do,
+		 *   should pass false.
 		 *
 		 * \return Pointer to the newly initialized Sample. If
 		 * the provided @a filepath is not readable, a nullptr
@@ -172,7 +179,8 @@ class Sample : public H2Core::Object<Sample>
 		 *
 		 * \fn load(const QString& filepath)
 		 */
-	static std::shared_ptr<Sample> load( const QString& filepath, const License& license = License() );
+	static std::shared_ptr<Sample> load( const QString& filepath, const License& license = License(),
+										 bool bResample = true );
 
 		/**
 		 * Load the sample stored in #__filepath into
@@ -197,16 +205,42 @@ class Sample : public H2Core::Object<Sample>
 		 *
 		 * After successfully loading, the function applies all loop,
 		 * rubberband, and envelope modifications in case they were
-		 * set by the user.
+		 * set by the user. Finally, it is converted to the rate set
+		 * via setTargetSampleRate() unless @a bResample is false.
 		 *
 		 * \fn load()
 		 */
-		bool load( float fBpm = 120 );
+		bool load( float fBpm = 120, bool bResample = true );
 		/**
 		 * Flush the current content of the left and right
 		 * channel and the current metadata.
 		 */
 		void unload();
+		/**
+		 * Locks #__data_l and #__data_r into RAM and faults in all
+		 * their pages so the first hit of the sample does not stall
+		 * the audio thread.
+		 *
+		 * Does nothing unless RealtimeMemory is enabled. Called by
+		 * load() itself.
+		 */
+		void lockMemory();
+
+		/**
+		 * Sets the rate all samples will be converted to by load().
+		 *
+		 * Converting samples to the sample rate of the audio driver once
+		 * while loading them allows the Sampler to just copy the data
+		 * of unpitched notes instead of interpolating it in every
+		 * process cycle. Since the conversion is band-limited, the
+		 * quality of pitched notes does improve too.
+		 *
+		 * Samples already loaded are not affected. A value of 0
+		 * disables the conversion and samples are kept at their native
+		 * rate.
+		 */
+		static void setTargetSampleRate( int nSampleRate );
+		static int getTargetSampleRate();
 
 		/** \return true if the associated sample file was loaded */
 		bool isLoaded() const;
@@ -241,6 +275,30 @@ class Sample : public H2Core::Object<Sample>
 		float* get_data_l() const;
 		/** \return #__data_r*/
 		float* get_data_r() const;
+		/**
+		 * Upper bound for the magnitude of all frames of both channels
+		 * starting at @a nFrame till the end of the sample.
+		 *
+		 * The bound is looked up in #m_tailPeaks with a resolution of
+		 * #nTailBlockSize frames and is therefore cheap enough to be
+		 * queried in each process cycle. For samples not loaded using
+		 * load() no bound is known and the largest float is returned.
+		 */
+		float getTailPeak( int nFrame ) const;
+		/** Number of frames covered by each entry in #m_tailPeaks. */
+		static constexpr int nTailBlockSize = 1024;
+		/**
+		 * Summarizes @a nPixels pixels of @a channel for drawing a
+		 * waveform. See PeakPyramid::getPeaks() for the meaning of the
+		 * arguments.
+		 *
+		 * Reads from #m_pPeakPyramid unless the sample is zoomed in
+		 * too far for the pyramid to be accurate or it was not loaded
+		 * using load(). In these cases the frames are read directly.
+		 */
+		void getPeaks( PeakPyramid::Channel channel, double fStartFrame,
+					   double fFramesPerPixel, int nPixels,
+					   PeakPyramid::Peak* pPeaks ) const;
 		/**
 		 * #__is_modified setter
 		 * \param value the new value for #__is_modified
@@ -304,9 +362,22 @@ class Sample : public H2Core::Object<Sample>
 		 * \param fBpm tempo the Rubberband transformation will target
 		 */
 		bool exec_rubberband_cli( float fBpm );
+		/** Has to be called before freeing #__data_l and #__data_r. */
+		void unlockMemory();
+		/** Converts #__data_l and #__data_r to the sample rate set via
+		 * setTargetSampleRate(). */
+		void resampleToTargetRate();
+		/** Fills #m_tailPeaks. Has to be called whenever #__data_l or
+		 * #__data_r changed. */
+		void computeTailPeaks();
+		/** Builds #m_pPeakPyramid. Has to be called whenever #__data_l
+		 * or #__data_r changed. */
+		void computePeakPyramid();
 
 		/** Convenience variable not written to disk. */
 		bool				m_bIsLoaded;
+		/** Number of frames per channel locked by lockMemory(). */
+		int					m_nLockedFrames;
 		QString				__filepath;          ///< filepath of the sample
 		int					__frames;            ///< number of frames in this sample
 		int					__sample_rate;       ///< samplerate for this sample
@@ -317,6 +388,13 @@ class Sample : public H2Core::Object<Sample>
 		VelocityEnvelope	__velocity_envelope; ///< velocity envelope vector
 		Loops				__loops;             ///< set of loop parameters
 		Rubberband			__rubberband;        ///< set of rubberband parameters
+		/** Peak magnitude of all frames from the beginning of the
+		 * corresponding block of #nTailBlockSize frames till the end
+		 * of the sample. Monotonically decreasing. */
+		std::vector<float>	m_tailPeaks;
+		/** Used by the waveform displays. Shared by all copies of the
+		 * sample since it is never altered after creation. */
+		std::shared_ptr<const PeakPyramid> m_pPeakPyramid;
 		/** loop modes string */
 		static const std::vector<QString> __loop_modes;
 
@@ -396,6 +474,17 @@ inline void Sample::set_is_modified( bool is_modified )
 	__is_modified = is_modified;
 }
 
+inline float Sample::getTailPeak( int nFrame ) const
+{
+	if ( nFrame >= __frames ) {
+		return 0;
+	}
+	if ( m_tailPeaks.empty() ) {
+		return std::numeric_limits<float>::max();
+	}
+	return m_tailPeaks[ std::max( nFrame, 0 ) / nTailBlockSize ];
+}
+
 inline bool Sample::get_is_modified() const
 {
 	return __is_modified;
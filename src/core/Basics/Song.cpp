@@ -54,6 +54,8 @@
 
 
 #include <QDir>
+#include <QFile>
+#include <QXmlStreamReader>
 
 namespace
 {
@@ -80,8 +82,10 @@ Song::Song( const QString& sName, const QString& sAuthor, float fBpm, float fVol
 	, m_patternMode( PatternMode::Selected )
 	, m_fHumanizeTimeValue( 0.0 )
 	, m_fHumanizeVelocityValue( 0.0 )
+	, m_nHumanizeSeed( 0 )
 	, m_fSwingFactor( 0.0 )
 	, m_bIsModified( false )
+	, m_nRevision( 0 )
 	, m_mode( Mode::Pattern )
 	, m_sPlaybackTrackFilename( "" )
 	, m_bPlaybackTrackEnabled( false )
@@ -200,8 +204,14 @@ std::shared_ptr<Song> Song::load( const QString& sFilename, bool bSilent )
 		INFOLOG( "Reading " + sPath );
 	}
 
+	// In contrast to drumkits and patterns there is no XSD schema for
+	// songs. loadFrom() copes with missing and legacy elements on its
+	// own. Only files which can not be streamed are parsed into a
+	// single DOM.
 	XMLDoc doc;
-	if ( ! doc.read( sFilename ) && ! bSilent ) {
+	PatternList* pPatternList = nullptr;
+	if ( ! streamDoc( sFilename, &doc, &pPatternList, bSilent ) &&
+		 ! doc.read( sFilename ) && ! bSilent ) {
 		ERRORLOG( QString( "Something went wrong while loading song [%1]" )
 				  .arg( sFilename ) );
 	}
@@ -210,6 +220,7 @@ std::shared_ptr<Song> Song::load( const QString& sFilename, bool bSilent )
 
 	if ( songNode.isNull() ) {
 		ERRORLOG( "Error reading song: 'song' node not found" );
+		delete pPatternList;
 		return nullptr;
 	}
 
@@ -223,7 +234,7 @@ std::shared_ptr<Song> Song::load( const QString& sFilename, bool bSilent )
 		}
 	}
 
-	auto pSong = Song::loadFrom( songNode, sFilename, bSilent );
+	auto pSong = Song::loadFrom( songNode, sFilename, bSilent, pPatternList );
 	if ( pSong != nullptr ) {
 		pSong->setFilename( sFilename );
 	}
@@ -231,7 +242,50 @@ std::shared_ptr<Song> Song::load( const QString& sFilename, bool bSilent )
 	return pSong;
 }
 
-std::shared_ptr<Song> Song::loadFrom( const XMLNode& rootNode, const QString& sFilename, bool bSilent )
+bool Song::streamDoc( const QString& sFilename, XMLDoc* pDoc,
+					  PatternList** ppPatternList, bool bSilent )
+{
+	QFile file( sFilename );
+	if ( ! file.open( QIODevice::ReadOnly ) ||
+		 Legacy::checkTinyXMLCompatMode( &file, bSilent ) ||
+		 ! file.seek( 0 ) ) {
+		return false;
+	}
+
+	QXmlStreamReader reader( &file );
+	if ( ! reader.readNextStartElement() ||
+		 reader.name() != QLatin1String( "song" ) ) {
+		return false;
+	}
+
+	XMLNode songNode = pDoc->createElement( "song" );
+	pDoc->appendChild( songNode );
+
+	PatternList* pPatternList = nullptr;
+	while ( reader.readNextStartElement() ) {
+		if ( reader.name() == QLatin1String( "patternList" ) &&
+			 pPatternList == nullptr ) {
+			pPatternList = PatternList::loadFrom( reader, bSilent );
+		}
+		else if ( pDoc->readElement( reader, songNode ).isNull() ) {
+			break;
+		}
+	}
+
+	if ( reader.hasError() ) {
+		ERRORLOG( QString( "Unable to stream song [%1]: %2" )
+				  .arg( sFilename ).arg( reader.errorString() ) );
+		delete pPatternList;
+		pDoc->clear();
+		return false;
+	}
+
+	*ppPatternList = pPatternList;
+	return true;
+}
+
+std::shared_ptr<Song> Song::loadFrom( const XMLNode& rootNode, const QString& sFilename,
+									  bool bSilent, PatternList* pPatternList )
 {
 	auto pPreferences = Preferences::get_instance();
 
@@ -308,6 +362,8 @@ std::shared_ptr<Song> Song::loadFrom( const XMLNode& rootNode, const QString& sF
 														false, false, bSilent ) );
 	pSong->setHumanizeVelocityValue( rootNode.read_float( "humanize_velocity", 0.0,
 															false, false, bSilent ) );
+	pSong->setHumanizeSeed( rootNode.read_int( "humanize_seed", 0,
+												 true, false, bSilent ) );
 	pSong->setSwingFactor( rootNode.read_float( "swing_factor", 0.0, false, false, bSilent ) );
 	pSong->setActionMode( static_cast<Song::ActionMode>(
 		rootNode.read_int( "action_mode",
@@ -397,8 +453,18 @@ std::shared_ptr<Song> Song::loadFrom( const XMLNode& rootNode, const QString& sF
 								bSilent ) );
 
 	// Pattern list
-	auto pPatternList = PatternList::load_from(
-		rootNode, pDrumkit->getExportName(), bSilent );
+	if ( pPatternList != nullptr ) {
+		// Already read by streamDoc() at a point the drumkit was not
+		// known yet.
+		for ( auto& ppPattern : *pPatternList ) {
+			ppPattern->setDrumkitName( pDrumkit->getExportName() );
+			ppPattern->fixupTypes( bSilent );
+		}
+	}
+	else {
+		pPatternList = PatternList::load_from(
+			rootNode, pDrumkit->getExportName(), bSilent );
+	}
 	if ( pPatternList != nullptr ) {
 		pPatternList->mapTo( pDrumkit );
 	}
@@ -548,16 +614,7 @@ bool Song::save( const QString& sFilename, bool bSilent )
 		INFOLOG( QString( "Saving song to [%1]" ).arg( sFilename ) );
 	}
 
-	XMLDoc doc;
-	XMLNode rootNode = doc.set_root( "song" );
-
-	// In order to comply with the GPL license we have to add a
-	// license notice to the file.
-	if ( getLicense().getType() == License::GPL ) {
-		doc.appendChild( doc.createComment( License::getGPLLicenseNotice( getAuthor() ) ) );
-	}
-
-	saveTo( rootNode, bSilent );
+	const XMLDoc doc = toXml( bSilent );
 
 	setFilename( sFilename );
 	setIsModified( false );
@@ -574,6 +631,21 @@ bool Song::save( const QString& sFilename, bool bSilent )
 	return true;
 }
 
+XMLDoc Song::toXml( bool bSilent ) const {
+	XMLDoc doc;
+	XMLNode rootNode = doc.set_root( "song" );
+
+	// In order to comply with the GPL license we have to add a
+	// license notice to the file.
+	if ( getLicense().getType() == License::GPL ) {
+		doc.appendChild( doc.createComment( License::getGPLLicenseNotice( getAuthor() ) ) );
+	}
+
+	saveTo( rootNode, bSilent );
+
+	return doc;
+}
+
 void Song::loadVirtualPatternsFrom( const XMLNode& node, bool bSilent ) {
 
 	XMLNode virtualPatternListNode = node.firstChildElement( "virtualPatternList" );
@@ -797,6 +869,7 @@ void Song::saveTo( XMLNode& rootNode, bool bSilent ) const {
 
 	rootNode.write_float( "humanize_time", m_fHumanizeTimeValue );
 	rootNode.write_float( "humanize_velocity", m_fHumanizeVelocityValue );
+	rootNode.write_int( "humanize_seed", m_nHumanizeSeed );
 	rootNode.write_float( "swing_factor", m_fSwingFactor );
 
 	// "drumkit_info" instead of "drumkit" seem unintuitive but is dictated by a
@@ -941,14 +1014,11 @@ std::shared_ptr<Song> Song::getEmptySong( std::shared_ptr<SoundLibraryDatabase>
 	const QString sDefaultDrumkitPath = Filesystem::drumkit_default_kit();
 	auto pDrumkit = pSoundLibraryDatabase->getDrumkit( sDefaultDrumkitPath );
 	if ( pDrumkit == nullptr ) {
-		for ( const auto& pEntry : pSoundLibraryDatabase->getDrumkitDatabase() ) {
-			if ( pEntry.second != nullptr ) {
-				WARNINGLOG( QString( "Unable to retrieve default drumkit [%1]. Using kit [%2] instead." )
-							.arg( sDefaultDrumkitPath )
-							.arg( pEntry.first ) );
-				pDrumkit = pEntry.second;
-				break;
-			}
+		pDrumkit = pSoundLibraryDatabase->getFallbackDrumkit();
+		if ( pDrumkit != nullptr ) {
+			WARNINGLOG( QString( "Unable to retrieve default drumkit [%1]. Using kit [%2] instead." )
+						.arg( sDefaultDrumkitPath )
+						.arg( pDrumkit->getPath() ) );
 		}
 	}
 
@@ -988,6 +1058,9 @@ void Song::setIsModified( bool bIsModified )
 	}
 
 	m_bIsModified = bIsModified;
+	if ( bIsModified ) {
+		++m_nRevision;
+	}
 
 	if( Notify ) {
 		EventQueue::get_instance()->push_event( EVENT_SONG_MODIFIED, -1 );
@@ -1021,31 +1094,85 @@ void Song::clearMissingSamples() {
 	}
 }
 
-void Song::loadTempPatternList( const QString& sFilename )
+std::shared_ptr<const Song::PatternSequence> Song::getPatternSequence() const
 {
-	XMLDoc doc;
-	if( !doc.read( sFilename ) ) {
-		return;
+	auto pSequence = std::make_shared<PatternSequence>();
+	if ( m_pPatternList == nullptr || m_pPatternGroupSequence == nullptr ) {
+		return pSequence;
 	}
-	XMLNode root = doc.firstChildElement( "sequence" );
-	if ( root.isNull() ) {
-		ERRORLOG( "sequence node not found" );
-		return;
+
+	std::vector<int> column;
+	pSequence->columns.reserve( m_pPatternGroupSequence->size() );
+	for ( int ii = 0; ii < m_pPatternGroupSequence->size(); ++ii ) {
+		column.clear();
+		for ( const auto& pPattern : *(*m_pPatternGroupSequence)[ ii ] ) {
+			column.push_back( m_pPatternList->index( pPattern ) );
+		}
+
+		if ( m_pLastPatternSequence != nullptr &&
+			 ii < m_pLastPatternSequence->columns.size() &&
+			 *m_pLastPatternSequence->columns[ ii ] == column ) {
+			pSequence->columns.push_back( m_pLastPatternSequence->columns[ ii ] );
+		} else {
+			pSequence->columns.push_back(
+				std::make_shared<const std::vector<int>>( column ) );
+		}
 	}
 
-	loadVirtualPatternsFrom( root, false );
-	loadPatternGroupVectorFrom( root, false );
+	pSequence->virtualPatterns.resize( m_pPatternList->size() );
+	for ( int ii = 0; ii < m_pPatternList->size(); ++ii ) {
+		for ( const auto& pVirtualPattern :
+				  *m_pPatternList->get( ii )->get_virtual_patterns() ) {
+			pSequence->virtualPatterns[ ii ].push_back(
+				m_pPatternList->index( pVirtualPattern ) );
+		}
+	}
+
+	m_pLastPatternSequence = pSequence;
+	return pSequence;
 }
 
-bool Song::saveTempPatternList( const QString& sFilename ) const
+void Song::setPatternSequence( const PatternSequence& sequence )
 {
-	XMLDoc doc;
-	XMLNode root = doc.set_root( "sequence" );
+	if ( m_pPatternList == nullptr || m_pPatternGroupSequence == nullptr ) {
+		return;
+	}
+
+	for ( auto& pColumn : *m_pPatternGroupSequence ) {
+		// The patterns themselves are owned by #m_pPatternList.
+		pColumn->clear();
+		delete pColumn;
+	}
+	m_pPatternGroupSequence->clear();
+	m_pPatternGroupSequence->reserve( sequence.columns.size() );
 
-	saveVirtualPatternsTo( root, false );
-	savePatternGroupVectorTo( root, false );
+	for ( const auto& pColumn : sequence.columns ) {
+		auto pPatternList = new PatternList();
+		for ( const int nIndex : *pColumn ) {
+			auto pPattern = m_pPatternList->get( nIndex );
+			if ( pPattern != nullptr ) {
+				pPatternList->add( pPattern );
+			} else {
+				WARNINGLOG( QString( "Pattern [%1] not found" ).arg( nIndex ) );
+			}
+		}
+		m_pPatternGroupSequence->push_back( pPatternList );
+	}
 
-	return doc.write( sFilename );
+	for ( int ii = 0; ii < m_pPatternList->size(); ++ii ) {
+		auto pPattern = m_pPatternList->get( ii );
+		pPattern->virtual_patterns_clear();
+		if ( ii >= sequence.virtualPatterns.size() ) {
+			continue;
+		}
+		for ( const int nIndex : sequence.virtualPatterns[ ii ] ) {
+			auto pVirtualPattern = m_pPatternList->get( nIndex );
+			if ( pVirtualPattern != nullptr ) {
+				pPattern->virtual_patterns_add( pVirtualPattern );
+			}
+		}
+	}
+	m_pPatternList->flattened_virtual_patterns_compute();
 }
 
 void Song::setPanLawKNorm( float fKNorm ) {
@@ -1222,6 +1349,8 @@ QString Song::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( m_fHumanizeTimeValue ) )
 			.append( QString( "%1%2m_fHumanizeVelocityValue: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_fHumanizeVelocityValue ) )
+			.append( QString( "%1%2m_nHumanizeSeed: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nHumanizeSeed ) )
 			.append( QString( "%1%2m_fSwingFactor: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_fSwingFactor ) )
 			.append( QString( "%1%2m_bIsModified: %3\n" ).arg( sPrefix ).arg( s )
@@ -1291,6 +1420,7 @@ QString Song::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( PatternModeToQString( m_patternMode ) ) )
 			.append( QString( ", m_fHumanizeTimeValue: %1" ).arg( m_fHumanizeTimeValue ) )
 			.append( QString( ", m_fHumanizeVelocityValue: %1" ).arg( m_fHumanizeVelocityValue ) )
+			.append( QString( ", m_nHumanizeSeed: %1" ).arg( m_nHumanizeSeed ) )
 			.append( QString( ", m_fSwingFactor: %1" ).arg( m_fSwingFactor ) )
 			.append( QString( ", m_bIsModified: %1" ).arg( m_bIsModified ) )
 			.append( QString( ", m_latestRoundRobins" ) );
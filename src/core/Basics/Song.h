@@ -26,6 +26,7 @@
 
 #include <QString>
 #include <QDomNode>
+#include <atomic>
 #include <vector>
 #include <map>
 #include <memory>
@@ -155,6 +156,15 @@ class Song : public H2Core::Object<Song>, public std::enable_shared_from_this<So
 	 *   warnings are suppressed.
 	 */
 	bool 			save( const QString& sFilename, bool bSilent = false );
+	/** Serializes the song into a document without altering it.
+	 *
+	 * The resulting document does not refer to the song and can be
+	 * written to disk by a different thread, e.g. while autosaving.
+	 *
+	 * \param bSilent if set to true, all log messages except of errors
+	 *   and warnings are suppressed.
+	 */
+	XMLDoc			toXml( bool bSilent = false ) const;
 
 		static constexpr int nDefaultResolution = 48;
 	bool getIsTimelineActivated() const;
@@ -232,6 +242,9 @@ class Song : public H2Core::Object<Song>, public std::enable_shared_from_this<So
 							
 		float			getHumanizeVelocityValue() const;
 		void			setHumanizeVelocityValue( float fValue );
+
+		int				getHumanizeSeed() const;
+		void			setHumanizeSeed( int nSeed );
 							
 		float			getSwingFactor() const;
 		void			setSwingFactor( float fFactor );
@@ -241,11 +254,33 @@ class Song : public H2Core::Object<Song>, public std::enable_shared_from_this<So
 							
 		bool			getIsModified() const;
 		void			setIsModified( bool bIsModified);
+		/** \return #m_nRevision */
+		int				getRevision() const;
 
 		AutomationPath*	getVelocityAutomationPath() const;
 
-		void			loadTempPatternList( const QString& sFilename );
-		bool			saveTempPatternList( const QString& sFilename ) const;
+		/**
+		 * In-memory copy of the pattern sequence and the virtual
+		 * patterns used by the undo history of the SongEditor.
+		 * Patterns are referred to by their position in
+		 * #m_pPatternList.
+		 *
+		 * A snapshot is never altered after its creation and can be
+		 * shared between undo actions. In addition, columns which did
+		 * not change since the previous call to getPatternSequence()
+		 * are shared with the previous snapshot.
+		 */
+		struct PatternSequence {
+			std::vector<std::shared_ptr<const std::vector<int>>> columns;
+			/** Positions of the virtual patterns of each pattern. */
+			std::vector<std::vector<int>> virtualPatterns;
+		};
+		std::shared_ptr<const PatternSequence> getPatternSequence() const;
+		/** Replaces the pattern sequence and virtual patterns by the
+		 * ones stored in @a sequence.
+		 *
+		 * Has to be called with the AudioEngine locked. */
+		void			setPatternSequence( const PatternSequence& sequence );
 							
 		int			getLatestRoundRobin( float fStartVelocity ) const;
 		void			setLatestRoundRobin( float fStartVelocity, int nLatestRoundRobin );
@@ -303,9 +338,28 @@ class Song : public H2Core::Object<Song>, public std::enable_shared_from_this<So
 	
 private:
 
+	/**
+	 * Reads the song stored in @a sFilename in a single pass.
+	 *
+	 * The patterns - usually the largest part of a song - are read
+	 * directly from the stream into @a ppPatternList while all other
+	 * elements are copied into @a pDoc to be handled by loadFrom().
+	 *
+	 * \return `false` in case the file could not be streamed, e.g.
+	 *   because it is malformed or was written using TinyXML. Both
+	 *   @a pDoc and @a ppPatternList are left empty in that case.
+	 */
+	static bool streamDoc( const QString& sFilename, XMLDoc* pDoc,
+						   PatternList** ppPatternList, bool bSilent = false );
+	/**
+	 * \param pPatternList Patterns already read by streamDoc(). The
+	 *   song takes ownership of them. If `nullptr`, the patterns are
+	 *   read from @a pNode instead.
+	 */
 	static std::shared_ptr<Song> loadFrom( const XMLNode& pNode,
 										   const QString& sFilename,
-										   bool bSilent = false );
+										   bool bSilent = false,
+										   PatternList* pPatternList = nullptr );
 	void saveTo( XMLNode& pNode, bool bSilent = false ) const;
 
 	void loadVirtualPatternsFrom( const XMLNode& pNode, bool bSilent = false );
@@ -344,6 +398,10 @@ private:
 		PatternList*	m_pPatternList;
 		///< Sequence of pattern groups
 		std::vector<PatternList*>* m_pPatternGroupSequence;
+		/** Snapshot returned by the latest call to
+		 * getPatternSequence(). Its columns are reused by the next
+		 * one. */
+		mutable std::shared_ptr<const PatternSequence> m_pLastPatternSequence;
 
 		/** Current drumkit
 		 *
@@ -375,8 +433,20 @@ private:
 		 * Supported range [0,1].
 		 */
 		float			m_fHumanizeVelocityValue;
+		/**
+		 * Seed used to reset the random number generators (see
+		 * #H2Core::Random) each time playback or export is started.
+		 * This way humanization is reproducible.
+		 *
+		 * If set to 0, no seed will be applied.
+		 */
+		int				m_nHumanizeSeed;
 		float			m_fSwingFactor;
 		bool			m_bIsModified;
+		/** Incremented each time the song is marked as modified. Used
+		 * to tell whether it changed since a particular point in
+		 * time, regardless of whether it was saved in between. */
+		std::atomic<int>	m_nRevision;
 		std::map< float, int> 	m_latestRoundRobins;
 		Mode			m_mode;
 		
@@ -530,6 +600,10 @@ inline void Song::setMetronomeVolume( float fValue )
 	m_fMetronomeVolume = fValue;
 }
 
+inline int Song::getRevision() const {
+	return m_nRevision.load();
+}
+
 inline bool Song::getIsModified() const 
 {
 	return m_bIsModified;
@@ -648,6 +722,16 @@ inline void Song::setHumanizeVelocityValue( float fValue )
 	m_fHumanizeVelocityValue = fValue;
 }
 
+inline int Song::getHumanizeSeed() const
+{
+	return m_nHumanizeSeed;
+}
+
+inline void Song::setHumanizeSeed( int nSeed )
+{
+	m_nHumanizeSeed = nSeed;
+}
+
 inline float Song::getSwingFactor() const
 {
 	return m_fSwingFactor;
@@ -1133,9 +1133,9 @@ bool CoreActionController::setDrumkit( std::shared_ptr<Drumkit> pNewDrumkit ) {
 				 .arg( pNewDrumkit->getName() ).arg( pNewDrumkit->getPath() ) );
 	}
 
-	// Ensure instruments of the new kit aren't already in the death row.
+	// Ensure instruments of the new kit aren't retired anymore.
 	for ( const auto& ppInstrument : *pNewDrumkit->getInstruments() ) {
-		pHydrogen->removeInstrumentFromDeathRow( ppInstrument );
+		pHydrogen->reviveInstrument( ppInstrument );
 	}
 
 	// It would be more clean to lock the audio engine _before_ loading
@@ -1148,12 +1148,12 @@ bool CoreActionController::setDrumkit( std::shared_ptr<Drumkit> pNewDrumkit ) {
 
 	pAudioEngine->lock( RIGHT_HERE );
 
-	// Add all instruments of the previous drumkit to the death row. This way
-	// all notes in audio engine and sampler queue can be rendered till they are
-	// done. Unloading their samples will be done at a latter point.
+	// Retire all instruments of the previous drumkit. This way all notes in
+	// audio engine and sampler queue can be rendered till they are done.
+	// Unloading their samples will be done at a latter point.
 	if ( pPreviousDrumkit != nullptr ) {
 		for ( const auto& ppInstrument : *pPreviousDrumkit->getInstruments() ) {
-			pHydrogen->addInstrumentToDeathRow( ppInstrument );
+			pHydrogen->retireInstrument( ppInstrument );
 		}
 	}
 
@@ -1625,8 +1625,8 @@ bool CoreActionController::addInstrument( std::shared_ptr<Instrument> pInstrumen
 
 	pAudioEngine->lock( RIGHT_HERE );
 
-	// Ensure instrument isn't already in the death row.
-	pHydrogen->removeInstrumentFromDeathRow( pInstrument );
+	// Ensure instrument isn't retired anymore.
+	pHydrogen->reviveInstrument( pInstrument );
 	pInstrument->load_samples( pAudioEngine->getTransportPosition()->getBpm() );
 
 	pDrumkit->addInstrument( pInstrument, nIndex );
@@ -1673,12 +1673,12 @@ bool CoreActionController::removeInstrument( std::shared_ptr<Instrument> pInstru
 	// At this point the instrument has been removed from both the current
 	// drumkit and every pattern in the song. But it still lives on as a shared
 	// pointer in all Notes within the queues of the AudioEngine and Sampler.
-	// Thus, it will be added to the death row, which guarantuees that its
-	// samples will be unloaded once all notes referencing it are gone. Note
+	// Thus, it will be retired, which guarantuees that its samples will be
+	// unloaded once all notes referencing it are gone. Note
 	// that this does not mean the instrument will be destructed. GUI can still
 	// hold a shared pointer as part of an undo/redo action (that's why it is so
 	// important to unload the samples).
-	pHydrogen->addInstrumentToDeathRow( pInstrument );
+	pHydrogen->retireInstrument( pInstrument );
 
 	// Instead of letting all notes associated with this instrument ring till
 	// the end, we discard those for which playback did not started yet and make
@@ -1731,8 +1731,8 @@ bool CoreActionController::replaceInstrument( std::shared_ptr<Instrument> pNewIn
 	pAudioEngine->lock( RIGHT_HERE );
 
 	if ( pNewInstrument != nullptr ) {
-		// Ensure instrument isn't already in the death row.
-		pHydrogen->removeInstrumentFromDeathRow( pNewInstrument );
+		// Ensure instrument isn't retired anymore.
+		pHydrogen->reviveInstrument( pNewInstrument );
 		pNewInstrument->load_samples( fBpm );
 	}
 
@@ -1741,12 +1741,12 @@ bool CoreActionController::replaceInstrument( std::shared_ptr<Instrument> pNewIn
 	// At this point the instrument has been removed from both the current
 	// drumkit and every pattern in the song. But it still lives on as a shared
 	// pointer in all Notes within the queues of the AudioEngine and Sampler.
-	// Thus, it will be added to the death row, which guarantuees that its
-	// samples will be unloaded once all notes referencing it are gone. Note
+	// Thus, it will be retired, which guarantuees that its samples will be
+	// unloaded once all notes referencing it are gone. Note
 	// that this does not mean the instrument will be destructed. GUI can still
 	// hold a shared pointer as part of an undo/redo action (that's why it is so
 	// important to unload the samples).
-	pHydrogen->addInstrumentToDeathRow( pOldInstrument );
+	pHydrogen->retireInstrument( pOldInstrument );
 
 	// Instead of letting all notes associated with this instrument ring till
 	// the end, we discard those for which playback did not started yet and make
@@ -335,10 +335,11 @@ class CoreActionController : public H2Core::Object<CoreActionController> {
 		 * instrument list.*/
 		static bool addInstrument( std::shared_ptr<Instrument> pInstrument,
 								   int nIndex = -1 );
-		/** Removes @a pInstrument from the current drumkit and adds it to the
-		 * instrument death row. This way it is guarantueed that its samples
-		 * stay loaded until the last #H2Core::Note is done rendering it.
-		 * Afterwards, its samples will be unloaded. */
+		/** Removes @a pInstrument from the current drumkit and retires it
+		 * (see H2Core::Hydrogen::retireInstrument()). This way it is
+		 * guarantueed that its samples stay loaded until the last
+		 * #H2Core::Note is done rendering it. Afterwards, its samples will be
+		 * unloaded. */
 		static bool removeInstrument( std::shared_ptr<Instrument> pInstrument );
 		/** Replaces @a pOldInstrument by @a pNewInstrument in the current
 		 * drumkit without clearing notes, changing the selected instrument
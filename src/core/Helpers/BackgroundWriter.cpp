@@ -0,0 +1,129 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/Helpers/BackgroundWriter.h>
+
+#include <core/Helpers/Filesystem.h>
+
+namespace H2Core
+{
+
+BackgroundWriter::BackgroundWriter()
+	: m_bBusy( false )
+	, m_bShutdown( false )
+{
+	m_thread = std::thread( &BackgroundWriter::run, this );
+}
+
+BackgroundWriter::~BackgroundWriter() {
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_bShutdown = true;
+	}
+	m_condition.notify_all();
+	if ( m_thread.joinable() ) {
+		m_thread.join();
+	}
+}
+
+void BackgroundWriter::write( const QString& sPath, const XMLDoc& doc ) {
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		bool bReplaced = false;
+		for ( auto& jjob : m_jobs ) {
+			if ( jjob.sPath == sPath && ! jjob.bRemove ) {
+				jjob.doc = doc;
+				bReplaced = true;
+				break;
+			}
+		}
+		if ( ! bReplaced ) {
+			m_jobs.push_back( { sPath, doc, false } );
+		}
+	}
+	m_condition.notify_all();
+}
+
+void BackgroundWriter::remove( const QString& sPath ) {
+	{
+		std::lock_guard<std::mutex> lock( m_mutex );
+		m_jobs.push_back( { sPath, XMLDoc(), true } );
+	}
+	m_condition.notify_all();
+}
+
+void BackgroundWriter::waitForFinished() {
+	std::unique_lock<std::mutex> lock( m_mutex );
+	m_finished.wait( lock, [&]() { return m_jobs.empty() && ! m_bBusy; } );
+}
+
+void BackgroundWriter::run() {
+	std::unique_lock<std::mutex> lock( m_mutex );
+	while ( true ) {
+		m_condition.wait( lock, [&]() { return m_bShutdown || ! m_jobs.empty(); } );
+		if ( m_jobs.empty() ) {
+			// Shutdown with all jobs done.
+			break;
+		}
+
+		Job job = std::move( m_jobs.front() );
+		m_jobs.pop_front();
+		m_bBusy = true;
+		lock.unlock();
+
+		if ( job.bRemove ) {
+			if ( Filesystem::file_exists( job.sPath, true ) ) {
+				Filesystem::rm( job.sPath );
+			}
+		}
+		else if ( ! job.doc.write( job.sPath ) ) {
+			ERRORLOG( QString( "Unable to write [%1]" ).arg( job.sPath ) );
+		}
+		// Release the document on this thread as well.
+		job = Job();
+
+		lock.lock();
+		m_bBusy = false;
+		m_finished.notify_all();
+	}
+}
+
+QString BackgroundWriter::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	std::lock_guard<std::mutex> lock( m_mutex );
+	if ( ! bShort ) {
+		sOutput = QString( "%1[BackgroundWriter]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_jobs: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_jobs.size() ) )
+			.append( QString( "%1%2m_bBusy: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_bBusy ) );
+	}
+	else {
+		sOutput = QString( "[BackgroundWriter]" )
+			.append( QString( " m_jobs: %1" ).arg( m_jobs.size() ) )
+			.append( QString( ", m_bBusy: %1" ).arg( m_bBusy ) );
+	}
+
+	return sOutput;
+}
+
+};
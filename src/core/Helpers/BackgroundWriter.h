@@ -0,0 +1,100 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef H2C_BACKGROUND_WRITER_H
+#define H2C_BACKGROUND_WRITER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <core/Object.h>
+#include <core/Helpers/Xml.h>
+
+namespace H2Core
+{
+
+/**
+ * Writes XML documents to disk on a dedicated thread.
+ *
+ * Used for autosaving. The caller serializes e.g. the song into a
+ * #XMLDoc (a snapshot no longer referring to the song) and hands it
+ * over. Converting the document into text and writing it, the
+ * expensive part for large songs, does not block the caller anymore.
+ * The target file is replaced atomically (see XMLDoc::write()).
+ *
+ * Jobs are processed in the order they were queued. A pending write
+ * to a path is replaced by a newer one to the same path.
+ */
+class BackgroundWriter : public H2Core::Object<BackgroundWriter>
+{
+	H2_OBJECT(BackgroundWriter)
+public:
+	BackgroundWriter();
+	/** Finishes all pending jobs. */
+	~BackgroundWriter();
+
+	/** Queues writing @a doc to @a sPath.
+	 *
+	 * @a doc shares its data with the copy stored in the queue. It must
+	 * not be altered by the caller afterwards. */
+	void write( const QString& sPath, const XMLDoc& doc );
+	/** Queues removing @a sPath. It is done after all writes queued
+	 * before. */
+	void remove( const QString& sPath );
+	/** Blocks until all jobs queued so far are done. */
+	void waitForFinished();
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	struct Job {
+		QString sPath;
+		XMLDoc doc;
+		/** Whether @a sPath should be removed instead of written. */
+		bool bRemove;
+	};
+
+	void run();
+
+	std::deque<Job> m_jobs;
+	/** Whether a job was taken from #m_jobs but is not done yet. */
+	bool m_bBusy;
+	bool m_bShutdown;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_condition;
+	/** Notified each time a job is done. */
+	std::condition_variable m_finished;
+	std::thread m_thread;
+};
+
+};
+
+#endif
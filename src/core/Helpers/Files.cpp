@@ -43,9 +43,6 @@ namespace H2Core
 			case SAVE_PATH:
 				fileInfo = fileName;
 				break;
-			case SAVE_TMP:
-				fileInfo = Filesystem::tmp_file_path( fileName );
-				break;
 			default:
 				ERRORLOG( QString( "unknown mode : %1" ).arg( mode ) );
 				return nullptr;
@@ -45,7 +45,6 @@ class Files : public H2Core::Object<Files>
 			SAVE_NEW,				// construct regular path, do not overwrite
 			SAVE_OVERWRITE,			// construct regular path, overwrite existing file
 			SAVE_PATH,				// given filename is the path
-			SAVE_TMP,				// construct the path in save
 		};
 
 		/**
@@ -90,20 +89,6 @@ class Files : public H2Core::Object<Files>
 			return savePattern( SAVE_PATH, filePath, pattern, song, drumkitName );
 		}
 
-		/**
-		 * save the given pattern under \<Tmp_directory\> with a unique filename built from \<fileName\>
-		 * will overwrite an existing file
-		 * \param fileName to build filePath from
-		 * \param pattern the one to be saved
-		 * \param song to access license, author info
-		 * \param drumkitName to access name info
-		 * \return filePath on success, NULL on failure
-		 */
-		static inline QString savePatternTmp( const QString& fileName, Pattern* pattern, std::shared_ptr<Song> song, const QString& drumkitName )
-		{
-			return savePattern( SAVE_TMP, fileName, pattern, song, drumkitName );
-		}
-
 
 	private:
 		static QString savePattern( SaveMode mode, const QString& fileName, const Pattern* pattern, std::shared_ptr<Song> song, const QString& drumkitName );
@@ -75,6 +75,7 @@
 #define DRUMPAT_XSD     "drumkit_pattern.xsd"
 #define DRUMKIT_DEFAULT_KIT "GMRockKit"
 #define PLAYLIST_XSD     "playlist.xsd"
+#define SOUND_LIBRARY_INDEX "soundLibraryIndex.xml"
 
 #define AUTOSAVE        "autosave"
 
@@ -685,6 +686,10 @@ QString Filesystem::repositories_cache_dir()
 {
 	return __usr_data_path + CACHE + REPOSITORIES;
 }
+QString Filesystem::sound_library_index_path()
+{
+	return __usr_data_path + CACHE + SOUND_LIBRARY_INDEX;
+}
 QString Filesystem::demos_dir()
 {
 	return __sys_data_path + DEMOS;
@@ -207,6 +207,8 @@ namespace H2Core
 		static QString cache_dir();
 		/** returns user repository cache path */
 		static QString repositories_cache_dir();
+		/** returns the path to the metadata index of the sound library */
+		static QString sound_library_index_path();
 		/** returns system demos path */
 		static QString demos_dir();
 		/** returns system xsd path */
@@ -21,18 +21,174 @@
 
 #include <core/Helpers/Random.h>
 
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <thread>
+
 namespace H2Core {
 
+namespace {
+
+/** Seed requested via Random::setSeed(). */
+std::atomic<uint64_t> seed( 0 );
+/** Incremented on each call to Random::setSeed() to notify all
+ * thread-local generators. */
+std::atomic<int> nSeedGeneration( 0 );
+
+uint64_t splitMix64( uint64_t& nState ) {
+	uint64_t z = ( nState += 0x9e3779b97f4a7c15ULL );
+	z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+	z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+	return z ^ ( z >> 31 );
+}
+
+inline uint64_t rotl( const uint64_t x, int k ) {
+	return ( x << k ) | ( x >> ( 64 - k ) );
+}
+
+/** xoshiro256** by David Blackman and Sebastiano Vigna. */
+struct Generator {
+	uint64_t s[ 4 ];
+	int nGeneration = -1;
+
+	void reseed() {
+		nGeneration = nSeedGeneration.load( std::memory_order_acquire );
+		uint64_t nState = seed.load( std::memory_order_acquire );
+		if ( nState == 0 ) {
+			std::random_device device;
+			nState = ( static_cast<uint64_t>( device() ) << 32 ) ^ device() ^
+				std::hash<std::thread::id>()( std::this_thread::get_id() ) ^
+				static_cast<uint64_t>( std::chrono::high_resolution_clock::now()
+									   .time_since_epoch().count() );
+		}
+		for ( auto& ss : s ) {
+			ss = splitMix64( nState );
+		}
+	}
+
+	inline uint64_t next() {
+		if ( nGeneration != nSeedGeneration.load( std::memory_order_relaxed ) ) {
+			reseed();
+		}
+
+		const uint64_t result = rotl( s[ 1 ] * 5, 7 ) * 9;
+		const uint64_t t = s[ 1 ] << 17;
+		s[ 2 ] ^= s[ 0 ];
+		s[ 3 ] ^= s[ 1 ];
+		s[ 1 ] ^= s[ 2 ];
+		s[ 0 ] ^= s[ 3 ];
+		s[ 2 ] ^= t;
+		s[ 3 ] = rotl( s[ 3 ], 45 );
+		return result;
+	}
+
+	/** Uniform value within (0,1). Excluding 0 allows to take the
+	 * logarithm. */
+	inline double nextOpen() {
+		return ( static_cast<double>( next() >> 11 ) + 0.5 ) *
+			( 1.0 / 9007199254740992.0 );
+	}
+};
+
+thread_local Generator generator;
+
+/** Tables of the 128 layer ziggurat of Marsaglia and Tsang (2000). */
+struct Ziggurat {
+	static constexpr double fR = 3.442619855899;
+	uint32_t kn[ 128 ];
+	float wn[ 128 ];
+	float fn[ 128 ];
+
+	Ziggurat() {
+		const double m1 = 2147483648.0;
+		const double vn = 9.91256303526217e-3;
+		double dn = fR;
+		double tn = dn;
+		const double q = vn / std::exp( -0.5 * dn * dn );
+
+		kn[ 0 ] = static_cast<uint32_t>( ( dn / q ) * m1 );
+		kn[ 1 ] = 0;
+		wn[ 0 ] = static_cast<float>( q / m1 );
+		wn[ 127 ] = static_cast<float>( dn / m1 );
+		fn[ 0 ] = 1.0f;
+		fn[ 127 ] = static_cast<float>( std::exp( -0.5 * dn * dn ) );
+
+		for ( int ii = 126; ii >= 1; --ii ) {
+			dn = std::sqrt( -2.0 * std::log( vn / dn +
+											 std::exp( -0.5 * dn * dn ) ) );
+			kn[ ii + 1 ] = static_cast<uint32_t>( ( dn / tn ) * m1 );
+			tn = dn;
+			fn[ ii ] = static_cast<float>( std::exp( -0.5 * dn * dn ) );
+			wn[ ii ] = static_cast<float>( dn / m1 );
+		}
+	}
+};
+
+const Ziggurat ziggurat;
+
+inline uint32_t absolute( int32_t n ) {
+	return n < 0 ? 0u - static_cast<uint32_t>( n ) : static_cast<uint32_t>( n );
+}
+
+/** Standard normal variate. */
+float drawNormal() {
+	for ( ;; ) {
+		const int32_t hz = static_cast<int32_t>( generator.next() >> 32 );
+		const uint32_t iz = hz & 127;
+		const float x = hz * ziggurat.wn[ iz ];
+
+		// Fast path: the point lies within the rectangular part of the
+		// layer (about 99% of all draws).
+		if ( absolute( hz ) < ziggurat.kn[ iz ] ) {
+			return x;
+		}
+
+		if ( iz == 0 ) {
+			// Base layer. Sample from the tail.
+			double fX, fY;
+			do {
+				fX = -std::log( generator.nextOpen() ) / Ziggurat::fR;
+				fY = -std::log( generator.nextOpen() );
+			} while ( fY + fY < fX * fX );
+			return static_cast<float>( hz > 0 ? Ziggurat::fR + fX :
+									   -Ziggurat::fR - fX );
+		}
+
+		// Wedge of the layer.
+		if ( ziggurat.fn[ iz ] + generator.nextOpen() *
+			 ( ziggurat.fn[ iz - 1 ] - ziggurat.fn[ iz ] ) <
+			 std::exp( -0.5 * x * x ) ) {
+			return x;
+		}
+	}
+}
+
+};
+
 float Random::getGaussian( float fStandardDeviation ) {
-	// gaussian distribution -- dimss
-	float x1, x2, w;
-	do {
-		x1 = 2.0 * ( ( ( float ) rand() ) / static_cast<float>(RAND_MAX) ) - 1.0;
-		x2 = 2.0 * ( ( ( float ) rand() ) / static_cast<float>(RAND_MAX) ) - 1.0;
-		w = x1 * x1 + x2 * x2;
-	} while ( w >= 1.0 );
-
-	w = sqrtf( ( -2.0 * logf( w ) ) / w );
-	return x1 * w * fStandardDeviation + 0.0; // tunable
+	return drawNormal() * fStandardDeviation;
+}
+
+float Random::getUniform() {
+	return static_cast<float>( generator.next() >> 40 ) *
+		( 1.0f / 16777216.0f );
+}
+
+int Random::getInt( int nMax ) {
+	if ( nMax <= 0 ) {
+		return 0;
+	}
+	// Lemire's multiply-shift. Its bias is negligible for the small
+	// ranges used in here.
+	return static_cast<int>(
+		( ( generator.next() >> 32 ) * static_cast<uint64_t>( nMax ) ) >> 32 );
+}
+
+void Random::setSeed( uint64_t nSeed ) {
+	seed.store( nSeed, std::memory_order_release );
+	nSeedGeneration.fetch_add( 1, std::memory_order_acq_rel );
 }
 };
@@ -22,6 +22,8 @@
 #ifndef H2C_RANDOM_H
 #define H2C_RANDOM_H
 
+#include <cstdint>
+
 #include <core/Object.h>
 
 namespace H2Core
@@ -30,6 +32,15 @@ namespace H2Core
 /**
  * Container for functions generating random number.
  *
+ * Each thread draws from its own xoshiro256** generator. No state is
+ * shared between threads and no locking is involved, which makes all
+ * functions safe to use within the audio thread as well as in worker
+ * threads.
+ *
+ * By default the generators are seeded non-deterministically. Using
+ * setSeed() all of them can be reseeded to yield reproducible
+ * sequences, e.g. to render the same humanized song twice.
+ *
  * \ingroup docCore
  */
 class Random : public H2Core::Object<Random>
@@ -40,9 +51,28 @@ public:
 	 * Draws an uncorrelated random value from a Gaussian distribution
 	 * of mean 0 and @a fStandardDeviation.
 	 *
+	 * The ziggurat method is used. Apart from rare cases in the tail
+	 * of the distribution, this requires a single draw and a table
+	 * lookup.
+	 *
 	 * @param fStandardDeviation Defines the width of the distribution used.
 	 */
 	static float getGaussian( float fStandardDeviation );
+	/** Draws a uniformly distributed value within [0,1). */
+	static float getUniform();
+	/** Draws a uniformly distributed integer within [0,@a nMax). */
+	static int getInt( int nMax );
+
+	/**
+	 * Reseeds the generators of all threads.
+	 *
+	 * Since the generators are thread-local, this is done lazily on
+	 * the next draw within each thread.
+	 *
+	 * @param nSeed Seed used to derive the state of the generators. In
+	 *   case it is 0, they are seeded non-deterministically.
+	 */
+	static void setSeed( uint64_t nSeed );
 };
 
 };
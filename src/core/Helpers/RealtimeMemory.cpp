@@ -0,0 +1,197 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/Helpers/RealtimeMemory.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace H2Core {
+
+namespace {
+
+std::atomic<bool> bEnabled( false );
+std::atomic<size_t> nLockedBytes( 0 );
+/** Locks do not stack and buffers are not page aligned. Thus, the
+ * number of locked ranges touching a page is counted and a page is
+ * only unlocked once no range references it anymore. */
+std::mutex lockedPagesMutex;
+std::map<uintptr_t, int> lockedPages;
+/** Failures are reported just once. */
+std::atomic<bool> bLockFailureReported( false );
+
+size_t pageSize() {
+#ifndef WIN32
+	static const size_t nPageSize = static_cast<size_t>(sysconf( _SC_PAGESIZE ));
+	return nPageSize;
+#else
+	return 4096;
+#endif
+}
+
+/** First and one past the last page touched by the range. */
+std::pair<uintptr_t, uintptr_t> pageRange( const void* pData, size_t nBytes ) {
+	const uintptr_t nStart = reinterpret_cast<uintptr_t>(pData);
+	const uintptr_t nFirst = nStart - nStart % pageSize();
+	const uintptr_t nEnd = nStart + nBytes;
+	const uintptr_t nLast = nEnd + ( pageSize() - nEnd % pageSize() ) % pageSize();
+	return { nFirst, nLast };
+}
+
+}
+
+void RealtimeMemory::setEnabled( bool bNewEnabled ) {
+	bEnabled.store( bNewEnabled );
+	if ( bNewEnabled ) {
+		bLockFailureReported.store( false );
+	}
+}
+
+bool RealtimeMemory::isEnabled() {
+	return bEnabled.load( std::memory_order_relaxed );
+}
+
+bool RealtimeMemory::lock( const void* pData, size_t nBytes ) {
+	if ( ! isEnabled() || pData == nullptr || nBytes == 0 ) {
+		return false;
+	}
+
+	bool bLocked = false;
+#ifndef WIN32
+	const auto [ nFirst, nLast ] = pageRange( pData, nBytes );
+	std::lock_guard<std::mutex> pagesLock( lockedPagesMutex );
+	// Locking already locked pages again is harmless. The whole range
+	// is passed at once so it is either locked completely or not at
+	// all.
+	if ( mlock( reinterpret_cast<const void*>(nFirst), nLast - nFirst ) == 0 ) {
+		for ( uintptr_t nPage = nFirst; nPage < nLast; nPage += pageSize() ) {
+			if ( lockedPages[ nPage ]++ == 0 ) {
+				nLockedBytes.fetch_add( pageSize() );
+			}
+		}
+		bLocked = true;
+	}
+	else if ( ! bLockFailureReported.exchange( true ) ) {
+		WARNINGLOG( QString( "Unable to lock [%1] bytes into memory (already locked: [%2] bytes): %3. Consider raising the limit for locked memory (ulimit -l)." )
+					.arg( nBytes ).arg( nLockedBytes.load() )
+					.arg( strerror( errno ) ) );
+	}
+#endif
+
+	// mlock() does fault in all pages itself. But in case it failed we
+	// still want the memory to be resident right now.
+	if ( ! bLocked ) {
+		prefault( pData, nBytes );
+	}
+
+	return bLocked;
+}
+
+void RealtimeMemory::unlock( const void* pData, size_t nBytes ) {
+	if ( pData == nullptr || nBytes == 0 ) {
+		return;
+	}
+#ifndef WIN32
+	const auto [ nFirst, nLast ] = pageRange( pData, nBytes );
+	std::lock_guard<std::mutex> pagesLock( lockedPagesMutex );
+
+	// Pages still referenced by other locked ranges are skipped.
+	// Adjacent pages to be released are unlocked at once.
+	uintptr_t nRunStart = nLast;
+	auto unlockRun = [&]( uintptr_t nRunEnd ) {
+		if ( nRunStart < nRunEnd ) {
+			munlock( reinterpret_cast<const void*>(nRunStart),
+					 nRunEnd - nRunStart );
+			nLockedBytes.fetch_sub( nRunEnd - nRunStart );
+		}
+		nRunStart = nLast;
+	};
+	for ( uintptr_t nPage = nFirst; nPage < nLast; nPage += pageSize() ) {
+		auto it = lockedPages.find( nPage );
+		if ( it == lockedPages.end() ) {
+			// Not locked via lock().
+			unlockRun( nPage );
+			continue;
+		}
+		if ( --it->second > 0 ) {
+			unlockRun( nPage );
+			continue;
+		}
+		lockedPages.erase( it );
+		if ( nRunStart == nLast ) {
+			nRunStart = nPage;
+		}
+	}
+	unlockRun( nLast );
+#endif
+}
+
+void RealtimeMemory::prefault( const void* pData, size_t nBytes ) {
+	if ( pData == nullptr || nBytes == 0 ) {
+		return;
+	}
+
+	const volatile char* pBytes = static_cast<const volatile char*>(pData);
+	volatile char sink = 0;
+	for ( size_t ii = 0; ii < nBytes; ii += pageSize() ) {
+		sink = pBytes[ ii ];
+	}
+	sink = pBytes[ nBytes - 1 ];
+	(void)sink;
+}
+
+void RealtimeMemory::prefaultStack() {
+	volatile char stack[ nStackPrefaultSize ];
+	for ( size_t ii = 0; ii < nStackPrefaultSize; ii += pageSize() ) {
+		stack[ ii ] = 0;
+	}
+	(void)stack;
+}
+
+bool RealtimeMemory::getPageFaults( long& nMinor, long& nMajor ) {
+#if defined(__linux__) && defined(RUSAGE_THREAD)
+	struct rusage usage;
+	if ( getrusage( RUSAGE_THREAD, &usage ) == 0 ) {
+		nMinor = usage.ru_minflt;
+		nMajor = usage.ru_majflt;
+		return true;
+	}
+#endif
+	nMinor = 0;
+	nMajor = 0;
+	return false;
+}
+
+size_t RealtimeMemory::getLockedBytes() {
+	return nLockedBytes.load();
+}
+
+};
@@ -0,0 +1,94 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef H2C_REALTIME_MEMORY_H
+#define H2C_REALTIME_MEMORY_H
+
+#include <cstddef>
+
+#include <core/Object.h>
+
+namespace H2Core
+{
+
+/**
+ * Container for functions keeping memory accessed by the audio thread
+ * resident.
+ *
+ * A page fault within audioEngine_process() - e.g. on the first hit
+ * of a rarely used layer whose sample data was swapped out - can
+ * easily take longer than a whole process cycle. When enabled (see
+ * Preferences::m_bLockRealtimeMemory), sample data as well as the
+ * buffers of the audio engine and driver are locked into RAM using
+ * `mlock()` and all their pages are faulted in right away.
+ *
+ * Locking is subject to the `RLIMIT_MEMLOCK` resource limit of the
+ * user (`ulimit -l`). In case it does not suffice, the memory is still
+ * prefaulted but might be swapped out again later on.
+ *
+ * \ingroup docCore
+ */
+class RealtimeMemory : public H2Core::Object<RealtimeMemory>
+{
+	H2_OBJECT(RealtimeMemory)
+public:
+	static void setEnabled( bool bEnabled );
+	static bool isEnabled();
+
+	/**
+	 * Locks all pages touched by @a nBytes starting at @a pData into
+	 * RAM and faults them in.
+	 *
+	 * Does nothing unless enabled.
+	 *
+	 * \return whether the memory was locked. Only in this case unlock()
+	 *   must be called before it is freed.
+	 */
+	static bool lock( const void* pData, size_t nBytes );
+	/** Pages are reference counted. Those shared with other locked
+	 * ranges stay locked till they are unlocked as well. */
+	static void unlock( const void* pData, size_t nBytes );
+
+	/** Reads one byte of each page within @a nBytes starting at @a
+	 * pData. */
+	static void prefault( const void* pData, size_t nBytes );
+	/** Writes to the first #nStackPrefaultSize bytes of the stack of
+	 * the calling thread. */
+	static void prefaultStack();
+
+	/**
+	 * Retrieves the number of minor and major page faults of the
+	 * calling thread so far.
+	 *
+	 * \return whether the numbers are available on this platform.
+	 */
+	static bool getPageFaults( long& nMinor, long& nMajor );
+
+	/** Total amount of memory locked via lock(). Since whole pages
+	 * are locked, this is a multiple of the page size. */
+	static size_t getLockedBytes();
+
+	static constexpr size_t nStackPrefaultSize = 256 * 1024;
+};
+
+};
+
+#endif  // H2C_REALTIME_MEMORY_H
@@ -24,13 +24,18 @@
 #include <core/Helpers/Legacy.h>
 
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QLocale>
+#include <QtCore/QSaveFile>
 #include <QtCore/QString>
 #include <QtCore/QTextStream>
 #include <QtXmlPatterns/QXmlSchema>
 #include <QtXmlPatterns/QXmlSchemaValidator>
 #include <QAbstractMessageHandler>
 
+#include <map>
+#include <mutex>
+
 #define XMLNS_BASE "http://www.hydrogen-music.org/"
 #define XMLNS_XSI "http://www.w3.org/2001/XMLSchema-instance"
 
@@ -310,6 +315,107 @@ XMLDoc::XMLDoc( const QString& sSerialized ) {
 	setContent( sSerialized );
 }
 
+bool XMLDoc::validate( QIODevice* pDevice, const QString& sSchemaPath,
+						const QString& sFilePath, bool bSilent )
+{
+	// Compiling a schema is a lot more expensive than validating a document
+	// against it. Therefore, each schema is compiled only once and reused.
+	// Drumkits are loaded in parallel by the SoundLibraryDatabase. But
+	// since QXmlSchema is not meant to be used by several threads at once,
+	// the cache is guarded as a whole, validation included. Only files not
+	// complying with the current format are validated anyway.
+	static SilentMessageHandler handler;
+	static std::map<QString, QXmlSchema> schemaCache;
+	static std::mutex schemaMutex;
+	std::lock_guard<std::mutex> lock( schemaMutex );
+
+	auto it = schemaCache.find( sSchemaPath );
+	if ( it == schemaCache.end() ) {
+		QFile schemaFile( sSchemaPath );
+		if ( !schemaFile.open( QIODevice::ReadOnly ) ) {
+			// Non-fatal since a bricked setup (missing or ill-formatted XSD
+			// files) should not keep the user from loading valid files.
+			ERRORLOG( QString( "Unable to open XML schema [%1] for reading." )
+					  .arg( sSchemaPath ) );
+			return false;
+		}
+
+		QXmlSchema schema;
+		schema.setMessageHandler( &handler );
+		schema.load( &schemaFile, QUrl::fromLocalFile( schemaFile.fileName() ) );
+		schemaFile.close();
+
+		it = schemaCache.insert( { sSchemaPath, schema } ).first;
+	}
+
+	const QXmlSchema& schema = it->second;
+	if ( ! schema.isValid() ) {
+		// Non-fatal since a bricked setup (missing or ill-formatted XSD
+		// files) should not keep the user from loading valid files.
+		ERRORLOG( QString( "XML schema [%1] is not valid. File [%2] will not be validated" )
+				  .arg( sSchemaPath ).arg( sFilePath ) );
+		return false;
+	}
+
+	bool bValid = true;
+	QXmlSchemaValidator validator( schema );
+	if ( !validator.validate( pDevice, QUrl::fromLocalFile( sFilePath ) ) ) {
+		if ( ! bSilent ) {
+			WARNINGLOG( QString( "XML document [%1] is not valid with respect to schema [%2], loading may fail" )
+						.arg( sFilePath ).arg( sSchemaPath ) );
+		}
+		bValid = false;
+	}
+	else if ( ! bSilent ) {
+		INFOLOG( QString( "XML document [%1] is valid with respect to schema [%2]" )
+				 .arg( sFilePath ).arg( sSchemaPath ) );
+	}
+	pDevice->seek( 0 );
+
+	return bValid;
+}
+
+XMLNode XMLDoc::readElement( QXmlStreamReader& reader, QDomNode parent,
+							 const std::map<QString, QStringList>* pFormat )
+{
+	QDomElement element = createElement( reader.qualifiedName().toString() );
+	for ( const auto& attribute : reader.attributes() ) {
+		element.setAttribute( attribute.qualifiedName().toString(),
+							  attribute.value().toString() );
+	}
+	parent.appendChild( element );
+
+	const QStringList* pAllowed = nullptr;
+	if ( pFormat != nullptr ) {
+		const auto it = pFormat->find( element.tagName() );
+		if ( it != pFormat->end() ) {
+			pAllowed = &it->second;
+		}
+	}
+
+	while ( ! reader.atEnd() ) {
+		reader.readNext();
+		if ( reader.isEndElement() ) {
+			return element;
+		}
+		else if ( reader.isStartElement() ) {
+			if ( pAllowed != nullptr &&
+				 ! pAllowed->contains( reader.name().toString() ) ) {
+				return XMLNode();
+			}
+			if ( readElement( reader, element, pFormat ).isNull() ) {
+				return XMLNode();
+			}
+		}
+		else if ( reader.isCharacters() && ! reader.isWhitespace() ) {
+			element.appendChild( createTextNode( reader.text().toString() ) );
+		}
+	}
+
+	// End of the document reached before the element was closed.
+	return XMLNode();
+}
+
 bool XMLDoc::read( const QString& sFilePath, const QString& sSchemaPath,
 				   bool bSilent )
 {
@@ -320,52 +426,13 @@ bool XMLDoc::read( const QString& sFilePath, const QString& sSchemaPath,
 				  .arg( sFilePath ) );
 		return false;
 	}
-	
-	SilentMessageHandler handler;
-	QXmlSchema schema;
-	schema.setMessageHandler( &handler );
-	
-	bool bSchemaUsable = false;
+
 	bool bSuccess = true;
-	
 	if ( ! sSchemaPath.isEmpty() ) {
-		QFile file( sSchemaPath );
-		if ( !file.open( QIODevice::ReadOnly ) ) {
-			// Non-fatal since a bricked setup (missing or ill-formatted XSD
-			// files) should not keep the user from loading valid files.
-			ERRORLOG( QString( "Unable to open XML schema [%1] for reading." )
-					  .arg( sSchemaPath ) );
-			bSuccess = false;
-		} else {
-			schema.load( &file, QUrl::fromLocalFile( file.fileName() ) );
-			file.close();
-			if ( schema.isValid() ) {
-				bSchemaUsable = true;
-			} else {
-				// Non-fatal since a bricked setup (missing or ill-formatted XSD
-				// files) should not keep the user from loading valid files.
-				ERRORLOG( QString( "XML schema [%1] is not valid. File [%2] will not be validated" )
-						  .arg( sSchemaPath ).arg( sFilePath ) );
-				bSuccess = false;
-			}
-		}
-	}
-	
-	if ( bSchemaUsable ) {
-		QXmlSchemaValidator validator( schema );
-		if ( !validator.validate( &file, QUrl::fromLocalFile( file.fileName() ) ) ) {
-			if ( ! bSilent ) {
-				WARNINGLOG( QString( "XML document [%1] is not valid with respect to schema [%2], loading may fail" )
-							.arg( sFilePath ).arg( sSchemaPath ) );
-			}
-			file.close();
-			return false;
-		}
-		else if ( ! bSilent ) {
-			INFOLOG( QString( "XML document [%1] is valid with respect to schema [%2]" )
-					 .arg( sFilePath ).arg( sSchemaPath ) );
-		}
-		file.seek( 0 );
+		// Even if the document does not comply with the schema, we parse it
+		// nevertheless. This way callers falling back to a more lenient
+		// loading do not have to read the file again.
+		bSuccess = validate( &file, sSchemaPath, sFilePath, bSilent );
 	}
 
 	if ( Legacy::checkTinyXMLCompatMode( &file ) ) {
@@ -392,25 +459,51 @@ bool XMLDoc::read( const QString& sFilePath, const QString& sSchemaPath,
 	return bSuccess;
 }
 
-bool XMLDoc::write( const QString& filepath )
+bool XMLDoc::write( const QString& filepath ) const
 {
-	QFile file( filepath );
-	if ( !file.open( QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate ) ) {
+	// QSaveFile replaces the target by renaming a temporary file onto
+	// it, which would turn a symbolic link into a regular file. Links
+	// are written through in place instead.
+	if ( QFileInfo( filepath ).isSymLink() ) {
+		QFile file( filepath );
+		if ( !file.open( QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate ) ) {
+			ERRORLOG( QString( "Unable to open %1 for writing" ).arg( filepath ) );
+			return false;
+		}
+		QTextStream out( &file );
+		out.setCodec( "UTF-8" );
+		save( out, 1 );
+		out.flush();
+
+		if ( out.status() != QTextStream::Ok ) {
+			ERRORLOG( QString( "Unable to write %1" ).arg( filepath ) );
+			return false;
+		}
+		return true;
+	}
+
+	// The document is streamed into a temporary file which replaces
+	// the target only after it was written completely. An interrupted
+	// write thus never leaves a truncated file behind.
+	QSaveFile file( filepath );
+	// Required for targets within directories we are not allowed to
+	// create files in.
+	file.setDirectWriteFallback( true );
+	if ( !file.open( QIODevice::WriteOnly | QIODevice::Text ) ) {
 		ERRORLOG( QString( "Unable to open %1 for writing" ).arg( filepath ) );
 		return false;
 	}
 	QTextStream out( &file );
 	out.setCodec( "UTF-8" );
-	out << toString().toUtf8();
+	save( out, 1 );
 	out.flush();
 
-	bool rv = true;
-	if ( !toString().isEmpty() && file.size() == 0 ) {
-		rv = false;
+	if ( out.status() != QTextStream::Ok ) {
+		ERRORLOG( QString( "Unable to write %1" ).arg( filepath ) );
+		file.cancelWriting();
 	}
 
-	file.close();
-	return rv;
+	return file.commit();
 }
 
 XMLNode XMLDoc::set_root( const QString& node_name, const QString& xmlns )
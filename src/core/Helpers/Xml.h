@@ -26,8 +26,12 @@
 #include <core/Object.h>
 #include <QtCore/QString>
 #include <QColor>
+#include <QStringList>
+#include <QXmlStreamReader>
 #include <QtXml/QDomDocument>
 
+#include <map>
+
 namespace H2Core
 {
 
@@ -206,6 +210,10 @@ class XMLDoc : public H2Core::Object<XMLDoc>, public QDomDocument
 		XMLDoc( const QString& sSerialized );
 		/**
 		 * read the content of an xml file
+		 *
+		 * In case the file does not comply with @a schemapath, `false` is
+		 * returned but the document is still parsed.
+		 *
 		 * \param filepath the path to the file to read from
 		 * \param schemapath the path to the XML Schema file
 		 * \param bSilent Whether debug and info messages should be logged
@@ -213,11 +221,54 @@ class XMLDoc : public H2Core::Object<XMLDoc>, public QDomDocument
 		 */
 	bool read( const QString& filepath, const QString& schemapath = nullptr,
 			   bool bSilent = false );
+		/**
+		 * Validates the XML document provided by @a pDevice.
+		 *
+		 * The schema at @a sSchemaPath is compiled only once and reused
+		 * in all subsequent calls. Calls from several threads are
+		 * serialized.
+		 *
+		 * \param pDevice Opened device positioned at the beginning of the
+		 *   document. It will be rewound afterwards.
+		 * \param sSchemaPath the path to the XML Schema file
+		 * \param sFilePath path of the document used in log messages
+		 * \param bSilent Whether debug and info messages should be logged.
+		 *
+		 * \return `true` in case the document is valid. `false` if either
+		 *   it is not or the schema could not be loaded.
+		 */
+	static bool validate( QIODevice* pDevice, const QString& sSchemaPath,
+						  const QString& sFilePath, bool bSilent = false );
+		/**
+		 * Copies the element @a reader is positioned at - including its
+		 * attributes, text, and all child elements - into the document.
+		 *
+		 * This allows to stream a file and to build DOM nodes only for
+		 * the parts handled by one of the XMLNode based loaders.
+		 *
+		 * \param reader positioned at a start element. It will be placed
+		 *   at the corresponding end element afterwards.
+		 * \param parent node of this document the copy is appended to.
+		 * \param pFormat optional map of element names to the names of
+		 *   the child elements they are allowed to contain. Elements not
+		 *   listed in there might contain arbitrary children.
+		 *
+		 * \return the copied element. A null node in case the stream
+		 *   is malformed or contains an element not permitted by
+		 *   @a pFormat.
+		 */
+	XMLNode readElement( QXmlStreamReader& reader, QDomNode parent,
+						 const std::map<QString, QStringList>* pFormat = nullptr );
 		/**
 		 * write itself into a file
+		 *
+		 * The existing file is replaced only after the document was
+		 * written completely. Symbolic links are written through in
+		 * place to keep them intact.
+		 *
 		 * \param filepath the path to the file to write to
 		 */
-		bool write( const QString& filepath );
+		bool write( const QString& filepath ) const;
 		/**
 		 * create the xml header and root node
 		 * \param node_name the name of the rootnode to build
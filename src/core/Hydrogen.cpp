@@ -168,8 +168,6 @@ Hydrogen::~Hydrogen()
 	m_pAudioEngine->prepare();
 	m_pAudioEngine->unlock();
 
-	killInstruments();
-
 	delete m_pAudioEngine;
 
 	__instance = nullptr;
@@ -224,9 +222,9 @@ void Hydrogen::sequencerStop()
 	m_pAudioEngine->stop();
 	Preferences::get_instance()->setRecordEvents(false);
 
-	// Delete redundant instruments still alive after switching the
-	// drumkit to a smaller one.
-	killInstruments();
+	// Release instruments retired while their notes were still
+	// ringing right away.
+	m_pAudioEngine->getReclaimer()->reclaim();
 }
 
 Song::PlaybackTrack Hydrogen::getPlaybackTrackState() const {
@@ -668,6 +666,9 @@ bool Hydrogen::startExportSession( int nSampleRate, int nSampleDepth )
 	
 	pDiskWriterDriver->setSampleRate( static_cast<unsigned>(nSampleRate) );
 	pDiskWriterDriver->setSampleDepth( nSampleDepth );
+	// The rate is only known after creating the driver. Rendering does
+	// not start before write() is called.
+	pAudioEngine->updateTargetSampleRate( nSampleRate );
 
 	m_bExportSessionIsActive = true;
 
@@ -1076,49 +1077,29 @@ void Hydrogen::onJackMaster()
 #endif
 }
 
-void Hydrogen::addInstrumentToDeathRow( std::shared_ptr<Instrument> pInstr ) {
-	m_instrumentDeathRow.push_back( pInstr );
-	killInstruments();
-}
+void Hydrogen::retireInstrument( std::shared_ptr<Instrument> pInstr ) {
+	if ( pInstr == nullptr ) {
+		return;
+	}
 
-void Hydrogen::removeInstrumentFromDeathRow( std::shared_ptr<Instrument> pInstr ) {
-	for ( auto it = m_instrumentDeathRow.begin();
-		  it != m_instrumentDeathRow.end(); ) {
-        if ( *it == pInstr ) {
-            it = m_instrumentDeathRow.erase( it );
-		} else {
-            ++it;
-		}
-    }
+	// The raw pointer is safe to use within the predicate and the
+	// release callback since the reclaimer holds a reference to the
+	// instrument till both are done.
+	Instrument* pRawInstr = pInstr.get();
+	m_pAudioEngine->getReclaimer()->retire(
+		pInstr,
+		[=]() { return ! pRawInstr->is_queued(); },
+		[=]() { pRawInstr->unload_samples(); } );
 }
 
-void Hydrogen::killInstruments() {
-	std::shared_ptr<Instrument> pInstr;
-
-	while ( m_instrumentDeathRow.size() > 0 &&
-			( m_instrumentDeathRow.front() == nullptr ||
-			  ( m_instrumentDeathRow.front() != nullptr &&
-				m_instrumentDeathRow.front()->is_queued() == 0 ) ) ) {
-		pInstr = m_instrumentDeathRow.front();
-		m_instrumentDeathRow.pop_front();
-
-		if ( pInstr != nullptr  ) {
-			pInstr->unload_samples();
-		}
+void Hydrogen::reviveInstrument( std::shared_ptr<Instrument> pInstr ) {
+	if ( pInstr == nullptr ) {
+		return;
 	}
 
-	if ( m_instrumentDeathRow.size() > 0 ) {
-		pInstr = m_instrumentDeathRow.front();
-		if ( pInstr != nullptr ) {
-			INFOLOG( QString( "Instrument [%1] still has active notes:\n\t%2 " )
-					 .arg( pInstr->get_name() )
-					 .arg( pInstr->getEnqueuedBy().join( "\n\t" ) ) );
-		}
-	}
+	m_pAudioEngine->getReclaimer()->revive( pInstr );
 }
 
-
-
 void Hydrogen::panic()
 {
 	m_pAudioEngine->lock( RIGHT_HERE );
@@ -1352,7 +1333,9 @@ void Hydrogen::startNsmClient()
 
 void Hydrogen::setIsModified( bool bIsModified ) {
 	if ( getSong() != nullptr ) {
-		if ( getSong()->getIsModified() != bIsModified ) {
+		// Every edit has to be passed on, even if the song is already
+		// marked modified, in order to bump its revision.
+		if ( bIsModified || getSong()->getIsModified() ) {
 			getSong()->setIsModified( bIsModified );
 		}
 	}
@@ -1611,14 +1594,6 @@ QString Hydrogen::toQString( const QString& sPrefix, bool bShort ) const {
 		} else {
 			sOutput.append( QString( "nullptr\n" ) );
 		}
-		sOutput.append( QString( "%1%2m_instrumentDeathRow:\n" ).arg( sPrefix ).arg( s ) );
-		for ( const auto& ii : m_instrumentDeathRow ) {
-			if ( ii != nullptr ) {
-				sOutput.append( QString( "%1" ).arg( ii->toQString( sPrefix + s + s, bShort ) ) );
-			} else {
-				sOutput.append( QString( "nullptr\n" ) );
-			}
-		}
 		sOutput.append( QString( "%1%2m_nSelectedInstrumentNumber: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_nSelectedInstrumentNumber ) )
 			.append( QString( "%1%2m_nSelectedPatternNumber: %3\n" ).arg( sPrefix ).arg( s )
@@ -1684,14 +1659,6 @@ QString Hydrogen::toQString( const QString& sPrefix, bool bShort ) const {
 		} else {
 			sOutput.append( QString( "nullptr" ) );
 		}						 
-		sOutput.append( QString( ", m_instrumentDeathRow: [" ) );
-		for ( const auto& ii : m_instrumentDeathRow ) {
-			if ( ii != nullptr ) {
-				sOutput.append( QString( "%1" ).arg( ii->toQString( sPrefix + s + s, bShort ) ) );
-			} else {
-				sOutput.append( QString( " nullptr" ) );
-			}
-		}
 		sOutput.append( QString( ", m_nSelectedInstrumentNumber: %1" )
 						.arg( m_nSelectedInstrumentNumber ) )
 			.append( QString( ", m_nSelectedPatternNumber: %1" )
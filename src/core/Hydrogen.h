@@ -179,7 +179,7 @@ public:
 		 * Get the current song.
 		 * \return #m_pSong
 		 */ 	
-		std::shared_ptr<Song>			getSong() const{ return m_pSong; }
+		const std::shared_ptr<Song>&	getSong() const{ return m_pSong; }
 		/**
 		 * Sets the current song #m_pSong to @a pNewSong.
 		 * \param pNewSong Pointer to the new Song object.
@@ -414,22 +414,23 @@ public:
 	bool			getSessionIsExported() const;
 
 	/**
-	 * Add @a pInstr to death row.
+	 * Retires @a pInstr after it was removed from the current kit.
 	 *
 	 * Since there might still be some notes using @a pInstr left in one of the
 	 * note queues, the instrument's samples must not be unloaded right away
 	 * (the instrumet's destructor might not be called after deleting it since
-	 * it might live on in the undo/redo stack of the GUI). Instead, this
-	 * function will add it to a list of instruments marked for deletion and it
-	 * will be dealt with at a later time (after audio rendering was stopped).
+	 * it might live on in the undo/redo stack of the GUI). Instead, it is
+	 * handed to the #EpochReclaimer of the #AudioEngine, which unloads the
+	 * samples as soon as no note references the instrument anymore and the
+	 * audio thread finished the process cycle it might have been used in.
 	 */
-	void addInstrumentToDeathRow( std::shared_ptr<Instrument> pInstr );
+	void retireInstrument( std::shared_ptr<Instrument> pInstr );
 
-		/** Since we are flushing the samples of the instruments in the death
-		 * row at a delayed point in time (like when stopping transport), we
-		 * have to take care not to get into trouble when switching
-		 * instrument/kits back and forth (like in undo/redo). */
-		void removeInstrumentFromDeathRow( std::shared_ptr<Instrument> pInstr );
+		/** Since the samples of retired instruments are unloaded at a
+		 * delayed point in time, we have to take care not to get into
+		 * trouble when switching instrument/kits back and forth (like in
+		 * undo/redo). */
+		void reviveInstrument( std::shared_ptr<Instrument> pInstr );
 
 	/**
 	 * Processes the patterns added to any virtual ones in the
@@ -465,8 +466,6 @@ private:
 	 */
 	Hydrogen();
 
-		void killInstruments();
-
 	void			midiNoteOn( Note *note );
 
 	/**
@@ -531,9 +530,6 @@ private:
 	 */
 	std::shared_ptr<Timeline>	m_pTimeline;
 
-	/// Deleting instruments too soon leads to potential crashes.
-	std::list<std::shared_ptr<Instrument>> 	m_instrumentDeathRow;
-	
 	/**
 	 * Instrument currently focused/selected in the GUI. 
 	 *
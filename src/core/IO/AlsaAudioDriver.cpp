@@ -26,8 +26,15 @@
 
 #include <pthread.h>
 #include <iostream>
+#include <utility>
+#include <vector>
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/AudioEngine/ProcessProfiler.h>
 #include <core/Preferences/Preferences.h>
 #include <core/EventQueue.h>
+#include <core/Helpers/RealtimeMemory.h>
+#include <core/Hydrogen.h>
+#include <core/IO/PcmConverter.h>
 
 namespace H2Core
 {
@@ -53,6 +60,89 @@ static int alsa_xrun_recovery( snd_pcm_t *handle, int err )
 	return err;
 }
 
+/**
+ * Converts @a nFrames frames of the output buffers of @a pDriver
+ * directly into the memory mapped ring buffer of the device.
+ *
+ * The mapped area might wrap around the end of the ring buffer.
+ * Therefore, it is filled in as many chunks as required.
+ *
+ * \return 0 on success or a negative error code.
+ */
+static int alsa_write_mmap( AlsaAudioDriver* pDriver, int nFrames )
+{
+	snd_pcm_t* pHandle = pDriver->m_pPlayback_handle;
+
+	// Required by snd_pcm_mmap_begin() to update the positions of the
+	// ring buffer.
+	snd_pcm_sframes_t nAvailable = snd_pcm_avail_update( pHandle );
+	if ( nAvailable < 0 ) {
+		return static_cast<int>(nAvailable);
+	}
+
+	int nWritten = 0;
+	while ( nWritten < nFrames ) {
+		const snd_pcm_channel_area_t* pAreas;
+		snd_pcm_uframes_t nOffset;
+		snd_pcm_uframes_t nChunk = nFrames - nWritten;
+		int err = snd_pcm_mmap_begin( pHandle, &pAreas, &nOffset, &nChunk );
+		if ( err < 0 ) {
+			return err;
+		}
+		if ( nChunk == 0 ) {
+			// Ring buffer is full. Wait for the device to consume the
+			// frames written so far.
+			if ( ( err = snd_pcm_wait( pHandle, 100 ) ) < 0 ) {
+				return err;
+			}
+			snd_pcm_avail_update( pHandle );
+			continue;
+		}
+
+		// Both channels are interleaved in the first area.
+		char* pDest = static_cast<char*>(pAreas[ 0 ].addr) +
+			pAreas[ 0 ].first / 8 + nOffset * ( pAreas[ 0 ].step / 8 );
+		pDriver->m_pConverter->convert( pDriver->m_pOut_L + nWritten,
+										pDriver->m_pOut_R + nWritten,
+										pDest, static_cast<int>(nChunk) );
+
+		const snd_pcm_sframes_t nCommitted =
+			snd_pcm_mmap_commit( pHandle, nOffset, nChunk );
+		if ( nCommitted < 0 ) {
+			return static_cast<int>(nCommitted);
+		}
+		else if ( static_cast<snd_pcm_uframes_t>(nCommitted) != nChunk ) {
+			return -EPIPE;
+		}
+		nWritten += static_cast<int>(nChunk);
+	}
+
+	// Playback does not start on its own in case the start threshold
+	// exceeds the frames written (e.g. after recovering from an XRUN).
+	if ( snd_pcm_state( pHandle ) == SND_PCM_STATE_PREPARED ) {
+		return snd_pcm_start( pHandle );
+	}
+
+	return 0;
+}
+
+/** Writes @a nFrames frames of the output buffers of @a pDriver to the
+ * device using the access type negotiated in
+ * AlsaAudioDriver::connect().
+ *
+ * \return a negative error code on failure. */
+static int alsa_write( AlsaAudioDriver* pDriver, int nFrames )
+{
+	if ( pDriver->m_bMmap ) {
+		return alsa_write_mmap( pDriver, nFrames );
+	}
+
+	pDriver->m_pConverter->convert( pDriver->m_pOut_L, pDriver->m_pOut_R,
+									pDriver->m_pBuffer, nFrames );
+	return snd_pcm_writei( pDriver->m_pPlayback_handle, pDriver->m_pBuffer,
+						   nFrames );
+}
+
 void* alsaAudioDriver_processCaller( void* param )
 {
 	Base *__object = (Base*)param;
@@ -78,22 +168,20 @@ void* alsaAudioDriver_processCaller( void* param )
 
 	int nFrames = pDriver->m_nBufferSize;
 	__INFOLOG( QString( "nFrames: %1" ).arg( nFrames ) );
-	short pBuffer[ nFrames * 2 ];
 
-	float *pOut_L = pDriver->m_pOut_L;
-	float *pOut_R = pDriver->m_pOut_R;
+	if ( RealtimeMemory::isEnabled() ) {
+		RealtimeMemory::prefaultStack();
+	}
 
 	int nTimeoutInMilliseconds = 100;
 
+	ProcessProfiler* pProfiler =
+		Hydrogen::get_instance()->getAudioEngine()->getProfiler();
+
 	while ( pDriver->m_bIsRunning ) {
 		// prepare the audio data
 		pDriver->m_processCallback( nFrames, nullptr );
 
-		for ( int i = 0; i < nFrames; ++i ) {
-			pBuffer[ i * 2 ] = ( short )( pOut_L[ i ] * 32768.0 );
-			pBuffer[ i * 2 + 1 ] = ( short )( pOut_R[ i ] * 32768.0 );
-		}
-
 		// Check whether the playback stream is ready to process
 		// input.
 		if ( ( err = snd_pcm_wait( pDriver->m_pPlayback_handle,
@@ -114,10 +202,10 @@ void* alsaAudioDriver_processCaller( void* param )
 			pDriver->m_nXRuns++;
 			EventQueue::get_instance()->push_event( EVENT_XRUN, 0 );
 		} else {
-
 			// Playback stream is ready, let's write out the audio
 			// buffer.
-			if ( ( err = snd_pcm_writei( pDriver->m_pPlayback_handle, pBuffer, nFrames ) ) < 0 ) {
+			const int64_t nStart = ProcessProfiler::now();
+			if ( ( err = alsa_write( pDriver, nFrames ) ) < 0 ) {
 				___ERRORLOG( QString( "Error while writing playback stream: %1" )
 							 .arg( snd_strerror( err ) ) );
 
@@ -125,7 +213,7 @@ void* alsaAudioDriver_processCaller( void* param )
 				// again and retry writing the output buffer.
 				if ( ( err = snd_pcm_recover( pDriver->m_pPlayback_handle, err, 0 ) ) == 0 ) {
 					___INFOLOG( "Successfully recovered from error. Attempt to write buffer again." );
-					if ( ( err = snd_pcm_writei( pDriver->m_pPlayback_handle, pBuffer, nFrames ) ) < 0 ) {
+					if ( ( err = alsa_write( pDriver, nFrames ) ) < 0 ) {
 						___ERRORLOG( QString( "Unable to write playback stream again: %1" )
 									 .arg( snd_strerror( err ) ) );
 						pDriver->m_nXRuns++;
@@ -142,6 +230,8 @@ void* alsaAudioDriver_processCaller( void* param )
 					EventQueue::get_instance()->push_event( EVENT_XRUN, 0 );
 				}
 			}
+			pProfiler->record( ProcessProfiler::Stage::DriverIO,
+							   ProcessProfiler::now() - nStart );
 		}
 	}
 	return nullptr;
@@ -189,6 +279,11 @@ AlsaAudioDriver::AlsaAudioDriver( audioProcessCallback processCallback )
 		, m_nBufferSize( 0 )
 		, m_pPlayback_handle( nullptr )
 		, m_processCallback( processCallback )
+		, m_bMmap( false )
+		, m_pConverter( nullptr )
+		, m_pBuffer( nullptr )
+		, m_nBufferBytes( 0 )
+		, m_bBufferLocked( false )
 {
 	m_nSampleRate = Preferences::get_instance()->m_nSampleRate;
 	m_sAlsaAudioDevice = Preferences::get_instance()->m_sAlsaAudioDevice;
@@ -271,21 +366,57 @@ int AlsaAudioDriver::connect()
 				  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
 		return 1;
 	}
-//	snd_pcm_hw_params_set_access( m_pPlayback_handle, hw_params, SND_PCM_ACCESS_MMAP_INTERLEAVED  );
 
+	// Writing directly into the ring buffer of the device saves a copy
+	// per period. Not all devices (and plugins) support it though.
+	m_bMmap = true;
 	if ( ( err = snd_pcm_hw_params_set_access( m_pPlayback_handle,
 											   hw_params,
-											   SND_PCM_ACCESS_RW_INTERLEAVED ) ) < 0 ) {
-		ERRORLOG( QString( "error in snd_pcm_hw_params_set_access: %1" )
-				  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
-		return 1;
+											   SND_PCM_ACCESS_MMAP_INTERLEAVED ) ) < 0 ) {
+		WARNINGLOG( QString( "Memory mapped access not supported by device [%1]: %2. Falling back to snd_pcm_writei." )
+					.arg( m_sAlsaAudioDevice )
+					.arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
+		m_bMmap = false;
+		if ( ( err = snd_pcm_hw_params_set_access( m_pPlayback_handle,
+												   hw_params,
+												   SND_PCM_ACCESS_RW_INTERLEAVED ) ) < 0 ) {
+			ERRORLOG( QString( "error in snd_pcm_hw_params_set_access: %1" )
+					  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
+			return 1;
+		}
 	}
 
-	if ( ( err = snd_pcm_hw_params_set_format( m_pPlayback_handle,
-											   hw_params,
-											   SND_PCM_FORMAT_S16_LE ) ) < 0 ) {
-		ERRORLOG( QString( "error in snd_pcm_hw_params_set_format: %1" )
-				  .arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
+	// Use the widest sample format supported by the device. This way
+	// precision is only lost - if at all - in plugins of the device
+	// instead of in here.
+	const std::vector<std::pair<snd_pcm_format_t, PcmConverter::Format>> formats = {
+		{ SND_PCM_FORMAT_FLOAT, PcmConverter::Format::Float },
+		{ SND_PCM_FORMAT_S32, PcmConverter::Format::S32 },
+		{ SND_PCM_FORMAT_S24, PcmConverter::Format::S24 },
+		{ SND_PCM_FORMAT_S24_3LE, PcmConverter::Format::S24_3LE },
+		{ SND_PCM_FORMAT_S16, PcmConverter::Format::S16 } };
+	bool bFormatFound = false;
+	PcmConverter::Format format = PcmConverter::Format::S16;
+	for ( const auto& [ alsaFormat, converterFormat ] : formats ) {
+		if ( snd_pcm_hw_params_test_format( m_pPlayback_handle, hw_params,
+											alsaFormat ) != 0 ) {
+			continue;
+		}
+		if ( ( err = snd_pcm_hw_params_set_format( m_pPlayback_handle,
+												   hw_params,
+												   alsaFormat ) ) < 0 ) {
+			WARNINGLOG( QString( "error in snd_pcm_hw_params_set_format [%1]: %2" )
+						.arg( snd_pcm_format_name( alsaFormat ) )
+						.arg( QString::fromLocal8Bit(snd_strerror(err)) ) );
+			continue;
+		}
+		format = converterFormat;
+		bFormatFound = true;
+		break;
+	}
+	if ( ! bFormatFound ) {
+		ERRORLOG( QString( "Audio device [%1] does not support any of the available sample formats" )
+				  .arg( m_sAlsaAudioDevice ) );
 		return 1;
 	}
 
@@ -343,6 +474,21 @@ int AlsaAudioDriver::connect()
 	INFOLOG( QString( "*** SAMPLE RATE: %1" ).arg( m_nSampleRate ) );
 	INFOLOG( QString( "*** BUFFER SIZE: %1" ).arg( nPeriods * m_nBufferSize ) );
 
+	m_pConverter = new PcmConverter(
+		format, Preferences::get_instance()->m_bAlsaDither );
+	INFOLOG( QString( "*** SAMPLE FORMAT: %1 (%2)" )
+			 .arg( PcmConverter::FormatToQString( format ) )
+			 .arg( m_bMmap ? "mmap" : "rw" ) );
+
+	if ( ! m_bMmap ) {
+		m_nBufferBytes = m_nBufferSize * 2 * m_pConverter->getSampleSize();
+		m_pBuffer = new char[ m_nBufferBytes ];
+		memset( m_pBuffer, 0, m_nBufferBytes );
+		if ( RealtimeMemory::isEnabled() ) {
+			m_bBufferLocked = RealtimeMemory::lock( m_pBuffer, m_nBufferBytes );
+		}
+	}
+
 	//snd_pcm_hw_params_free( hw_params );
 
 	m_pOut_L = new float[ m_nBufferSize ];
@@ -379,6 +525,27 @@ void AlsaAudioDriver::disconnect()
 
 	delete[] m_pOut_R;
 	m_pOut_R = nullptr;
+
+	if ( m_pBuffer != nullptr ) {
+		if ( m_bBufferLocked ) {
+			RealtimeMemory::unlock( m_pBuffer, m_nBufferBytes );
+			m_bBufferLocked = false;
+		}
+		delete[] static_cast<char*>(m_pBuffer);
+		m_pBuffer = nullptr;
+		m_nBufferBytes = 0;
+	}
+
+	delete m_pConverter;
+	m_pConverter = nullptr;
+}
+
+QString AlsaAudioDriver::getSampleFormat() const
+{
+	if ( m_pConverter == nullptr ) {
+		return "";
+	}
+	return PcmConverter::FormatToQString( m_pConverter->getFormat() );
 }
 
 unsigned AlsaAudioDriver::getBufferSize()
@@ -415,14 +582,20 @@ QString AlsaAudioDriver::toQString( const QString& sPrefix, bool bShort ) const
 			.append( QString( "%1%2m_nXRuns: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_nXRuns ) )
 			.append( QString( "%1%2m_nSampleRate: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( m_nSampleRate ) );
+					 .arg( m_nSampleRate ) )
+			.append( QString( "%1%2m_bMmap: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_bMmap ) )
+			.append( QString( "%1%2sample format: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( getSampleFormat() ) );
 	} else {
 		sOutput = QString( "[AlsaAudioDriver]" )
 			.append( QString( " m_bIsRunning: %1" ).arg( m_bIsRunning ) )
 			.append( QString( ", m_nBufferSize: %1" ).arg( m_nBufferSize ) )
 			.append( QString( ", m_sAlsaAudioDevice: %1" ).arg( m_sAlsaAudioDevice ) )
 			.append( QString( ", m_nXRuns: %1" ).arg( m_nXRuns ) )
-			.append( QString( ", m_nSampleRate: %1" ).arg( m_nSampleRate ) );
+			.append( QString( ", m_nSampleRate: %1" ).arg( m_nSampleRate ) )
+			.append( QString( ", m_bMmap: %1" ).arg( m_bMmap ) )
+			.append( QString( ", sample format: %1" ).arg( getSampleFormat() ) );
 	}
 
 	return sOutput;
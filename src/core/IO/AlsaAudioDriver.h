@@ -33,6 +33,8 @@
 namespace H2Core
 {
 
+class PcmConverter;
+
 /** \ingroup docCore docAudioDriver */
 class AlsaAudioDriver : public Object<AlsaAudioDriver>, public AudioOutput
 {
@@ -46,6 +48,16 @@ public:
 	QString m_sAlsaAudioDevice;
 	audioProcessCallback m_processCallback;
 	int m_nXRuns;
+	/** Whether frames are written directly into the memory mapped ring
+	 * buffer of the device or - in case the device does not support
+	 * it - using snd_pcm_writei() and #m_pBuffer. */
+	bool m_bMmap;
+	/** Converts #m_pOut_L and #m_pOut_R into the sample format
+	 * negotiated in connect(). */
+	PcmConverter* m_pConverter;
+	/** Interleaved buffer passed to snd_pcm_writei() in case #m_bMmap
+	 * is false. */
+	void* m_pBuffer;
 
 	AlsaAudioDriver( audioProcessCallback processCallback );
 	~AlsaAudioDriver();
@@ -60,11 +72,17 @@ public:
 	static QStringList getDevices();
 
 	virtual int getXRuns() const override { return m_nXRuns; }
+	/** \return Sample format negotiated with the device or an empty
+	 * string in case the driver is not connected. */
+	QString getSampleFormat() const;
 
 	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
 private:
 
 	unsigned int m_nSampleRate;
+	/** Size of #m_pBuffer in bytes. */
+	size_t m_nBufferBytes;
+	bool m_bBufferLocked;
 };
 
 #else
@@ -122,7 +122,8 @@ JackAudioDriver* JackAudioDriver::pJackDriverInstance = nullptr;
 
 JackAudioDriver::JackAudioDriver( JackProcessCallback m_processCallback )
 	: AudioOutput()
-	, m_nTrackPortCount( 0 )
+	, m_pTrackOutputs( nullptr )
+	, m_pResolvedTrackOutputs( nullptr )
 	, m_pClient( nullptr )
 	, m_pOutputPort1( nullptr )
 	, m_pOutputPort2( nullptr )
@@ -149,9 +150,6 @@ JackAudioDriver::JackAudioDriver( JackProcessCallback m_processCallback )
 	m_sOutputPortName1 = pPreferences->m_sJackPortName1;
 	m_sOutputPortName2 = pPreferences->m_sJackPortName2;
 
-	memset( m_pTrackOutputPortsL, 0, sizeof(m_pTrackOutputPortsL) );
-	memset( m_pTrackOutputPortsR, 0, sizeof(m_pTrackOutputPortsR) );
-
 	m_JackTransportState  = JackTransportStopped;
 }
 
@@ -269,8 +267,12 @@ void JackAudioDriver::deactivate()
 			ERRORLOG( "Error in jack_deactivate" );
 		}
 	}
-	memset( m_pTrackOutputPortsL, 0, sizeof(m_pTrackOutputPortsL) );
-	memset( m_pTrackOutputPortsR, 0, sizeof(m_pTrackOutputPortsR) );
+
+	// The process callback is not called anymore.
+	delete m_pTrackOutputs.exchange( nullptr );
+	m_pResolvedTrackOutputs = nullptr;
+	m_trackOutputPortsL.clear();
+	m_trackOutputPortsR.clear();
 }
 
 unsigned JackAudioDriver::getBufferSize()
@@ -283,23 +285,41 @@ unsigned JackAudioDriver::getSampleRate()
 	return JackAudioDriver::jackServerSampleRate;
 }
 
-void JackAudioDriver::clearPerTrackAudioBuffers( uint32_t nFrames )
+void JackAudioDriver::resolveTrackOutputs( uint32_t nFrames )
 {
-	if ( m_pClient != nullptr &&
-		 Preferences::get_instance()->m_bJackTrackOuts ) {
-		float* pBuffer;
-
-		for ( int ii = 0; ii < m_nTrackPortCount; ++ii ) {
-			pBuffer = getTrackOut_L( ii );
-			if ( pBuffer != nullptr ) {
-				memset( pBuffer, 0, nFrames * sizeof( float ) );
-			}
-			pBuffer = getTrackOut_R( ii );
-			if ( pBuffer != nullptr ) {
-				memset( pBuffer, 0, nFrames * sizeof( float ) );
-			}
+	m_pResolvedTrackOutputs = nullptr;
+	if ( m_pClient == nullptr ||
+		 ! Preferences::get_instance()->m_bJackTrackOuts ) {
+		return;
+	}
+
+	auto pTrackOutputs = m_pTrackOutputs.load( std::memory_order_acquire );
+	if ( pTrackOutputs == nullptr ) {
+		return;
+	}
+
+	for ( size_t ii = 0; ii < pTrackOutputs->portsL.size(); ++ii ) {
+		float* pBuffer_L = nullptr;
+		float* pBuffer_R = nullptr;
+		if ( pTrackOutputs->portsL[ ii ] != nullptr ) {
+			pBuffer_L = static_cast<jack_default_audio_sample_t*>(
+				jack_port_get_buffer( pTrackOutputs->portsL[ ii ], nFrames ) );
+		}
+		if ( pTrackOutputs->portsR[ ii ] != nullptr ) {
+			pBuffer_R = static_cast<jack_default_audio_sample_t*>(
+				jack_port_get_buffer( pTrackOutputs->portsR[ ii ], nFrames ) );
+		}
+		if ( pBuffer_L != nullptr ) {
+			memset( pBuffer_L, 0, nFrames * sizeof( float ) );
 		}
+		if ( pBuffer_R != nullptr ) {
+			memset( pBuffer_R, 0, nFrames * sizeof( float ) );
+		}
+		pTrackOutputs->buffersL[ ii ] = pBuffer_L;
+		pTrackOutputs->buffersR[ ii ] = pBuffer_R;
 	}
+
+	m_pResolvedTrackOutputs = pTrackOutputs;
 }
 
 const jack_position_t& JackAudioDriver::getJackPosition() const {
@@ -796,47 +816,6 @@ float* JackAudioDriver::getOut_R()
 	return out;
 }
 
-float* JackAudioDriver::getTrackOut_L( unsigned nTrack )
-{
-	if ( nTrack > static_cast<unsigned>(m_nTrackPortCount) ) {
-		return nullptr;
-	}
-
-	jack_port_t* pPort = m_pTrackOutputPortsL[nTrack];
-	jack_default_audio_sample_t* out = nullptr;
-	if( pPort ) {
-		out = static_cast<jack_default_audio_sample_t*>(jack_port_get_buffer( pPort, JackAudioDriver::jackServerBufferSize));
-	}
-	return out;
-}
-
-float* JackAudioDriver::getTrackOut_R( unsigned nTrack )
-{
-	if( nTrack > static_cast<unsigned>(m_nTrackPortCount) ) {
-		return nullptr;
-	}
-
-	jack_port_t* pPort = m_pTrackOutputPortsR[nTrack];
-	jack_default_audio_sample_t* out = nullptr;
-	if( pPort ) {
-		out = static_cast<jack_default_audio_sample_t*>(jack_port_get_buffer( pPort, JackAudioDriver::jackServerBufferSize));
-	}
-	return out;
-}
-
-float* JackAudioDriver::getTrackOut_L( std::shared_ptr<Instrument> instr,
-									   int nComponentIdx )
-{
-	return getTrackOut_L(m_trackMap[instr->get_id()][ nComponentIdx ]);
-}
-
-float* JackAudioDriver::getTrackOut_R( std::shared_ptr<Instrument> instr,
-									   int nComponentIdx )
-{
-	return getTrackOut_R(m_trackMap[instr->get_id()][ nComponentIdx ]);
-}
-
-
 #define CLIENT_FAILURE(msg) {						\
 	ERRORLOG("Could not connect to JACK server (" msg ")"); 	\
 	if ( m_pClient != nullptr ) {						\
@@ -1078,19 +1057,32 @@ void JackAudioDriver::makeTrackOutputs( std::shared_ptr<Song> pSong )
 
 	WARNINGLOG( QString( "Creating / renaming %1 ports" ).arg( nInstruments ) );
 
+	// The table is assembled aside and handed over to the realtime
+	// thread once complete. This way no lock is held while talking to
+	// the JACK server.
+	auto pTrackOutputs = new TrackOutputs;
 	int nTrackCount = 0;
 
-	for( int i = 0 ; i < MAX_INSTRUMENTS ; i++ ){
-		for ( int j = 0 ; j < MAX_COMPONENTS ; j++ ){
-			m_trackMap[i][j] = 0;
-		}
+	int nMaxId = -1;
+	for ( int n = 0; n < nInstruments; n++ ) {
+		nMaxId = std::max( nMaxId, pInstrumentList->get( n )->get_id() );
 	}
+	pTrackOutputs->trackMap.resize( nMaxId + 1 );
+
 	// Creates a new output track or reassigns an existing one for
 	// each component of each instrument and stores the result in
-	// the `m_trackMap'.
+	// the `trackMap'.
 	std::shared_ptr<InstrumentComponent> ppComponent;
 	for ( int n = 0; n <= nInstruments - 1; n++ ) {
 		pInstrument = pInstrumentList->get( n );
+		if ( pInstrument->get_id() < 0 ) {
+			ERRORLOG( QString( "Instrument [%1] has invalid id [%2]" )
+					  .arg( pInstrument->get_name() )
+					  .arg( pInstrument->get_id() ) );
+			continue;
+		}
+		auto& tracks = pTrackOutputs->trackMap[ pInstrument->get_id() ];
+		tracks.assign( pInstrument->get_components()->size(), -1 );
 		for ( int ii = 0; ii < pInstrument->get_components()->size(); ++ii ) {
 			ppComponent = pInstrument->get_component( ii );
 			if ( ppComponent == nullptr ) {
@@ -1098,26 +1090,44 @@ void JackAudioDriver::makeTrackOutputs( std::shared_ptr<Song> pSong )
 			}
 
 			setTrackOutput( nTrackCount, pInstrument, ppComponent, pSong);
-			m_trackMap[ pInstrument->get_id() ][ ii ] = nTrackCount;
+			tracks[ ii ] = nTrackCount;
 			nTrackCount++;
 		}
 	}
-	// clean up unused ports
-	jack_port_t *pPortL, *pPortR;
-	for ( int n = nTrackCount; n < m_nTrackPortCount; n++ ) {
-		pPortL = m_pTrackOutputPortsL[n];
-		pPortR = m_pTrackOutputPortsR[n];
-		m_pTrackOutputPortsL[n] = nullptr;
-		if ( jack_port_unregister( m_pClient, pPortL ) != 0 ) {
+	pTrackOutputs->portsL.assign( m_trackOutputPortsL.begin(),
+								  m_trackOutputPortsL.begin() + nTrackCount );
+	pTrackOutputs->portsR.assign( m_trackOutputPortsR.begin(),
+								  m_trackOutputPortsR.begin() + nTrackCount );
+	pTrackOutputs->buffersL.assign( nTrackCount, nullptr );
+	pTrackOutputs->buffersR.assign( nTrackCount, nullptr );
+	publishTrackOutputs( pTrackOutputs );
+
+	// clean up unused ports. They can not be reached by the realtime
+	// thread anymore.
+	for ( int n = nTrackCount; n < static_cast<int>(m_trackOutputPortsL.size()); n++ ) {
+		if ( jack_port_unregister( m_pClient, m_trackOutputPortsL[ n ] ) != 0 ) {
 			ERRORLOG( QString( "Unable to unregister left port [%1]" ).arg( n ) );
 		}
-		m_pTrackOutputPortsR[n] = nullptr;
-		if ( jack_port_unregister( m_pClient, pPortR ) != 0 ) {
+		if ( jack_port_unregister( m_pClient, m_trackOutputPortsR[ n ] ) != 0 ) {
 			ERRORLOG( QString( "Unable to unregister right port [%1]" ).arg( n ) );
 		}
 	}
 
-	m_nTrackPortCount = nTrackCount;
+	m_trackOutputPortsL.resize( nTrackCount );
+	m_trackOutputPortsR.resize( nTrackCount );
+}
+
+void JackAudioDriver::publishTrackOutputs( TrackOutputs* pTrackOutputs ) {
+	auto pOldTrackOutputs =
+		m_pTrackOutputs.exchange( pTrackOutputs, std::memory_order_acq_rel );
+	if ( pOldTrackOutputs == nullptr ) {
+		return;
+	}
+
+	// Wait for process cycles which might still use the previous
+	// table. The realtime thread itself is never blocked.
+	Hydrogen::get_instance()->getAudioEngine()->getReclaimer()->synchronize();
+	delete pOldTrackOutputs;
 }
 
 void JackAudioDriver::setTrackOutput( int n, std::shared_ptr<Instrument> pInstrument, std::shared_ptr<InstrumentComponent> pInstrumentComponent, std::shared_ptr<Song> pSong )
@@ -1139,37 +1149,36 @@ void JackAudioDriver::setTrackOutput( int n, std::shared_ptr<Instrument> pInstru
 
 	QString sComponentName;
 
-	// The function considers `m_nTrackPortCount' as the number of
-	// ports already present. If it's smaller than `n', new ports
-	// have to be created.
-	if ( m_nTrackPortCount <= n ) {
-		for ( int m = m_nTrackPortCount; m <= n; m++ ) {
-			sComponentName = QString( "Track_%1_" ).arg( m + 1 );
-			m_pTrackOutputPortsL[m] =
-				jack_port_register( m_pClient, ( sComponentName + "L" ).toLocal8Bit(),
-						     JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0 );
-
-			m_pTrackOutputPortsR[m] =
-				jack_port_register( m_pClient, ( sComponentName + "R" ).toLocal8Bit(),
-						    JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0 );
-
-			if ( ! m_pTrackOutputPortsR[m] || ! m_pTrackOutputPortsL[m] ) {
-				Hydrogen::get_instance()->getAudioEngine()->raiseError( Hydrogen::JACK_ERROR_IN_PORT_REGISTER );
-			}
+	// The number of ports already present is given by the size of
+	// `m_trackOutputPortsL'. If it's smaller than `n', new ports have
+	// to be created.
+	for ( int m = static_cast<int>(m_trackOutputPortsL.size()); m <= n; m++ ) {
+		sComponentName = QString( "Track_%1_" ).arg( m + 1 );
+		jack_port_t* pPortL =
+			jack_port_register( m_pClient, ( sComponentName + "L" ).toLocal8Bit(),
+								JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0 );
+
+		jack_port_t* pPortR =
+			jack_port_register( m_pClient, ( sComponentName + "R" ).toLocal8Bit(),
+								JACK_DEFAULT_AUDIO_TYPE, JackPortIsOutput, 0 );
+
+		if ( pPortL == nullptr || pPortR == nullptr ) {
+			Hydrogen::get_instance()->getAudioEngine()->raiseError( Hydrogen::JACK_ERROR_IN_PORT_REGISTER );
 		}
-		m_nTrackPortCount = n + 1;
+		m_trackOutputPortsL.push_back( pPortL );
+		m_trackOutputPortsR.push_back( pPortR );
 	}
 
 	// Now that we're sure there is an n'th port, rename it.
 	sComponentName = QString( "Track_%1_%2_%3_" ).arg( n + 1 )
 		.arg( pInstrument->get_name() ).arg( pInstrumentComponent->getName() );
 
-	if ( jack_port_rename( m_pClient, m_pTrackOutputPortsL[n],
+	if ( jack_port_rename( m_pClient, m_trackOutputPortsL[n],
 						   ( sComponentName + "L" ).toLocal8Bit() ) != 0 ) {
 		ERRORLOG( QString( "Unable to rename left port of track [%1] to [%2]" )
 				  .arg( n ).arg( sComponentName + "L" ) );
 	}
-	if ( jack_port_rename( m_pClient, m_pTrackOutputPortsR[n],
+	if ( jack_port_rename( m_pClient, m_trackOutputPortsR[n],
 					  ( sComponentName + "R" ).toLocal8Bit() ) != 0 ) {
 		ERRORLOG( QString( "Unable to rename right port of track [%1] to [%2]" )
 				  .arg( n ).arg( sComponentName + "R" ) );
@@ -1532,17 +1541,22 @@ QString JackAudioDriver::toQString( const QString& sPrefix, bool bShort ) const
 					 .arg( m_sOutputPortName1 ) )
 			.append( QString( "%1%2m_sOutputPortName2: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_sOutputPortName2 ) )
-			.append( QString( "%1%2m_trackMap:\n" ).arg( sPrefix ).arg( s ) );
-		for ( int rrow = 0; rrow < MAX_INSTRUMENTS; ++rrow ) {
-			sOutput.append( QString( "%1%2%2[" ).arg( sPrefix ).arg( s ) );
-			for ( int ccolumn = 0; ccolumn < MAX_COMPONENTS; ++ccolumn ) {
-				sOutput.append( QString( "%1, " )
-								.arg( m_trackMap[ rrow ][ ccolumn ] ) );
+			.append( QString( "%1%2m_pTrackOutputs->trackMap:\n" ).arg( sPrefix ).arg( s ) );
+		const auto pTrackOutputs = m_pTrackOutputs.load();
+		const int nTrackMapSize = pTrackOutputs != nullptr ?
+			static_cast<int>(pTrackOutputs->trackMap.size()) : 0;
+		for ( int nnId = 0; nnId < nTrackMapSize; ++nnId ) {
+			if ( pTrackOutputs->trackMap[ nnId ].empty() ) {
+				continue;
+			}
+			sOutput.append( QString( "%1%2%2[%3]: [" ).arg( sPrefix ).arg( s ).arg( nnId ) );
+			for ( const auto& nnTrack : pTrackOutputs->trackMap[ nnId ] ) {
+				sOutput.append( QString( "%1, " ).arg( nnTrack ) );
 			}
 			sOutput.append( "]\n" );
 		}
-		sOutput.append( QString( "%1%2m_nTrackPortCount: %3\n" ).arg( sPrefix ).arg( s )
-					 .arg( m_nTrackPortCount ) )
+		sOutput.append( QString( "%1%2m_trackOutputPortsL.size(): %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_trackOutputPortsL.size() ) )
 			.append( QString( "%1%2m_JackTransportState: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( JackTransportStateToQString( m_JackTransportState ) ) )
 			.append( QString( "%1%2m_JackTransportPos: %3\n" ).arg( sPrefix ).arg( s )
@@ -1575,17 +1589,22 @@ QString JackAudioDriver::toQString( const QString& sPrefix, bool bShort ) const
 					 .arg( m_sOutputPortName1 ) )
 			.append( QString( ", m_sOutputPortName2: %1" )
 					 .arg( m_sOutputPortName2 ) )
-			.append( ", m_trackMap: [" );
-		for ( int rrow = 0; rrow < MAX_INSTRUMENTS; ++rrow ) {
-			sOutput.append( QString( "[" ) );
-			for ( int ccolumn = 0; ccolumn < MAX_COMPONENTS; ++ccolumn ) {
-				sOutput.append( QString( "%1, " )
-								.arg( m_trackMap[ rrow ][ ccolumn ] ) );
+			.append( ", m_pTrackOutputs->trackMap: [" );
+		const auto pTrackOutputs = m_pTrackOutputs.load();
+		const int nTrackMapSize = pTrackOutputs != nullptr ?
+			static_cast<int>(pTrackOutputs->trackMap.size()) : 0;
+		for ( int nnId = 0; nnId < nTrackMapSize; ++nnId ) {
+			if ( pTrackOutputs->trackMap[ nnId ].empty() ) {
+				continue;
+			}
+			sOutput.append( QString( "%1: [" ).arg( nnId ) );
+			for ( const auto& nnTrack : pTrackOutputs->trackMap[ nnId ] ) {
+				sOutput.append( QString( "%1, " ).arg( nnTrack ) );
 			}
 			sOutput.append( "] " );
 		}
-		sOutput.append( QString( ", m_nTrackPortCount: %1" )
-					 .arg( m_nTrackPortCount ) )
+		sOutput.append( QString( "], m_trackOutputPortsL.size(): %1" )
+					 .arg( m_trackOutputPortsL.size() ) )
 			.append( QString( ", m_JackTransportState: %1" )
 					 .arg( JackTransportStateToQString( m_JackTransportState ) ) )
 			.append( QString( ", m_JackTransportPos: %1" )
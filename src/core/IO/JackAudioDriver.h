@@ -30,9 +30,11 @@
 #if defined(H2CORE_HAVE_JACK) || _DOXYGEN_
 // JACK support is enabled.
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <pthread.h>
+#include <vector>
 #include <jack/jack.h>
 #include <jack/transport.h>
 
@@ -164,16 +166,28 @@ public:
 
 	virtual int getXRuns() const override;
 
-	/** Resets the buffers contained in #m_pTrackOutputPortsL and
-	 * #m_pTrackOutputPortsR.
+	/**
+	 * Resolves the buffers of all per-track output ports for the
+	 * current process cycle and clears them.
+	 *
+	 * JACK hands out a new buffer for each port in every cycle. Instead
+	 * of querying them for each rendered voice, they are looked up once
+	 * and stored in the table published by makeTrackOutputs(). Since
+	 * the table is never altered once published, no lock is required.
 	 * 
 	 * @param nFrames Size of the buffers used in the audio process
 	 * callback function.
 	 */
-	void clearPerTrackAudioBuffers( uint32_t nFrames );
+	void resolveTrackOutputs( uint32_t nFrames );
 	
 	/**
 	 * Creates per component output ports for each instrument.
+	 *
+	 * All JACK calls are done without holding a lock the realtime
+	 * thread is waiting for. The resulting ports and track
+	 * assignments are published to the realtime thread as a whole by
+	 * replacing #m_pTrackOutputs. Previous ports are unregistered only
+	 * after no process cycle can access them anymore.
 	 */
 	void makeTrackOutputs( std::shared_ptr<Song> pSong );
 
@@ -201,49 +215,19 @@ public:
 	 */
 	virtual float* getOut_R() override;
 	/**
-	 * Get content of left output port of a specific track.
-	 *
-	 * \param nTrack Track number. Must not be bigger than
-	 * #m_nTrackPortCount.
-	 *
-	 * \return Pointer to buffer content of type
-	 * _jack_default_audio_sample_t*_ (jack/types.h)
-	 */
-	float* getTrackOut_L( unsigned nTrack );
-	/**
-	 * Get content of right output port of a specific track.
-	 *
-	 * \param nTrack Track number. Must not be bigger than
-	 * #m_nTrackPortCount.
-	 *
-	 * \return Pointer to buffer content of type
-	 * _jack_default_audio_sample_t*_ (jack/types.h)
-	 */
-	float* getTrackOut_R( unsigned nTrack );
-	/** 
-	 * Convenience function looking up the track number of a component of an
-	 * instrument in #m_trackMap. Using the number it then calls
-	 * getTrackOut_L( unsigned ) and returns its result.
-	 *
-	 * \param instr Pointer to an Instrument
-	 * \param nComponentIdx Component position in component vector.
-	 *
-	 * \return Pointer to buffer content of type
-	 * _jack_default_audio_sample_t*_ (jack/types.h)
-	 */
-	float* getTrackOut_L( std::shared_ptr<Instrument> instr, int nComponentIdx );
-	/** 
-	 * Convenience function looking up the track number of a component of an
-	 * instrument in #m_trackMap. Using the number it then calls
-	 * getTrackOut_R( unsigned ) and returns its result.
+	 * Buffer of the left output port of the track assigned to the
+	 * component @a nComponentIdx of the instrument with id @a
+	 * nInstrumentId.
 	 *
-	 * \param instr Pointer to an Instrument
-	 * \param nComponentIdx Component position in component vector.
+	 * Only valid within the process cycle after
+	 * resolveTrackOutputs() was called. Neither JACK nor any lock is
+	 * involved.
 	 *
-	 * \return Pointer to buffer content of type
-	 * _jack_default_audio_sample_t*_ (jack/types.h)
+	 * \return `nullptr` if no track is assigned.
 	 */
-	float* getTrackOut_R( std::shared_ptr<Instrument> instr, int nComponentIdx );
+	float* getTrackOut_L( int nInstrumentId, int nComponentIdx ) const;
+	/** Right counterpart of getTrackOut_L(). */
+	float* getTrackOut_R( int nInstrumentId, int nComponentIdx ) const;
 
 	/**
 	 * Initializes the JACK audio driver.
@@ -486,29 +470,52 @@ private:
 	 */
 	QString				m_sOutputPortName2;
 	/**
-	 * Matrix containing the track number of each component of all
-	 * instruments. Its rows represent the instruments and its columns
-	 * their components. _m_trackMap[2][1]=6_ thus therefore mean the
-	 * output of the second component of the third instrument is
-	 * assigned the seventh output port. Since its total size is
-	 * defined by #MAX_INSTRUMENTS and #MAX_COMPONENTS, most of its
-	 * entries will be zero.
-	 */
-	int				m_trackMap[MAX_INSTRUMENTS][MAX_COMPONENTS];
-	/**
-	 * Total number of output ports currently in use.
-	 */
-	int				m_nTrackPortCount;
+	 * Per-track output ports along with the assignment of instrument
+	 * components to them as seen by the realtime thread. Once
+	 * published via #m_pTrackOutputs a table is not altered anymore
+	 * except for the buffers resolved in each process cycle.
+	 */
+	struct TrackOutputs {
+		/**
+		 * Track number of each component of all instruments. The outer
+		 * vector is indexed by the instrument id and the inner ones by
+		 * the component index. _trackMap[2][1]=6_ thus means the output
+		 * of the second component of the instrument with id 2 is
+		 * assigned the seventh output port. Components without a port
+		 * are marked by -1.
+		 */
+		std::vector<std::vector<int>>	trackMap;
+		std::vector<jack_port_t*>	portsL;
+		std::vector<jack_port_t*>	portsR;
+		/**
+		 * Buffers of #portsL resolved for the current process
+		 * cycle. Sized in makeTrackOutputs() so resolveTrackOutputs()
+		 * does not have to allocate. Only accessed by the realtime
+		 * thread.
+		 */
+		std::vector<float*>		buffersL;
+		/** Buffers of #portsR for the current process cycle. */
+		std::vector<float*>		buffersR;
+	};
+	/** Replaces #m_pTrackOutputs by @a pTrackOutputs and deletes the
+	 * previous table once no process cycle can access it anymore. */
+	void publishTrackOutputs( TrackOutputs* pTrackOutputs );
 	/**
-	 * Vector of all left audio output ports currently used by the
-	 * local JACK client.
+	 * All left audio output ports currently registered by the local
+	 * JACK client. Their number is not limited. Only accessed outside
+	 * of the realtime thread.
 	 */
-	jack_port_t*			m_pTrackOutputPortsL[MAX_INSTRUMENTS];
+	std::vector<jack_port_t*>	m_trackOutputPortsL;
 	/**
-	 * Vector of all right audio output ports currently used by the
-	 * local JACK client.
+	 * All right audio output ports currently registered by the local
+	 * JACK client.
 	 */
-	jack_port_t*		 	m_pTrackOutputPortsR[MAX_INSTRUMENTS];
+	std::vector<jack_port_t*>	m_trackOutputPortsR;
+	/** Table currently published to the realtime thread. */
+	std::atomic<TrackOutputs*>	m_pTrackOutputs;
+	/** Table resolved within the current process cycle. `nullptr` in
+	 * case there is none. Only accessed by the realtime thread. */
+	TrackOutputs*			m_pResolvedTrackOutputs;
 
 	/**
 	 * Current transport state returned by
@@ -623,6 +630,33 @@ private:
 #endif
 };
 
+inline float* JackAudioDriver::getTrackOut_L( int nInstrumentId,
+											   int nComponentIdx ) const {
+	if ( m_pResolvedTrackOutputs == nullptr || nInstrumentId < 0 ||
+		 nInstrumentId >= static_cast<int>(m_pResolvedTrackOutputs->trackMap.size()) ) {
+		return nullptr;
+	}
+	const auto& tracks = m_pResolvedTrackOutputs->trackMap[ nInstrumentId ];
+	if ( nComponentIdx < 0 || nComponentIdx >= static_cast<int>(tracks.size()) ||
+		 tracks[ nComponentIdx ] < 0 ) {
+		return nullptr;
+	}
+	return m_pResolvedTrackOutputs->buffersL[ tracks[ nComponentIdx ] ];
+}
+inline float* JackAudioDriver::getTrackOut_R( int nInstrumentId,
+											   int nComponentIdx ) const {
+	if ( m_pResolvedTrackOutputs == nullptr || nInstrumentId < 0 ||
+		 nInstrumentId >= static_cast<int>(m_pResolvedTrackOutputs->trackMap.size()) ) {
+		return nullptr;
+	}
+	const auto& tracks = m_pResolvedTrackOutputs->trackMap[ nInstrumentId ];
+	if ( nComponentIdx < 0 || nComponentIdx >= static_cast<int>(tracks.size()) ||
+		 tracks[ nComponentIdx ] < 0 ) {
+		return nullptr;
+	}
+	return m_pResolvedTrackOutputs->buffersR[ tracks[ nComponentIdx ] ];
+}
+
 }; // H2Core namespace
 
 
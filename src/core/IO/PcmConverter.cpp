@@ -0,0 +1,178 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/IO/PcmConverter.h>
+
+#include <algorithm>
+
+namespace H2Core
+{
+
+// Largest float not exceeding the maximum of a 32 bit integer.
+// 2^31 - 1 itself would be rounded up to 2^31 and overflow.
+static constexpr float fMaxS32 = 2147483520.f;
+
+/** Scales, saturates, and rounds (half away from zero) both channels
+ * into @a pOut. */
+template <typename T>
+static void convertInteger( const float* __restrict__ pIn_L,
+							const float* __restrict__ pIn_R,
+							T* __restrict__ pOut, int nFrames,
+							float fScale, float fMax ) {
+	for ( int ii = 0; ii < nFrames; ++ii ) {
+		float fL = std::min( std::max( pIn_L[ ii ] * fScale, -fScale ), fMax );
+		float fR = std::min( std::max( pIn_R[ ii ] * fScale, -fScale ), fMax );
+		fL += fL < 0 ? -0.5f : 0.5f;
+		fR += fR < 0 ? -0.5f : 0.5f;
+		pOut[ 2 * ii ] = static_cast<T>( static_cast<int32_t>( fL ) );
+		pOut[ 2 * ii + 1 ] = static_cast<T>( static_cast<int32_t>( fR ) );
+	}
+}
+
+/** Uniformly distributed in [0, 1). */
+static inline float uniformRandom( uint32_t& nState ) {
+	nState = nState * 1664525u + 1013904223u;
+	return static_cast<float>( nState >> 8 ) * ( 1.f / 16777216.f );
+}
+
+PcmConverter::PcmConverter( Format format, bool bDither )
+	: m_format( format )
+	, m_bDither( bDither )
+	, m_nRandomState( 22222 ) {
+}
+
+QString PcmConverter::FormatToQString( Format format ) {
+	switch ( format ) {
+	case Format::Float:
+		return "Float";
+	case Format::S32:
+		return "S32";
+	case Format::S24:
+		return "S24";
+	case Format::S24_3LE:
+		return "S24_3LE";
+	case Format::S16:
+		return "S16";
+	default:
+		return "<unknown>";
+	}
+}
+
+int PcmConverter::getSampleSize() const {
+	switch ( m_format ) {
+	case Format::S24_3LE:
+		return 3;
+	case Format::S16:
+		return 2;
+	default:
+		return 4;
+	}
+}
+
+void PcmConverter::convert( const float* pIn_L, const float* pIn_R,
+							void* pOut, int nFrames ) {
+	switch ( m_format ) {
+	case Format::Float: {
+		float* pFloat = static_cast<float*>(pOut);
+		for ( int ii = 0; ii < nFrames; ++ii ) {
+			pFloat[ 2 * ii ] = std::min( std::max( pIn_L[ ii ], -1.f ), 1.f );
+			pFloat[ 2 * ii + 1 ] = std::min( std::max( pIn_R[ ii ], -1.f ), 1.f );
+		}
+		break;
+	}
+
+	case Format::S32:
+		convertInteger( pIn_L, pIn_R, static_cast<int32_t*>(pOut), nFrames,
+						2147483648.f, fMaxS32 );
+		break;
+
+	case Format::S24:
+		convertInteger( pIn_L, pIn_R, static_cast<int32_t*>(pOut), nFrames,
+						8388608.f, 8388607.f );
+		break;
+
+	case Format::S24_3LE: {
+		// Converted in chunks using a 32 bit scratch buffer and packed
+		// afterwards.
+		constexpr int nChunkSize = 64;
+		int32_t buffer[ 2 * nChunkSize ];
+		uint8_t* pBytes = static_cast<uint8_t*>(pOut);
+		for ( int nStart = 0; nStart < nFrames; nStart += nChunkSize ) {
+			const int nChunk = std::min( nChunkSize, nFrames - nStart );
+			convertInteger( pIn_L + nStart, pIn_R + nStart, buffer, nChunk,
+							8388608.f, 8388607.f );
+			for ( int ii = 0; ii < 2 * nChunk; ++ii ) {
+				pBytes[ 0 ] = static_cast<uint8_t>( buffer[ ii ] );
+				pBytes[ 1 ] = static_cast<uint8_t>( buffer[ ii ] >> 8 );
+				pBytes[ 2 ] = static_cast<uint8_t>( buffer[ ii ] >> 16 );
+				pBytes += 3;
+			}
+		}
+		break;
+	}
+
+	case Format::S16:
+		if ( ! m_bDither ) {
+			convertInteger( pIn_L, pIn_R, static_cast<int16_t*>(pOut), nFrames,
+							32768.f, 32767.f );
+		}
+		else {
+			int16_t* pShort = static_cast<int16_t*>(pOut);
+			const float* channels[ 2 ] = { pIn_L, pIn_R };
+			for ( int ii = 0; ii < nFrames; ++ii ) {
+				for ( int nChannel = 0; nChannel < 2; ++nChannel ) {
+					// The difference of two uniformly distributed values
+					// has a triangular distribution spanning +/- 1 LSB.
+					const float fDither = uniformRandom( m_nRandomState ) -
+						uniformRandom( m_nRandomState );
+					float fValue = std::min(
+						std::max( channels[ nChannel ][ ii ] * 32768.f + fDither,
+								  -32768.f ), 32767.f );
+					fValue += fValue < 0 ? -0.5f : 0.5f;
+					pShort[ 2 * ii + nChannel ] =
+						static_cast<int16_t>( static_cast<int32_t>( fValue ) );
+				}
+			}
+		}
+		break;
+	}
+}
+
+QString PcmConverter::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[PcmConverter]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_format: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( FormatToQString( m_format ) ) )
+			.append( QString( "%1%2m_bDither: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_bDither ) );
+	}
+	else {
+		sOutput = QString( "[PcmConverter] m_format: %1" )
+			.arg( FormatToQString( m_format ) )
+			.append( QString( ", m_bDither: %1" ).arg( m_bDither ) );
+	}
+
+	return sOutput;
+}
+
+};
@@ -0,0 +1,107 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef PCM_CONVERTER_H
+#define PCM_CONVERTER_H
+
+#include <cstdint>
+
+#include <core/Object.h>
+
+namespace H2Core
+{
+
+/**
+ * Converts the float buffers of the audio engine into interleaved
+ * stereo frames of the sample format negotiated with a driver.
+ *
+ * All integer formats saturate instead of wrapping around on samples
+ * exceeding [-1, 1]. Apart from the dithered one, the kernels contain
+ * neither branches nor library calls and are vectorized by the
+ * compiler.
+ *
+ * \ingroup docCore docAudioDriver
+ */
+class PcmConverter : public H2Core::Object<PcmConverter>
+{
+	H2_OBJECT(PcmConverter)
+public:
+	enum class Format {
+		/** 32 bit float in native byte order. */
+		Float,
+		/** 32 bit signed integer in native byte order. */
+		S32,
+		/** 24 bit signed integer in the lower bytes of a 32 bit one in
+		 * native byte order. */
+		S24,
+		/** 24 bit signed integer packed into three bytes, little
+		 * endian. */
+		S24_3LE,
+		/** 16 bit signed integer in native byte order. */
+		S16
+	};
+	static QString FormatToQString( Format format );
+
+	/**
+	 * \param bDither Add triangular (TPDF) dither of one least
+	 *   significant bit before rounding. Only applies to
+	 *   Format::S16. Wider formats have a noise floor below the one
+	 *   of any DAC.
+	 */
+	PcmConverter( Format format, bool bDither );
+
+	Format getFormat() const;
+	bool getDither() const;
+	/** Size of a single sample of one channel in bytes. */
+	int getSampleSize() const;
+
+	/** Writes @a nFrames frames of @a pIn_L and @a pIn_R as
+	 * interleaved stereo frames into @a pOut. */
+	void convert( const float* pIn_L, const float* pIn_R, void* pOut,
+				  int nFrames );
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	Format m_format;
+	bool m_bDither;
+	/** State of the random number generator used for dithering. */
+	uint32_t m_nRandomState;
+};
+
+inline PcmConverter::Format PcmConverter::getFormat() const {
+	return m_format;
+}
+inline bool PcmConverter::getDither() const {
+	return m_bDither;
+}
+
+};
+
+#endif
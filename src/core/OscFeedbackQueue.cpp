@@ -0,0 +1,104 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/OscFeedbackQueue.h>
+
+#include <algorithm>
+
+namespace H2Core
+{
+
+OscFeedbackQueue::OscFeedbackQueue()
+	: m_bWindowOpen( false ) {
+}
+
+void OscFeedbackQueue::push( const QString& sPath, const QByteArray& data,
+							 Clock::time_point now ) {
+	if ( ! m_bWindowOpen ) {
+		m_windowEnd = now + std::chrono::milliseconds( nCoalescingWindowMs );
+		m_bWindowOpen = true;
+	}
+
+	auto it = m_entries.find( sPath );
+	if ( it != m_entries.end() ) {
+		// Only the latest state is of interest.
+		it->second.data = data;
+		return;
+	}
+
+	m_entries[ sPath ] = { data, m_windowEnd };
+}
+
+OscFeedbackQueue::Clock::time_point OscFeedbackQueue::nextDue() const {
+	Clock::time_point due = Clock::time_point::max();
+	for ( const auto& [ _, entry ] : m_entries ) {
+		due = std::min( due, entry.due );
+	}
+	return due;
+}
+
+std::vector<OscFeedbackQueue::Message> OscFeedbackQueue::takeDue(
+	Clock::time_point now ) {
+	std::vector<Message> messages;
+	for ( auto it = m_entries.begin(); it != m_entries.end(); ) {
+		if ( it->second.due > now ) {
+			++it;
+			continue;
+		}
+		messages.push_back( { it->first, it->second.data } );
+		it = m_entries.erase( it );
+	}
+
+	if ( m_bWindowOpen && m_windowEnd <= now ) {
+		m_bWindowOpen = false;
+	}
+
+	return messages;
+}
+
+QString OscFeedbackQueue::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[OscFeedbackQueue]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_entries:\n" ).arg( sPrefix ).arg( s ) );
+		for ( const auto& [ sPath, _ ] : m_entries ) {
+			sOutput.append( QString( "%1%2%2%3\n" ).arg( sPrefix ).arg( s )
+							.arg( sPath ) );
+		}
+		sOutput.append( QString( "%1%2m_bWindowOpen: %3\n" ).arg( sPrefix )
+						.arg( s ).arg( m_bWindowOpen ) );
+	}
+	else {
+		sOutput = QString( "[OscFeedbackQueue] m_entries: [" );
+		bool bFirst = true;
+		for ( const auto& [ sPath, _ ] : m_entries ) {
+			sOutput.append( QString( "%1%2" ).arg( bFirst ? "" : ", " )
+							.arg( sPath ) );
+			bFirst = false;
+		}
+		sOutput.append( QString( "], m_bWindowOpen: %1" ).arg( m_bWindowOpen ) );
+	}
+
+	return sOutput;
+}
+
+};
@@ -0,0 +1,113 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef OSC_FEEDBACK_QUEUE_H
+#define OSC_FEEDBACK_QUEUE_H
+
+#include <chrono>
+#include <map>
+#include <vector>
+
+#include <QByteArray>
+#include <QString>
+
+#include <core/Object.h>
+
+namespace H2Core
+{
+
+/**
+ * Pending feedback messages of the OscServer.
+ *
+ * Messages are stored per OSC path and a newer message replaces the
+ * pending one of the same path. This way a fader moved during
+ * automation results in a single message per window instead of one
+ * per intermediate value.
+ *
+ * The coalescing window opens with the first message pushed into an
+ * empty queue and closes #nCoalescingWindowMs later. All messages
+ * pushed in between are due at the same time and can thus be sent
+ * within a single bundle.
+ *
+ * The queue does not lock. It is the responsibility of the caller to
+ * guard it.
+ *
+ * \ingroup docCore
+ */
+class OscFeedbackQueue : public H2Core::Object<OscFeedbackQueue>
+{
+	H2_OBJECT(OscFeedbackQueue)
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	struct Message {
+		QString sPath;
+		/** Message serialized using lo_message_serialise(). */
+		QByteArray data;
+	};
+
+	OscFeedbackQueue();
+
+	/** Adds or replaces the pending message of @a sPath. */
+	void push( const QString& sPath, const QByteArray& data,
+			   Clock::time_point now );
+
+	bool isEmpty() const;
+	/** Point in time at which the next message is due. Only valid
+	 * if the queue is not empty. */
+	Clock::time_point nextDue() const;
+
+	/** Removes and returns all messages due at @a now ordered by
+	 * path. */
+	std::vector<Message> takeDue( Clock::time_point now );
+
+	static constexpr int nCoalescingWindowMs = 20;
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	struct Entry {
+		QByteArray data;
+		Clock::time_point due;
+	};
+
+	std::map<QString, Entry> m_entries;
+	/** End of the current coalescing window. Only valid if
+	 * #m_bWindowOpen is true. */
+	Clock::time_point m_windowEnd;
+	bool m_bWindowOpen;
+};
+
+inline bool OscFeedbackQueue::isEmpty() const {
+	return m_entries.empty();
+}
+
+};
+
+#endif
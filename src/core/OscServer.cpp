@@ -353,6 +353,8 @@ int OscServer::generic_handler(const char *	path,
 
 
 OscServer::OscServer() : m_bInitialized( false )
+					   , m_pFeedbackQueue( new H2Core::OscFeedbackQueue() )
+					   , m_bFeedbackThreadRunning( false )
 {
 	auto pPref = H2Core::Preferences::get_instance();
 	
@@ -393,6 +395,16 @@ OscServer::OscServer() : m_bInitialized( false )
 
 OscServer::~OscServer(){
 
+	if ( m_feedbackThread.joinable() ) {
+		{
+			std::lock_guard<std::mutex> lock( m_feedbackMutex );
+			m_bFeedbackThreadRunning = false;
+		}
+		m_feedbackCondition.notify_one();
+		m_feedbackThread.join();
+	}
+	delete m_pFeedbackQueue;
+
 	for (std::list<lo_address>::iterator it=m_pClientRegistry.begin(); it != m_pClientRegistry.end(); ++it){
 		lo_address_free( *it );
 	}
@@ -1059,6 +1071,52 @@ void OscServer::PLAYLIST_REMOVE_SONG_Handler(lo_arg **argv, int argc) {
 	H2Core::CoreActionController::removeFromPlaylist( pEntry, nIndex );
 }
 
+void OscServer::PROCESS_PROFILE_Handler(lo_arg **argv, int argc, lo_message msg) {
+	INFOLOG( "processing message" );
+
+	auto pProfiler = H2Core::Hydrogen::get_instance()->getAudioEngine()->getProfiler();
+
+	std::vector<H2Core::OscFeedbackQueue::Message> messages;
+	for ( int ii = 0; ii < H2Core::ProcessProfiler::nStages; ++ii ) {
+		const auto stage = static_cast<H2Core::ProcessProfiler::Stage>(ii);
+		const auto statistics = pProfiler->getStatistics( stage );
+
+		lo_message reply = lo_message_new();
+		lo_message_add_int64( reply, statistics.nCount );
+		lo_message_add_float( reply, statistics.fLast );
+		lo_message_add_float( reply, statistics.fMean );
+		lo_message_add_float( reply, statistics.fPercentile99 );
+		lo_message_add_float( reply, statistics.fMax );
+
+		const QString sPath = QString( "/Hydrogen/PROCESS_PROFILE/%1" )
+			.arg( H2Core::ProcessProfiler::StageToQString( stage ) );
+		size_t nSize = 0;
+		void* pData = lo_message_serialise( reply, sPath.toLatin1().data(),
+											nullptr, &nSize );
+		if ( pData != nullptr ) {
+			messages.push_back( { sPath, QByteArray( static_cast<const char*>(pData),
+													 static_cast<int>(nSize) ) } );
+			free( pData );
+		}
+
+		lo_message_free( reply );
+	}
+
+	// The statistics are only of interest to the client asking for
+	// them and are sent right away instead of being broadcasted.
+	lo_address source = lo_message_get_source( msg );
+	lo_address address =
+		lo_address_new_with_proto( lo_address_get_protocol( source ),
+								   lo_address_get_hostname( source ),
+								   lo_address_get_port( source ) );
+	get_instance()->sendBundles( messages, { address } );
+	lo_address_free( address );
+
+	if ( argc > 0 && argv[0]->f != 0 ) {
+		pProfiler->reset();
+	}
+}
+
 // -------------------------------------------------------------------
 // Helper functions
 
@@ -1072,17 +1130,117 @@ bool IsLoAddressEqual( const lo_address& first, const lo_address& second )
 }
 
 void OscServer::broadcastMessage( const char* msgText, const lo_message& message ) {
-	for ( const auto& clientAddress: m_pClientRegistry ){
-		
-		INFOLOG( QString( "Outgoing OSC broadcast message %1" ).arg( msgText ));
-		
-		int i;
-		for (i = 0; i < lo_message_get_argc( message ); i++) {
-			QString formattedArgument = qPrettyPrint( (lo_type)lo_message_get_types(message)[i], lo_message_get_argv(message)[i] );
-			INFOLOG(QString("Argument %1: %2 %3").arg(i).arg(lo_message_get_types(message)[i]).arg(formattedArgument));
+	{
+		std::lock_guard<std::mutex> lock( m_feedbackMutex );
+		if ( m_pClientRegistry.empty() ) {
+			return;
 		}
-		
-		lo_send_message(clientAddress, msgText, message);
+	}
+
+	INFOLOG( QString( "Outgoing OSC broadcast message %1" ).arg( msgText ));
+
+	int i;
+	for (i = 0; i < lo_message_get_argc( message ); i++) {
+		QString formattedArgument = qPrettyPrint( (lo_type)lo_message_get_types(message)[i], lo_message_get_argv(message)[i] );
+		INFOLOG(QString("Argument %1: %2 %3").arg(i).arg(lo_message_get_types(message)[i]).arg(formattedArgument));
+	}
+
+	// The message itself is owned by the caller. We store a copy.
+	size_t nSize = 0;
+	void* pData = lo_message_serialise( message, msgText, nullptr, &nSize );
+	if ( pData == nullptr ) {
+		ERRORLOG( QString( "Unable to serialize message [%1]" ).arg( msgText ) );
+		return;
+	}
+	const QByteArray data( static_cast<const char*>(pData),
+						   static_cast<int>(nSize) );
+	free( pData );
+
+	{
+		std::lock_guard<std::mutex> lock( m_feedbackMutex );
+		m_pFeedbackQueue->push( msgText, data,
+								H2Core::OscFeedbackQueue::Clock::now() );
+	}
+	m_feedbackCondition.notify_one();
+}
+
+void OscServer::feedbackLoop() {
+	std::unique_lock<std::mutex> lock( m_feedbackMutex );
+	while ( m_bFeedbackThreadRunning ) {
+		if ( m_pFeedbackQueue->isEmpty() ) {
+			m_feedbackCondition.wait( lock );
+			continue;
+		}
+
+		const auto now = H2Core::OscFeedbackQueue::Clock::now();
+		const auto due = m_pFeedbackQueue->nextDue();
+		if ( due > now ) {
+			// Wait for further changes to coalesce.
+			m_feedbackCondition.wait_until( lock, due );
+			continue;
+		}
+
+		const auto messages = m_pFeedbackQueue->takeDue( now );
+		const std::vector<lo_address> clients( m_pClientRegistry.begin(),
+											   m_pClientRegistry.end() );
+
+		// Addresses in the registry are only freed in the destructor
+		// after this thread was joined.
+		lock.unlock();
+		sendBundles( messages, clients );
+		lock.lock();
+	}
+}
+
+void OscServer::sendBundles( const std::vector<H2Core::OscFeedbackQueue::Message>& messages,
+							 const std::vector<lo_address>& clients ) {
+	// LO_TT_IMMEDIATE is a compound literal and not valid C++.
+	lo_timetag immediately;
+	immediately.sec = 0;
+	immediately.frac = 1;
+
+	auto send = [&]( lo_bundle bundle ) {
+		for ( const auto& clientAddress : clients ) {
+			if ( lo_send_bundle( clientAddress, bundle ) == -1 ) {
+				WARNINGLOG( QString( "Unable to send OSC bundle to [%1:%2]: %3" )
+							.arg( lo_address_get_hostname( clientAddress ) )
+							.arg( lo_address_get_port( clientAddress ) )
+							.arg( lo_address_errstr( clientAddress ) ) );
+			}
+		}
+		// Frees the messages added as well.
+		lo_bundle_free_recursive( bundle );
+	};
+
+	lo_bundle bundle = nullptr;
+	size_t nBundleSize = 0;
+	for ( const auto& message : messages ) {
+		QByteArray data( message.data );
+		int nResult = 0;
+		lo_message msg = lo_message_deserialise( data.data(), data.size(),
+												 &nResult );
+		if ( msg == nullptr ) {
+			ERRORLOG( QString( "Unable to deserialize message [%1]: %2" )
+					  .arg( message.sPath ).arg( nResult ) );
+			continue;
+		}
+
+		const QByteArray path = message.sPath.toLatin1();
+		const size_t nLength = lo_message_length( msg, path.constData() );
+		if ( bundle != nullptr && nBundleSize + nLength > nMaxBundleSize ) {
+			send( bundle );
+			bundle = nullptr;
+		}
+		if ( bundle == nullptr ) {
+			bundle = lo_bundle_new( immediately );
+			nBundleSize = 0;
+		}
+		lo_bundle_add_message( bundle, path.constData(), msg );
+		nBundleSize += nLength;
+	}
+
+	if ( bundle != nullptr ) {
+		send( bundle );
 	}
 }
 
@@ -1222,6 +1380,7 @@ bool OscServer::init()
 	m_pServerThread->add_method(nullptr, nullptr, [&](lo_message msg){
 		lo_address address = lo_message_get_source(msg);
 
+		std::unique_lock<std::mutex> lock( m_feedbackMutex );
 		bool AddressRegistered = false;
 		for ( const auto& cclientAddress : m_pClientRegistry ){
 			if ( IsLoAddressEqual( address, cclientAddress ) ) {
@@ -1236,6 +1395,7 @@ bool OscServer::init()
 										   lo_address_get_hostname( address ),
 										   lo_address_get_port( address ) );
 			m_pClientRegistry.push_back( newAddress );
+			lock.unlock();
 			INFOLOG( QString( "New OSC client registered. Hostname: %1, port: %2, protocol: %3" )
 					 .arg( lo_address_get_hostname( address ) )
 					 .arg( lo_address_get_port( address ) )
@@ -1382,6 +1542,11 @@ bool OscServer::init()
 	m_pServerThread->add_method("/Hydrogen/PLAYLIST_REMOVE_SONG", "f",
 								PLAYLIST_REMOVE_SONG_Handler);
 
+	m_pServerThread->add_method("/Hydrogen/PROCESS_PROFILE", "",
+								PROCESS_PROFILE_Handler);
+	m_pServerThread->add_method("/Hydrogen/PROCESS_PROFILE", "f",
+								PROCESS_PROFILE_Handler);
+
 	m_pServerThread->add_method(nullptr, nullptr, generic_handler, nullptr);
 
 	m_bInitialized = true;
@@ -1403,6 +1568,11 @@ bool OscServer::start() {
 
 	m_pServerThread->start();
 
+	if ( ! m_feedbackThread.joinable() ) {
+		m_bFeedbackThreadRunning = true;
+		m_feedbackThread = std::thread( &OscServer::feedbackLoop, this );
+	}
+
 	int nOscPortUsed;
 	const auto pPref = H2Core::Preferences::get_instance();
 	if ( pPref->m_nOscTemporaryPort != -1 ) {
@@ -29,8 +29,13 @@
 
 
 #include <core/Object.h>
+#include <core/OscFeedbackQueue.h>
 #include <cassert>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 namespace lo
 {
@@ -843,6 +848,23 @@ class OscServer : public H2Core::Object<OscServer>
 		static void PLAYLIST_ADD_CURRENT_SONG_Handler(lo_arg **argv, int argc);
 		static void PLAYLIST_REMOVE_SONG_Handler(lo_arg **argv, int argc);
 
+		/**
+		 * Sends the timing statistics of all stages of the audio
+		 * engine's process cycle (see H2Core::ProcessProfiler) back
+		 * to the client requesting them.
+		 *
+		 * For each stage a message is sent to \e
+		 * /Hydrogen/PROCESS_PROFILE/[stage] containing the number of
+		 * recorded cycles followed by the last, mean, 99th percentile,
+		 * and maximum duration in milliseconds.
+		 *
+		 * \param argv If the optional "f" field is present and not
+		 * 0, the statistics are reset after being sent.
+		 * \param argc Number of arguments passed by the OSC
+		 * message.
+		 * \param msg Message providing the address of the client.*/
+		static void PROCESS_PROFILE_Handler(lo_arg **argv, int argc, lo_message msg);
+
 		/** 
 		 * Catches any incoming messages and display them. 
 		 *
@@ -879,10 +901,26 @@ class OscServer : public H2Core::Object<OscServer>
 	private:
 		OscServer();
 		
-		/** Helper function which sends a message with msgText to all 
-		 * connected clients. **/
+		/** Helper function which queues a message with msgText to be
+		 * sent to all connected clients.
+		 *
+		 * The message is serialized and handed over to the
+		 * #m_feedbackThread. Its sending does thus not block the
+		 * caller. Rapid changes of the same path are coalesced (see
+		 * H2Core::OscFeedbackQueue). **/
 		void broadcastMessage( const char* msgText, const lo_message& message);
 
+		/** Sends all feedback messages once they are due. Runs in
+		 * #m_feedbackThread. */
+		void feedbackLoop();
+		/** Sends @a messages as OSC bundles holding at most
+		 * #nMaxBundleSize bytes to each address in @a clients. */
+		void sendBundles( const std::vector<H2Core::OscFeedbackQueue::Message>& messages,
+						  const std::vector<lo_address>& clients );
+		/** Bundles are sent via UDP and should not exceed the size of
+		 * a single datagram by much. */
+		static constexpr size_t nMaxBundleSize = 4096;
+
 		/**
 		 * Used to determine whether the callback methods were already
 		 * added to #m_pServerThread.
@@ -907,6 +945,17 @@ class OscServer : public H2Core::Object<OscServer>
 		 * propagated to all registered clients.
 		 */
 		std::list<lo_address> m_pClientRegistry;
+
+		/** Guards #m_pClientRegistry, #m_pFeedbackQueue, and
+		 * #m_bFeedbackThreadRunning. */
+		std::mutex m_feedbackMutex;
+		std::condition_variable m_feedbackCondition;
+		/** Feedback messages not sent yet. */
+		H2Core::OscFeedbackQueue* m_pFeedbackQueue;
+		/** Publishes the feedback messages to all registered clients.
+		 * Started in start(). */
+		std::thread m_feedbackThread;
+		bool m_bFeedbackThreadRunning;
 };
 
 inline lo::ServerThread* OscServer::getServerThread() const {
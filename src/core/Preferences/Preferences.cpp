@@ -109,6 +109,10 @@ Preferences::Preferences()
 	, m_nMaxNotes( 256 )
 	, m_nBufferSize( 1024 )
 	, m_nSampleRate( 44100 )
+	, m_bLockRealtimeMemory( false )
+	, m_bResampleSamplesOnLoad( false )
+	, m_bEndSilentVoices( true )
+	, m_fSilenceThreshold( -96 )
 	, m_sOSSDevice( "/dev/dsp" )
 	, m_sMidiPortName(  Preferences::getNullMidiPort() )
 	, m_sMidiOutputPortName(  Preferences::getNullMidiPort() )
@@ -121,6 +125,7 @@ Preferences::Preferences()
 	, m_bOscFeedbackEnabled( true )
 	, m_nOscTemporaryPort( -1 )
 	, m_nOscServerPort( 9000 )
+	, m_bAlsaDither( true )
 	, m_sPortAudioDevice( "" )
 	, m_sPortAudioHostAPI( "" )
 	, m_nLatencyTarget( 0 )
@@ -149,6 +154,7 @@ Preferences::Preferences()
 	, m_bUseLash( false )
 	, m_nMaxBars( 400 )
 	, m_nMaxLayers( 16 )
+	, m_nUndoLimit( 250 )
 #ifdef H2CORE_HAVE_OSC
 	, m_sNsmClientId( "" )
 #endif
@@ -288,6 +294,10 @@ Preferences::Preferences( std::shared_ptr<Preferences> pOther )
 	, m_nMaxNotes( pOther->m_nMaxNotes )
 	, m_nBufferSize( pOther->m_nBufferSize )
 	, m_nSampleRate( pOther->m_nSampleRate )
+	, m_bLockRealtimeMemory( pOther->m_bLockRealtimeMemory )
+	, m_bResampleSamplesOnLoad( pOther->m_bResampleSamplesOnLoad )
+	, m_bEndSilentVoices( pOther->m_bEndSilentVoices )
+	, m_fSilenceThreshold( pOther->m_fSilenceThreshold )
 	, m_sOSSDevice( pOther->m_sOSSDevice )
 	, m_sMidiDriver( pOther->m_sMidiDriver )
 	, m_sMidiPortName( pOther->m_sMidiPortName )
@@ -302,6 +312,7 @@ Preferences::Preferences( std::shared_ptr<Preferences> pOther )
 	, m_nOscTemporaryPort( pOther->m_nOscTemporaryPort )
 	, m_nOscServerPort( pOther->m_nOscServerPort )
 	, m_sAlsaAudioDevice( pOther->m_sAlsaAudioDevice )
+	, m_bAlsaDither( pOther->m_bAlsaDither )
 	, m_sPortAudioDevice( pOther->m_sPortAudioDevice )
 	, m_sPortAudioHostAPI( pOther->m_sPortAudioHostAPI )
 	, m_nLatencyTarget( pOther->m_nLatencyTarget )
@@ -331,6 +342,7 @@ Preferences::Preferences( std::shared_ptr<Preferences> pOther )
 	, m_bUseLash( pOther->m_bUseLash )
 	, m_nMaxBars( pOther->m_nMaxBars )
 	, m_nMaxLayers( pOther->m_nMaxLayers )
+	, m_nUndoLimit( pOther->m_nUndoLimit )
 #ifdef H2CORE_HAVE_OSC
 	, m_sNsmClientId( pOther->m_sNsmClientId )
 #endif
@@ -451,6 +463,8 @@ std::shared_ptr<Preferences> Preferences::load( const QString& sPath, const bool
 		"maxBars", pPref->m_nMaxBars, false, false, bSilent );
 	pPref->m_nMaxLayers = rootNode.read_int(
 		"maxLayers", pPref->m_nMaxLayers, false, false, bSilent );
+	pPref->m_nUndoLimit = std::max( rootNode.read_int(
+		"undoLimit", pPref->m_nUndoLimit, false, false, bSilent ), 0 );
 	if ( pPref->m_nMaxLayers < 16 ) {
 		WARNINGLOG( QString( "[maxLayers: %1] is smaller than the minimum number of layers [16]" )
 					.arg( pPref->m_nMaxLayers ) );
@@ -582,6 +596,18 @@ std::shared_ptr<Preferences> Preferences::load( const QString& sPath, const bool
 			"buffer_size", pPref->m_nBufferSize, false, false, bSilent );
 		pPref->m_nSampleRate = audioEngineNode.read_int(
 			"samplerate", pPref->m_nSampleRate, false, false, bSilent );
+		pPref->m_bLockRealtimeMemory = audioEngineNode.read_bool(
+			"lock_realtime_memory", pPref->m_bLockRealtimeMemory, false, false,
+			bSilent );
+		pPref->m_bResampleSamplesOnLoad = audioEngineNode.read_bool(
+			"resample_samples_on_load", pPref->m_bResampleSamplesOnLoad,
+			false, false, bSilent );
+		pPref->m_bEndSilentVoices = audioEngineNode.read_bool(
+			"end_silent_voices", pPref->m_bEndSilentVoices,
+			false, false, bSilent );
+		pPref->m_fSilenceThreshold = audioEngineNode.read_float(
+			"silence_threshold", pPref->m_fSilenceThreshold,
+			false, false, bSilent );
 
 		//// OSS DRIVER ////
 		const XMLNode ossDriverNode =
@@ -689,6 +715,8 @@ std::shared_ptr<Preferences> Preferences::load( const QString& sPath, const bool
 			pPref->m_sAlsaAudioDevice = alsaAudioDriverNode.read_string(
 				"alsa_audio_device",
 				pPref->m_sAlsaAudioDevice, false, false, bSilent );
+			pPref->m_bAlsaDither = alsaAudioDriverNode.read_bool(
+				"alsa_dither", pPref->m_bAlsaDither, false, false, bSilent );
 		} else {
 			WARNINGLOG( "<alsa_audio_driver> node not found" );
 		}
@@ -1070,6 +1098,7 @@ bool Preferences::saveTo( const QString& sPath, const bool bSilent ) const {
 
 	rootNode.write_int( "maxBars", m_nMaxBars );
 	rootNode.write_int( "maxLayers", m_nMaxLayers );
+	rootNode.write_int( "undoLimit", m_nUndoLimit );
 
 	rootNode.write_int( "defaultUILayout", static_cast<int>(
 							interfaceTheme.m_layout) );
@@ -1149,6 +1178,11 @@ bool Preferences::saveTo( const QString& sPath, const bool bSilent ) const {
 		audioEngineNode.write_int( "maxNotes", m_nMaxNotes );
 		audioEngineNode.write_int( "buffer_size", m_nBufferSize );
 		audioEngineNode.write_int( "samplerate", m_nSampleRate );
+		audioEngineNode.write_bool( "lock_realtime_memory", m_bLockRealtimeMemory );
+		audioEngineNode.write_bool( "resample_samples_on_load",
+									m_bResampleSamplesOnLoad );
+		audioEngineNode.write_bool( "end_silent_voices", m_bEndSilentVoices );
+		audioEngineNode.write_float( "silence_threshold", m_fSilenceThreshold );
 
 		//// OSS DRIVER ////
 		XMLNode ossDriverNode = audioEngineNode.createNode( "oss_driver" );
@@ -1215,6 +1249,7 @@ bool Preferences::saveTo( const QString& sPath, const bool bSilent ) const {
 		XMLNode alsaAudioDriverNode = audioEngineNode.createNode( "alsa_audio_driver" );
 		{
 			alsaAudioDriverNode.write_string( "alsa_audio_device", m_sAlsaAudioDevice );
+			alsaAudioDriverNode.write_bool( "alsa_dither", m_bAlsaDither );
 		}
 
 		/// MIDI DRIVER ///
@@ -1395,6 +1430,9 @@ Preferences::AudioDriver Preferences::parseAudioDriver( const QString& sDriver )
 	else if ( s == "portaudio" || s == "port" ) {
 		return AudioDriver::PortAudio;
 	}
+	else if ( s == "null" ) {
+		return AudioDriver::Null;
+	}
 	else {
 		if ( Logger::isAvailable() ) {
 			ERRORLOG( QString( "Unable to parse driver [%1]" ). arg( sDriver ) );
@@ -1680,6 +1718,14 @@ QString Preferences::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( s ).arg( m_nBufferSize ) )
 			.append( QString( "%1%2m_nSampleRate: %3\n" ).arg( sPrefix )
 					 .arg( s ).arg( m_nSampleRate ) )
+			.append( QString( "%1%2m_bLockRealtimeMemory: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_bLockRealtimeMemory ) )
+			.append( QString( "%1%2m_bResampleSamplesOnLoad: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_bResampleSamplesOnLoad ) )
+			.append( QString( "%1%2m_bEndSilentVoices: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_bEndSilentVoices ) )
+			.append( QString( "%1%2m_fSilenceThreshold: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_fSilenceThreshold ) )
 			.append( QString( "%1%2m_sOSSDevice: %3\n" ).arg( sPrefix )
 					 .arg( s ).arg( m_sOSSDevice ) )
 			.append( QString( "%1%2m_sMidiDriver: %3\n" ).arg( sPrefix )
@@ -1708,6 +1754,8 @@ QString Preferences::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( s ).arg( m_nOscServerPort ) )
 			.append( QString( "%1%2m_sAlsaAudioDevice: %3\n" ).arg( sPrefix )
 					 .arg( s ).arg( m_sAlsaAudioDevice ) )
+			.append( QString( "%1%2m_bAlsaDither: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_bAlsaDither ) )
 			.append( QString( "%1%2m_sPortAudioDevice: %3\n" ).arg( sPrefix )
 					 .arg( s ).arg( m_sPortAudioDevice ) )
 			.append( QString( "%1%2m_sPortAudioHostAPI: %3\n" ).arg( sPrefix )
@@ -1770,6 +1818,8 @@ QString Preferences::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( s ).arg( m_nMaxBars ) )
 			.append( QString( "%1%2m_nMaxLayers: %3\n" ).arg( sPrefix )
 					 .arg( s ).arg( m_nMaxLayers ) )
+			.append( QString( "%1%2m_nUndoLimit: %3\n" ).arg( sPrefix )
+					 .arg( s ).arg( m_nUndoLimit ) )
 #ifdef H2CORE_HAVE_OSC
 			.append( QString( "%1%2m_sNsmClientId: %3\n" ).arg( sPrefix )
 					 .arg( s ).arg( m_sNsmClientId ) )
@@ -1925,6 +1975,14 @@ QString Preferences::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( m_nBufferSize ) )
 			.append( QString( ", m_nSampleRate: %1" )
 					 .arg( m_nSampleRate ) )
+			.append( QString( ", m_bLockRealtimeMemory: %1" )
+					 .arg( m_bLockRealtimeMemory ) )
+			.append( QString( ", m_bResampleSamplesOnLoad: %1" )
+					 .arg( m_bResampleSamplesOnLoad ) )
+			.append( QString( ", m_bEndSilentVoices: %1" )
+					 .arg( m_bEndSilentVoices ) )
+			.append( QString( ", m_fSilenceThreshold: %1" )
+					 .arg( m_fSilenceThreshold ) )
 			.append( QString( ", m_sOSSDevice: %1" )
 					 .arg( m_sOSSDevice ) )
 			.append( QString( ", m_sMidiDriver: %1" )
@@ -1953,6 +2011,8 @@ QString Preferences::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( m_nOscServerPort ) )
 			.append( QString( ", m_sAlsaAudioDevice: %1" )
 					 .arg( m_sAlsaAudioDevice ) )
+			.append( QString( ", m_bAlsaDither: %1" )
+					 .arg( m_bAlsaDither ) )
 			.append( QString( ", m_sPortAudioDevice: %1" )
 					 .arg( m_sPortAudioDevice ) )
 			.append( QString( ", m_sPortAudioHostAPI: %1" )
@@ -2015,6 +2075,8 @@ QString Preferences::toQString( const QString& sPrefix, bool bShort ) const {
 					 .arg( m_nMaxBars ) )
 			.append( QString( ", m_nMaxLayers: %1" )
 					 .arg( m_nMaxLayers ) )
+			.append( QString( ", m_nUndoLimit: %1" )
+					 .arg( m_nUndoLimit ) )
 #ifdef H2CORE_HAVE_OSC
 			.append( QString( ", m_sNsmClientId: %1" )
 					 .arg( m_sNsmClientId ) )
@@ -266,6 +266,23 @@ public:
 	 * rate of the freshly opened JACK client.
 	 */
 	unsigned			m_nSampleRate;
+	/** Whether sample data and audio buffers are locked into RAM.
+	 *
+	 * \sa RealtimeMemory */
+	bool				m_bLockRealtimeMemory;
+	/** Whether samples are converted to the sample rate of the audio
+	 * driver while loading them.
+	 *
+	 * \sa Sample::setTargetSampleRate() */
+	bool				m_bResampleSamplesOnLoad;
+	/** Whether the #Sampler ends voices as soon as the remaining part
+	 * of their sample is below #m_fSilenceThreshold.
+	 *
+	 * \sa Sample::getTailPeak() */
+	bool				m_bEndSilentVoices;
+	/** Level in dBFS below which the tail of a voice is considered
+	 * inaudible. */
+	float				m_fSilenceThreshold;
 
 	//	OSS driver properties ___
 	QString				m_sOSSDevice;		///< Device used for output
@@ -340,6 +357,9 @@ public:
 
 	//	alsa audio driver properties ___
 	QString				m_sAlsaAudioDevice;
+	/** Whether to add triangular dither when the ALSA device only
+	 * supports 16 bit samples. */
+	bool				m_bAlsaDither;
 
 	// PortAudio properties
 	QString				m_sPortAudioDevice;
@@ -446,6 +466,10 @@ public:
 	int				getMaxLayers() const;
 	/** @param layers Sets #m_nMaxLayers.*/
 	void			setMaxLayers( const int layers );
+	/** @return #m_nUndoLimit.*/
+	int				getUndoLimit() const;
+	/** @param nLimit Sets #m_nUndoLimit.*/
+	void			setUndoLimit( int nLimit );
 
 #if defined(H2CORE_HAVE_OSC) || _DOXYGEN_
 	const QString&	getNsmClientId(void) const;
@@ -640,6 +664,10 @@ private:
 	/** Maximum number of layers to be used in the Instrument
 	 *  editor. */
 	int					m_nMaxLayers;
+	/** Maximum number of actions kept in the undo history. The
+	 * oldest ones are dropped once it is exceeded. 0 means no
+	 * limit. Applied on startup. */
+	int					m_nUndoLimit;
 
 #if defined(H2CORE_HAVE_OSC) || _DOXYGEN_
 		QString			m_sNsmClientId;
@@ -1150,6 +1178,14 @@ inline int Preferences::getMaxLayers() const {
 	return m_nMaxLayers;
 }
 
+inline void Preferences::setUndoLimit( int nLimit ){
+	m_nUndoLimit = nLimit;
+}
+
+inline int Preferences::getUndoLimit() const {
+	return m_nUndoLimit;
+}
+
 #if defined(H2CORE_HAVE_OSC) || _DOXYGEN_
 inline void Preferences::setNsmClientId(const QString& nsmClientId){
 	m_sNsmClientId = nsmClientId;
@@ -29,6 +29,7 @@
 #include <core/Basics/Instrument.h>
 #include <core/Basics/InstrumentList.h>
 #include <core/Basics/AutomationPath.h>
+#include <core/Helpers/Random.h>
 
 #include <QFile>
 #include <QTextCodec>
@@ -261,8 +262,7 @@ void SMFWriter::save( const QString& sFilename, std::shared_ptr<Song> pSong )
 					Note *pNote = it->second;
 					if ( pNote != nullptr &&
 						 pNote->get_instrument() != nullptr ) {
-						float rnd = (float)rand()/(float)RAND_MAX;
-						if ( pNote->get_probability() < rnd ) {
+						if ( pNote->get_probability() < Random::getUniform() ) {
 							continue;
 						}
 
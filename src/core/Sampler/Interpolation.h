@@ -23,6 +23,8 @@
 #ifndef INTERPOLATION_H
 #define INTERPOLATION_H
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <QString>
 
@@ -35,7 +37,10 @@ namespace Interpolation
 								Cosine = 1,
 								Third = 2,
 								Cubic = 3,
-								Hermite = 4 };
+								Hermite = 4,
+								/** Band-limited windowed sinc. See
+								 * SincInterpolator. */
+								Sinc = 5 };
 
 	static const QString ModeToQString( const InterpolateMode& mode )
 	{
@@ -50,11 +55,56 @@ namespace Interpolation
 			return "Cubic";
 		case InterpolateMode::Hermite:
 			return "Hermite";
+		case InterpolateMode::Sinc:
+			return "Sinc";
 		default:
 			return "<unknown>";
 		}
 	}
 
+	/** Inverse of ModeToQString(). The comparison is case
+	 * insensitive.
+	 *
+	 * \param pOk set to false in case @a sMode does not match any mode
+	 *   (Linear is returned in this case). */
+	static InterpolateMode ModeFromQString( const QString& sMode,
+											bool* pOk = nullptr )
+	{
+		for ( const auto& mode : { InterpolateMode::Linear,
+								   InterpolateMode::Cosine,
+								   InterpolateMode::Third,
+								   InterpolateMode::Cubic,
+								   InterpolateMode::Hermite,
+								   InterpolateMode::Sinc } ) {
+			if ( ModeToQString( mode ).compare(
+					 sMode, Qt::CaseInsensitive ) == 0 ) {
+				if ( pOk != nullptr ) {
+					*pOk = true;
+				}
+				return mode;
+			}
+		}
+		if ( pOk != nullptr ) {
+			*pOk = false;
+		}
+		return InterpolateMode::Linear;
+	}
+
+	/** Resolution of #cosineTable. */
+	static constexpr int nCosineTableSize = 1024;
+
+	/** ( 1 - cos( mu * pi ) ) / 2 for mu in [0, 1] sampled at
+	 * #nCosineTableSize + 1 points. Replaces the call to cos() in
+	 * cosine_Interpolate(). */
+	inline const std::array<float, nCosineTableSize + 1> cosineTable = [](){
+		std::array<float, nCosineTableSize + 1> table;
+		for ( int ii = 0; ii <= nCosineTableSize; ++ii ) {
+			table[ ii ] = static_cast<float>(
+				( 1 - std::cos( M_PI * ii / nCosineTableSize ) ) / 2 );
+		}
+		return table;
+	}();
+
 	inline static float linear_Interpolate( float y1, float y2, float mu )
 	{
 			/*
@@ -72,9 +122,14 @@ namespace Interpolation
 			 * y1 = buffervalue on position
 			 * y2 = buffervalue on position +1
 			 */
-			double mu2;
-	
-			mu2 = ( 1 - cos ( mu * 3.14159 ) ) / 2;
+			// Linear interpolation within the table is way cheaper than
+			// calling cos() and its error is far below the one of the
+			// interpolation itself.
+			const float fPos = static_cast<float>(mu) * nCosineTableSize;
+			const int nPos = std::min( static_cast<int>(fPos),
+									   nCosineTableSize - 1 );
+			const float mu2 = cosineTable[ nPos ] + ( fPos - nPos ) *
+				( cosineTable[ nPos + 1 ] - cosineTable[ nPos ] );
 			return( y1 * (1 - mu2 ) + y2 * mu2 );
 	};
 	
@@ -151,6 +206,9 @@ namespace Interpolation
 			return cubic_Interpolate( y0, y1, y2, y3, mu );
 		case InterpolateMode::Hermite:
 			return hermite_Interpolate( y0, y1, y2, y3, mu );
+		case InterpolateMode::Sinc:
+			// Requires more than four frames and is handled by
+			// SincInterpolator.
 		default:
 			assert( false && "Unknown interpolation mode" );
 		}
@@ -0,0 +1,74 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/Sampler/PanLawTable.h>
+
+#include <core/Sampler/Sampler.h>
+
+namespace H2Core
+{
+
+PanLawTable::PanLawTable()
+	: m_nPanLawType( -1 )
+	, m_fKNorm( 0 )
+	, m_nVersion( 0 ) {
+	update( Sampler::RATIO_STRAIGHT_POLYGONAL, Sampler::K_NORM_DEFAULT );
+}
+
+bool PanLawTable::update( int nPanLawType, float fKNorm ) {
+	if ( nPanLawType == m_nPanLawType && fKNorm == m_fKNorm ) {
+		return false;
+	}
+
+	for ( int ii = 0; ii <= nSize; ++ii ) {
+		const float fPan = -1 + 2 * static_cast<float>(ii) / nSize;
+		m_table[ ii ] = Sampler::computePanLaw( fPan, nPanLawType, fKNorm );
+	}
+
+	m_nPanLawType = nPanLawType;
+	m_fKNorm = fKNorm;
+	++m_nVersion;
+
+	return true;
+}
+
+QString PanLawTable::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[PanLawTable]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_nPanLawType: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nPanLawType ) )
+			.append( QString( "%1%2m_fKNorm: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_fKNorm ) )
+			.append( QString( "%1%2m_nVersion: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nVersion ) );
+	}
+	else {
+		sOutput = QString( "[PanLawTable] m_nPanLawType: %1" ).arg( m_nPanLawType )
+			.append( QString( ", m_fKNorm: %1" ).arg( m_fKNorm ) )
+			.append( QString( ", m_nVersion: %1" ).arg( m_nVersion ) );
+	}
+
+	return sOutput;
+}
+
+};
@@ -0,0 +1,108 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef PAN_LAW_TABLE_H
+#define PAN_LAW_TABLE_H
+
+#include <array>
+
+#include <core/Object.h>
+
+namespace H2Core
+{
+
+/**
+ * Pan law of the current song sampled at #nSize + 1 equidistant pan
+ * values in [-1, 1].
+ *
+ * Most pan laws (see Sampler::PAN_LAW_TYPES) involve sqrt(), pow(),
+ * or trigonometric functions. Instead of evaluating them for every
+ * rendered note the table is filled once whenever the pan law type or
+ * k-norm of the song changes and linearly interpolated in between.
+ * Pan values at the nodes, including center and both hard pans, are
+ * exact. The largest deviation, below 0.006, occurs in the outermost
+ * intervals of the laws involving square roots.
+ *
+ * \ingroup docCore
+ */
+class PanLawTable : public H2Core::Object<PanLawTable>
+{
+	H2_OBJECT(PanLawTable)
+public:
+	PanLawTable();
+
+	/**
+	 * Refills the table in case @a nPanLawType or @a fKNorm differ
+	 * from the ones used last time.
+	 *
+	 * \return true if the table was refilled.
+	 */
+	bool update( int nPanLawType, float fKNorm );
+
+	/** Gain of the left channel for @a fPan. The one of the right
+	 * channel is obtained by passing -@a fPan. */
+	float gain( float fPan ) const;
+
+	/** Incremented every time the table is refilled. Allows to detect
+	 * gains computed using an outdated pan law. */
+	int getVersion() const;
+
+	/** Even number of intervals, so center pan is a node as well. */
+	static constexpr int nSize = 2048;
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	std::array<float, nSize + 1> m_table;
+	int m_nPanLawType;
+	float m_fKNorm;
+	int m_nVersion;
+};
+
+inline float PanLawTable::gain( float fPan ) const {
+	float fPosition = ( fPan + 1 ) * ( 0.5f * nSize );
+	if ( fPosition <= 0 ) {
+		return m_table[ 0 ];
+	}
+	else if ( fPosition >= nSize ) {
+		return m_table[ nSize ];
+	}
+	const int nIndex = static_cast<int>(fPosition);
+	const float fFraction = fPosition - nIndex;
+	return m_table[ nIndex ] +
+		fFraction * ( m_table[ nIndex + 1 ] - m_table[ nIndex ] );
+}
+
+inline int PanLawTable::getVersion() const {
+	return m_nVersion;
+}
+
+};
+
+#endif
@@ -0,0 +1,213 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef RESONANT_FILTER_H
+#define RESONANT_FILTER_H
+
+#include <algorithm>
+#include <cmath>
+#include <QString>
+
+namespace H2Core
+{
+
+/**
+ * Resonant filter applied to the notes of instruments with an active
+ * filter (see Instrument::is_filter_active()).
+ *
+ * A two-pole state variable filter. Its recurrence
+ *
+ *     bp = resonance * bp + cutoff * ( in - lp )
+ *     lp = lp + cutoff * bp
+ *
+ * is the one Hydrogen always used for its low-pass filter, so existing
+ * kits and songs sound the same. The high-pass output is the input
+ * minus the low-pass one. The band-pass output is scaled by
+ * ( 1 - resonance ) / cutoff to keep its peak gain close to unity
+ * while the resonance narrows the pass band.
+ */
+namespace ResonantFilter
+{
+	enum class Mode { LowPass = 0,
+					  HighPass = 1,
+					  BandPass = 2 };
+
+	static const QString ModeToQString( const Mode& mode )
+	{
+		switch ( mode ) {
+		case Mode::LowPass:
+			return "LowPass";
+		case Mode::HighPass:
+			return "HighPass";
+		case Mode::BandPass:
+			return "BandPass";
+		default:
+			return "<unknown>";
+		}
+	}
+
+	/** Inverse of ModeToQString(). The comparison is case
+	 * insensitive.
+	 *
+	 * \param pOk set to false in case @a sMode does not match any mode
+	 *   (LowPass is returned in this case). */
+	static Mode ModeFromQString( const QString& sMode, bool* pOk = nullptr )
+	{
+		for ( const auto& mode : { Mode::LowPass, Mode::HighPass,
+								   Mode::BandPass } ) {
+			if ( ModeToQString( mode ).compare(
+					 sMode, Qt::CaseInsensitive ) == 0 ) {
+				if ( pOk != nullptr ) {
+					*pOk = true;
+				}
+				return mode;
+			}
+		}
+		if ( pOk != nullptr ) {
+			*pOk = false;
+		}
+		return Mode::LowPass;
+	}
+
+	/** Lower bound of the cutoff used to normalize the band-pass
+	 * output. Below it the gain would grow without bounds. */
+	static constexpr float fMinBandPassCutoff = 0.001;
+
+	/** Filter state of a single note. */
+	struct State {
+		/** Band-pass integrators of the left and right channel. */
+		float bp[ 2 ] = { 0, 0 };
+		/** Low-pass integrators of the left and right channel. */
+		float lp[ 2 ] = { 0, 0 };
+		/** Parameters reached at the end of the last block. A negative
+		 * cutoff indicates no block was processed yet. */
+		float fCutoff = -1;
+		float fResonance = 0;
+
+		/** Whether the filter still produces output without input. */
+		bool isRinging() const {
+			const float fLimit = 0.001;
+			return std::abs( lp[ 0 ] ) > fLimit || std::abs( lp[ 1 ] ) > fLimit ||
+				std::abs( bp[ 0 ] ) > fLimit || std::abs( bp[ 1 ] ) > fLimit;
+		}
+	};
+
+	/**
+	 * Filters a block of @a nFrames frames in place.
+	 *
+	 * Both parameters are ramped linearly from the values reached in
+	 * the previous block to @a fCutoff and @a fResonance, so turning
+	 * the knobs while a note is playing does not produce zipper noise.
+	 *
+	 * The integrators of both channels are kept in local two-element
+	 * arrays processed by the same instructions, which allows the
+	 * compiler to handle the stereo pair in a single SIMD register.
+	 */
+	template <Mode mode>
+	inline void process( State& state, float* pBuffer_L, float* pBuffer_R,
+						 int nFrames, float fCutoff, float fResonance )
+	{
+		if ( nFrames <= 0 ) {
+			return;
+		}
+		if ( state.fCutoff < 0 ) {
+			state.fCutoff = fCutoff;
+			state.fResonance = fResonance;
+		}
+
+		const float fCutoffStep = ( fCutoff - state.fCutoff ) / nFrames;
+		const float fResonanceStep = ( fResonance - state.fResonance ) / nFrames;
+		float fCurrentCutoff = state.fCutoff;
+		float fCurrentResonance = state.fResonance;
+
+		// Gain of the band-pass output. It is ramped as well to avoid a
+		// division per frame.
+		float fGain = 0;
+		float fGainStep = 0;
+		if constexpr ( mode == Mode::BandPass ) {
+			fGain = ( 1 - state.fResonance ) /
+				std::max( state.fCutoff, fMinBandPassCutoff );
+			fGainStep = ( ( 1 - fResonance ) /
+						  std::max( fCutoff, fMinBandPassCutoff ) -
+						  fGain ) / nFrames;
+		}
+
+		float bp[ 2 ] = { state.bp[ 0 ], state.bp[ 1 ] };
+		float lp[ 2 ] = { state.lp[ 0 ], state.lp[ 1 ] };
+		for ( int ii = 0; ii < nFrames; ++ii ) {
+			const float in[ 2 ] = { pBuffer_L[ ii ], pBuffer_R[ ii ] };
+			float out[ 2 ];
+			for ( int nChannel = 0; nChannel < 2; ++nChannel ) {
+				bp[ nChannel ] = fCurrentResonance * bp[ nChannel ] +
+					fCurrentCutoff * ( in[ nChannel ] - lp[ nChannel ] );
+				lp[ nChannel ] += fCurrentCutoff * bp[ nChannel ];
+				if constexpr ( mode == Mode::LowPass ) {
+					out[ nChannel ] = lp[ nChannel ];
+				}
+				else if constexpr ( mode == Mode::HighPass ) {
+					out[ nChannel ] = in[ nChannel ] - lp[ nChannel ];
+				}
+				else {
+					out[ nChannel ] = fGain * bp[ nChannel ];
+				}
+			}
+			pBuffer_L[ ii ] = out[ 0 ];
+			pBuffer_R[ ii ] = out[ 1 ];
+
+			fCurrentCutoff += fCutoffStep;
+			fCurrentResonance += fResonanceStep;
+			if constexpr ( mode == Mode::BandPass ) {
+				fGain += fGainStep;
+			}
+		}
+
+		state.bp[ 0 ] = bp[ 0 ];
+		state.bp[ 1 ] = bp[ 1 ];
+		state.lp[ 0 ] = lp[ 0 ];
+		state.lp[ 1 ] = lp[ 1 ];
+		state.fCutoff = fCutoff;
+		state.fResonance = fResonance;
+	}
+
+	/** Dispatches to the variant of process() for @a mode. */
+	inline void process( Mode mode, State& state, float* pBuffer_L,
+						 float* pBuffer_R, int nFrames, float fCutoff,
+						 float fResonance )
+	{
+		switch ( mode ) {
+		case Mode::HighPass:
+			process<Mode::HighPass>( state, pBuffer_L, pBuffer_R, nFrames,
+									 fCutoff, fResonance );
+			break;
+		case Mode::BandPass:
+			process<Mode::BandPass>( state, pBuffer_L, pBuffer_R, nFrames,
+									 fCutoff, fResonance );
+			break;
+		default:
+			process<Mode::LowPass>( state, pBuffer_L, pBuffer_R, nFrames,
+									fCutoff, fResonance );
+		}
+	}
+};
+
+};
+
+#endif
@@ -0,0 +1,186 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/Sampler/SampleRateConverter.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+
+namespace H2Core
+{
+
+SampleRateConverter::SampleRateConverter( int nInputRate, int nOutputRate )
+	: m_nInputRate( std::max( nInputRate, 1 ) )
+	, m_nOutputRate( std::max( nOutputRate, 1 ) ) {
+
+	const int nGcd = std::gcd( m_nInputRate, m_nOutputRate );
+	m_nUp = m_nOutputRate / nGcd;
+	m_nDown = m_nInputRate / nGcd;
+	m_nPhases = std::min( m_nUp, nMaxPhases );
+
+	// When downsampling the cutoff has to be lowered to the Nyquist
+	// frequency of the output and the kernel widens accordingly.
+	const double fRelativeCutoff = fCutoff *
+		std::min( 1.0, static_cast<double>(m_nOutputRate) / m_nInputRate );
+	m_nHalfTaps = static_cast<int>(
+		std::ceil( nZeroCrossings / fRelativeCutoff ) );
+
+	const int nTaps = 2 * m_nHalfTaps;
+	const double fNormalization = besselI0( fKaiserBeta );
+	m_table.resize( static_cast<size_t>( m_nPhases + 1 ) * nTaps );
+
+	for ( int nPhase = 0; nPhase <= m_nPhases; ++nPhase ) {
+		const double fFraction = static_cast<double>(nPhase) / m_nPhases;
+		float* pRow = m_table.data() + static_cast<size_t>(nPhase) * nTaps;
+
+		double fSum = 0;
+		for ( int ii = 0; ii < nTaps; ++ii ) {
+			// Distance between the input frame and the output frame
+			// in input frames.
+			const double fX = ( ii - m_nHalfTaps + 1 ) - fFraction;
+			const double fT = fX / m_nHalfTaps;
+
+			double fValue = 0;
+			if ( std::abs( fT ) < 1 ) {
+				const double fArg = M_PI * fRelativeCutoff * fX;
+				const double fSinc = fArg == 0 ? 1 : std::sin( fArg ) / fArg;
+				fValue = fRelativeCutoff * fSinc *
+					besselI0( fKaiserBeta * std::sqrt( 1 - fT * fT ) ) /
+					fNormalization;
+			}
+			pRow[ ii ] = static_cast<float>(fValue);
+			fSum += fValue;
+		}
+
+		// Unity gain at DC for every phase. Otherwise a constant signal
+		// would be modulated by the phase pattern.
+		if ( fSum != 0 ) {
+			for ( int ii = 0; ii < nTaps; ++ii ) {
+				pRow[ ii ] = static_cast<float>( pRow[ ii ] / fSum );
+			}
+		}
+	}
+}
+
+double SampleRateConverter::besselI0( double fX ) {
+	// Power series. Converges quickly for the arguments used for
+	// Kaiser windows.
+	double fSum = 1;
+	double fTerm = 1;
+	const double fHalfX = fX / 2;
+	for ( int kk = 1; kk < 64; ++kk ) {
+		fTerm *= ( fHalfX / kk ) * ( fHalfX / kk );
+		fSum += fTerm;
+		if ( fTerm < fSum * 1e-12 ) {
+			break;
+		}
+	}
+	return fSum;
+}
+
+int SampleRateConverter::getOutputFrames( int nInputFrames ) const {
+	if ( nInputFrames <= 0 ) {
+		return 0;
+	}
+	const int64_t nFrames =
+		( static_cast<int64_t>(nInputFrames) * m_nUp + m_nDown - 1 ) / m_nDown;
+	return static_cast<int>(
+		std::min( nFrames,
+				  static_cast<int64_t>( std::numeric_limits<int>::max() ) ) );
+}
+
+void SampleRateConverter::process( const float* pInput, int nInputFrames,
+								   float* pOutput ) const {
+	const int nOutputFrames = getOutputFrames( nInputFrames );
+	const int nTaps = 2 * m_nHalfTaps;
+	const bool bExactPhases = m_nPhases == m_nUp;
+
+	for ( int nn = 0; nn < nOutputFrames; ++nn ) {
+		const int64_t nPosition = static_cast<int64_t>(nn) * m_nDown;
+		const int nFrame = static_cast<int>( nPosition / m_nUp );
+		const int nRemainder = static_cast<int>( nPosition % m_nUp );
+
+		// Input frames covered by the kernel clipped to the sample.
+		const int nFirst = nFrame - m_nHalfTaps + 1;
+		const int nStart = std::max( 0, -nFirst );
+		const int nEnd = std::min( nTaps, nInputFrames - nFirst );
+
+		float fValue = 0;
+		if ( bExactPhases ) {
+			const float* pRow = m_table.data() +
+				static_cast<size_t>(nRemainder) * nTaps;
+			for ( int ii = nStart; ii < nEnd; ++ii ) {
+				fValue += pInput[ nFirst + ii ] * pRow[ ii ];
+			}
+		}
+		else {
+			const double fPhase =
+				static_cast<double>(nRemainder) * m_nPhases / m_nUp;
+			const int nPhase = static_cast<int>(fPhase);
+			const float fWeight = static_cast<float>( fPhase - nPhase );
+			const float* pRow = m_table.data() +
+				static_cast<size_t>(nPhase) * nTaps;
+			const float* pNextRow = pRow + nTaps;
+			for ( int ii = nStart; ii < nEnd; ++ii ) {
+				const float fCoefficient = pRow[ ii ] +
+					fWeight * ( pNextRow[ ii ] - pRow[ ii ] );
+				fValue += pInput[ nFirst + ii ] * fCoefficient;
+			}
+		}
+		pOutput[ nn ] = fValue;
+	}
+}
+
+QString SampleRateConverter::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[SampleRateConverter]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_nInputRate: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nInputRate ) )
+			.append( QString( "%1%2m_nOutputRate: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nOutputRate ) )
+			.append( QString( "%1%2m_nUp: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nUp ) )
+			.append( QString( "%1%2m_nDown: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nDown ) )
+			.append( QString( "%1%2m_nHalfTaps: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nHalfTaps ) )
+			.append( QString( "%1%2m_nPhases: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nPhases ) );
+	}
+	else {
+		sOutput = QString( "[SampleRateConverter] m_nInputRate: %1" )
+			.arg( m_nInputRate )
+			.append( QString( ", m_nOutputRate: %1" ).arg( m_nOutputRate ) )
+			.append( QString( ", m_nUp: %1" ).arg( m_nUp ) )
+			.append( QString( ", m_nDown: %1" ).arg( m_nDown ) )
+			.append( QString( ", m_nHalfTaps: %1" ).arg( m_nHalfTaps ) )
+			.append( QString( ", m_nPhases: %1" ).arg( m_nPhases ) );
+	}
+
+	return sOutput;
+}
+
+};
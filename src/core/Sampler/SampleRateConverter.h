@@ -0,0 +1,119 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef SAMPLE_RATE_CONVERTER_H
+#define SAMPLE_RATE_CONVERTER_H
+
+#include <vector>
+
+#include <core/Object.h>
+
+namespace H2Core
+{
+
+/**
+ * Offline sample rate conversion using a Kaiser windowed sinc filter.
+ *
+ * In contrast to the interpolation performed by the Sampler while
+ * rendering a note this converter is band-limited and way too
+ * expensive to be used in the audio thread. It is intended to convert
+ * whole samples once while loading them (see
+ * Sample::setTargetSampleRate()).
+ *
+ * The ratio between both rates is reduced to L/M and the filter is
+ * stored as a polyphase table containing one set of coefficients for
+ * each of the L possible fractional positions of an output frame. For
+ * odd ratios with more than #nMaxPhases phases the coefficients are
+ * linearly interpolated between adjacent table entries instead.
+ *
+ * \ingroup docCore
+ */
+class SampleRateConverter : public H2Core::Object<SampleRateConverter>
+{
+	H2_OBJECT(SampleRateConverter)
+public:
+	SampleRateConverter( int nInputRate, int nOutputRate );
+
+	int getInputRate() const;
+	int getOutputRate() const;
+
+	/** Number of frames produced when converting @a nInputFrames
+	 * frames. */
+	int getOutputFrames( int nInputFrames ) const;
+
+	/**
+	 * Converts @a nInputFrames frames of @a pInput into @a pOutput.
+	 *
+	 * \param pOutput has to hold getOutputFrames( @a nInputFrames )
+	 *   frames.
+	 */
+	void process( const float* pInput, int nInputFrames, float* pOutput ) const;
+
+	/** Zeroth order modified Bessel function of the first kind used to
+	 * compute Kaiser windows. */
+	static double besselI0( double fX );
+
+	/** Number of zero crossings of the sinc on either side of its
+	 * center when upsampling. */
+	static constexpr int nZeroCrossings = 32;
+	/** Shape parameter of the Kaiser window. */
+	static constexpr double fKaiserBeta = 9.0;
+	/** Cutoff frequency relative to the lower of both Nyquist
+	 * frequencies. */
+	static constexpr double fCutoff = 0.95;
+	static constexpr int nMaxPhases = 4096;
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	int m_nInputRate;
+	int m_nOutputRate;
+	/** Reduced upsampling factor L. */
+	int m_nUp;
+	/** Reduced downsampling factor M. */
+	int m_nDown;
+	/** Number of input frames considered on either side of an output
+	 * frame. */
+	int m_nHalfTaps;
+	/** Number of rows in #m_table minus one. */
+	int m_nPhases;
+	/** (#m_nPhases + 1) rows of 2 * #m_nHalfTaps coefficients each. */
+	std::vector<float> m_table;
+};
+
+inline int SampleRateConverter::getInputRate() const {
+	return m_nInputRate;
+}
+inline int SampleRateConverter::getOutputRate() const {
+	return m_nOutputRate;
+}
+
+};
+
+#endif
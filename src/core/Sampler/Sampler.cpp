@@ -20,6 +20,8 @@
  *
  */
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
@@ -44,10 +46,12 @@
 #include <core/Basics/Pattern.h>
 #include <core/Basics/PatternList.h>
 #include <core/Helpers/Filesystem.h>
+#include <core/Helpers/RealtimeMemory.h>
 #include <core/EventQueue.h>
 
 #include <core/FX/Effects.h>
 #include <core/Sampler/Sampler.h>
+#include <core/Sampler/PanLawTable.h>
 
 #include <iostream>
 #include <QDebug>
@@ -75,11 +79,24 @@ Sampler::Sampler()
 		, m_pMainOut_R( nullptr )
 		, m_pPreviewInstrument( nullptr )
 		, m_interpolateMode( Interpolation::InterpolateMode::Linear )
+		, m_pSincInterpolator( nullptr )
+		, m_pPanLawTable( nullptr )
+		, m_bAnyInstrumentSoloed( false )
+		, m_pRenderBuffer_L( nullptr )
+		, m_pRenderBuffer_R( nullptr )
+		, m_bMemoryLocked( false )
+		, m_nVoices( 0 )
+		, m_fSilenceThreshold( 0 )
+		, m_pTrackOutputDriver( nullptr )
 {
 	
 	
 	m_pMainOut_L = new float[ MAX_BUFFER_SIZE ];
 	m_pMainOut_R = new float[ MAX_BUFFER_SIZE ];
+	m_pRenderBuffer_L = new float[ MAX_BUFFER_SIZE ];
+	m_pRenderBuffer_R = new float[ MAX_BUFFER_SIZE ];
+	m_pSincInterpolator = new SincInterpolator;
+	m_pPanLawTable = new PanLawTable;
 
 	m_nMaxLayers = InstrumentComponent::getMaxLayers();
 
@@ -99,13 +116,51 @@ Sampler::~Sampler()
 {
 	INFOLOG( "DESTROY" );
 
+	if ( m_bMemoryLocked ) {
+		const size_t nBytes = MAX_BUFFER_SIZE * sizeof( float );
+		RealtimeMemory::unlock( m_pMainOut_L, nBytes );
+		RealtimeMemory::unlock( m_pMainOut_R, nBytes );
+		RealtimeMemory::unlock( m_pRenderBuffer_L, nBytes );
+		RealtimeMemory::unlock( m_pRenderBuffer_R, nBytes );
+	}
+
 	delete[] m_pMainOut_L;
 	delete[] m_pMainOut_R;
+	delete[] m_pRenderBuffer_L;
+	delete[] m_pRenderBuffer_R;
+	delete m_pSincInterpolator;
+	delete m_pPanLawTable;
 
 	m_pPreviewInstrument = nullptr;
 	m_pPlaybackTrackInstrument = nullptr;
 }
 
+void Sampler::lockMemory() {
+	if ( m_bMemoryLocked ) {
+		return;
+	}
+
+	const size_t nBytes = MAX_BUFFER_SIZE * sizeof( float );
+	const std::array<float*, 4> buffers = { m_pMainOut_L, m_pMainOut_R,
+		m_pRenderBuffer_L, m_pRenderBuffer_R };
+	std::array<bool, 4> locked;
+	m_bMemoryLocked = true;
+	for ( size_t ii = 0; ii < buffers.size(); ++ii ) {
+		locked[ ii ] = RealtimeMemory::lock( buffers[ ii ], nBytes );
+		m_bMemoryLocked = m_bMemoryLocked && locked[ ii ];
+	}
+
+	if ( ! m_bMemoryLocked ) {
+		// Prefaulted but not locked. Since locked pages are reference
+		// counted, partial locks must not be kept around.
+		for ( size_t ii = 0; ii < buffers.size(); ++ii ) {
+			if ( locked[ ii ] ) {
+				RealtimeMemory::unlock( buffers[ ii ], nBytes );
+			}
+		}
+	}
+}
+
 /** set default k for pan law with -4.5dB center compensation, given L^k + R^k = const
  * it is the mean compromise between constant sum and constant power
  */
@@ -123,33 +178,51 @@ void Sampler::process( uint32_t nFrames )
 	memset( m_pMainOut_L, 0, nFrames * sizeof( float ) );
 	memset( m_pMainOut_R, 0, nFrames * sizeof( float ) );
 
-	// Max notes limit
-	int nMaxNotes = Preferences::get_instance()->m_nMaxNotes;
-	while ( ( int )m_playingNotesQueue.size() > nMaxNotes ) {
-		Note * pOldNote = m_playingNotesQueue[ 0 ];
-		m_playingNotesQueue.erase( m_playingNotesQueue.begin() );
-		if ( pOldNote->get_instrument() != nullptr ) {
-			pOldNote->get_instrument()->dequeue( pOldNote );
-			WARNINGLOG( QString( "Number of playing notes [%1] exceeds maximum [%2]. Dropping note [%3]" )
-						.arg( m_playingNotesQueue.size() ).arg( nMaxNotes )
-						.arg( pOldNote->toQString() ) );
-			delete pOldNote;
-		}
-		else {
-			ERRORLOG( QString( "Old note in Sampler has no instrument! [%1]" )
-					  .arg( pOldNote->toQString() ) );
-			delete pOldNote;
-		}
+	// Voices are not ended early during export. Rendering is not time
+	// critical there and the resulting file should contain every
+	// single bit of the samples.
+	const auto pPref = Preferences::get_instance();
+	if ( pPref->m_bEndSilentVoices && ! pHydrogen->getIsExportSessionActive() ) {
+		m_fSilenceThreshold = std::pow( 10.0f, pPref->m_fSilenceThreshold / 20 );
+	} else {
+		m_fSilenceThreshold = 0;
 	}
 
-	// Render next `nFrames` audio frames of all playing notes.
-	unsigned i = 0;
+	// Pan laws are only evaluated when the settings of the song
+	// changed. Notes recompute their gains once the version of the
+	// table changes.
+	if ( pSong->getPanLawType() < RATIO_STRAIGHT_POLYGONAL ||
+		 pSong->getPanLawType() > QUADRATIC_CONST_K_NORM ) {
+		WARNINGLOG( "Unknown pan law type. Set default." );
+		pSong->setPanLawType( RATIO_STRAIGHT_POLYGONAL );
+	}
+	m_pPanLawTable->update( pSong->getPanLawType(), pSong->getPanLawKNorm() );
+
+	// Solo state is the same for all notes rendered within this cycle.
+	m_bAnyInstrumentSoloed = pSong->getDrumkit() != nullptr &&
+		pSong->getDrumkit()->getInstruments()->isAnyInstrumentSoloed();
+
+#ifdef H2CORE_HAVE_JACK
+	// The buffers of the per-track outputs were already resolved by
+	// the driver at the beginning of the cycle.
+	m_pTrackOutputDriver = nullptr;
+	if ( pPref->m_bJackTrackOuts ) {
+		m_pTrackOutputDriver =
+			dynamic_cast<JackAudioDriver*>( pHydrogen->getAudioOutput() );
+	}
+#endif
+
+	// Render next `nFrames` audio frames of all playing notes. Notes
+	// still playing are moved to the front of the queue in a single
+	// pass preserving their order (which is used to determine the
+	// oldest voice).
+	size_t nPlaying = 0;
 	Note* pNote;
-	while ( i < m_playingNotesQueue.size() ) {
-		pNote = m_playingNotesQueue[ i ];
+	for ( size_t ii = 0; ii < m_playingNotesQueue.size(); ++ii ) {
+		pNote = m_playingNotesQueue[ ii ];
 		if ( renderNote( pNote, nFrames ) ) {
 			// End of note was reached during rendering.
-			m_playingNotesQueue.erase( m_playingNotesQueue.begin() + i );
+			untrackVoice( pNote );
 			if ( pNote->get_instrument() != nullptr ) {
 				pNote->get_instrument()->dequeue( pNote );
 			} else {
@@ -158,10 +231,11 @@ void Sampler::process( uint32_t nFrames )
 			}
 			m_queuedNoteOffs.push_back( pNote );
 		} else {
-			// As finished notes are poped above 
-			++i;
+			m_playingNotesQueue[ nPlaying ] = pNote;
+			++nPlaying;
 		}
 	}
+	m_playingNotesQueue.resize( nPlaying );
 
 	if ( m_queuedNoteOffs.size() > 0 ) {
 		MidiOutput* pMidiOut = pHydrogen->getMidiOutput();
@@ -219,6 +293,19 @@ void Sampler::noteOn(Note *pNote )
 	pNote->get_adsr()->attack();
 	auto pInstr = pNote->get_instrument();
 
+	// choke group
+	const int nChokeGrp = pInstr->getChokeGroup();
+	if ( nChokeGrp != -1 ) {
+		for ( const auto& pOtherNote: m_playingNotesQueue ) {
+			if ( pOtherNote != nullptr &&
+				 pOtherNote->get_instrument() != nullptr &&
+				 pOtherNote->get_instrument() != pInstr  &&
+				 pOtherNote->get_instrument()->getChokeGroup() == nChokeGrp ) {
+				stealVoice( pOtherNote );
+			}
+		}
+	}
+
 	// mute group
 	int nMuteGrp = pInstr->get_mute_group();
 	if ( nMuteGrp != -1 ) {
@@ -247,11 +334,98 @@ void Sampler::noteOn(Note *pNote )
 	}
 
 	if ( ! pNote->get_note_off() ){
+		// Polyphony limits. The queue is only traversed in case one of
+		// them is hit.
+		const int nMaxVoices = pInstr->getMaxVoices();
+		while ( nMaxVoices > 0 && pInstr->getVoices() >= nMaxVoices ) {
+			auto pVictim = findVoiceToSteal( pInstr.get() );
+			if ( pVictim == nullptr ) {
+				break;
+			}
+			stealVoice( pVictim );
+		}
+
+		const int nMaxNotes = Preferences::get_instance()->m_nMaxNotes;
+		while ( m_nVoices >= nMaxNotes ) {
+			auto pVictim = findVoiceToSteal( nullptr );
+			if ( pVictim == nullptr ) {
+				break;
+			}
+			WARNINGLOG( QString( "Number of playing notes [%1] exceeds maximum [%2]. Fading out note [%3]" )
+						.arg( m_nVoices + 1 ).arg( nMaxNotes )
+						.arg( pVictim->prettyName() ) );
+			stealVoice( pVictim );
+		}
+
 		pInstr->enqueue( pNote );
+		pInstr->addVoice();
+		++m_nVoices;
 		m_playingNotesQueue.push_back( pNote );
 	}
 }
 
+void Sampler::stealVoice( Note* pNote )
+{
+	if ( pNote->isStolen() ) {
+		return;
+	}
+	untrackVoice( pNote );
+	pNote->setStolen( true );
+
+	if ( pNote->get_adsr() != nullptr ) {
+		auto pAudioDriver = Hydrogen::get_instance()->getAudioOutput();
+		const unsigned int nSampleRate = pAudioDriver != nullptr ?
+			pAudioDriver->getSampleRate() : 44100;
+		pNote->get_adsr()->fadeOut(
+			static_cast<unsigned int>( fVoiceFadeOutTime * nSampleRate ) );
+	}
+}
+
+Note* Sampler::findVoiceToSteal( const Instrument* pInstr ) const
+{
+	const auto voiceStealing = pInstr != nullptr ?
+		pInstr->getVoiceStealing() : Instrument::VoiceStealing::Oldest;
+
+	// The queue is ordered by the time notes were started.
+	Note* pVictim = nullptr;
+	float fMinLevel = 0;
+	for ( const auto& ppNote : m_playingNotesQueue ) {
+		if ( ppNote->isStolen() ||
+			 ( pInstr != nullptr && ppNote->get_instrument().get() != pInstr ) ) {
+			continue;
+		}
+
+		if ( voiceStealing == Instrument::VoiceStealing::Oldest ) {
+			return ppNote;
+		}
+
+		float fLevel = ppNote->get_velocity();
+		if ( voiceStealing == Instrument::VoiceStealing::Quietest &&
+			 ppNote->isPartiallyRendered() && ppNote->get_adsr() != nullptr ) {
+			fLevel *= ppNote->get_adsr()->getValue();
+		}
+		if ( pVictim == nullptr || fLevel < fMinLevel ) {
+			pVictim = ppNote;
+			fMinLevel = fLevel;
+		}
+	}
+
+	return pVictim;
+}
+
+void Sampler::untrackVoice( Note* pNote )
+{
+	if ( pNote->isStolen() ) {
+		return;
+	}
+	if ( m_nVoices > 0 ) {
+		--m_nVoices;
+	}
+	if ( pNote->get_instrument() != nullptr ) {
+		pNote->get_instrument()->removeVoice();
+	}
+}
+
 void Sampler::midiKeyboardNoteOff( int key )
 {
 	for ( const auto& pNote: m_playingNotesQueue ) {
@@ -411,44 +585,41 @@ float Sampler::ratioConstKNormPanLaw( float fPan, float k) {
 	}
 }
 
-// function to direct the computation to the selected pan law.
-inline float Sampler::panLaw( float fPan, std::shared_ptr<Song> pSong ) {
-	int nPanLawType = pSong->getPanLawType();
-	if ( nPanLawType == RATIO_STRAIGHT_POLYGONAL ) {
+float Sampler::computePanLaw( float fPan, int nPanLawType, float fKNorm ) {
+	switch ( nPanLawType ) {
+	case RATIO_STRAIGHT_POLYGONAL:
 		return ratioStraightPolygonalPanLaw( fPan );
-	} else if ( nPanLawType == RATIO_CONST_POWER ) {
+	case RATIO_CONST_POWER:
 		return ratioConstPowerPanLaw( fPan );
-	} else if ( nPanLawType == RATIO_CONST_SUM ) {
+	case RATIO_CONST_SUM:
 		return ratioConstSumPanLaw( fPan );
-	} else if ( nPanLawType == LINEAR_STRAIGHT_POLYGONAL ) {
+	case LINEAR_STRAIGHT_POLYGONAL:
 		return linearStraightPolygonalPanLaw( fPan );
-	} else if ( nPanLawType == LINEAR_CONST_POWER ) {
+	case LINEAR_CONST_POWER:
 		return linearConstPowerPanLaw( fPan );
-	} else if ( nPanLawType == LINEAR_CONST_SUM ) {
+	case LINEAR_CONST_SUM:
 		return linearConstSumPanLaw( fPan );
-	} else if ( nPanLawType == POLAR_STRAIGHT_POLYGONAL ) {
+	case POLAR_STRAIGHT_POLYGONAL:
 		return polarStraightPolygonalPanLaw( fPan );
-	} else if ( nPanLawType == POLAR_CONST_POWER ) {
+	case POLAR_CONST_POWER:
 		return polarConstPowerPanLaw( fPan );
-	} else if ( nPanLawType == POLAR_CONST_SUM ) {
+	case POLAR_CONST_SUM:
 		return polarConstSumPanLaw( fPan );
-	} else if ( nPanLawType == QUADRATIC_STRAIGHT_POLYGONAL ) {
+	case QUADRATIC_STRAIGHT_POLYGONAL:
 		return quadraticStraightPolygonalPanLaw( fPan );
-	} else if ( nPanLawType == QUADRATIC_CONST_POWER ) {
+	case QUADRATIC_CONST_POWER:
 		return quadraticConstPowerPanLaw( fPan );
-	} else if ( nPanLawType == QUADRATIC_CONST_SUM ) {
+	case QUADRATIC_CONST_SUM:
 		return quadraticConstSumPanLaw( fPan );
-	} else if ( nPanLawType == LINEAR_CONST_K_NORM ) {
-		return linearConstKNormPanLaw( fPan, pSong->getPanLawKNorm() );
-	} else if ( nPanLawType == POLAR_CONST_K_NORM ) {
-		return polarConstKNormPanLaw( fPan, pSong->getPanLawKNorm() );
-	} else if ( nPanLawType == RATIO_CONST_K_NORM ) {
-		return ratioConstKNormPanLaw( fPan, pSong->getPanLawKNorm() );
-	} else if ( nPanLawType == QUADRATIC_CONST_K_NORM ) {
-		return quadraticConstKNormPanLaw( fPan, pSong->getPanLawKNorm() );
-	} else {
-		WARNINGLOG( "Unknown pan law type. Set default." );
-		pSong->setPanLawType( RATIO_STRAIGHT_POLYGONAL );
+	case LINEAR_CONST_K_NORM:
+		return linearConstKNormPanLaw( fPan, fKNorm );
+	case POLAR_CONST_K_NORM:
+		return polarConstKNormPanLaw( fPan, fKNorm );
+	case RATIO_CONST_K_NORM:
+		return ratioConstKNormPanLaw( fPan, fKNorm );
+	case QUADRATIC_CONST_K_NORM:
+		return quadraticConstKNormPanLaw( fPan, fKNorm );
+	default:
 		return ratioStraightPolygonalPanLaw( fPan );
 	}
 }
@@ -551,14 +722,17 @@ void Sampler::handleSongSizeChange() {
 
 bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 {
+	// Objects are accessed via plain pointers in here. This avoids
+	// atomic reference counting for each rendered note while their
+	// lifetime is guarded by the EpochReclaimer.
 	auto pHydrogen = Hydrogen::get_instance();
-	auto pSong = pHydrogen->getSong();
+	Song* pSong = pHydrogen->getSong().get();
 	if ( pSong == nullptr ) {
 		ERRORLOG( "no song" );
 		return true;
 	}
 
-	auto pInstr = pNote->get_instrument();
+	Instrument* pInstr = pNote->get_instrument().get();
 	if ( pInstr == nullptr ) {
 		ERRORLOG( "NULL instrument" );
 		return true;
@@ -633,11 +807,26 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 	*	if instrPan is sided, notePan moves the signal in a progressively smaller pan range centered at instrPan;
 	*	if instrPan is HARD-sided, notePan doesn't have any effect.
 	*/
-	float fPan = pInstr->getPan() + pNote->getPan() * ( 1 - fabs( pInstr->getPan() ) );
-	
-	// Pass fPan to the Pan Law
-	float fPan_L = panLaw( fPan, pSong );
-	float fPan_R = panLaw( -fPan, pSong );
+	//
+	// The resulting gains are cached in the note and only recomputed in
+	// case one of the pans or the pan law changed.
+	auto& panGains = pNote->getPanGains();
+	if ( panGains.nPanLawVersion != m_pPanLawTable->getVersion() ||
+		 panGains.fInstrumentPan != pInstr->getPan() ||
+		 panGains.fNotePan != pNote->getPan() ) {
+		panGains.fInstrumentPan = pInstr->getPan();
+		panGains.fNotePan = pNote->getPan();
+		panGains.nPanLawVersion = m_pPanLawTable->getVersion();
+
+		const float fPan = panGains.fInstrumentPan + panGains.fNotePan *
+			( 1 - fabs( panGains.fInstrumentPan ) );
+		panGains.fPan_L = m_pPanLawTable->gain( fPan );
+		panGains.fPan_R = m_pPanLawTable->gain( -fPan );
+		panGains.fNotePan_L = m_pPanLawTable->gain( panGains.fNotePan );
+		panGains.fNotePan_R = m_pPanLawTable->gain( -panGains.fNotePan );
+	}
+	const float fPan_L = panGains.fPan_L;
+	const float fPan_R = panGains.fPan_R;
 
 	// In PreFader mode of the per track output of the JACK driver we
 	// disregard the instrument pan along with all other settings
@@ -647,12 +836,12 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 	if ( pHydrogen->hasJackAudioDriver() &&
 		 Preferences::get_instance()->m_JackTrackOutputMode ==
 		 Preferences::JackTrackOutputMode::preFader ) {
-		fNotePan_L = panLaw( pNote->getPan(), pSong );
-		fNotePan_R = panLaw( -1 * pNote->getPan(), pSong );
+		fNotePan_L = panGains.fNotePan_L;
+		fNotePan_R = panGains.fNotePan_R;
 	}
 	//---------------------------------------------------------
 
-	auto pComponents = pInstr->get_components();
+	const auto& pComponents = pInstr->get_components();
 	auto returnValues = std::vector<bool>( pComponents->size() );
 
 	for ( int ii = 0; ii < pComponents->size(); ++ii ){
@@ -662,7 +851,7 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 	int nAlreadySelectedLayer = -1;
 
 	for ( int ii = 0; ii < pComponents->size(); ++ii ) {
-		auto pCompo = pComponents->at( ii );
+		InstrumentComponent* pCompo = pComponents->at( ii ).get();
 		if ( pCompo == nullptr ) {
 			ERRORLOG( QString( "Component [%1] is invalid" ).arg( ii ) );
 			continue;
@@ -700,7 +889,8 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 			returnValues[ ii ] = true;
 			continue;
 		}
-		auto pLayer = pCompo->getLayer( pSelectedLayer->nSelectedLayer );
+		InstrumentLayer* pLayer =
+			pCompo->getLayer( pSelectedLayer->nSelectedLayer ).get();
 		if ( pLayer == nullptr ) {
 			ERRORLOG( QString( "Unable to retrieve layer [%1]" )
 					  .arg( pSelectedLayer->nSelectedLayer ) );
@@ -742,9 +932,7 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 		 */
 		bool bIsMutedForExport = ( pHydrogen->getIsExportSessionActive() &&
 								 ! pInstr->is_currently_exported() );
-		bool bAnyInstrumentIsSoloed =
-			pSong->getDrumkit()->getInstruments()->isAnyInstrumentSoloed();
-		bool bIsMutedBecauseOfSolo = ( bAnyInstrumentIsSoloed &&
+		bool bIsMutedBecauseOfSolo = ( m_bAnyInstrumentSoloed &&
 									   ! pInstr->is_soloed() );
 
 		// check wether another component of this instrument is muted
@@ -761,7 +949,7 @@ bool Sampler::renderNote( Note* pNote, unsigned nBufferSize )
 		// check whether another sample of the same component is soloed
 		if ( ! bIsMutedBecauseOfSolo ) {
 			for ( const auto& ppLayer : pCompo->getLayers() ) {
-				if ( ppLayer != nullptr && ppLayer != pLayer &&
+				if ( ppLayer != nullptr && ppLayer.get() != pLayer &&
 					 ppLayer->getIsSoloed() ) {
 					bIsMutedBecauseOfSolo = true;
 					break;
@@ -860,9 +1048,9 @@ void copySample( float *__restrict__ pBuffer_L, float *__restrict__ pBuffer_R,
 			nFramesFromSample * sizeof( float ) );
 
 	if ( nFramesFromSample < nFrames ) {
-		memset( &pBuffer_L[ nFramesFromSample ], '0',
+		memset( &pBuffer_L[ nFramesFromSample ], 0,
 				( nFrames - nFramesFromSample ) * sizeof( float ) );
-		memset( &pBuffer_R[ nFramesFromSample ], '0',
+		memset( &pBuffer_R[ nFramesFromSample ], 0,
 				( nFrames - nFramesFromSample ) * sizeof( float ) );
 	}
 }
@@ -975,6 +1163,7 @@ void resample( float *__restrict__ pBuffer_L, float *__restrict__ pBuffer_R,
 
 /// Resample with runtime-selection of interpolation mode
 void resample( Interpolation::InterpolateMode mode,
+			   const SincInterpolator* pSincInterpolator,
 			   float *__restrict__ pBuffer_L, float *__restrict__ pBuffer_R,
 			   float *__restrict__ pSample_data_L, float *__restrict__ pSample_data_R,
 			   int nFrames, double &fSamplePos, float fStep, int nSampleFrames )
@@ -1006,6 +1195,11 @@ void resample( Interpolation::InterpolateMode mode,
 			( pBuffer_L, pBuffer_R, pSample_data_L, pSample_data_R,
 			  nFrames, fSamplePos, fStep, nSampleFrames );
 		break;
+	case Interpolation::InterpolateMode::Sinc:
+		pSincInterpolator->resample( pBuffer_L, pBuffer_R, pSample_data_L,
+									 pSample_data_R, nFrames, fSamplePos,
+									 fStep, nSampleFrames );
+		break;
 	}
 }
 
@@ -1070,14 +1264,14 @@ bool Sampler::processPlaybackTrack(int nBufferSize)
 	int nFinalBufferPos = nInitialBufferPos + nAvail_bytes;
 
 	// Output-rate buffer as temporary storage for sample data, resampled to output rate
-	float buffer_L[ nBufferSize ];
-	float buffer_R[ nBufferSize ];
+	float* buffer_L = m_pRenderBuffer_L;
+	float* buffer_R = m_pRenderBuffer_R;
 
 	if ( pSample->get_sample_rate() == pAudioDriver->getSampleRate() ) {
 		copySample( &buffer_L[ nInitialBufferPos ], &buffer_R[ nInitialBufferPos ], pSample_data_L, pSample_data_R,
 					nBufferSize, fSamplePos, fStep, nSampleFrames );
 	} else {
-		resample( m_interpolateMode,
+		resample( m_interpolateMode, m_pSincInterpolator,
 				  &buffer_L[ nInitialBufferPos ], &buffer_R[ nInitialBufferPos ], pSample_data_L, pSample_data_R,
 				  nBufferSize, fSamplePos, fStep, nSampleFrames );
 	}
@@ -1102,10 +1296,10 @@ bool Sampler::processPlaybackTrack(int nBufferSize)
 }
 
 bool Sampler::renderNoteResample(
-	std::shared_ptr<Sample> pSample,
+	Sample* pSample,
 	Note *pNote,
-	std::shared_ptr<SelectedLayerInfo> pSelectedLayerInfo,
-	std::shared_ptr<InstrumentComponent> pCompo,
+	SelectedLayerInfo* pSelectedLayerInfo,
+	InstrumentComponent* pCompo,
 	int nComponentIdx,
 	int nBufferSize,
 	int nInitialBufferPos,
@@ -1118,7 +1312,7 @@ bool Sampler::renderNoteResample(
 {
 	auto pHydrogen = Hydrogen::get_instance();
 	auto pAudioDriver = pHydrogen->getAudioOutput();
-	auto pSong = pHydrogen->getSong();
+	Song* pSong = pHydrogen->getSong().get();
 
 	if ( pSong == nullptr ) {
 		ERRORLOG( "Invalid song" );
@@ -1135,7 +1329,7 @@ bool Sampler::renderNoteResample(
 		return true;
 	}
 
-	auto pInstrument = pNote->get_instrument();
+	Instrument* pInstrument = pNote->get_instrument().get();
 	if ( pInstrument == nullptr || pNote->get_adsr() == nullptr ) {
 		ERRORLOG( "Invalid note instrument" );
 		return true;
@@ -1165,6 +1359,49 @@ bool Sampler::renderNoteResample(
 		(static_cast<float>(nSampleFrames) - pSelectedLayerInfo->fSamplePosition) /
 		fStep );
 
+	// Silence detection. In case everything left of the sample would
+	// be rendered below the threshold, the voice is ended right away.
+	// The resonant filter might amplify the tail and is excluded.
+	if ( m_fSilenceThreshold > 0 && nRemainingFrames > 0 &&
+		 ! pInstrument->is_filter_active() ) {
+		const auto pADSR = pNote->get_adsr();
+		float fGain;
+		switch ( pADSR->getState() ) {
+		case ADSR::State::Attack:
+		case ADSR::State::Decay:
+			fGain = 1;
+			break;
+		case ADSR::State::Sustain:
+			fGain = pADSR->getSustain();
+			break;
+		default:
+			fGain = pADSR->getValue();
+		}
+		float fMaxCost = std::max( std::max( fCost_L, fCost_R ),
+								   std::max( fCostTrack_L, fCostTrack_R ) );
+#ifdef H2CORE_HAVE_LADSPA
+		for ( unsigned nFX = 0; nFX < MAX_FX; ++nFX ) {
+			LadspaFX* pFX = Effects::get_instance()->getLadspaFX( nFX );
+			if ( pFX != nullptr ) {
+				fMaxCost = std::max( fMaxCost, pInstrument->get_fx_level( nFX ) *
+									 pFX->getVolume() * pSong->getVolume() );
+			}
+		}
+#endif
+		fGain *= fMaxCost;
+
+		// Interpolation may overshoot the original frames. A margin of
+		// 6dB accounts for this.
+		if ( 2 * fGain * pSample->getTailPeak(
+				 static_cast<int>(pSelectedLayerInfo->fSamplePosition) ) <
+			 m_fSilenceThreshold ) {
+			pHydrogen->getAudioEngine()->getProfiler()->recordSilencedVoice(
+				nRemainingFrames );
+			pSelectedLayerInfo->fSamplePosition = nSampleFrames;
+			return true;
+		}
+	}
+
 	bool bRetValue = true; // the note is ended
 	int nAvail_bytes;
 	if ( nRemainingFrames > nBufferSize - nInitialBufferPos ) {
@@ -1207,11 +1444,13 @@ bool Sampler::renderNoteResample(
 					pSample->get_sample_rate() );
 		}
 
-		nNoteEnd = std::min(nFinalBufferPos + 1, static_cast<int>(
+		// The envelope starts at the first frame of the note within the
+		// buffer.
+		nNoteEnd = std::min(nFinalBufferPos + 1, nInitialBufferPos + static_cast<int>(
 			(static_cast<float>(pSelectedLayerInfo->nNoteLength) -
 				pSelectedLayerInfo->fSamplePosition) / fStep ));
 
-		if ( nNoteEnd < 0 ) {
+		if ( nNoteEnd < nInitialBufferPos ) {
 			if ( ! pInstrument->is_filter_active() ) {
 				// In case resonance filtering is active the sampler stops
 				// rendering of the sample at the custom note length but lets
@@ -1221,7 +1460,7 @@ bool Sampler::renderNoteResample(
 						  .arg( pSelectedLayerInfo->fSamplePosition )
 						  .arg( nFinalBufferPos ).arg( fStep ) );
 			}
-			nNoteEnd = 0;
+			nNoteEnd = nInitialBufferPos;
 		}
 	}
 	else {
@@ -1231,90 +1470,89 @@ bool Sampler::renderNoteResample(
 		nNoteEnd = nFinalBufferPos + 1;
 	}
 
-	auto pADSR = pNote->get_adsr();
-	float fVal_L;
-	float fVal_R;
+	VoiceRender voice;
+	voice.pNote = pNote;
+	voice.pADSR = pNote->get_adsr().get();
+	voice.interpolateMode = pInstrument->hasCustomInterpolateMode() ?
+		pInstrument->getInterpolateMode() : m_interpolateMode;
+	voice.filterMode = pInstrument->getFilterMode();
+	voice.fFilterCutoff = pInstrument->get_filter_cutoff();
+	voice.fFilterResonance = pInstrument->get_filter_resonance();
+	voice.bResample = bResample;
+	voice.pSample_data_L = pSample_data_L;
+	voice.pSample_data_R = pSample_data_R;
+	voice.nSampleFrames = nSampleFrames;
+	voice.fSamplePos = pSelectedLayerInfo->fSamplePosition;
+	voice.fStep = fStep;
+	voice.nInitialBufferPos = nInitialBufferPos;
+	voice.nFinalBufferPos = nFinalBufferPos;
+	voice.nNoteEnd = nNoteEnd;
+	voice.fCost_L = fCost_L;
+	voice.fCost_R = fCost_R;
+	voice.fCostTrack_L = fCostTrack_L;
+	voice.fCostTrack_R = fCostTrack_R;
+	voice.pTrackOut_L = nullptr;
+	voice.pTrackOut_R = nullptr;
+	voice.nFXSends = 0;
+	voice.fPeak_L = 0;
+	voice.fPeak_R = 0;
 
 #ifdef H2CORE_HAVE_JACK
-	float* pTrackOutL = nullptr;
-	float* pTrackOutR = nullptr;
-
-	if ( Preferences::get_instance()->m_bJackTrackOuts ) {
-		auto pJackAudioDriver = dynamic_cast<JackAudioDriver*>( pAudioDriver );
-		if ( pJackAudioDriver != nullptr ) {
-			pTrackOutL = pJackAudioDriver->getTrackOut_L(
-				pInstrument, nComponentIdx );
-			pTrackOutR = pJackAudioDriver->getTrackOut_R(
-				pInstrument, nComponentIdx );
-		}
+	if ( m_pTrackOutputDriver != nullptr ) {
+		voice.pTrackOut_L = m_pTrackOutputDriver->getTrackOut_L(
+			pInstrument->get_id(), nComponentIdx );
+		voice.pTrackOut_R = m_pTrackOutputDriver->getTrackOut_R(
+			pInstrument->get_id(), nComponentIdx );
 	}
 #endif
 
-	float buffer_L[ nBufferSize ];
-	float buffer_R[ nBufferSize ];
-
-	if ( bResample ) {
-		resample( m_interpolateMode,
-				  &buffer_L[ nInitialBufferPos ], &buffer_R[ nInitialBufferPos ], pSample_data_L, pSample_data_R,
-				  nFinalBufferPos - nInitialBufferPos, fSamplePos, fStep, nSampleFrames );
-	} else {
-		copySample( &buffer_L[ nInitialBufferPos ], &buffer_R[ nInitialBufferPos ], pSample_data_L, pSample_data_R,
-					nFinalBufferPos - nInitialBufferPos, fSamplePos, fStep, nSampleFrames );
-	}
-
-	if ( pADSR->applyADSR( buffer_L, buffer_R, nFinalBufferPos, nNoteEnd,
-						   fStep ) ) {
-		bRetValue = true;
-	}
-
-	// Low pass resonant filter
-	if ( pInstrument->is_filter_active() ) {
-		for ( int nBufferPos = nInitialBufferPos; nBufferPos < nFinalBufferPos;
-			  ++nBufferPos ) {
-
-			fVal_L = buffer_L[ nBufferPos ];
-			fVal_R = buffer_R[ nBufferPos ];
-
-			pNote->compute_lr_values( &fVal_L, &fVal_R );
-
-			buffer_L[ nBufferPos ] = fVal_L;
-			buffer_R[ nBufferPos ] = fVal_R;
-
+#ifdef H2CORE_HAVE_LADSPA
+	if ( ! pInstrument->is_muted() && ! pSong->getIsMuted() ) {
+		const float fMasterVol = pSong->getVolume();
+		for ( unsigned nFX = 0; nFX < MAX_FX; ++nFX ) {
+			LadspaFX *pFX = Effects::get_instance()->getLadspaFX( nFX );
+			const float fLevel = pInstrument->get_fx_level( nFX );
+			if ( pFX != nullptr && fLevel != 0.0 ) {
+				voice.fxBuffers_L[ voice.nFXSends ] = pFX->m_pBuffer_L;
+				voice.fxBuffers_R[ voice.nFXSends ] = pFX->m_pBuffer_R;
+				voice.fxCosts[ voice.nFXSends ] =
+					fLevel * pFX->getVolume() * fMasterVol;
+				++voice.nFXSends;
+			}
 		}
 	}
+#endif
 
-	// Mix rendered sample buffer to track and mixer output
-	float fSamplePeak_L = 0.0, fSamplePeak_R = 0.0;
-	for ( int nBufferPos = nInitialBufferPos; nBufferPos < nFinalBufferPos;
-		  ++nBufferPos ) {
-
-		fVal_L = buffer_L[ nBufferPos ];
-		fVal_R = buffer_R[ nBufferPos ];
-
-#ifdef H2CORE_HAVE_JACK
-		if ( pTrackOutL ) {
-			pTrackOutL[nBufferPos] += fVal_L * fCostTrack_L;
+	// Dispatch to the variant containing just the stages required.
+	const bool bFilter = pInstrument->is_filter_active();
+	const bool bTrackOuts = voice.pTrackOut_L != nullptr ||
+		voice.pTrackOut_R != nullptr;
+	const bool bFXSends = voice.nFXSends > 0;
+	bool bEnvelopeEnded;
+	if ( bFilter ) {
+		if ( bTrackOuts ) {
+			bEnvelopeEnded = bFXSends ? renderVoice<true, true, true>( voice ) :
+				renderVoice<true, true, false>( voice );
+		} else {
+			bEnvelopeEnded = bFXSends ? renderVoice<true, false, true>( voice ) :
+				renderVoice<true, false, false>( voice );
 		}
-		if ( pTrackOutR ) {
-			pTrackOutR[nBufferPos] += fVal_R * fCostTrack_R;
+	} else {
+		if ( bTrackOuts ) {
+			bEnvelopeEnded = bFXSends ? renderVoice<false, true, true>( voice ) :
+				renderVoice<false, true, false>( voice );
+		} else {
+			bEnvelopeEnded = bFXSends ? renderVoice<false, false, true>( voice ) :
+				renderVoice<false, false, false>( voice );
 		}
-#endif
-
-		fVal_L *= fCost_L;
-		fVal_R *= fCost_R;
-
-		fSamplePeak_L = std::max( fSamplePeak_L, fVal_L );
-		fSamplePeak_R = std::max( fSamplePeak_R, fVal_R );
-
-		// to main mix
-		m_pMainOut_L[nBufferPos] += fVal_L;
-		m_pMainOut_R[nBufferPos] += fVal_R;
-
+	}
+	if ( bEnvelopeEnded ) {
+		bRetValue = true;
 	}
 
 	// update instr peak
-	pInstrument->set_peak_l( std::max( pInstrument->get_peak_l(), fSamplePeak_L ) );
-	pInstrument->set_peak_r( std::max( pInstrument->get_peak_r(), fSamplePeak_R ) );
+	pInstrument->set_peak_l( std::max( pInstrument->get_peak_l(), voice.fPeak_L ) );
+	pInstrument->set_peak_r( std::max( pInstrument->get_peak_r(), voice.fPeak_R ) );
 
 	if ( pInstrument->is_filter_active() && pNote->filter_sustain() ) {
 		// Note is still ringing, do not end.
@@ -1323,60 +1561,122 @@ bool Sampler::renderNoteResample(
 	
 	pSelectedLayerInfo->fSamplePosition += nAvail_bytes * fStep;
 
+	return bRetValue;
+}
 
-#ifdef H2CORE_HAVE_LADSPA
-	// LADSPA
-	// change the below return logic if you add code after that ifdef
-	if ( pInstrument->is_muted() || pSong->getIsMuted() ) {
-		return bRetValue;
-	}
-	float masterVol = pSong->getVolume();
-	for ( unsigned nFX = 0; nFX < MAX_FX; ++nFX ) {
-		LadspaFX *pFX = Effects::get_instance()->getLadspaFX( nFX );
-		float fLevel = pInstrument->get_fx_level( nFX );
-		if ( pFX != nullptr && fLevel != 0.0 ) {
-			fLevel = fLevel * pFX->getVolume();
+template <bool bFilter, bool bTrackOuts, bool bFXSends>
+bool Sampler::renderVoice( VoiceRender& voice ) {
+	alignas( 16 ) float buffer_L[ nRenderBlockSize ];
+	alignas( 16 ) float buffer_R[ nRenderBlockSize ];
+
+	bool bEnvelopeEnded = false;
+	for ( int nBlockStart = voice.nInitialBufferPos;
+		  nBlockStart < voice.nFinalBufferPos; nBlockStart += nRenderBlockSize ) {
+		const int nFrames = std::min( nRenderBlockSize,
+									  voice.nFinalBufferPos - nBlockStart );
+
+		if ( ! bEnvelopeEnded ) {
+			if ( voice.bResample ) {
+				resample( voice.interpolateMode, m_pSincInterpolator,
+						  buffer_L, buffer_R, voice.pSample_data_L,
+						  voice.pSample_data_R, nFrames, voice.fSamplePos,
+						  voice.fStep, voice.nSampleFrames );
+			} else {
+				copySample( buffer_L, buffer_R, voice.pSample_data_L,
+							voice.pSample_data_R, nFrames, voice.fSamplePos,
+							voice.fStep, voice.nSampleFrames );
+				voice.fSamplePos += nFrames;
+			}
 
-			float *pBuf_L = pFX->m_pBuffer_L;
-			float *pBuf_R = pFX->m_pBuffer_R;
+			// Release position relative to the current block.
+			bEnvelopeEnded = voice.pADSR->applyADSR(
+				buffer_L, buffer_R, nFrames, voice.nNoteEnd - nBlockStart,
+				voice.fStep );
+		}
+		else if constexpr ( bFilter ) {
+			// The envelope is silent but the filter might still ring.
+			std::fill_n( buffer_L, nFrames, 0.f );
+			std::fill_n( buffer_R, nFrames, 0.f );
+		}
+		else {
+			// Nothing left to contribute.
+			break;
+		}
 
-			float fFXCost_L = fLevel * masterVol;
-			float fFXCost_R = fLevel * masterVol;
+		// Resonant filter
+		if constexpr ( bFilter ) {
+			ResonantFilter::process( voice.filterMode,
+									 voice.pNote->get_filter_state(),
+									 buffer_L, buffer_R, nFrames,
+									 voice.fFilterCutoff,
+									 voice.fFilterResonance );
+		}
 
-			int nBufferPos = nInitialBufferPos;
-			for ( int i = 0; i < nAvail_bytes; ++i ) {
+		// Mix rendered block to track and mixer output as well as to
+		// the FX sends.
+		float* pMainOut_L = &m_pMainOut_L[ nBlockStart ];
+		float* pMainOut_R = &m_pMainOut_R[ nBlockStart ];
+		for ( int ii = 0; ii < nFrames; ++ii ) {
+			const float fVal_L = buffer_L[ ii ];
+			const float fVal_R = buffer_R[ ii ];
+
+			if constexpr ( bTrackOuts ) {
+				if ( voice.pTrackOut_L != nullptr ) {
+					voice.pTrackOut_L[ nBlockStart + ii ] += fVal_L * voice.fCostTrack_L;
+				}
+				if ( voice.pTrackOut_R != nullptr ) {
+					voice.pTrackOut_R[ nBlockStart + ii ] += fVal_R * voice.fCostTrack_R;
+				}
+			}
 
-				fVal_L = buffer_L[ nBufferPos ];
-				fVal_R = buffer_R[ nBufferPos ];
+			const float fOut_L = fVal_L * voice.fCost_L;
+			const float fOut_R = fVal_R * voice.fCost_R;
+			voice.fPeak_L = std::max( voice.fPeak_L, fOut_L );
+			voice.fPeak_R = std::max( voice.fPeak_R, fOut_R );
+			pMainOut_L[ ii ] += fOut_L;
+			pMainOut_R[ ii ] += fOut_R;
+		}
 
-				pBuf_L[ nBufferPos ] += fVal_L * fFXCost_L;
-				pBuf_R[ nBufferPos ] += fVal_R * fFXCost_R;
-				++nBufferPos;
+		if constexpr ( bFXSends ) {
+			for ( int nSend = 0; nSend < voice.nFXSends; ++nSend ) {
+				float* pFX_L = &voice.fxBuffers_L[ nSend ][ nBlockStart ];
+				float* pFX_R = &voice.fxBuffers_R[ nSend ][ nBlockStart ];
+				const float fFXCost = voice.fxCosts[ nSend ];
+				for ( int ii = 0; ii < nFrames; ++ii ) {
+					pFX_L[ ii ] += buffer_L[ ii ] * fFXCost;
+					pFX_R[ ii ] += buffer_R[ ii ] * fFXCost;
+				}
 			}
 		}
 	}
-#endif
-	return bRetValue;
+
+	return bEnvelopeEnded;
 }
 
 void Sampler::stopPlayingNotes( std::shared_ptr<Instrument> pInstr )
 {
 	if ( pInstr != nullptr ) { // stop all notes using this instrument
-		for ( unsigned i = 0; i < m_playingNotesQueue.size(); ) {
-			Note *pNote = m_playingNotesQueue[ i ];
+		size_t nPlaying = 0;
+		for ( size_t ii = 0; ii < m_playingNotesQueue.size(); ++ii ) {
+			Note *pNote = m_playingNotesQueue[ ii ];
 			assert( pNote );
 			if ( pNote->get_instrument() == pInstr ) {
+				untrackVoice( pNote );
 				pInstr->dequeue( pNote );
 				delete pNote;
-				m_playingNotesQueue.erase( m_playingNotesQueue.begin() + i );
 			}
-			++i;
+			else {
+				m_playingNotesQueue[ nPlaying ] = pNote;
+				++nPlaying;
+			}
 		}
+		m_playingNotesQueue.resize( nPlaying );
 	}
 	else { // stop all notes
 		// delete all copied notes in the playing notes queue
 		for ( unsigned i = 0; i < m_playingNotesQueue.size(); ++i ) {
 			Note *pNote = m_playingNotesQueue[i];
+			untrackVoice( pNote );
 			if ( pNote->get_instrument() != nullptr ) {
 				pNote->get_instrument()->dequeue( pNote );
 			}
@@ -1409,7 +1709,8 @@ void Sampler::preview_sample(std::shared_ptr<Sample> pSample, int nLength )
 		return;
 	}
 	
-	Hydrogen::get_instance()->getAudioEngine()->lock( RIGHT_HERE );
+	auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+	pAudioEngine->lock( RIGHT_HERE );
 
 	for (const auto& pComponent: *m_pPreviewInstrument->get_components()) {
 		if ( pComponent == nullptr ) {
@@ -1418,7 +1719,7 @@ void Sampler::preview_sample(std::shared_ptr<Sample> pSample, int nLength )
 		}
 		auto pLayer = pComponent->getLayer( 0 );
 
-		pLayer->set_sample( pSample );
+		pLayer->set_sample( pSample, pAudioEngine->getReclaimer() );
 
 		Note *pPreviewNote = new Note( m_pPreviewInstrument, 0, 1.0, 0.f, nLength );
 
@@ -1427,7 +1728,7 @@ void Sampler::preview_sample(std::shared_ptr<Sample> pSample, int nLength )
 
 	}
 
-	Hydrogen::get_instance()->getAudioEngine()->unlock();
+	pAudioEngine->unlock();
 }
 
 
@@ -1514,6 +1815,10 @@ QString Sampler::toQString( const QString& sPrefix, bool bShort ) const {
 				QString( "%1%2m_pPreviewInstrument: %3\n" ).arg( sPrefix ).arg( s )
 				.arg( m_pPreviewInstrument == nullptr ? "nullptr" :
 					  m_pPreviewInstrument->toQString( sPrefix + s, bShort) ) )
+			.append( QString( "%1%2m_nVoices: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nVoices ) )
+			.append( QString( "%1%2m_fSilenceThreshold: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_fSilenceThreshold ) )
 			.append( QString( "%1%2m_nMaxLayers: %3\n" ).arg( sPrefix ).arg( s )
 					 .arg( m_nMaxLayers ) )
 			.append( QString( "%1%2m_nPlayBackSamplePosition: %3\n" ).arg( sPrefix ).arg( s )
@@ -1541,6 +1846,8 @@ QString Sampler::toQString( const QString& sPrefix, bool bShort ) const {
 				QString( ", m_pPreviewInstrument: %1" )
 				.arg( m_pPreviewInstrument == nullptr ? "nullptr" :
 					  m_pPreviewInstrument->toQString( "", bShort) ) )
+			.append( QString( ", m_nVoices: %1" ).arg( m_nVoices ) )
+			.append( QString( ", m_fSilenceThreshold: %1" ).arg( m_fSilenceThreshold ) )
 			.append( QString( ", m_nMaxLayers: %1" )
 					 .arg( m_nMaxLayers ) )
 			.append( QString( ", m_nPlayBackSamplePosition: %1" )
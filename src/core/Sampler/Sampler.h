@@ -27,7 +27,10 @@
 #include <core/Object.h>
 #include <core/Globals.h>
 #include <core/Sampler/Interpolation.h>
+#include <core/Sampler/ResonantFilter.h>
+#include <core/Sampler/SincInterpolator.h>
 
+#include <array>
 #include <inttypes.h>
 #include <vector>
 #include <memory>
@@ -35,12 +38,15 @@
 namespace H2Core
 {
 
+class ADSR;
 class Note;
 class Song;
 class Sample;
 class Instrument;
 struct SelectedLayerInfo;
 class InstrumentComponent;
+class JackAudioDriver;
+class PanLawTable;
 
 ///
 /// Waveform based sampler.
@@ -99,6 +105,9 @@ public:
 	* Some pan laws use expensive math functions like pow() and sqrt().
 	* Pan laws can be approximated by polynomials, e.g. with degree = 2, to adjust the center compensation,
 	* but then you cannot control the interpretation of the fPan argument exactly.
+	* While rendering, the pan law of the song is read from a PanLawTable
+	* instead, which evaluates these functions only when the song's pan
+	* law changes.
 	*/
 	enum PAN_LAW_TYPES {
 		RATIO_STRAIGHT_POLYGONAL = 0,
@@ -143,6 +152,9 @@ public:
 	static float polarConstKNormPanLaw( float fPan, float k );
 	static float ratioConstKNormPanLaw( float fPan, float k );
 	static float quadraticConstKNormPanLaw( float fPan, float k );
+	/** Evaluates the pan law @a nPanLawType, one of #PAN_LAW_TYPES.
+	 * Unknown types fall back to #RATIO_STRAIGHT_POLYGONAL. */
+	static float computePanLaw( float fPan, int nPanLawType, float fKNorm );
 
    /** This function is used to load old version files (v<=1.1).
 	* It returns the single pan parameter in [-1,1] from the L,R gains
@@ -162,6 +174,10 @@ public:
 	float* m_pMainOut_L;	///< sampler main out (left channel)
 	float* m_pMainOut_R;	///< sampler main out (right channel)
 
+	/** Locks the output and render buffers into RAM in case
+	 * RealtimeMemory is enabled. */
+	void lockMemory();
+
 	/**
 	 * Constructor of the Sampler.
 	 *
@@ -196,6 +212,11 @@ public:
 	int getPlayingNotesNumber() const {
 		return m_playingNotesQueue.size();
 	}
+	/** Number of notes in #m_playingNotesQueue which were not stolen
+	 * and count towards Preferences::m_nMaxNotes. */
+	int getVoices() const {
+		return m_nVoices;
+	}
 
 	void preview_sample( std::shared_ptr<Sample> pSample, int length );
 	void preview_instrument( std::shared_ptr<Instrument> pInstr );
@@ -246,20 +267,18 @@ public:
 	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
 	
 private:
-	/** function to direct the computation to the selected pan law function
-	 */
-	float panLaw( float fPan, std::shared_ptr<Song> pSong );
-
 	bool processPlaybackTrack(int nBufferSize);
 
     /** @return false - the note is not ended, true - the note is ended */
 	bool renderNote( Note* pNote, unsigned nBufferSize );
 
+	/** All objects are passed as plain pointers. Their lifetime is
+	 * guarded by the #EpochReclaimer of the #AudioEngine. */
 	bool renderNoteResample(
-		std::shared_ptr<Sample> pSample,
+		Sample* pSample,
 		Note *pNote,
-		std::shared_ptr<SelectedLayerInfo> pSelectedLayerInfo,
-		std::shared_ptr<InstrumentComponent> pCompo,
+		SelectedLayerInfo* pSelectedLayerInfo,
+		InstrumentComponent* pCompo,
 		int nComponentIdx,
 		int nBufferSize,
 		int nInitialBufferPos,
@@ -270,8 +289,102 @@ private:
 		float fLayerPitch
 	);
 
+	/** Everything required to render a single layer of a voice within
+	 * one process cycle. Filled by renderNoteResample(). */
+	struct VoiceRender {
+		Note* pNote;
+		ADSR* pADSR;
+		Interpolation::InterpolateMode interpolateMode;
+		/** Filter settings of the instrument read once per process
+		 * cycle. */
+		ResonantFilter::Mode filterMode;
+		float fFilterCutoff;
+		float fFilterResonance;
+		bool bResample;
+		float* pSample_data_L;
+		float* pSample_data_R;
+		int nSampleFrames;
+		double fSamplePos;
+		float fStep;
+		int nInitialBufferPos;
+		int nFinalBufferPos;
+		/** Buffer position the release of the envelope starts at. */
+		int nNoteEnd;
+		float fCost_L;
+		float fCost_R;
+		float fCostTrack_L;
+		float fCostTrack_R;
+		/** JACK per-track output buffers or `nullptr`. */
+		float* pTrackOut_L;
+		float* pTrackOut_R;
+		/** Number of valid entries in #fxBuffers_L, #fxBuffers_R, and
+		 * #fxCosts. */
+		int nFXSends;
+		std::array<float*, MAX_FX> fxBuffers_L;
+		std::array<float*, MAX_FX> fxBuffers_R;
+		std::array<float, MAX_FX> fxCosts;
+		/** Peaks of the main output contribution. */
+		float fPeak_L;
+		float fPeak_R;
+	};
+
+	/**
+	 * Renders @a voice in a single pass over the buffer. Blocks of
+	 * #nRenderBlockSize frames are resampled, enveloped, filtered, and
+	 * mixed into the main, track, and FX outputs while still residing
+	 * in the cache. Stages not required by the voice are removed at
+	 * compile time.
+	 *
+	 * \return true if the envelope of the voice finished.
+	 */
+	template <bool bFilter, bool bTrackOuts, bool bFXSends>
+	bool renderVoice( VoiceRender& voice );
+
+	/** Number of frames processed at once by renderVoice(). */
+	static constexpr int nRenderBlockSize = 64;
+
+	/**
+	 * Fades out @a pNote within #fVoiceFadeOutTime and stops counting
+	 * it as a voice of both the Sampler and its instrument. The note
+	 * itself stays in #m_playingNotesQueue till its fade-out was
+	 * rendered.
+	 */
+	void stealVoice( Note* pNote );
+	/**
+	 * Selects the voice to be stolen when starting a note of @a pInstr
+	 * exceeds its polyphony limit according to
+	 * Instrument::getVoiceStealing().
+	 *
+	 * \param pInstr If `nullptr`, the oldest voice of all instruments
+	 *   is returned instead. Used for Preferences::m_nMaxNotes.
+	 *
+	 * \return `nullptr` if there is no voice left to steal.
+	 */
+	Note* findVoiceToSteal( const Instrument* pInstr ) const;
+	/** Updates the voice counts for @a pNote being removed from
+	 * #m_playingNotesQueue. */
+	void untrackVoice( Note* pNote );
+
+	/** Duration of the fade-out of stolen and choked voices in
+	 * seconds. Short enough to not be heard as a release and long
+	 * enough to avoid clicks. */
+	static constexpr float fVoiceFadeOutTime = 0.005;
+
 	std::vector<Note*> m_playingNotesQueue;
 	std::vector<Note*> m_queuedNoteOffs;
+	/** Number of notes in #m_playingNotesQueue not stolen yet. Along
+	 * with Instrument::getVoices() it allows to check the polyphony
+	 * limits without traversing the queue. */
+	int m_nVoices;
+	/** Linear amplitude below which the remainder of a voice is
+	 * considered inaudible and the voice is ended early. 0 disables
+	 * the check. Updated at the beginning of each process cycle from
+	 * Preferences::m_fSilenceThreshold. */
+	float m_fSilenceThreshold;
+	/** Driver providing the per-track output buffers resolved for the
+	 * current process cycle or `nullptr` if there are none. Set at the
+	 * beginning of process(). */
+	JackAudioDriver* m_pTrackOutputDriver;
 
 	/// Instrument used for the playback track feature.
 	std::shared_ptr<Instrument> m_pPlaybackTrackInstrument;
@@ -288,7 +401,24 @@ private:
 
 	int m_nPlayBackSamplePosition;
 
+	/** Default interpolation mode. Instruments can override it using
+	 * Instrument::setInterpolateMode(). */
 	Interpolation::InterpolateMode m_interpolateMode;
+	/** Tables used by Interpolation::InterpolateMode::Sinc. */
+	SincInterpolator* m_pSincInterpolator;
+	/** Pan law of the current song. Updated at the beginning of each
+	 * process cycle. */
+	PanLawTable* m_pPanLawTable;
+	/** Whether any instrument of the current drumkit is soloed.
+	 * Updated at the beginning of each process cycle. */
+	bool m_bAnyInstrumentSoloed;
+
+	/** Scratch buffers holding the resampled data of a single note
+	 * (or the playback track) before being mixed into the outputs.
+	 * Both have #MAX_BUFFER_SIZE frames. */
+	float* m_pRenderBuffer_L;
+	float* m_pRenderBuffer_R;
+	bool m_bMemoryLocked;
 };
 
 inline const std::vector<Note*>& Sampler::getPlayingNotesQueue() const {
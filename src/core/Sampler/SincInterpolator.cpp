@@ -0,0 +1,177 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/Sampler/SincInterpolator.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include <core/Sampler/SampleRateConverter.h>
+
+namespace H2Core
+{
+
+SincInterpolator::SincInterpolator() {
+	const double fNormalization = SampleRateConverter::besselI0( fKaiserBeta );
+
+	m_tables.resize( nBands );
+	for ( int nBand = 0; nBand < nBands; ++nBand ) {
+		auto& table = m_tables[ nBand ];
+
+		const double fBandStep = std::pow( 2.0, nBand / 4.0 );
+		const double fBandCutoff = fCutoff / fBandStep;
+		table.nHalfTaps = static_cast<int>( std::ceil( nHalfTaps * fBandStep ) );
+		table.nHalfTaps += table.nHalfTaps % 2;
+
+		const int nTaps = 2 * table.nHalfTaps;
+		table.coefficients.resize( static_cast<size_t>( nPhases + 1 ) * nTaps );
+
+		for ( int nPhase = 0; nPhase <= nPhases; ++nPhase ) {
+			const double fFraction = static_cast<double>(nPhase) / nPhases;
+			float* pRow = table.coefficients.data() +
+				static_cast<size_t>(nPhase) * nTaps;
+
+			double fSum = 0;
+			for ( int ii = 0; ii < nTaps; ++ii ) {
+				const double fX = ( ii - table.nHalfTaps + 1 ) - fFraction;
+				const double fT = fX / table.nHalfTaps;
+
+				double fValue = 0;
+				if ( std::abs( fT ) < 1 ) {
+					const double fArg = M_PI * fBandCutoff * fX;
+					const double fSinc = fArg == 0 ? 1 : std::sin( fArg ) / fArg;
+					fValue = fSinc *
+						SampleRateConverter::besselI0(
+							fKaiserBeta * std::sqrt( 1 - fT * fT ) ) /
+						fNormalization;
+				}
+				pRow[ ii ] = static_cast<float>(fValue);
+				fSum += fValue;
+			}
+
+			// Unity gain at DC for all phases.
+			if ( fSum != 0 ) {
+				for ( int ii = 0; ii < nTaps; ++ii ) {
+					pRow[ ii ] = static_cast<float>( pRow[ ii ] / fSum );
+				}
+			}
+		}
+	}
+}
+
+int SincInterpolator::band( float fStep ) {
+	if ( fStep <= 1 ) {
+		return 0;
+	}
+	const int nBand = static_cast<int>(
+		std::ceil( 4 * std::log2( static_cast<double>(fStep) ) - 1e-6 ) );
+	return std::clamp( nBand, 0, nBands - 1 );
+}
+
+void SincInterpolator::resample( float* pBuffer_L, float* pBuffer_R,
+								 const float* pSample_data_L,
+								 const float* pSample_data_R,
+								 int nFrames, double& fSamplePos, float fStep,
+								 int nSampleFrames ) const {
+	const auto& table = m_tables[ band( fStep ) ];
+	const int nTableHalfTaps = table.nHalfTaps;
+	const int nTaps = 2 * nTableHalfTaps;
+	const float* pCoefficients = table.coefficients.data();
+
+	// Coefficients for the current read position. Aligned and padded so
+	// the loops below can be vectorized.
+	alignas( 16 ) float coefficients[ nMaxTaps ];
+
+	for ( int nFrame = 0; nFrame < nFrames; ++nFrame ) {
+		const int nSamplePos = static_cast<int>(fSamplePos);
+		const float fPhase =
+			static_cast<float>( fSamplePos - nSamplePos ) * nPhases;
+		const int nPhase = std::min( static_cast<int>(fPhase), nPhases - 1 );
+		const float fWeight = fPhase - nPhase;
+
+		const float* pRow = pCoefficients + static_cast<size_t>(nPhase) * nTaps;
+		const float* pNextRow = pRow + nTaps;
+		for ( int ii = 0; ii < nTaps; ++ii ) {
+			coefficients[ ii ] = pRow[ ii ] + fWeight * ( pNextRow[ ii ] - pRow[ ii ] );
+		}
+
+		const int nFirst = nSamplePos - nTableHalfTaps + 1;
+		float fVal_L = 0;
+		float fVal_R = 0;
+		if ( nFirst >= 0 && nFirst + nTaps <= nSampleFrames ) {
+			// Fast path. Four independent partial sums allow the
+			// compiler to use SIMD registers without reordering the
+			// floating point additions itself.
+			const float* pL = pSample_data_L + nFirst;
+			const float* pR = pSample_data_R + nFirst;
+			float sumL[ 4 ] = { 0, 0, 0, 0 };
+			float sumR[ 4 ] = { 0, 0, 0, 0 };
+			for ( int ii = 0; ii < nTaps; ii += 4 ) {
+				for ( int jj = 0; jj < 4; ++jj ) {
+					sumL[ jj ] += pL[ ii + jj ] * coefficients[ ii + jj ];
+					sumR[ jj ] += pR[ ii + jj ] * coefficients[ ii + jj ];
+				}
+			}
+			fVal_L = ( sumL[ 0 ] + sumL[ 1 ] ) + ( sumL[ 2 ] + sumL[ 3 ] );
+			fVal_R = ( sumR[ 0 ] + sumR[ 1 ] ) + ( sumR[ 2 ] + sumR[ 3 ] );
+		}
+		else {
+			// Kernel reaches beyond the beginning or end of the sample,
+			// which is treated as silence.
+			const int nStart = std::max( 0, -nFirst );
+			const int nEnd = std::min( nTaps, nSampleFrames - nFirst );
+			for ( int ii = nStart; ii < nEnd; ++ii ) {
+				fVal_L += pSample_data_L[ nFirst + ii ] * coefficients[ ii ];
+				fVal_R += pSample_data_R[ nFirst + ii ] * coefficients[ ii ];
+			}
+		}
+
+		pBuffer_L[ nFrame ] = fVal_L;
+		pBuffer_R[ nFrame ] = fVal_R;
+		fSamplePos += fStep;
+	}
+}
+
+QString SincInterpolator::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	if ( ! bShort ) {
+		sOutput = QString( "%1[SincInterpolator]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_tables:\n" ).arg( sPrefix ).arg( s ) );
+		for ( int ii = 0; ii < static_cast<int>(m_tables.size()); ++ii ) {
+			sOutput.append( QString( "%1%2%2[%3] nHalfTaps: %4\n" )
+							.arg( sPrefix ).arg( s ).arg( ii )
+							.arg( m_tables[ ii ].nHalfTaps ) );
+		}
+	}
+	else {
+		sOutput = QString( "[SincInterpolator] m_tables: [" );
+		for ( int ii = 0; ii < static_cast<int>(m_tables.size()); ++ii ) {
+			sOutput.append( QString( "%1%2" ).arg( ii == 0 ? "" : ", " )
+							.arg( m_tables[ ii ].nHalfTaps ) );
+		}
+		sOutput.append( "]" );
+	}
+
+	return sOutput;
+}
+
+};
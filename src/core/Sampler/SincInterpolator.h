@@ -0,0 +1,122 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#ifndef SINC_INTERPOLATOR_H
+#define SINC_INTERPOLATOR_H
+
+#include <vector>
+
+#include <core/Object.h>
+
+namespace H2Core
+{
+
+/**
+ * Band-limited interpolation used by Interpolation::InterpolateMode::Sinc.
+ *
+ * Output frames are computed by convolving the sample with a Kaiser
+ * windowed sinc evaluated at the fractional read position. The kernel
+ * is precomputed for #nPhases fractional positions and linearly
+ * interpolated in between, so rendering requires neither calls to
+ * trigonometric functions nor divisions.
+ *
+ * Reading the sample faster than its rate (pitching up) would alias
+ * unless the cutoff of the kernel is lowered accordingly. Therefore,
+ * there is a separate table for each of #nBands step sizes spaced by a
+ * quarter octave up to #fMaxStep. The table with the lowest cutoff not
+ * exceeding the Nyquist frequency of the step is used. Beyond
+ * #fMaxStep the last table is used and a small amount of aliasing is
+ * accepted in order to bound the number of taps.
+ *
+ * All tables are created in the constructor and never altered
+ * afterwards. resample() neither locks nor allocates.
+ *
+ * \ingroup docCore
+ */
+class SincInterpolator : public H2Core::Object<SincInterpolator>
+{
+	H2_OBJECT(SincInterpolator)
+public:
+	SincInterpolator();
+
+	/**
+	 * Same interface as the templated resample() function within
+	 * Sampler.cpp.
+	 *
+	 * \param pBuffer_L output buffer holding at least @a nFrames
+	 * \param pBuffer_R output buffer holding at least @a nFrames
+	 * \param pSample_data_L sample data
+	 * \param pSample_data_R sample data
+	 * \param nFrames number of frames to render
+	 * \param fSamplePos position within the sample. Will be advanced
+	 *   by @a nFrames times @a fStep.
+	 * \param fStep sample frames per output frame
+	 * \param nSampleFrames number of frames in the sample
+	 */
+	void resample( float* pBuffer_L, float* pBuffer_R,
+				   const float* pSample_data_L, const float* pSample_data_R,
+				   int nFrames, double& fSamplePos, float fStep,
+				   int nSampleFrames ) const;
+
+	/** Index of the table used for @a fStep. */
+	static int band( float fStep );
+
+	/** Number of taps on either side of the read position for steps up
+	 * to 1. Wider kernels are used for larger steps. */
+	static constexpr int nHalfTaps = 8;
+	static constexpr int nPhases = 256;
+	/** Number of tables. Consecutive ones differ by a quarter octave. */
+	static constexpr int nBands = 9;
+	static constexpr float fMaxStep = 4;
+	static constexpr double fKaiserBeta = 8.0;
+	/** Cutoff relative to the Nyquist frequency of the step leaving
+	 * room for the transition band. */
+	static constexpr double fCutoff = 0.9;
+	/** Upper bound for the number of taps of all tables. */
+	static constexpr int nMaxTaps = 2 * nHalfTaps * static_cast<int>(fMaxStep);
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+private:
+	struct Table {
+		/** Number of taps on either side of the read position. Always
+		 * even to allow for processing four taps at once. */
+		int nHalfTaps;
+		/** (#nPhases + 1) rows of 2 * #nHalfTaps coefficients each. The
+		 * last row is used for interpolating the coefficients of the
+		 * last phase. */
+		std::vector<float> coefficients;
+	};
+
+	std::vector<Table> m_tables;
+};
+
+};
+
+#endif
@@ -0,0 +1,338 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <core/Sampler/TimeStretcher.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentComponent.h>
+#include <core/Basics/InstrumentLayer.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Basics/Sample.h>
+#include <core/Basics/Song.h>
+#include <core/Hydrogen.h>
+#include <core/Preferences/Preferences.h>
+
+namespace H2Core
+{
+
+TimeStretcher::TimeStretcher( AudioEngine* pAudioEngine )
+	: m_pAudioEngine( pAudioEngine )
+	, m_fRequestedBpm( 0 )
+	, m_nGeneration( 0 )
+	, m_bShutdown( false )
+	, m_nMemoryUsage( 0 )
+	, m_nMemoryLimit( nDefaultMemoryLimit )
+{
+	m_dispatcher = std::thread( &TimeStretcher::runDispatcher, this );
+
+	// Rubber Band itself is single-threaded. Use a couple of workers
+	// but leave room for the audio and GUI threads.
+	const int nWorkers = std::clamp(
+		static_cast<int>(std::thread::hardware_concurrency()) / 2, 1,
+		nMaxWorkers );
+	for ( int ii = 0; ii < nWorkers; ++ii ) {
+		m_workers.push_back( std::thread( &TimeStretcher::runWorker, this ) );
+	}
+}
+
+TimeStretcher::~TimeStretcher() {
+	{
+		std::lock_guard<std::mutex> lock( m_jobMutex );
+		m_bShutdown = true;
+		m_jobs.clear();
+	}
+	m_dispatchCondition.notify_all();
+	m_jobCondition.notify_all();
+
+	if ( m_dispatcher.joinable() ) {
+		m_dispatcher.join();
+	}
+	for ( auto& tthread : m_workers ) {
+		if ( tthread.joinable() ) {
+			tthread.join();
+		}
+	}
+}
+
+void TimeStretcher::request( float fBpm ) {
+	m_fRequestedBpm.store( fBpm, std::memory_order_relaxed );
+	m_nGeneration.fetch_add( 1, std::memory_order_release );
+}
+
+std::shared_ptr<Sample> TimeStretcher::stretch( std::shared_ptr<Sample> pSample,
+												float fBpm ) {
+	if ( pSample == nullptr ) {
+		return nullptr;
+	}
+
+	const QString sKey = key( pSample, fBpm );
+	std::shared_ptr<Sample> pCached;
+	{
+		std::lock_guard<std::mutex> lock( m_cacheMutex );
+		auto it = m_cacheIndex.find( sKey );
+		if ( it != m_cacheIndex.end() ) {
+			auto entryIt = it.value();
+			m_cache.splice( m_cache.begin(), m_cache, entryIt );
+			pCached = entryIt->pSample;
+		}
+	}
+	if ( pCached != nullptr ) {
+		// Copying is done outside of the lock. Cached variants are
+		// never altered.
+		return std::make_shared<Sample>( pCached );
+	}
+
+	// The variant is rendered from the original file and not from
+	// pSample, which might be a stretched variant itself.
+	auto pStretched = std::make_shared<Sample>( pSample->get_filepath(),
+												pSample->getLicense() );
+	pStretched->set_loops( pSample->get_loops() );
+	pStretched->set_rubberband( pSample->get_rubberband() );
+	pStretched->set_pan_envelope( pSample->get_pan_envelope() );
+	pStretched->set_velocity_envelope( pSample->get_velocity_envelope() );
+	if ( ! pStretched->load( fBpm ) ) {
+		ERRORLOG( QString( "Unable to stretch [%1] to [%2] bpm" )
+				  .arg( pSample->get_filepath() ).arg( fBpm ) );
+		return nullptr;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( m_cacheMutex );
+		// Another thread might have rendered the same variant in the
+		// meantime.
+		if ( ! m_cacheIndex.contains( sKey ) ) {
+			const size_t nBytes =
+				static_cast<size_t>(pStretched->get_frames()) * 2 * sizeof( float );
+			m_cache.push_front( { sKey, pStretched, nBytes } );
+			m_cacheIndex.insert( sKey, m_cache.begin() );
+			m_nMemoryUsage += nBytes;
+			evict();
+		}
+	}
+
+	return std::make_shared<Sample>( pStretched );
+}
+
+bool TimeStretcher::isCached( const std::shared_ptr<Sample>& pSample,
+							  float fBpm ) const {
+	if ( pSample == nullptr ) {
+		return false;
+	}
+	const QString sKey = key( pSample, fBpm );
+	std::lock_guard<std::mutex> lock( m_cacheMutex );
+	return m_cacheIndex.contains( sKey );
+}
+
+void TimeStretcher::clear() {
+	std::lock_guard<std::mutex> lock( m_cacheMutex );
+	m_cache.clear();
+	m_cacheIndex.clear();
+	m_nMemoryUsage = 0;
+}
+
+void TimeStretcher::setMemoryLimit( size_t nBytes ) {
+	std::lock_guard<std::mutex> lock( m_cacheMutex );
+	m_nMemoryLimit = nBytes;
+	evict();
+}
+
+void TimeStretcher::evict() {
+	// The most recent variant is always kept. Evicting a variant does
+	// only drop the reference held by the cache. Layers using it are
+	// not affected.
+	while ( m_nMemoryUsage > m_nMemoryLimit && m_cache.size() > 1 ) {
+		const auto& entry = m_cache.back();
+		m_nMemoryUsage -= entry.nBytes;
+		m_cacheIndex.remove( entry.sKey );
+		m_cache.pop_back();
+	}
+}
+
+QString TimeStretcher::key( const std::shared_ptr<Sample>& pSample, float fBpm ) {
+	const auto& rubberband = pSample->get_rubberband();
+	const auto& loops = pSample->get_loops();
+
+	QString sKey = QString( "%1|%2|%3|%4|%5|%6" )
+		.arg( pSample->get_filepath() )
+		.arg( fBpm, 0, 'f', 3 )
+		.arg( rubberband.divider )
+		.arg( rubberband.pitch )
+		.arg( rubberband.c_settings )
+		// Determines the Rubber Band processing options.
+		.arg( Preferences::get_instance()->getRubberBandBatchMode() );
+	sKey.append( QString( "|%1:%2:%3:%4:%5" )
+				 .arg( loops.start_frame ).arg( loops.loop_frame )
+				 .arg( loops.end_frame ).arg( loops.count )
+				 .arg( static_cast<int>(loops.mode) ) );
+
+	sKey.append( "|p" );
+	for ( const auto& ppoint : pSample->get_pan_envelope() ) {
+		sKey.append( QString( ":%1,%2" ).arg( ppoint.frame ).arg( ppoint.value ) );
+	}
+	sKey.append( "|v" );
+	for ( const auto& ppoint : pSample->get_velocity_envelope() ) {
+		sKey.append( QString( ":%1,%2" ).arg( ppoint.frame ).arg( ppoint.value ) );
+	}
+
+	// Variants are converted to this rate while loading.
+	sKey.append( QString( "|r%1" ).arg( Sample::getTargetSampleRate() ) );
+
+	return sKey;
+}
+
+std::vector<TimeStretcher::Job> TimeStretcher::collectJobs( float fBpm,
+															uint64_t nGeneration ) const {
+	std::vector<Job> jobs;
+
+	m_pAudioEngine->lock( RIGHT_HERE );
+
+	auto pSong = Hydrogen::get_instance()->getSong();
+	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
+		m_pAudioEngine->unlock();
+		return jobs;
+	}
+
+	for ( const auto& pInstrument : *pSong->getDrumkit()->getInstruments() ) {
+		if ( pInstrument == nullptr ) {
+			continue;
+		}
+		for ( const auto& pComponent : *pInstrument->get_components() ) {
+			if ( pComponent == nullptr ) {
+				continue;
+			}
+			for ( int nnLayer = 0; nnLayer < InstrumentComponent::getMaxLayers();
+				  ++nnLayer ) {
+				const auto pLayer = pComponent->getLayer( nnLayer );
+				if ( pLayer != nullptr && pLayer->get_sample() != nullptr &&
+					 pLayer->get_sample()->get_rubberband().use ) {
+					jobs.push_back( { pLayer, pLayer->get_sample(), fBpm,
+							nGeneration } );
+				}
+			}
+		}
+	}
+
+	m_pAudioEngine->unlock();
+
+	return jobs;
+}
+
+void TimeStretcher::process( const Job& job ) {
+	auto pStretched = stretch( job.pSample, job.fBpm );
+	if ( pStretched == nullptr ) {
+		return;
+	}
+
+	m_pAudioEngine->lock( RIGHT_HERE );
+	// Neither the tempo nor the layer must have changed in the
+	// meantime.
+	if ( job.nGeneration == m_nGeneration.load( std::memory_order_acquire ) &&
+		 job.pLayer->get_sample() == job.pSample ) {
+		job.pLayer->set_sample( pStretched, m_pAudioEngine->getReclaimer() );
+	}
+	m_pAudioEngine->unlock();
+}
+
+void TimeStretcher::runDispatcher() {
+	uint64_t nDispatched = 0;
+
+	std::unique_lock<std::mutex> lock( m_jobMutex );
+	while ( ! m_bShutdown ) {
+		const uint64_t nGeneration = m_nGeneration.load( std::memory_order_acquire );
+		if ( nGeneration == nDispatched ) {
+			m_dispatchCondition.wait_for(
+				lock, std::chrono::milliseconds( nPollIntervalMs ) );
+			continue;
+		}
+		nDispatched = nGeneration;
+		const float fBpm = m_fRequestedBpm.load( std::memory_order_relaxed );
+
+		lock.unlock();
+		auto jobs = collectJobs( fBpm, nGeneration );
+		lock.lock();
+
+		// Jobs of previous requests are obsolete.
+		m_jobs.clear();
+		for ( auto& jjob : jobs ) {
+			m_jobs.push_back( std::move( jjob ) );
+		}
+		m_jobCondition.notify_all();
+	}
+}
+
+void TimeStretcher::runWorker() {
+	std::unique_lock<std::mutex> lock( m_jobMutex );
+	while ( true ) {
+		m_jobCondition.wait( lock, [&]() {
+			return m_bShutdown || ! m_jobs.empty(); } );
+		if ( m_bShutdown ) {
+			break;
+		}
+
+		const Job job = std::move( m_jobs.front() );
+		m_jobs.pop_front();
+
+		if ( job.nGeneration != m_nGeneration.load( std::memory_order_acquire ) ) {
+			// Superseded by a more recent request.
+			continue;
+		}
+
+		lock.unlock();
+		process( job );
+		lock.lock();
+	}
+}
+
+QString TimeStretcher::toQString( const QString& sPrefix, bool bShort ) const {
+	QString s = Base::sPrintIndention;
+	QString sOutput;
+	std::lock_guard<std::mutex> lock( m_cacheMutex );
+	if ( ! bShort ) {
+		sOutput = QString( "%1[TimeStretcher]\n" ).arg( sPrefix )
+			.append( QString( "%1%2m_fRequestedBpm: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_fRequestedBpm.load() ) )
+			.append( QString( "%1%2m_nGeneration: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nGeneration.load() ) )
+			.append( QString( "%1%2m_cache: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_cache.size() ) )
+			.append( QString( "%1%2m_nMemoryUsage: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nMemoryUsage ) )
+			.append( QString( "%1%2m_nMemoryLimit: %3\n" ).arg( sPrefix ).arg( s )
+					 .arg( m_nMemoryLimit ) );
+	}
+	else {
+		sOutput = QString( "[TimeStretcher]" )
+			.append( QString( " m_fRequestedBpm: %1" ).arg( m_fRequestedBpm.load() ) )
+			.append( QString( ", m_nGeneration: %1" ).arg( m_nGeneration.load() ) )
+			.append( QString( ", m_cache: %1" ).arg( m_cache.size() ) )
+			.append( QString( ", m_nMemoryUsage: %1" ).arg( m_nMemoryUsage ) )
+			.append( QString( ", m_nMemoryLimit: %1" ).arg( m_nMemoryLimit ) );
+	}
+
+	return sOutput;
+}
+
+};
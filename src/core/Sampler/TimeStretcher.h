@@ -0,0 +1,185 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+#ifndef TIME_STRETCHER_H
+#define TIME_STRETCHER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QHash>
+#include <QString>
+
+#include <core/Object.h>
+
+namespace H2Core
+{
+
+class AudioEngine;
+class InstrumentLayer;
+class Sample;
+
+/**
+ * Renders and caches tempo-dependent variants of samples which have
+ * Rubber Band enabled.
+ *
+ * Whenever the tempo changes while Rubber Band batch mode is active,
+ * request() is called. It is safe to do so from within the audio
+ * thread: the request is just recorded and picked up by a dispatcher
+ * thread, which collects all affected layers of the current drumkit
+ * and hands them over to a couple of worker threads. Each worker
+ * renders the stretched variant (or retrieves it from the cache) and
+ * swaps it into the layer. Until then, the previous variant keeps
+ * playing.
+ *
+ * Only the most recent request is served. Jobs belonging to tempi
+ * which were superseded before being processed are dropped.
+ *
+ * Stretched variants are cached keyed by their sample file, tempo,
+ * and all sample settings affecting the result. Least recently used
+ * variants are evicted as soon as #m_nMemoryLimit is exceeded.
+ */
+class TimeStretcher : public H2Core::Object<TimeStretcher>
+{
+	H2_OBJECT(TimeStretcher)
+public:
+	TimeStretcher( AudioEngine* pAudioEngine );
+	~TimeStretcher();
+
+	/**
+	 * Asks for all layers of the current drumkit to be stretched to
+	 * @a fBpm in the background.
+	 *
+	 * Neither locks nor allocates and can thus be called from within
+	 * the audio thread.
+	 */
+	void request( float fBpm );
+
+	/**
+	 * Returns a variant of @a pSample stretched to @a fBpm.
+	 *
+	 * It is either taken from the cache or rendered in the calling
+	 * thread. Either way, the caller gets a copy of its own. Layers
+	 * unload their samples once their instrument is retired, which
+	 * must not affect other layers using the same variant.
+	 *
+	 * \return `nullptr` in case the sample could not be loaded.
+	 */
+	std::shared_ptr<Sample> stretch( std::shared_ptr<Sample> pSample,
+									 float fBpm );
+
+	/** Whether a variant of @a pSample stretched to @a fBpm is
+	 * cached. */
+	bool isCached( const std::shared_ptr<Sample>& pSample, float fBpm ) const;
+	/** Drops all cached variants. */
+	void clear();
+
+	void setMemoryLimit( size_t nBytes );
+	size_t getMemoryLimit() const;
+	/** Memory occupied by the sample data of all cached variants. */
+	size_t getMemoryUsage() const;
+	int getCacheSize() const;
+
+	/** Formatted string version for debugging purposes.
+	 * \param sPrefix String prefix which will be added in front of
+	 * every new line
+	 * \param bShort Instead of the whole content of all classes
+	 * stored as members just a single unique identifier will be
+	 * displayed without line breaks.
+	 *
+	 * \return String presentation of current object.*/
+	QString toQString( const QString& sPrefix = "", bool bShort = true ) const override;
+
+	static constexpr size_t nDefaultMemoryLimit = 256 * 1024 * 1024;
+
+private:
+	struct Job {
+		std::shared_ptr<InstrumentLayer> pLayer;
+		/** Sample of #pLayer at the time the job was created. */
+		std::shared_ptr<Sample> pSample;
+		float fBpm;
+		uint64_t nGeneration;
+	};
+	struct Entry {
+		QString sKey;
+		std::shared_ptr<Sample> pSample;
+		size_t nBytes;
+	};
+
+	static QString key( const std::shared_ptr<Sample>& pSample, float fBpm );
+
+	/** Collects all layers of the current drumkit using Rubber Band. */
+	std::vector<Job> collectJobs( float fBpm, uint64_t nGeneration ) const;
+	void process( const Job& job );
+	/** Has to be called with #m_cacheMutex being locked. */
+	void evict();
+
+	void runDispatcher();
+	void runWorker();
+
+	AudioEngine* m_pAudioEngine;
+
+	std::atomic<float> m_fRequestedBpm;
+	/** Incremented on each call to request(). */
+	std::atomic<uint64_t> m_nGeneration;
+
+	std::mutex m_jobMutex;
+	std::condition_variable m_dispatchCondition;
+	std::condition_variable m_jobCondition;
+	std::deque<Job> m_jobs;
+	bool m_bShutdown;
+	std::thread m_dispatcher;
+	std::vector<std::thread> m_workers;
+
+	mutable std::mutex m_cacheMutex;
+	/** Most recently used variants first. */
+	std::list<Entry> m_cache;
+	QHash<QString, std::list<Entry>::iterator> m_cacheIndex;
+	size_t m_nMemoryUsage;
+	size_t m_nMemoryLimit;
+
+	/** Since request() does not notify the dispatcher, it has to poll. */
+	static constexpr int nPollIntervalMs = 20;
+	static constexpr int nMaxWorkers = 4;
+};
+
+inline size_t TimeStretcher::getMemoryLimit() const {
+	std::lock_guard<std::mutex> lock( m_cacheMutex );
+	return m_nMemoryLimit;
+}
+inline size_t TimeStretcher::getMemoryUsage() const {
+	std::lock_guard<std::mutex> lock( m_cacheMutex );
+	return m_nMemoryUsage;
+}
+inline int TimeStretcher::getCacheSize() const {
+	std::lock_guard<std::mutex> lock( m_cacheMutex );
+	return static_cast<int>(m_cache.size());
+}
+
+};
+
+#endif
@@ -20,12 +20,21 @@
  *
  */
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <map>
 #include <set>
+#include <thread>
+
+#include <QDateTime>
+#include <QFileInfo>
 
 #include <core/SoundLibrary/SoundLibraryDatabase.h>
 
 #include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentList.h>
 #include <core/Basics/Song.h>
 #include <core/EventQueue.h>
 #include <core/Helpers/Filesystem.h>
@@ -37,8 +46,9 @@ namespace H2Core
 
 QString SoundLibraryDatabase::m_sPatternBaseCategory = "not_categorized";
 
-SoundLibraryDatabase::SoundLibraryDatabase()
+SoundLibraryDatabase::SoundLibraryDatabase() : m_bIndexOutdated( false )
 {
+	readIndex();
 	update();
 }
 
@@ -78,7 +88,15 @@ void SoundLibraryDatabase::update()
 
 void SoundLibraryDatabase::updateDrumkits( bool bTriggerEvent ) {
 
+	// Kits of the previous scan - or restored from the on-disk index - are
+	// reused in case their drumkit.xml did not change in the meantime.
+	const auto previousDatabase = m_drumkitDatabase;
+	const auto previousTimestamps = m_drumkitTimestamps;
+	const auto previousIndexedPaths = m_indexedDrumkitPaths;
+
 	m_drumkitDatabase.clear();
+	m_drumkitTimestamps.clear();
+	m_indexedDrumkitPaths.clear();
 
 	QStringList drumkitPaths;
 	// system drumkits
@@ -107,27 +125,66 @@ void SoundLibraryDatabase::updateDrumkits( bool bTriggerEvent ) {
 		}
 	}
 
+	QStringList outdatedPaths;
+	std::vector<qint64> outdatedTimestamps;
 	for ( const auto& sDrumkitPath : drumkitPaths ) {
-		auto pDrumkit = Drumkit::load( sDrumkitPath );
-		if ( pDrumkit != nullptr ) {
-			if ( m_drumkitDatabase.find( sDrumkitPath ) !=
-				 m_drumkitDatabase.end() ) {
-				ERRORLOG( QString( "A drumkit was already loaded from [%1]. Something went wrong." )
-						  .arg( sDrumkitPath ) );
-				continue;
+		if ( m_drumkitDatabase.find( sDrumkitPath ) !=
+			 m_drumkitDatabase.end() || outdatedPaths.contains( sDrumkitPath ) ) {
+			ERRORLOG( QString( "A drumkit was already loaded from [%1]. Something went wrong." )
+					  .arg( sDrumkitPath ) );
+			continue;
+		}
+
+		const qint64 nLastModified =
+			lastModified( Filesystem::drumkit_file( sDrumkitPath ) );
+		const auto it = previousTimestamps.find( sDrumkitPath );
+		if ( it != previousTimestamps.end() && it->second == nLastModified &&
+			 previousDatabase.find( sDrumkitPath ) != previousDatabase.end() ) {
+			m_drumkitDatabase[ sDrumkitPath ] = previousDatabase.at( sDrumkitPath );
+			m_drumkitTimestamps[ sDrumkitPath ] = nLastModified;
+			if ( previousIndexedPaths.find( sDrumkitPath ) !=
+				 previousIndexedPaths.end() ) {
+				m_indexedDrumkitPaths.insert( sDrumkitPath );
 			}
+		}
+		else {
+			outdatedPaths << sDrumkitPath;
+			outdatedTimestamps.push_back( nLastModified );
+		}
+	}
 
+	const auto loadedDrumkits = loadDrumkits( outdatedPaths, &outdatedTimestamps );
+	for ( int ii = 0; ii < outdatedPaths.size(); ++ii ) {
+		const auto& sDrumkitPath = outdatedPaths[ ii ];
+		const auto& pDrumkit = loadedDrumkits[ ii ];
+		if ( pDrumkit != nullptr ) {
 			INFOLOG( QString( "Drumkit [%1] loaded from [%2]" )
 					 .arg( pDrumkit->getName() ).arg( sDrumkitPath ) );
 
 			m_drumkitDatabase[ sDrumkitPath ] = pDrumkit;
-			registerUniqueLabel( sDrumkitPath, pDrumkit );
+			m_drumkitTimestamps[ sDrumkitPath ] = outdatedTimestamps[ ii ];
 		}
 		else {
 			ERRORLOG( QString( "Unable to load drumkit at [%1]" ).arg( sDrumkitPath ) );
 		}
 	}
 
+	if ( outdatedPaths.size() > 0 ||
+		 previousDatabase.size() != m_drumkitDatabase.size() ) {
+		m_bIndexOutdated = true;
+	}
+
+	// Labels are assigned in the order the kits were found in order to get
+	// the same results regardless of which kits were loaded from disk.
+	for ( const auto& sDrumkitPath : drumkitPaths ) {
+		const auto it = m_drumkitDatabase.find( sDrumkitPath );
+		if ( it != m_drumkitDatabase.end() ) {
+			registerUniqueLabel( sDrumkitPath, it->second );
+		}
+	}
+
+	writeIndex();
+
 	if ( bTriggerEvent ) {
 		EventQueue::get_instance()->push_event( EVENT_SOUND_LIBRARY_CHANGED, 0 );
 	}
@@ -135,10 +192,16 @@ void SoundLibraryDatabase::updateDrumkits( bool bTriggerEvent ) {
 
 void SoundLibraryDatabase::updateDrumkit( const QString& sDrumkitPath, bool bTriggerEvent ) {
 
+	const qint64 nLastModified =
+		lastModified( Filesystem::drumkit_file( sDrumkitPath ) );
 	auto pDrumkit = Drumkit::load( sDrumkitPath );
 	if ( pDrumkit != nullptr ) {
 		m_drumkitDatabase[ sDrumkitPath ] = pDrumkit;
+		m_drumkitTimestamps[ sDrumkitPath ] = nLastModified;
+		m_indexedDrumkitPaths.erase( sDrumkitPath );
+		m_bIndexOutdated = true;
 		registerUniqueLabel( sDrumkitPath, pDrumkit );
+		writeIndex();
 	}
 	else {
 		ERRORLOG( QString( "Unable to load drumkit at [%1]" ).arg( sDrumkitPath ) );
@@ -149,6 +212,76 @@ void SoundLibraryDatabase::updateDrumkit( const QString& sDrumkitPath, bool bTri
 	}
 }
 
+bool SoundLibraryDatabase::isIndexed( const QString& sDrumkitPath ) const {
+	return m_indexedDrumkitPaths.find( sDrumkitPath ) !=
+		m_indexedDrumkitPaths.end();
+}
+
+std::vector<std::shared_ptr<Drumkit>> SoundLibraryDatabase::loadDrumkits(
+	const QStringList& drumkitPaths, std::vector<qint64>* pTimestamps )
+{
+	std::vector<std::shared_ptr<Drumkit>> drumkits( drumkitPaths.size(),
+													nullptr );
+	if ( drumkitPaths.size() == 0 ) {
+		return drumkits;
+	}
+
+	// Reading the drumkit.xml files is independent for each kit. Each
+	// worker picks the next kit not claimed yet. Upgrades, on the other
+	// hand, write to disk and are deferred till all workers are done.
+	// (std::vector<bool> can not be written to concurrently.)
+	std::vector<char> upgradeRequired( drumkitPaths.size(), false );
+	const int nWorkers = std::clamp(
+		static_cast<int>(std::thread::hardware_concurrency()), 1,
+		drumkitPaths.size() );
+	std::atomic<int> nNextIndex( 0 );
+	auto loadWorker = [&]() {
+		int nIndex = nNextIndex++;
+		while ( nIndex < drumkitPaths.size() ) {
+			bool bUpgradeRequired = false;
+			drumkits[ nIndex ] = Drumkit::load( drumkitPaths[ nIndex ],
+												false, // upgrade
+												false, // bSilent
+												&bUpgradeRequired );
+			upgradeRequired[ nIndex ] = bUpgradeRequired;
+			nIndex = nNextIndex++;
+		}
+	};
+
+	std::vector<std::future<void>> workers;
+	for ( int ii = 1; ii < nWorkers; ++ii ) {
+		workers.push_back( std::async( std::launch::async, loadWorker ) );
+	}
+	loadWorker();
+	for ( auto& wworker : workers ) {
+		wworker.wait();
+	}
+
+	for ( int ii = 0; ii < drumkitPaths.size(); ++ii ) {
+		if ( drumkits[ ii ] != nullptr && upgradeRequired[ ii ] ) {
+			drumkits[ ii ]->upgrade();
+
+			// Do not consider the kit outdated during the next update
+			// just because it was rewritten in here.
+			if ( pTimestamps != nullptr &&
+				 ii < static_cast<int>(pTimestamps->size()) ) {
+				( *pTimestamps )[ ii ] =
+					lastModified( Filesystem::drumkit_file( drumkitPaths[ ii ] ) );
+			}
+		}
+	}
+
+	return drumkits;
+}
+
+qint64 SoundLibraryDatabase::lastModified( const QString& sPath ) {
+	const QFileInfo fileInfo( sPath );
+	if ( ! fileInfo.exists() ) {
+		return -1;
+	}
+	return fileInfo.lastModified().toMSecsSinceEpoch();
+}
+
 std::shared_ptr<Drumkit> SoundLibraryDatabase::getDrumkit( const QString& sDrumkit ) {
 
 	// Convert supplied path or drumkit name into absolute path used
@@ -179,6 +312,8 @@ std::shared_ptr<Drumkit> SoundLibraryDatabase::getDrumkit( const QString& sDrumk
 
 		// Drumkit is not present in database yet. We attempt to load
 		// and add it.
+		const qint64 nLastModified =
+			lastModified( Filesystem::drumkit_file( sDrumkitPath ) );
 		auto pDrumkit = Drumkit::load( sDrumkitPath,
 									   true, // upgrade
 									   false // bSilent
@@ -190,6 +325,7 @@ std::shared_ptr<Drumkit> SoundLibraryDatabase::getDrumkit( const QString& sDrumk
 		m_customDrumkitPaths << sDrumkitPath;
 
 		m_drumkitDatabase[ sDrumkitPath ] = pDrumkit;
+		m_drumkitTimestamps[ sDrumkitPath ] = nLastModified;
 		registerUniqueLabel( sDrumkitPath, pDrumkit );
 		
 		INFOLOG( QString( "Session Drumkit [%1] loaded from [%2]" )
@@ -200,11 +336,37 @@ std::shared_ptr<Drumkit> SoundLibraryDatabase::getDrumkit( const QString& sDrumk
 		
 		return pDrumkit;
 	}
+
+	if ( m_indexedDrumkitPaths.find( sDrumkitPath ) !=
+		 m_indexedDrumkitPaths.end() ) {
+		// Only the metadata of the kit was restored from the on-disk index.
+		// Time to load the real thing.
+		m_indexedDrumkitPaths.erase( sDrumkitPath );
+
+		auto pDrumkit = Drumkit::load( sDrumkitPath,
+									   true, // upgrade
+									   false // bSilent
+									   );
+		if ( pDrumkit == nullptr ) {
+			ERRORLOG( QString( "Unable to load indexed drumkit [%1]. Removing it from database." )
+					  .arg( sDrumkitPath ) );
+			m_drumkitDatabase.erase( sDrumkitPath );
+			m_drumkitTimestamps.erase( sDrumkitPath );
+			m_bIndexOutdated = true;
+			writeIndex();
+
+			EventQueue::get_instance()->push_event( EVENT_SOUND_LIBRARY_CHANGED, 0 );
+			return nullptr;
+		}
+
+		m_drumkitDatabase[ sDrumkitPath ] = pDrumkit;
+		return pDrumkit;
+	}
 	
 	return m_drumkitDatabase.at( sDrumkitPath );
 }
 
-std::shared_ptr<Drumkit> SoundLibraryDatabase::getPreviousDrumkit() const {
+std::shared_ptr<Drumkit> SoundLibraryDatabase::getPreviousDrumkit() {
 
 	auto pHydrogen = H2Core::Hydrogen::get_instance();
 	auto pSong = pHydrogen->getSong();
@@ -218,18 +380,18 @@ std::shared_ptr<Drumkit> SoundLibraryDatabase::getPreviousDrumkit() const {
 
 	if ( sLastLoadedDrumkitPath.isEmpty() || search == m_drumkitDatabase.end() ) {
 		// In case we do not find the last loaded kit, we start at the top.
-		return m_drumkitDatabase.begin()->second;
+		return getDrumkit( m_drumkitDatabase.begin()->first );
 	}
 	else if ( search == m_drumkitDatabase.begin() ) {
 		// Periodic boundary conditions. The previous with respect to the first
 		// one is the last.
-		return std::prev( m_drumkitDatabase.end(), 1 )->second;
+		return getDrumkit( std::prev( m_drumkitDatabase.end(), 1 )->first );
 	}
 
-	return std::prev( search, 1 )->second;
+	return getDrumkit( std::prev( search, 1 )->first );
 }
 
-std::shared_ptr<Drumkit> SoundLibraryDatabase::getNextDrumkit() const {
+std::shared_ptr<Drumkit> SoundLibraryDatabase::getNextDrumkit() {
 
 	auto pHydrogen = H2Core::Hydrogen::get_instance();
 	auto pSong = pHydrogen->getSong();
@@ -246,10 +408,28 @@ std::shared_ptr<Drumkit> SoundLibraryDatabase::getNextDrumkit() const {
 		 m_drumkitDatabase.end() ) {
 		// In case we do not find the last loaded kit or it is located at the
 		// very bottom, we start at the top.
-		return m_drumkitDatabase.begin()->second;
+		return getDrumkit( m_drumkitDatabase.begin()->first );
 	}
 
-	return std::next( search, 1 )->second;
+	return getDrumkit( std::next( search, 1 )->first );
+}
+
+std::shared_ptr<Drumkit> SoundLibraryDatabase::getFallbackDrumkit() {
+	// getDrumkit() removes indexed kits which fail to load. Thus, we must
+	// not iterate the database itself.
+	QStringList drumkitPaths;
+	for ( const auto& entry : m_drumkitDatabase ) {
+		drumkitPaths << entry.first;
+	}
+
+	for ( const auto& sDrumkitPath : drumkitPaths ) {
+		auto pDrumkit = getDrumkit( sDrumkitPath );
+		if ( pDrumkit != nullptr ) {
+			return pDrumkit;
+		}
+	}
+
+	return nullptr;
 }
 
 void SoundLibraryDatabase::registerUniqueLabel( const QString& sDrumkitPath,
@@ -342,6 +522,23 @@ void SoundLibraryDatabase::updatePatterns( bool bTriggerEvent )
 	// search patterns user directory
 	loadPatternFromDirectory( Filesystem::patterns_dir() );
 
+	// Drop index entries of patterns which are gone.
+	std::set<QString> patternPaths;
+	for ( const auto& ppInfo : m_patternInfoVector ) {
+		patternPaths.insert( ppInfo->getPath() );
+	}
+	for ( auto it = m_patternIndex.begin(); it != m_patternIndex.end(); ) {
+		if ( patternPaths.find( it->first ) == patternPaths.end() ) {
+			it = m_patternIndex.erase( it );
+			m_bIndexOutdated = true;
+		}
+		else {
+			++it;
+		}
+	}
+
+	writeIndex();
+
 	if ( bTriggerEvent ) {
 		EventQueue::get_instance()->push_event( EVENT_SOUND_LIBRARY_CHANGED, 0 );
 	}
@@ -351,21 +548,218 @@ void SoundLibraryDatabase::loadPatternFromDirectory( const QString& sPatternDir
 {
 	foreach ( const QString& sName, Filesystem::pattern_list( sPatternDir ) ) {
 		QString sFile = sPatternDir + sName;
-		std::shared_ptr<SoundLibraryInfo> pInfo =
-			std::make_shared<SoundLibraryInfo>();
+		const qint64 nLastModified = lastModified( sFile );
+
+		std::shared_ptr<SoundLibraryInfo> pInfo;
+		const auto it = m_patternIndex.find( sFile );
+		if ( it != m_patternIndex.end() && it->second.first == nLastModified ) {
+			pInfo = it->second.second;
+		}
+		else {
+			pInfo = std::make_shared<SoundLibraryInfo>();
+			if ( ! pInfo->load( sFile ) ) {
+				continue;
+			}
 
-		if ( pInfo->load( sFile ) ) {
 			INFOLOG( QString( "Pattern [%1] of category [%2] loaded from [%3]" )
 					 .arg( pInfo->getName() ).arg( pInfo->getCategory() )
 					 .arg( sFile ) );
-			
-			m_patternInfoVector.push_back( pInfo );
+
+			m_patternIndex[ sFile ] = std::make_pair( nLastModified, pInfo );
+			m_bIndexOutdated = true;
+		}
+
+		m_patternInfoVector.push_back( pInfo );
 		
-			if ( ! m_patternCategories.contains( pInfo->getCategory() ) ) {
-				m_patternCategories << pInfo->getCategory();
+		if ( ! m_patternCategories.contains( pInfo->getCategory() ) ) {
+			m_patternCategories << pInfo->getCategory();
+		}
+	}
+}
+
+void SoundLibraryDatabase::readIndex() {
+	const QString sIndexPath = Filesystem::sound_library_index_path();
+	if ( ! Filesystem::file_exists( sIndexPath, true ) ) {
+		m_bIndexOutdated = true;
+		return;
+	}
+
+	XMLDoc doc;
+	if ( ! doc.read( sIndexPath, nullptr, true ) ) {
+		ERRORLOG( QString( "Unable to read sound library index [%1]. It will be rebuilt." )
+				  .arg( sIndexPath ) );
+		m_bIndexOutdated = true;
+		return;
+	}
+
+	const XMLNode rootNode = doc.firstChildElement( "soundLibraryIndex" );
+	if ( rootNode.isNull() ||
+		 rootNode.read_int( "formatVersion", 0, false, false, true ) !=
+		 nIndexFormatVersion ) {
+		WARNINGLOG( QString( "Sound library index [%1] is outdated. It will be rebuilt." )
+					.arg( sIndexPath ) );
+		m_bIndexOutdated = true;
+		return;
+	}
+
+	XMLNode drumkitNode = rootNode.firstChildElement( "drumkitList" )
+		.firstChildElement( "drumkit" );
+	while ( ! drumkitNode.isNull() ) {
+		const QString sPath = drumkitNode.read_string( "path", "", false, false, true );
+		const QString sName = drumkitNode.read_string( "name", "", false, false, true );
+		if ( sPath.isEmpty() || sName.isEmpty() ) {
+			drumkitNode = drumkitNode.nextSiblingElement( "drumkit" );
+			continue;
+		}
+
+		auto pDrumkit = std::make_shared<Drumkit>();
+		pDrumkit->setPath( sPath );
+		pDrumkit->setName( sName );
+		pDrumkit->setVersion( drumkitNode.read_int( "userVersion", 0,
+													true, true, true ) );
+		pDrumkit->setAuthor( drumkitNode.read_string(
+								 "author", "undefined author", true, true, true ) );
+		pDrumkit->setInfo( drumkitNode.read_string(
+							   "info", "No information available.", true, true, true ) );
+		pDrumkit->setLicense( License( drumkitNode.read_string(
+										   "license", "undefined license",
+										   true, true, true ),
+									   pDrumkit->getAuthor() ) );
+		pDrumkit->setImage( drumkitNode.read_string( "image", "", true, true, true ) );
+		pDrumkit->setImageLicense( License( drumkitNode.read_string(
+												"imageLicense", "undefined license",
+												true, true, true ),
+											pDrumkit->getAuthor() ) );
+		pDrumkit->setContext( Drumkit::DetermineContext( sPath ) );
+
+		// Instruments are only represented by the properties required to
+		// list them in the GUI and to query their types.
+		auto pInstrumentList = std::make_shared<InstrumentList>();
+		XMLNode instrumentNode = drumkitNode.firstChildElement( "instrumentList" )
+			.firstChildElement( "instrument" );
+		while ( ! instrumentNode.isNull() ) {
+			auto pInstrument = std::make_shared<Instrument>(
+				instrumentNode.read_int( "id", EMPTY_INSTR_ID, false, false, true ),
+				instrumentNode.read_string( "name", "", false, true, true ) );
+			pInstrument->setType(
+				instrumentNode.read_string( "type", "", true, true, true ) );
+			pInstrumentList->add( pInstrument );
+
+			instrumentNode = instrumentNode.nextSiblingElement( "instrument" );
+		}
+		pDrumkit->setInstruments( pInstrumentList );
+
+		m_drumkitDatabase[ sPath ] = pDrumkit;
+		m_drumkitTimestamps[ sPath ] = drumkitNode.read_string(
+			"lastModified", "-1", false, false, true ).toLongLong();
+		m_indexedDrumkitPaths.insert( sPath );
+
+		drumkitNode = drumkitNode.nextSiblingElement( "drumkit" );
+	}
+
+	XMLNode patternNode = rootNode.firstChildElement( "patternList" )
+		.firstChildElement( "pattern" );
+	while ( ! patternNode.isNull() ) {
+		const QString sPath = patternNode.read_string( "path", "", false, false, true );
+		if ( sPath.isEmpty() ) {
+			patternNode = patternNode.nextSiblingElement( "pattern" );
+			continue;
+		}
+
+		auto pInfo = std::make_shared<SoundLibraryInfo>();
+		pInfo->setPath( sPath );
+		pInfo->setType( "pattern" );
+		pInfo->setName( patternNode.read_string( "name", "", true, true, true ) );
+		pInfo->setAuthor( patternNode.read_string(
+							  "author", "undefined author", true, true, true ) );
+		pInfo->setLicense( License( patternNode.read_string(
+										"license", "", true, true, true ) ) );
+		pInfo->setInfo( patternNode.read_string(
+							"info", "No information available.", true, true, true ) );
+		pInfo->setCategory( patternNode.read_string( "category", "", true, true, true ) );
+		pInfo->setDrumkitName( patternNode.read_string(
+								   "drumkitName", "", true, true, true ) );
+
+		const qint64 nLastModified = patternNode.read_string(
+			"lastModified", "-1", false, false, true ).toLongLong();
+		m_patternIndex[ sPath ] = std::make_pair( nLastModified, pInfo );
+
+		patternNode = patternNode.nextSiblingElement( "pattern" );
+	}
+
+	INFOLOG( QString( "[%1] drumkits and [%2] patterns restored from sound library index [%3]" )
+			 .arg( m_drumkitDatabase.size() ).arg( m_patternIndex.size() )
+			 .arg( sIndexPath ) );
+}
+
+void SoundLibraryDatabase::writeIndex() {
+	if ( ! m_bIndexOutdated ) {
+		return;
+	}
+
+	XMLDoc doc;
+	XMLNode rootNode = doc.set_root( "soundLibraryIndex" );
+	rootNode.write_int( "formatVersion", nIndexFormatVersion );
+
+	XMLNode drumkitListNode = rootNode.createNode( "drumkitList" );
+	for ( const auto& [ ssPath, ppDrumkit ] : m_drumkitDatabase ) {
+		const auto it = m_drumkitTimestamps.find( ssPath );
+		if ( ppDrumkit == nullptr || it == m_drumkitTimestamps.end() ) {
+			continue;
+		}
+
+		XMLNode drumkitNode = drumkitListNode.createNode( "drumkit" );
+		drumkitNode.write_string( "path", ssPath );
+		drumkitNode.write_string( "lastModified", QString::number( it->second ) );
+		drumkitNode.write_string( "name", ppDrumkit->getName() );
+		drumkitNode.write_int( "userVersion", ppDrumkit->getVersion() );
+		drumkitNode.write_string( "author", ppDrumkit->getAuthor() );
+		drumkitNode.write_string( "info", ppDrumkit->getInfo() );
+		drumkitNode.write_string( "license",
+								  ppDrumkit->getLicense().getLicenseString() );
+		drumkitNode.write_string( "image", ppDrumkit->getImage() );
+		drumkitNode.write_string( "imageLicense",
+								  ppDrumkit->getImageLicense().getLicenseString() );
+
+		XMLNode instrumentListNode = drumkitNode.createNode( "instrumentList" );
+		for ( const auto& ppInstrument : *ppDrumkit->getInstruments() ) {
+			if ( ppInstrument == nullptr ) {
+				continue;
 			}
+			XMLNode instrumentNode = instrumentListNode.createNode( "instrument" );
+			instrumentNode.write_int( "id", ppInstrument->get_id() );
+			instrumentNode.write_string( "name", ppInstrument->get_name() );
+			instrumentNode.write_string( "type", ppInstrument->getType() );
 		}
 	}
+
+	XMLNode patternListNode = rootNode.createNode( "patternList" );
+	for ( const auto& [ ssPath, eentry ] : m_patternIndex ) {
+		const auto& [ nnLastModified, ppInfo ] = eentry;
+		if ( ppInfo == nullptr ) {
+			continue;
+		}
+
+		XMLNode patternNode = patternListNode.createNode( "pattern" );
+		patternNode.write_string( "path", ssPath );
+		patternNode.write_string( "lastModified", QString::number( nnLastModified ) );
+		patternNode.write_string( "name", ppInfo->getName() );
+		patternNode.write_string( "author", ppInfo->getAuthor() );
+		patternNode.write_string( "license",
+								  ppInfo->getLicense().getLicenseString() );
+		patternNode.write_string( "info", ppInfo->getInfo() );
+		patternNode.write_string( "category", ppInfo->getCategory() );
+		patternNode.write_string( "drumkitName", ppInfo->getDrumkitName() );
+	}
+
+	const QString sIndexPath = Filesystem::sound_library_index_path();
+	if ( ! doc.write( sIndexPath ) ) {
+		ERRORLOG( QString( "Unable to write sound library index [%1]" )
+				  .arg( sIndexPath ) );
+		return;
+	}
+
+	m_bIndexOutdated = false;
 }
 
 QString SoundLibraryDatabase::toQString( const QString& sPrefix, bool bShort ) const {
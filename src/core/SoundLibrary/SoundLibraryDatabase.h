@@ -30,6 +30,7 @@
 #include <QStringList>
 #include <map>
 #include <memory>
+#include <set>
 #include <vector>
 
 namespace H2Core
@@ -41,6 +42,12 @@ namespace H2Core
 *
 * This class organizes the metadata of all locally installed soundlibrary items.
 *
+* In order to not parse every single drumkit and pattern during startup, the
+* metadata of all items is stored in an on-disk index
+* (#Filesystem::sound_library_index_path()). Items whose files did not change
+* since they were indexed are restored from it and drumkits are only loaded
+* from disk once they are requested via getDrumkit().
+*
 * @author Sebastian Moors
 *
 */
@@ -80,15 +87,27 @@ class SoundLibraryDatabase :    public H2Core::Object<SoundLibraryDatabase>
 		/** Based on #Song::m_sLastLoadedDrumkitPath get the previous drumkit in
 		 * the data base (the one shown above the last loaded one in the Sound
 		 * Library widget) */
-		std::shared_ptr<Drumkit> getPreviousDrumkit() const;
+		std::shared_ptr<Drumkit> getPreviousDrumkit();
 		/** Based on #Song::m_sLastLoadedDrumkitPath get the next drumkit in the
 		 * data base (the one shown below the last loaded one in the Sound
 		 * Library widget) */
-		std::shared_ptr<Drumkit> getNextDrumkit() const;
+		std::shared_ptr<Drumkit> getNextDrumkit();
+		/** Fully loaded version of the first kit in the database which can
+		 * be loaded from disk. Used in case the default kit is not
+		 * available.
+		 *
+		 * \return `nullptr` if no kit could be loaded. */
+		std::shared_ptr<Drumkit> getFallbackDrumkit();
 
+	/** Kits restored from the on-disk index only hold their metadata and
+	 * the id, name, and type of their instruments. Use getDrumkit() in
+	 * order to retrieve a fully loaded version. */
 	const std::map<QString, std::shared_ptr<Drumkit>>& getDrumkitDatabase() const {
 		return m_drumkitDatabase;
 	}
+		/** Whether the kit at @a sDrumkitPath was restored from the on-disk
+		 * index and was not loaded from disk yet. */
+		bool isIndexed( const QString& sDrumkitPath ) const;
 		/** Retrieves an unique label for the kit associated with @a
 		 * sDrumkitPath. This may serve as a more accessible alternative to the
 		 * absolute path of the kit in the GUI. */
@@ -127,6 +146,31 @@ private:
 		void registerUniqueLabel( const QString& sDrumkitPath,
 								  std::shared_ptr<Drumkit> pDrumkit );
 
+		/** Restores the metadata of all drumkits and patterns from the
+		 * on-disk index. */
+		void readIndex();
+		/** Stores the metadata of all drumkits and patterns in the on-disk
+		 * index. Does nothing in case no item changed since the index was
+		 * read or written the last time. */
+		void writeIndex();
+		/** Loads all kits in @a drumkitPaths using several worker threads.
+		 *
+		 * Kits not complying with the current format are upgraded one at a
+		 * time after all of them have been loaded.
+		 *
+		 * \param pTimestamps Modification times of the drumkit.xml files in
+		 *   the same order as @a drumkitPaths. The ones of upgraded kits
+		 *   are updated.
+		 *
+		 * \return Kits in the same order as @a drumkitPaths. Entries of kits
+		 *   which could not be loaded are `nullptr`. */
+		static std::vector<std::shared_ptr<Drumkit>> loadDrumkits(
+			const QStringList& drumkitPaths,
+			std::vector<qint64>* pTimestamps = nullptr );
+		/** \return Modification time of @a sPath in msecs since epoch or -1
+		 *   in case it does not exist. */
+		static qint64 lastModified( const QString& sPath );
+
 	std::map<QString, std::shared_ptr<Drumkit>> m_drumkitDatabase;
 		/** The absolute path to a drumkit folder is not the most accessible way
 		 * to refer to a kit in the GUI. Instead, each kit will also have an
@@ -154,6 +198,22 @@ private:
 		/** Whole folders that will be scanned for drumkits in addition to the
 		 * system and user drumkti folder. */
 		QStringList m_customDrumkitFolders;
+
+		/** Modification times of the drumkit.xml files of all kits in
+		 * #m_drumkitDatabase at the time they were loaded. */
+		std::map<QString, qint64> m_drumkitTimestamps;
+		/** Modification times and metadata of all pattern files loaded
+		 * either from disk or from the on-disk index. */
+		std::map<QString, std::pair<qint64, std::shared_ptr<SoundLibraryInfo>>> m_patternIndex;
+		/** Paths of all kits in #m_drumkitDatabase which were restored from
+		 * the on-disk index and were not loaded from disk yet. */
+		std::set<QString> m_indexedDrumkitPaths;
+		/** Whether the content of the database differs from the on-disk
+		 * index. */
+		bool m_bIndexOutdated;
+
+		/** Used to indicate changes in the format of the on-disk index. */
+		static constexpr int nIndexFormatVersion = 1;
 };
 }; // namespace H2Core
 
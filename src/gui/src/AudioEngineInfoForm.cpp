@@ -44,6 +44,19 @@ AudioEngineInfoForm::AudioEngineInfoForm(QWidget* parent)
  , Object()
 {
 	setupUi( this );
+
+	processProfileLbl->setFont(
+		QFontDatabase::systemFont( QFontDatabase::FixedFont ) );
+	// Reserve space for all stages before the size is fixed.
+	QStringList rows;
+	for ( int ii = 0; ii <= ProcessProfiler::nStages; ++ii ) {
+		rows << QString( 66, ' ' );
+	}
+	processProfileLbl->setText( rows.join( "\n" ) );
+	connect( resetProfileBtn, &QPushButton::clicked, [](){
+		Hydrogen::get_instance()->getAudioEngine()->getProfiler()->reset();
+	});
+
 	adjustSize();
 	setFixedSize( width(), height() );	// not resizable
 
@@ -73,6 +86,7 @@ AudioEngineInfoForm::~AudioEngineInfoForm()
  */
 void AudioEngineInfoForm::showEvent ( QShowEvent* )
 {
+	Hydrogen::get_instance()->getAudioEngine()->setPageFaultStatisticsEnabled( true );
 	updateInfo();
 	m_pTimer->start(200);
 }
@@ -84,6 +98,7 @@ void AudioEngineInfoForm::showEvent ( QShowEvent* )
 void AudioEngineInfoForm::hideEvent ( QHideEvent* )
 {
 	m_pTimer->stop();
+	Hydrogen::get_instance()->getAudioEngine()->setPageFaultStatisticsEnabled( false );
 }
 
 
@@ -113,6 +128,15 @@ void AudioEngineInfoForm::updateInfo()
 	sprintf(tmp, "%#.2f / %#.2f  (%d%%)", pAudioEngine->getProcessTime(), pAudioEngine->getMaxProcessTime(), perc );
 	processTimeLbl->setText(tmp);
 
+	// minor / major faults of the last cycle (totals)
+	pageFaultsLbl->setText( QString( "%1 / %2  (%3 / %4)" )
+							.arg( pAudioEngine->getMinorPageFaults() )
+							.arg( pAudioEngine->getMajorPageFaults() )
+							.arg( pAudioEngine->getTotalMinorPageFaults() )
+							.arg( pAudioEngine->getTotalMajorPageFaults() ) );
+
+	processProfileLbl->setText( pAudioEngine->getProfiler()->format().trimmed() );
+
 	// Song state
 	if (pSong == nullptr) {
 		songStateLbl->setText( "NULL song" );
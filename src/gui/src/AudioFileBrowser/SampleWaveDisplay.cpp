@@ -44,7 +44,7 @@ SampleWaveDisplay::SampleWaveDisplay(QWidget* pParent)
 		ERRORLOG( "Error loading pixmap" );
 	}
 
-	m_pPeakData = new int[ w ];
+	m_peaks.assign( w, { 0, 0, 0 } );
 
 }
 
@@ -54,8 +54,6 @@ SampleWaveDisplay::SampleWaveDisplay(QWidget* pParent)
 SampleWaveDisplay::~SampleWaveDisplay()
 {
 	//INFOLOG( "DESTROY" );
-
-	delete[] m_pPeakData;
 }
 
 
@@ -66,11 +64,16 @@ void SampleWaveDisplay::paintEvent(QPaintEvent *ev)
 	painter.setRenderHint( QPainter::Antialiasing );
 	painter.drawPixmap( ev->rect(), m_Background, ev->rect() );
 
-	painter.setPen( QColor( 102, 150, 205 ) );
-	int VCenter = height() / 2;
-	for ( int x = 0; x < width(); x++ ) {
-		painter.drawLine( x, VCenter, x, m_pPeakData[x] + VCenter );
-		painter.drawLine( x, VCenter, x, -m_pPeakData[x] + VCenter );
+	const QColor peakColor( 102, 150, 205 );
+	const QColor rmsColor( 152, 190, 235 );
+	const int nVCenter = height() / 2;
+	const int nPixels = std::min( width(), static_cast<int>(m_peaks.size()) );
+	for ( int x = 0; x < nPixels; x++ ) {
+		const auto& peak = m_peaks[ x ];
+		painter.setPen( peakColor );
+		painter.drawLine( x, nVCenter - peak.fMax, x, nVCenter - peak.fMin );
+		painter.setPen( rmsColor );
+		painter.drawLine( x, nVCenter - peak.fRms, x, nVCenter + peak.fRms );
 	}
 
 	QFont font;
@@ -101,27 +104,15 @@ void SampleWaveDisplay::updateDisplay( const QString& filename )
 
 //		INFOLOG( "[updateDisplay] sample: " + m_sSampleName  );
 
-		int nSampleLength = pNewSample->get_frames();
-		float nScaleFactor = nSampleLength / width();
-
-		float fGain = height() / 2.0 * 1.0;
-
-		auto pSampleData = pNewSample->get_data_l();
-
-		int nSamplePos =0;
-		int nVal;
-		for ( int i = 0; i < width(); ++i ){
-			nVal = 0;
-			for ( int j = 0; j < nScaleFactor; ++j ) {
-				if ( j < nSampleLength ) {
-					int newVal = static_cast<int>( pSampleData[ nSamplePos ] * fGain );
-					if ( newVal > nVal ) {
-						nVal = newVal;
-					}
-				}
-				++nSamplePos;
-			}
-			m_pPeakData[ i ] = nVal;
+		const int nWidth = width();
+		m_peaks.resize( nWidth );
+		pNewSample->getPeaks( PeakPyramid::Channel::Both, 0,
+							  static_cast<double>(pNewSample->get_frames()) / nWidth,
+							  nWidth, m_peaks.data() );
+
+		const float fGain = height() / 2.0 * 1.0;
+		for ( auto& peak : m_peaks ) {
+			peak = { peak.fMin * fGain, peak.fMax * fGain, peak.fRms * fGain };
 		}
 	}
 
@@ -24,7 +24,9 @@
 #define SAMPLE_WAVE_DISPLAY
 
 #include <QtWidgets>
+#include <vector>
 
+#include <core/Basics/PeakPyramid.h>
 #include <core/Object.h>
 
 
@@ -46,7 +48,9 @@ class SampleWaveDisplay :  public QWidget,  public H2Core::Object<SampleWaveDisp
 	private:
 		QPixmap m_Background;
 		QString m_sSampleName;
-		int *	m_pPeakData;
+		/** One entry per pixel already scaled to the height of the
+		 * widget. */
+		std::vector<H2Core::PeakPyramid::Peak> m_peaks;
 };
 
 
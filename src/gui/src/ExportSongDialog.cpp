@@ -78,6 +78,9 @@ static int interpolateModeToComboBoxIndex(Interpolation::InterpolateMode interpo
 		case Interpolation::InterpolateMode::Hermite:
 			Index = 4;
 			break;
+		case Interpolation::InterpolateMode::Sinc:
+			Index = 5;
+			break;
 	}
 	
 	return Index;
@@ -611,10 +614,11 @@ void ExportSongDialog::closeExport() {
 	m_bExporting = false;
 	
 	if ( pPref->getRubberBandBatchMode() ){
-		pHydrogen->getAudioEngine()->lock( RIGHT_HERE );
-		pSong->getDrumkit()->recalculateRubberband(
-			pHydrogen->getAudioEngine()->getTransportPosition()->getBpm() );
-		pHydrogen->getAudioEngine()->unlock();
+		// Samples were stretched to the tempi encountered during
+		// export.
+		auto pAudioEngine = pHydrogen->getAudioEngine();
+		pAudioEngine->getTimeStretcher()->request(
+			pAudioEngine->getTransportPosition()->getBpm() );
 	}
 	pPref->setRubberBandBatchMode( m_bOldRubberbandBatchMode );
 	pHydrogen->setIsTimelineActivated( m_bOldTimeLineBPMMode );
@@ -855,6 +859,9 @@ void ExportSongDialog::setResamplerMode(int index)
 	case 4:
 		pSampler->setInterpolateMode( Interpolation::InterpolateMode::Hermite );
 		break;
+	case 5:
+		pSampler->setInterpolateMode( Interpolation::InterpolateMode::Sinc );
+		break;
 	}
 }
 
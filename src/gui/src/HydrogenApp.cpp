@@ -98,13 +98,14 @@ HydrogenApp::HydrogenApp( MainForm *pMainForm )
 
 	m_pCommonStrings = std::make_shared<CommonStrings>();
 
+	const auto pPref = Preferences::get_instance();
+
 	//setup the undo stack
 	m_pUndoStack = new QUndoStack( this );
+	m_pUndoStack->setUndoLimit( pPref->getUndoLimit() );
 
 	updateWindowTitle();
 
-	const auto pPref = Preferences::get_instance();
-
 	setupSinglePanedInterface();
 
 	// restore audio engine form properties
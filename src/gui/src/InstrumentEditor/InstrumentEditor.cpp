@@ -1132,7 +1132,7 @@ void InstrumentEditor::loadLayerBtnClicked()
 
 			if ( pLayer != nullptr ) {
 				// insert new sample from newInstrument, old sample gets deleted by set_sample
-				pLayer->set_sample( pNewSample );
+				pLayer->set_sample( pNewSample, pHydrogen->getAudioEngine()->getReclaimer() );
 			}
 			else {
 				pLayer = std::make_shared<H2Core::InstrumentLayer>( pNewSample );
@@ -32,7 +32,6 @@ using namespace H2Core;
 
 WaveDisplay::WaveDisplay(QWidget* pParent)
  : QWidget( pParent )
- , m_nCurrentWidth( 0 )
  , m_sSampleName( "-" )
  , m_pLayer( nullptr )
  , m_SampleNameAlignment( Qt::AlignCenter )
@@ -44,9 +43,6 @@ WaveDisplay::WaveDisplay(QWidget* pParent)
 		ERRORLOG( "Error loading pixmap" );
 	}
 
-	m_pPeakData = new int[ width() ];
-	memset( m_pPeakData, 0, width() * sizeof( m_pPeakData[0] ) );
-	
 	connect( HydrogenApp::get_instance(), &HydrogenApp::preferencesChanged, this, &WaveDisplay::onPreferencesChanged );
 }
 
@@ -56,8 +52,6 @@ WaveDisplay::WaveDisplay(QWidget* pParent)
 WaveDisplay::~WaveDisplay()
 {
 	//INFOLOG( "DESTROY" );
-
-	delete[] m_pPeakData;
 }
 
 void WaveDisplay::paintEvent( QPaintEvent *ev ) {
@@ -78,11 +72,16 @@ void WaveDisplay::createBackground( QPainter* painter ) {
 	painter->drawRect(0, 0, width(), height());
 	
 	if( m_pLayer ){
-		painter->setPen( QColor( 102, 150, 205 ) );
-		int VCenter = height() / 2;
-		for ( int x = 0; x < width(); x++ ) {
-			painter->drawLine( x, VCenter, x, m_pPeakData[x] + VCenter );
-			painter->drawLine( x, VCenter, x, -m_pPeakData[x] + VCenter );
+		const QColor peakColor( 102, 150, 205 );
+		const QColor rmsColor( 152, 190, 235 );
+		const int nVCenter = height() / 2;
+		const int nPixels = std::min( width(), static_cast<int>(m_peaks.size()) );
+		for ( int x = 0; x < nPixels; x++ ) {
+			const auto& peak = m_peaks[ x ];
+			painter->setPen( peakColor );
+			painter->drawLine( x, nVCenter - peak.fMax, x, nVCenter - peak.fMin );
+			painter->setPen( rmsColor );
+			painter->drawLine( x, nVCenter - peak.fRms, x, nVCenter + peak.fRms );
 		}
 		
 	}
@@ -112,59 +111,38 @@ void WaveDisplay::resizeEvent( QResizeEvent * event )
 
 void WaveDisplay::updateDisplay( std::shared_ptr<H2Core::InstrumentLayer> pLayer )
 {
-	int currentWidth = width();
+	const int nWidth = width();
 	
-	if(!pLayer || currentWidth <= 0){
+	if(!pLayer || nWidth <= 0){
 		m_pLayer = nullptr;
 		m_sSampleName = "-";
 
 		update();
 		return;
 	}
-	
-	if(currentWidth != m_nCurrentWidth){
-		delete[] m_pPeakData;
-		m_pPeakData = new int[ currentWidth ];
-		
-		m_nCurrentWidth = currentWidth;
-	}
+
+	m_peaks.assign( nWidth, { 0, 0, 0 } );
 	
 	if ( pLayer && pLayer->get_sample() ) {
 		m_pLayer = pLayer;
-		m_sSampleName = pLayer->get_sample()->get_filename();
+		auto pSample = pLayer->get_sample();
+		m_sSampleName = pSample->get_filename();
 
 		//INFOLOG( "[updateDisplay] sample: " + m_sSampleName  );
 
-		int nSampleLength = pLayer->get_sample()->get_frames();
-		int nScaleFactor = nSampleLength / m_nCurrentWidth;
-
-		float fGain = height() / 2.0 * pLayer->get_gain();
-
-		auto pSampleData = pLayer->get_sample()->get_data_l();
-
-		int nSamplePos =0;
-		int nVal;
-		for ( int i = 0; i < width(); ++i ){
-			nVal = 0;
-			for ( int j = 0; j < nScaleFactor; ++j ) {
-				if ( j < nSampleLength ) {
-					int newVal = (int)( pSampleData[ nSamplePos ] * fGain );
-					if ( newVal > nVal ) {
-						nVal = newVal;
-					}
-				}
-				++nSamplePos;
-			}
-			m_pPeakData[ i ] = nVal;
+		const double fFramesPerPixel =
+			static_cast<double>(pSample->get_frames()) / nWidth;
+		pSample->getPeaks( PeakPyramid::Channel::Both, 0, fFramesPerPixel,
+						   nWidth, m_peaks.data() );
+
+		const float fGain = height() / 2.0 * pLayer->get_gain();
+		for ( auto& peak : m_peaks ) {
+			peak = { peak.fMin * fGain, peak.fMax * fGain, peak.fRms * fGain };
 		}
 	}
 	else {
 		m_pLayer = nullptr;
 		m_sSampleName = "-";
-		for ( int i =0; i < m_nCurrentWidth; ++i ){
-			m_pPeakData[ i ] = 0;
-		}
-		
 	}
 
 	update();
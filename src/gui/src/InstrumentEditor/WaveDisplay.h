@@ -26,6 +26,9 @@
 #include <QtGui>
 #include <QtWidgets>
 
+#include <vector>
+
+#include <core/Basics/PeakPyramid.h>
 #include <core/Object.h>
 #include <core/Preferences/Preferences.h>
 #include "../Widgets/WidgetWithScalableFont.h"
@@ -67,13 +70,9 @@ public slots:
 		Qt::AlignmentFlag			m_SampleNameAlignment;
 		QPixmap						m_Background;
 		QString						m_sSampleName;
-		int *						m_pPeakData;
-		
-		/*
-		 * Used to re-initialise m_pPeakData if width has changed
-		 */
-		
-		int							m_nCurrentWidth;
+		/** One entry per pixel already scaled to the height of the
+		 * widget. */
+		std::vector<H2Core::PeakPyramid::Peak>	m_peaks;
 		
 		std::shared_ptr<H2Core::InstrumentLayer>	m_pLayer;
 };
@@ -34,6 +34,7 @@
 #include <core/Basics/Playlist.h>
 #include <core/EventQueue.h>
 #include <core/H2Exception.h>
+#include <core/Helpers/BackgroundWriter.h>
 #include <core/Helpers/Files.h>
 #include <core/Hydrogen.h>
 #include <core/IO/MidiCommon.h>
@@ -97,6 +98,8 @@ MainForm::MainForm( QApplication * pQApplication, const QString& sSongFilename,
 					const QString& sPlaylistFilename )
 	: QMainWindow( nullptr )
 	, m_sPreviousAutoSaveSongFile( "" )
+	, m_pAutoSaveWriter( new BackgroundWriter() )
+	, m_nAutoSavedRevision( 0 )
 {
 	const auto pPref = H2Core::Preferences::get_instance();
 	auto pHydrogen = H2Core::Hydrogen::get_instance();
@@ -233,6 +236,9 @@ MainForm::~MainForm()
 
 	delete m_pUndoView;
 
+	// Finishes pending autosaves.
+	delete m_pAutoSaveWriter;
+
 	if (h2app != nullptr) {
 		delete h2app;
 		h2app = nullptr;
@@ -756,6 +762,7 @@ void MainForm::action_file_new()
 	QFileInfo autoSaveFile( QString( "%1/.%2.autosave%3" )
 							.arg( fileInfo.absoluteDir().absolutePath() )
 							.arg( sBaseName ).arg( Filesystem::songs_ext ) );
+	m_pAutoSaveWriter->waitForFinished();
 	if ( autoSaveFile.exists() ) {
 		Filesystem::rm( autoSaveFile.absoluteFilePath() );
 	}
@@ -867,9 +874,7 @@ bool MainForm::action_file_save_as()
 			// autosave file.
 			const QString sAutoSaveFile = Filesystem::getAutoSaveFilename(
 				Filesystem::Type::Song, sLastFilename );
-			if ( Filesystem::file_exists( sAutoSaveFile, true ) ) {
-				Filesystem::rm( sAutoSaveFile );
-			}
+			m_pAutoSaveWriter->remove( sAutoSaveFile );
 		}
 	}
 
@@ -919,6 +924,11 @@ bool MainForm::action_file_save( const QString& sNewFilename )
 	// Clear the pattern editor selection to resolve any duplicates
 	HydrogenApp::get_instance()->getPatternEditorPanel()->getDrumPatternEditor()->clearSelection();
 
+	// An autosave still pending in the background writer must not
+	// land after the song itself. Being newer, it would otherwise be
+	// offered for recovery the next time the song is opened.
+	m_pAutoSaveWriter->waitForFinished();
+
 	bool bSaved;
 	if ( sNewFilename.isEmpty() ) {
 		bSaved = H2Core::CoreActionController::saveSong();
@@ -2143,23 +2153,24 @@ void MainForm::onAutoSaveTimer()
 	auto pSong = pHydrogen->getSong();
 	auto pPlaylist = pHydrogen->getPlaylist();
 
-	if ( pSong != nullptr && pSong->getIsModified() ) {
-		const QString sOldFilename = pSong->getFilename();
-
+	if ( pSong != nullptr && pSong->getIsModified() &&
+		 ( m_pAutoSavedSong.lock() != pSong ||
+		   m_nAutoSavedRevision != pSong->getRevision() ) ) {
 		const QString sAutoSaveFilename = Filesystem::getAutoSaveFilename(
 			Filesystem::Type::Song, pSong->getFilename() );
 		if ( sAutoSaveFilename != m_sPreviousAutoSaveSongFile ) {
 			if ( ! m_sPreviousAutoSaveSongFile.isEmpty() ) {
-				QFile file( m_sPreviousAutoSaveSongFile );
-				file.remove();
+				m_pAutoSaveWriter->remove( m_sPreviousAutoSaveSongFile );
 			}
 			m_sPreviousAutoSaveSongFile = sAutoSaveFilename;
 		}
-			
-		pSong->save( sAutoSaveFilename );
 
-		pSong->setFilename( sOldFilename );
-		pSong->setIsModified( true );
+		// Only the serialization into a document is done on the GUI
+		// thread. Neither the filename nor the modification state of
+		// the song are touched.
+		m_pAutoSaveWriter->write( sAutoSaveFilename, pSong->toXml() );
+		m_pAutoSavedSong = pSong;
+		m_nAutoSavedRevision = pSong->getRevision();
 	}
 
 	if ( pPlaylist != nullptr && pPlaylist->getIsModified() ) {
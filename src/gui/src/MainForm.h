@@ -42,7 +42,9 @@ class InfoBar;
 class QUndoView;///debug only
 
 namespace H2Core {
+	class BackgroundWriter;
 	class Drumkit;
+	class Song;
 }
 
 ///
@@ -321,6 +323,13 @@ public slots:
 		written unless we take care of them.*/
 	QString m_sPreviousAutoSaveSongFile;
 	QString m_sPreviousAutoSavePlaylistFile;
+	/** Writes the autosave files of the song so that the GUI is not
+		blocked while doing so. */
+	H2Core::BackgroundWriter* m_pAutoSaveWriter;
+	/** Song and H2Core::Song::getRevision() of the latest autosave.
+		Used to skip autosaving when nothing changed since. */
+	std::weak_ptr<H2Core::Song> m_pAutoSavedSong;
+	int m_nAutoSavedRevision;
 
 	/**
 	 * Maps an incoming @a pKeyEvent to actions via #Shortcuts
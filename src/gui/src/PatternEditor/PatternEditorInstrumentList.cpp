@@ -136,6 +136,107 @@ InstrumentLine::InstrumentLine(QWidget* pParent)
 								 HydrogenApp::get_instance()->getMainForm(),
 								 SLOT( action_drumkit_addInstrument() ) );
 	m_pFunctionPopup->addAction( tr( "Rename instrument" ), this, SLOT( functionRenameInstrument() ) );
+
+	m_pInterpolationPopup = new QMenu( tr( "Interpolation ..." ), m_pFunctionPopup );
+	m_pInterpolationGroup = new QActionGroup( m_pInterpolationPopup );
+	m_pInterpolationGroup->setExclusive( true );
+	/*: Uses the interpolation mode selected in the Preferences for the
+	 *  instrument. */
+	auto pDefaultInterpolationAction =
+		m_pInterpolationPopup->addAction( tr( "Default" ) );
+	pDefaultInterpolationAction->setCheckable( true );
+	m_pInterpolationGroup->addAction( pDefaultInterpolationAction );
+	m_pInterpolationPopup->addSeparator();
+	for ( const auto& mode : { Interpolation::InterpolateMode::Linear,
+							   Interpolation::InterpolateMode::Cosine,
+							   Interpolation::InterpolateMode::Third,
+							   Interpolation::InterpolateMode::Cubic,
+							   Interpolation::InterpolateMode::Hermite,
+							   Interpolation::InterpolateMode::Sinc } ) {
+		auto pAction = m_pInterpolationPopup->addAction(
+			Interpolation::ModeToQString( mode ) );
+		pAction->setCheckable( true );
+		pAction->setData( static_cast<int>(mode) );
+		m_pInterpolationGroup->addAction( pAction );
+	}
+	connect( m_pInterpolationGroup, &QActionGroup::triggered,
+			 this, &InstrumentLine::setInterpolateMode );
+	m_pFunctionPopup->addMenu( m_pInterpolationPopup );
+
+	/*: Response of the resonant filter of the instrument. Only has an
+	 *  effect in case the filter is activated in the Instrument Editor. */
+	m_pFilterModePopup = new QMenu( tr( "Filter mode ..." ), m_pFunctionPopup );
+	m_pFilterModeGroup = new QActionGroup( m_pFilterModePopup );
+	m_pFilterModeGroup->setExclusive( true );
+	for ( const auto& [ mode, sLabel ] :
+			  { std::make_pair( ResonantFilter::Mode::LowPass, tr( "Low-pass" ) ),
+				std::make_pair( ResonantFilter::Mode::HighPass, tr( "High-pass" ) ),
+				std::make_pair( ResonantFilter::Mode::BandPass, tr( "Band-pass" ) ) } ) {
+		auto pAction = m_pFilterModePopup->addAction( sLabel );
+		pAction->setCheckable( true );
+		pAction->setData( static_cast<int>(mode) );
+		m_pFilterModeGroup->addAction( pAction );
+	}
+	connect( m_pFilterModeGroup, &QActionGroup::triggered,
+			 this, &InstrumentLine::setFilterMode );
+	m_pFunctionPopup->addMenu( m_pFilterModePopup );
+
+	m_pVoicesPopup = new QMenu( tr( "Polyphony ..." ), m_pFunctionPopup );
+	m_pMaxVoicesGroup = new QActionGroup( m_pVoicesPopup );
+	m_pMaxVoicesGroup->setExclusive( true );
+	for ( const int nMaxVoices : { 0, 1, 2, 4, 8, 16, 32 } ) {
+		auto pAction = m_pVoicesPopup->addAction(
+			/*: No limit for the number of notes of an instrument played
+			 *  at the same time. */
+			nMaxVoices == 0 ? tr( "Unlimited" ) :
+			tr( "%1 voice(s)" ).arg( nMaxVoices ) );
+		pAction->setCheckable( true );
+		pAction->setData( nMaxVoices );
+		m_pMaxVoicesGroup->addAction( pAction );
+	}
+	connect( m_pMaxVoicesGroup, &QActionGroup::triggered,
+			 this, &InstrumentLine::setMaxVoices );
+	/*: Which voice to stop once the polyphony limit of an instrument
+	 *  is reached. */
+	m_pVoicesPopup->addSection( tr( "Voice stealing" ) );
+	m_pVoiceStealingGroup = new QActionGroup( m_pVoicesPopup );
+	m_pVoiceStealingGroup->setExclusive( true );
+	for ( const auto& [ voiceStealing, sLabel ] :
+			  { std::make_pair( Instrument::VoiceStealing::Oldest,
+								tr( "Oldest" ) ),
+				std::make_pair( Instrument::VoiceStealing::Quietest,
+								tr( "Quietest" ) ),
+				std::make_pair( Instrument::VoiceStealing::LowestVelocity,
+								tr( "Lowest velocity" ) ) } ) {
+		auto pAction = m_pVoicesPopup->addAction( sLabel );
+		pAction->setCheckable( true );
+		pAction->setData( static_cast<int>(voiceStealing) );
+		m_pVoiceStealingGroup->addAction( pAction );
+	}
+	connect( m_pVoiceStealingGroup, &QActionGroup::triggered,
+			 this, &InstrumentLine::setVoiceStealing );
+	m_pFunctionPopup->addMenu( m_pVoicesPopup );
+
+	/*: Starting a note of an instrument quickly fades out all notes of
+	 *  other instruments in the same choke group, e.g. a closed hi-hat
+	 *  silencing an open one. */
+	m_pChokeGroupPopup = new QMenu( tr( "Choke group ..." ), m_pFunctionPopup );
+	m_pChokeGroupGroup = new QActionGroup( m_pChokeGroupPopup );
+	m_pChokeGroupGroup->setExclusive( true );
+	for ( int nGroup = -1; nGroup < 8; ++nGroup ) {
+		auto pAction = m_pChokeGroupPopup->addAction(
+			nGroup == -1 ? tr( "None" ) : tr( "Group %1" ).arg( nGroup + 1 ) );
+		pAction->setCheckable( true );
+		pAction->setData( nGroup );
+		m_pChokeGroupGroup->addAction( pAction );
+		if ( nGroup == -1 ) {
+			m_pChokeGroupPopup->addSeparator();
+		}
+	}
+	connect( m_pChokeGroupGroup, &QActionGroup::triggered,
+			 this, &InstrumentLine::setChokeGroup );
+	m_pFunctionPopup->addMenu( m_pChokeGroupPopup );
+
 	auto deleteAction =
 		m_pFunctionPopup->addAction( pCommonStrings->getActionDeleteInstrument() );
 	connect( deleteAction, &QAction::triggered, this, [=](){
@@ -406,6 +507,9 @@ void InstrumentLine::mousePressEvent(QMouseEvent *ev)
 		
 	}
 	else if (ev->button() == Qt::RightButton ) {
+		updateInterpolationPopup();
+		updateFilterModePopup();
+		updateVoicesPopup();
 		m_pFunctionPopup->popup( QPoint( ev->globalX(), ev->globalY() ) );
 	}
 
@@ -695,6 +799,164 @@ void InstrumentLine::functionRenameInstrument()
 	}
 }
 
+void InstrumentLine::updateInterpolationPopup() {
+	auto pSong = Hydrogen::get_instance()->getSong();
+	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
+		return;
+	}
+	auto pInstrument = pSong->getDrumkit()->getInstruments()->get( m_nInstrumentNumber );
+	if ( pInstrument == nullptr ) {
+		return;
+	}
+
+	for ( auto& pAction : m_pInterpolationGroup->actions() ) {
+		if ( ! pAction->data().isValid() ) {
+			pAction->setChecked( ! pInstrument->hasCustomInterpolateMode() );
+		}
+		else {
+			pAction->setChecked(
+				pInstrument->hasCustomInterpolateMode() &&
+				static_cast<int>(pInstrument->getInterpolateMode()) ==
+				pAction->data().toInt() );
+		}
+	}
+}
+
+void InstrumentLine::setInterpolateMode( QAction* pAction ) {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pSong = pHydrogen->getSong();
+	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
+		ERRORLOG( "No song set yet" );
+		return;
+	}
+	auto pInstrument = pSong->getDrumkit()->getInstruments()->get( m_nInstrumentNumber );
+	if ( pInstrument == nullptr || pAction == nullptr ) {
+		ERRORLOG( "No instrument selected" );
+		return;
+	}
+
+	if ( ! pAction->data().isValid() ) {
+		pInstrument->resetInterpolateMode();
+	}
+	else {
+		pInstrument->setInterpolateMode(
+			static_cast<Interpolation::InterpolateMode>( pAction->data().toInt() ) );
+	}
+	pHydrogen->setIsModified( true );
+}
+
+void InstrumentLine::updateFilterModePopup() {
+	auto pSong = Hydrogen::get_instance()->getSong();
+	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
+		return;
+	}
+	auto pInstrument = pSong->getDrumkit()->getInstruments()->get( m_nInstrumentNumber );
+	if ( pInstrument == nullptr ) {
+		return;
+	}
+
+	for ( auto& pAction : m_pFilterModeGroup->actions() ) {
+		pAction->setChecked( static_cast<int>(pInstrument->getFilterMode()) ==
+							 pAction->data().toInt() );
+	}
+}
+
+void InstrumentLine::setFilterMode( QAction* pAction ) {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pSong = pHydrogen->getSong();
+	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
+		ERRORLOG( "No song set yet" );
+		return;
+	}
+	auto pInstrument = pSong->getDrumkit()->getInstruments()->get( m_nInstrumentNumber );
+	if ( pInstrument == nullptr || pAction == nullptr ) {
+		ERRORLOG( "No instrument selected" );
+		return;
+	}
+
+	pInstrument->setFilterMode(
+		static_cast<ResonantFilter::Mode>( pAction->data().toInt() ) );
+	pHydrogen->setIsModified( true );
+}
+
+void InstrumentLine::updateVoicesPopup() {
+	auto pSong = Hydrogen::get_instance()->getSong();
+	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
+		return;
+	}
+	auto pInstrument = pSong->getDrumkit()->getInstruments()->get( m_nInstrumentNumber );
+	if ( pInstrument == nullptr ) {
+		return;
+	}
+
+	for ( auto& pAction : m_pMaxVoicesGroup->actions() ) {
+		pAction->setChecked( pAction->data().toInt() ==
+							 pInstrument->getMaxVoices() );
+	}
+	for ( auto& pAction : m_pVoiceStealingGroup->actions() ) {
+		pAction->setChecked( pAction->data().toInt() ==
+							 static_cast<int>(pInstrument->getVoiceStealing()) );
+		// The policy only matters in case there is a limit.
+		pAction->setEnabled( pInstrument->getMaxVoices() > 0 );
+	}
+	for ( auto& pAction : m_pChokeGroupGroup->actions() ) {
+		pAction->setChecked( pAction->data().toInt() ==
+							 pInstrument->getChokeGroup() );
+	}
+}
+
+void InstrumentLine::setMaxVoices( QAction* pAction ) {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pSong = pHydrogen->getSong();
+	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
+		ERRORLOG( "No song set yet" );
+		return;
+	}
+	auto pInstrument = pSong->getDrumkit()->getInstruments()->get( m_nInstrumentNumber );
+	if ( pInstrument == nullptr || pAction == nullptr ) {
+		ERRORLOG( "No instrument selected" );
+		return;
+	}
+
+	pInstrument->setMaxVoices( pAction->data().toInt() );
+	pHydrogen->setIsModified( true );
+}
+
+void InstrumentLine::setVoiceStealing( QAction* pAction ) {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pSong = pHydrogen->getSong();
+	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
+		ERRORLOG( "No song set yet" );
+		return;
+	}
+	auto pInstrument = pSong->getDrumkit()->getInstruments()->get( m_nInstrumentNumber );
+	if ( pInstrument == nullptr || pAction == nullptr ) {
+		ERRORLOG( "No instrument selected" );
+		return;
+	}
+
+	pInstrument->setVoiceStealing(
+		static_cast<Instrument::VoiceStealing>( pAction->data().toInt() ) );
+	pHydrogen->setIsModified( true );
+}
+
+void InstrumentLine::setChokeGroup( QAction* pAction ) {
+	auto pHydrogen = Hydrogen::get_instance();
+	auto pSong = pHydrogen->getSong();
+	if ( pSong == nullptr || pSong->getDrumkit() == nullptr ) {
+		ERRORLOG( "No song set yet" );
+		return;
+	}
+	auto pInstrument = pSong->getDrumkit()->getInstruments()->get( m_nInstrumentNumber );
+	if ( pInstrument == nullptr || pAction == nullptr ) {
+		ERRORLOG( "No instrument selected" );
+		return;
+	}
+
+	pInstrument->setChokeGroup( pAction->data().toInt() );
+	pHydrogen->setIsModified( true );
+}
+
 void InstrumentLine::onPreferencesChanged( const H2Core::Preferences::Changes& changes ) {
 	const auto pPref = H2Core::Preferences::get_instance();
 
@@ -94,6 +94,20 @@ public slots:
 	private:
 		QMenu *m_pFunctionPopup;
 		QMenu *m_pFunctionPopupSub;
+		/** Selects the interpolation mode of the instrument. The first
+		 * action resets it to the default one of the Sampler. */
+		QMenu *m_pInterpolationPopup;
+		QActionGroup *m_pInterpolationGroup;
+		/** Selects the response of the resonant filter. */
+		QMenu *m_pFilterModePopup;
+		QActionGroup *m_pFilterModeGroup;
+		/** Polyphony limit and voice stealing policy of the
+		 * instrument. */
+		QMenu *m_pVoicesPopup;
+		QActionGroup *m_pMaxVoicesGroup;
+		QActionGroup *m_pVoiceStealingGroup;
+		QMenu *m_pChokeGroupPopup;
+		QActionGroup *m_pChokeGroupGroup;
 		QLabel *m_pNameLbl;
 		bool m_bIsSelected;
 		int m_nInstrumentNumber;	///< The related instrument number
@@ -115,6 +129,20 @@ public slots:
 		void setMuted(bool isMuted);
 		void setSoloed( bool soloed );
 		void setSamplesMissing( bool bSamplesMissing );
+		/** Checks the action corresponding to the interpolation mode of
+		 * the instrument in #m_pInterpolationPopup. */
+		void updateInterpolationPopup();
+		void setInterpolateMode( QAction* pAction );
+		/** Checks the action corresponding to the filter mode of the
+		 * instrument in #m_pFilterModePopup. */
+		void updateFilterModePopup();
+		void setFilterMode( QAction* pAction );
+		/** Checks the actions corresponding to the polyphony limit,
+		 * voice stealing policy, and choke group of the instrument. */
+		void updateVoicesPopup();
+		void setMaxVoices( QAction* pAction );
+		void setVoiceStealing( QAction* pAction );
+		void setChokeGroup( QAction* pAction );
 
 	/** Whether the cursor entered the boundary of the widget.*/
 	bool m_bEntered;
@@ -820,10 +820,9 @@ void PlayerControl::rubberbandButtonToggle()
 				// Recalculate all samples ones just to be safe since the
 				// recalculation is just triggered if there is a tempo change
 				// in the audio engine.
-				pHydrogen->getAudioEngine()->lock( RIGHT_HERE );
-				pDrumkit->recalculateRubberband(
-					pHydrogen->getAudioEngine()->getTransportPosition()->getBpm() );
-				pHydrogen->getAudioEngine()->unlock();
+				auto pAudioEngine = pHydrogen->getAudioEngine();
+				pAudioEngine->getTimeStretcher()->request(
+					pAudioEngine->getTransportPosition()->getBpm() );
 			}
 		}
 		pPref->setRubberBandBatchMode(true);
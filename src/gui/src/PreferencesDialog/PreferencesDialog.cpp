@@ -336,6 +336,17 @@ PreferencesDialog::PreferencesDialog(QWidget* parent)
 	resampleComboBox->setSize( audioTabWidgetSizeBottom );
 	resampleComboBox->setCurrentIndex( static_cast<int>(pHydrogen->getAudioEngine()->getSampler()->getInterpolateMode() ) );
 
+	lockRealtimeMemoryCheckBox->setChecked( pPref->m_bLockRealtimeMemory );
+	resampleSamplesOnLoadCheckBox->setChecked( pPref->m_bResampleSamplesOnLoad );
+
+	// Audio tab - silence detection
+	silenceThresholdSpinBox->setSize( audioTabWidgetSizeBottom );
+	silenceThresholdSpinBox->setValue( pPref->m_fSilenceThreshold );
+	silenceThresholdSpinBox->setEnabled( pPref->m_bEndSilentVoices );
+	endSilentVoicesCheckBox->setChecked( pPref->m_bEndSilentVoices );
+	connect( endSilentVoicesCheckBox, &QCheckBox::toggled,
+			 silenceThresholdSpinBox, &LCDSpinBox::setEnabled );
+
 	updateDriverInfo();
 
 	//////////////////////////////////////////////////////////////////
@@ -757,6 +768,18 @@ void PreferencesDialog::updateDriverPreferences() {
 		bAudioOptionAltered = true;
 	}
 
+	if ( pPref->m_bLockRealtimeMemory != lockRealtimeMemoryCheckBox->isChecked() ) {
+		pPref->m_bLockRealtimeMemory = lockRealtimeMemoryCheckBox->isChecked();
+		bAudioOptionAltered = true;
+	}
+
+	if ( pPref->m_bResampleSamplesOnLoad !=
+		 resampleSamplesOnLoadCheckBox->isChecked() ) {
+		pPref->m_bResampleSamplesOnLoad =
+			resampleSamplesOnLoadCheckBox->isChecked();
+		bAudioOptionAltered = true;
+	}
+
 	switch ( trackOutputComboBox->currentIndex() ) {
 	case 0:
 		if ( pPref->m_JackTrackOutputMode !=
@@ -865,6 +888,16 @@ void PreferencesDialog::on_okBtn_clicked()
 		bAudioOptionAltered = true;
 	}
 
+	// Silence detection
+	if ( pPref->m_bEndSilentVoices != endSilentVoicesCheckBox->isChecked() ) {
+		pPref->m_bEndSilentVoices = endSilentVoicesCheckBox->isChecked();
+		bAudioOptionAltered = true;
+	}
+	if ( pPref->m_fSilenceThreshold != silenceThresholdSpinBox->value() ) {
+		pPref->m_fSilenceThreshold = silenceThresholdSpinBox->value();
+		bAudioOptionAltered = true;
+	}
+
 	// Interpolation
 	if ( static_cast<int>( pHydrogen->getAudioEngine()->getSampler()->getInterpolateMode() ) !=
 		 resampleComboBox->currentIndex() ) {
@@ -884,6 +917,9 @@ void PreferencesDialog::on_okBtn_clicked()
 		case 4:
 			Hydrogen::get_instance()->getAudioEngine()->getSampler()->setInterpolateMode( Interpolation::InterpolateMode::Hermite );
 			break;
+		case 5:
+			Hydrogen::get_instance()->getAudioEngine()->getSampler()->setInterpolateMode( Interpolation::InterpolateMode::Sinc );
+			break;
 		}
 		bAudioOptionAltered = true;
 	}
@@ -1264,6 +1300,11 @@ void PreferencesDialog::updateDriverInfoLabel() {
 			sInfo.append( "<br>" ).append( tr( "Currently connected to device: " ) )
 				.append( "<b>" ).append( pAlsaDriver->m_sAlsaAudioDevice )
 				.append( "</b>" );
+			if ( ! pAlsaDriver->getSampleFormat().isEmpty() ) {
+				sInfo.append( "<br>" ).append( tr( "Sample format: " ) )
+					.append( "<b>" ).append( pAlsaDriver->getSampleFormat() )
+					.append( "</b>" );
+			}
 		} else {
 			ERRORLOG( "ALSA driver selected in PreferencesDialog but no ALSA driver running?" );
 		}
@@ -31,8 +31,7 @@ using namespace H2Core;
 DetailWaveDisplay::DetailWaveDisplay(QWidget* pParent )
  : QWidget( pParent )
  , m_sSampleName( "" )
- , m_pPeakDatal( nullptr )
- , m_pPeakDatar( nullptr )  
+ , m_pSample( nullptr )
 {
 //	setAttribute(Qt::WA_OpaquePaintEvent);
 
@@ -58,8 +57,6 @@ DetailWaveDisplay::DetailWaveDisplay(QWidget* pParent )
 DetailWaveDisplay::~DetailWaveDisplay()
 {
 	//INFOLOG( "DESTROY" );
-	delete[] m_pPeakDatal;
-	delete[] m_pPeakDatar;
 }
 
 
@@ -85,11 +82,23 @@ void DetailWaveDisplay::paintEvent(QPaintEvent *ev)
 //	int imagedetailframes = m_pnormalimagedetailframes / m_pzoomFactor;
 	int startpos = m_pDetailSamplePosition  - m_pNormalImageDetailFrames / 2 ;
 
+	// One frame per pixel. Each line connects a frame with its
+	// predecessor.
+	const int nPixels = width() + 1;
+	std::vector<PeakPyramid::Peak> peaksl( nPixels, { 0, 0, 0 } );
+	std::vector<PeakPyramid::Peak> peaksr( nPixels, { 0, 0, 0 } );
+	if ( m_pSample != nullptr ) {
+		m_pSample->getPeaks( PeakPyramid::Channel::Left, startpos - 1, 1,
+							 nPixels, peaksl.data() );
+		m_pSample->getPeaks( PeakPyramid::Channel::Right, startpos - 1, 1,
+							 nPixels, peaksr.data() );
+	}
+
+	const float fGain = height() / 4.0 * m_pZoomFactor;
 	for ( int x = 0; x < width() ; x++ ) {
 		if ( (startpos) > 0 ){
-			painter.drawLine( x, (-m_pPeakDatal[startpos -1] *m_pZoomFactor) +VCenterl, x, (-m_pPeakDatal[startpos ] *m_pZoomFactor)+VCenterl );
-			painter.drawLine( x, (-m_pPeakDatar[startpos -1] *m_pZoomFactor) +VCenterr, x, (-m_pPeakDatar[startpos ] *m_pZoomFactor)+VCenterr );
-			//ERRORLOG( QString("startpos: %1").arg(startpos) )
+			painter.drawLine( x, (-peaksl[ x ].fMax * fGain) +VCenterl, x, (-peaksl[ x + 1 ].fMax * fGain)+VCenterl );
+			painter.drawLine( x, (-peaksr[ x ].fMax * fGain) +VCenterr, x, (-peaksr[ x + 1 ].fMax * fGain)+VCenterr );
 		}
 		else
 		{
@@ -124,31 +133,11 @@ void DetailWaveDisplay::paintEvent(QPaintEvent *ev)
 void DetailWaveDisplay::updateDisplay( const QString& filename )
 {
 
-	auto pNewSample = Sample::load( filename );
+	// Same native frames the SampleEditor is working with.
+	auto pNewSample = Sample::load( filename, License(), false );
 
 	if ( pNewSample != nullptr ) {
-
-		int mSampleLength = pNewSample->get_frames();
-
-		m_pPeakDatal = new int[ mSampleLength + m_pNormalImageDetailFrames /2 ];
-		m_pPeakDatar = new int[ mSampleLength + m_pNormalImageDetailFrames /2 ];
-
-		for ( int i = 0 ; i < mSampleLength + m_pNormalImageDetailFrames /2 ; i++){
-			m_pPeakDatal[ i ] = 0;
-			m_pPeakDatar[ i ] = 0;
-		}
-
-		float fGain = height() / 4.0 * 1.0;
-
-		auto pSampleDatal = pNewSample->get_data_l();
-		auto pSampleDatar = pNewSample->get_data_r();
-
-		for ( int i = 0; i < mSampleLength; i++ ){
-			m_pPeakDatal[ i ] = static_cast<int>( pSampleDatal[ i ] * fGain );
-			m_pPeakDatar[ i ] = static_cast<int>( pSampleDatar[ i ] * fGain );
-		}
-
-
+		m_pSample = pNewSample;
 	}
 }
 
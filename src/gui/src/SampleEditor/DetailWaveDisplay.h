@@ -26,6 +26,8 @@
 #include <QtGui>
 #include <QtWidgets>
 
+#include <memory>
+
 #include <core/Object.h>
 
 namespace H2Core
@@ -52,8 +54,8 @@ class DetailWaveDisplay :  public QWidget,  public H2Core::Object<DetailWaveDisp
 	private:
 		QPixmap m_background;
 		QString m_sSampleName;
-		int *m_pPeakDatal;
-		int *m_pPeakDatar;
+		/** Frames of the visible part are read on each repaint. */
+		std::shared_ptr<H2Core::Sample> m_pSample;
 		int m_pDetailSamplePosition;
 		int m_pNormalImageDetailFrames;
 		float m_pZoomFactor;
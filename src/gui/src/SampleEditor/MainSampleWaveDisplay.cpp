@@ -45,15 +45,14 @@ MainSampleWaveDisplay::MainSampleWaveDisplay(QWidget* pParent)
 		ERRORLOG( "Error loading pixmap" );
 	}
 
-	m_pPeakDatal = new int[ w ];
-	m_pPeakDatar = new int[ w ];
+	m_peaksl.assign( w - 50, { 0, 0, 0 } );
+	m_peaksr.assign( w - 50, { 0, 0, 0 } );
 
 	m_nStartFramePosition = 25;
 	m_nLoopFramePosition = 25;
 	m_nEndFramePosition = width() -25;
 	m_nLocator = -1;
 	m_bUpdatePosition = false;
-	m_nSampleLength = 0;
 
 	m_bStartSliderIsMoved = false;
 	m_bLoopSliderIsMoved = false;
@@ -69,9 +68,6 @@ MainSampleWaveDisplay::MainSampleWaveDisplay(QWidget* pParent)
 MainSampleWaveDisplay::~MainSampleWaveDisplay()
 {
 	//INFOLOG( "DESTROY" );
-
-	delete[] m_pPeakDatal;
-	delete[] m_pPeakDatar;
 }
 
 void MainSampleWaveDisplay::paintLocatorEvent( int pos, bool updateposi)
@@ -104,25 +100,17 @@ void MainSampleWaveDisplay::paintEvent(QPaintEvent *ev)
 	QPainter painter( this );
 	painter.setRenderHint( QPainter::Antialiasing );
 
-	bool issmaller = false;
-
 	painter.drawPixmap( ev->rect(), m_background, ev->rect() );
 	painter.setPen( QColor( 230, 230, 230 ) );
 	int VCenterl = height() / 4;
 	int VCenterr = height() / 4 + height() / 2;
 
-	if ( width() >= m_nSampleLength  ) issmaller = true;
-
-	for ( int x = 25; x < width() -25; x++ ) {
-		if ( !issmaller || x <= m_nSampleLength){
-			painter.drawLine( x, -m_pPeakDatal[x -25] +VCenterl, x, -m_pPeakDatal[x -24] +VCenterl  );
-			painter.drawLine( x, -m_pPeakDatar[x -25] +VCenterr, x, -m_pPeakDatar[x -24] +VCenterr  );	
-		}else
-		{
-			painter.drawLine( x, 0 +VCenterl, x, 0 +VCenterl  );
-			painter.drawLine( x, 0 +VCenterr, x, 0 +VCenterr  );
-		}
-	
+	const int nPixels = std::min( width() - 50, static_cast<int>(m_peaksl.size()) );
+	for ( int x = 25; x < 25 + nPixels; x++ ) {
+		const auto& peakl = m_peaksl[ x - 25 ];
+		const auto& peakr = m_peaksr[ x - 25 ];
+		painter.drawLine( x, -peakl.fMax +VCenterl, x, -peakl.fMin +VCenterl  );
+		painter.drawLine( x, -peakr.fMax +VCenterr, x, -peakr.fMin +VCenterr  );
 	}
 
 
@@ -171,45 +159,27 @@ void MainSampleWaveDisplay::updateDisplayPointer()
 void MainSampleWaveDisplay::updateDisplay( const QString& filename )
 {
 
-	auto pNewSample = Sample::load( filename );
+	// Same native frames the SampleEditor is working with.
+	auto pNewSample = Sample::load( filename, License(), false );
 	
 	if ( pNewSample ) {
-
-		int nSampleLength = pNewSample->get_frames();
-		m_nSampleLength = nSampleLength;
-		float nScaleFactor = nSampleLength / (width() -50);
-		if ( nScaleFactor < 1 ){
-			nScaleFactor = 1;
-		}
-
-		float fGain = height() / 4.0 * 1.0;
-
-		auto pSampleDatal = pNewSample->get_data_l();
-		auto pSampleDatar = pNewSample->get_data_r();
-
-		unsigned nSamplePos = 0;
-		int nVall = 0;
-		int nValr = 0;
-		int newVall = 0;
-		int newValr = 0;
-		for ( int i = 0; i < width(); ++i ){
-			for ( int j = 0; j < nScaleFactor; ++j ) {
-				if ( j < nSampleLength && nSamplePos < nSampleLength) {
-					if ( pSampleDatal[ nSamplePos ] && pSampleDatar[ nSamplePos ] ){
-						newVall = static_cast<int>( pSampleDatal[ nSamplePos ] * fGain );
-						newValr = static_cast<int>( pSampleDatar[ nSamplePos ] * fGain );
-						nVall = newVall;
-						nValr = newValr;
-					}else
-					{
-						nVall = 0;	
-						nValr = 0;
-					}
-				}
-				++nSamplePos;
+		// Same scaling as SampleEditor::m_divider to keep the waveform
+		// aligned with the sliders.
+		const int nPixels = std::max( width() - 50, 0 );
+		const double fFramesPerPixel =
+			static_cast<double>(pNewSample->get_frames()) / std::max( nPixels, 1 );
+		m_peaksl.resize( nPixels );
+		m_peaksr.resize( nPixels );
+		pNewSample->getPeaks( PeakPyramid::Channel::Left, 0, fFramesPerPixel,
+							  nPixels, m_peaksl.data() );
+		pNewSample->getPeaks( PeakPyramid::Channel::Right, 0, fFramesPerPixel,
+							  nPixels, m_peaksr.data() );
+
+		const float fGain = height() / 4.0 * 1.0;
+		for ( auto* pPeaks : { &m_peaksl, &m_peaksr } ) {
+			for ( auto& peak : *pPeaks ) {
+				peak = { peak.fMin * fGain, peak.fMax * fGain, peak.fRms * fGain };
 			}
-			m_pPeakDatal[ i ] = nVall;
-			m_pPeakDatar[ i ] = nValr;
 		}
 	}
 	update();
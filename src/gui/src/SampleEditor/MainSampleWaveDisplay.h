@@ -25,7 +25,9 @@
 
 #include <QtGui>
 #include <QtWidgets>
+#include <vector>
 
+#include <core/Basics/PeakPyramid.h>
 #include <core/Object.h>
 #include "SampleEditor.h"
 class SampleEditor;
@@ -76,10 +78,11 @@ class MainSampleWaveDisplay :  public QWidget,  public H2Core::Object<MainSample
 		void mouseUpdateDone();
 		
 		QPixmap m_background;
-		int*	m_pPeakDatal;
-		int*	m_pPeakDatar;
+		/** One entry per pixel of the area between the margins already
+		 * scaled to the height of the widget. */
+		std::vector<H2Core::PeakPyramid::Peak> m_peaksl;
+		std::vector<H2Core::PeakPyramid::Peak> m_peaksr;
 		
-		int		m_nSampleLength;
 		int		m_nLocator;
 		bool	m_bUpdatePosition;
 
@@ -96,8 +96,10 @@ SampleEditor::SampleEditor ( QWidget* pParent, int nSelectedComponent,
 	setWindowTitle ( QString( tr( "SampleEditor " ) + newfilename) );
 	setModal ( true );
 
-	//this new sample give us the not changed real samplelength
-	m_pSampleFromFile = Sample::load( sSampleFilename );
+	//this new sample give us the not changed real samplelength. Loops
+	//and envelopes refer to frames at the native rate of the file.
+	//Therefore, it must not be converted to the rate of the driver.
+	m_pSampleFromFile = Sample::load( sSampleFilename, License(), false );
 	if ( m_pSampleFromFile == nullptr ) {
 		reject();
 	}
@@ -234,7 +236,7 @@ void SampleEditor::getAllFrameInfos()
 	// this values are needed if we restore a sample from disk if a
 	// new song with sample changes will load
 	m_bSampleIsModified = pSample->get_is_modified();
-	m_nSamplerate = pSample->get_sample_rate();
+	m_nSamplerate = m_pSampleFromFile->get_sample_rate();
 	__loops = pSample->get_loops();
 	__rubberband = pSample->get_rubberband();
 
@@ -463,7 +465,7 @@ void SampleEditor::createNewLayer()
 			pLayer = pInstrument->get_component( m_nSelectedComponent )->getLayer( m_nSelectedLayer );
 
 			// insert new sample from newInstrument
-			pLayer->set_sample( pEditSample );
+			pLayer->set_sample( pEditSample, pAudioEngine->getReclaimer() );
 		}
 
 		pAudioEngine->unlock();
@@ -642,11 +644,14 @@ void SampleEditor::on_PlayPushButton_clicked()
 	}
 
 
-	m_nRealtimeFrameEnd = pAudioEngine->getRealtimeFrame() + m_nSlframes;
+	const double fFramesPerRealtimeFrame = getFramesPerRealtimeFrame();
+	m_nRealtimeFrameEnd = pAudioEngine->getRealtimeFrame() +
+		m_nSlframes / fFramesPerRealtimeFrame;
 
 	//calculate the new rubberband sample length
 	if( __rubberband.use ){
-		m_nRealtimeFrameEndForTarget = pAudioEngine->getRealtimeFrame() + (m_nSlframes * m_fRatio + 0.1);
+		m_nRealtimeFrameEndForTarget = pAudioEngine->getRealtimeFrame() +
+			(m_nSlframes * m_fRatio + 0.1) / fFramesPerRealtimeFrame;
 	}else
 	{
 		m_nRealtimeFrameEndForTarget = m_nRealtimeFrameEnd;
@@ -684,7 +689,8 @@ void SampleEditor::on_PlayOrigPushButton_clicked()
 	// have to construct a temporary instrument. Otherwise pInstrument would be
 	// deleted if consumed by preview_instrument.
 	auto pTmpInstrument = std::make_shared<Instrument>( pInstrument );
-	auto pNewSample = Sample::load( pInstrument->get_component( m_nSelectedComponent )->getLayer( nSelectedlayer )->get_sample()->get_filepath() );
+	auto pNewSample = Sample::load( pInstrument->get_component( m_nSelectedComponent )->getLayer( nSelectedlayer )->get_sample()->get_filepath(),
+								   License(), false );
 
 	if ( pNewSample != nullptr ){
 		int length = ( ( pNewSample->get_frames() / pNewSample->get_sample_rate() + 1) * 100 );
@@ -696,7 +702,8 @@ void SampleEditor::on_PlayOrigPushButton_clicked()
 	m_pMainSampleWaveDisplay->paintLocatorEvent( StartFrameSpinBox->value() / m_divider + 24 , true);
 	m_pSampleAdjustView->setDetailSamplePosition( __loops.start_frame, m_fZoomfactor , nullptr);
 	m_pTimer->start(40);	// update ruler at 25 fps
-	m_nRealtimeFrameEnd = Hydrogen::get_instance()->getAudioEngine()->getRealtimeFrame() + m_nSlframes;
+	m_nRealtimeFrameEnd = Hydrogen::get_instance()->getAudioEngine()->getRealtimeFrame() +
+		m_nSlframes / getFramesPerRealtimeFrame();
 	PlayOrigPushButton->setText( QString( "Stop") );
 }
 
@@ -704,7 +711,9 @@ void SampleEditor::updateMainsamplePositionRuler()
 {
 	unsigned long realpos = Hydrogen::get_instance()->getAudioEngine()->getRealtimeFrame();
 	if ( realpos < m_nRealtimeFrameEnd ){
-		unsigned frame = m_nSlframes - ( m_nRealtimeFrameEnd  - realpos );
+		unsigned frame = m_nSlframes - std::min<unsigned>(
+			( m_nRealtimeFrameEnd  - realpos ) * getFramesPerRealtimeFrame(),
+			m_nSlframes );
 		if ( m_bPlayButton == true ){
 			m_pMainSampleWaveDisplay->paintLocatorEvent( m_pPositionsRulerPath[frame] / m_divider + 25 , true);
 			m_pSampleAdjustView->setDetailSamplePosition( m_pPositionsRulerPath[frame], m_fZoomfactor , nullptr);
@@ -734,7 +743,9 @@ void SampleEditor::updateTargetsamplePositionRuler()
 	}
 	
 	if ( realpos < m_nRealtimeFrameEndForTarget ){
-		unsigned pos = targetSampleLength - ( m_nRealtimeFrameEndForTarget - realpos );
+		unsigned pos = targetSampleLength - std::min<unsigned>(
+			( m_nRealtimeFrameEndForTarget - realpos ) * getFramesPerRealtimeFrame(),
+			targetSampleLength );
 		m_pTargetSampleView->paintLocatorEventTargetDisplay( (m_pTargetSampleView->width() * pos /targetSampleLength), true);
 //		ERRORLOG( QString("sampleval: %1").arg(frame) );
 	} else {
@@ -749,6 +760,16 @@ void SampleEditor::updateTargetsamplePositionRuler()
 
 
 
+double SampleEditor::getFramesPerRealtimeFrame() const
+{
+	auto pAudioDriver = Hydrogen::get_instance()->getAudioEngine()->getAudioDriver();
+	if ( pAudioDriver == nullptr || pAudioDriver->getSampleRate() == 0 ||
+		 m_nSamplerate == 0 ) {
+		return 1;
+	}
+	return static_cast<double>(m_nSamplerate) / pAudioDriver->getSampleRate();
+}
+
 void SampleEditor::createPositionsRulerPath()
 {
 	setSamplelengthFrames();
@@ -93,6 +93,9 @@ class SampleEditor :  public QDialog, public Ui_SampleEditor_UI,  public H2Core:
 		void createNewLayer();
 		void setSamplelengthFrames();
 		void createPositionsRulerPath();
+		/** Frames of the edited sample at its native rate passing
+		 * within a single frame of the audio driver. */
+		double getFramesPerRealtimeFrame() const;
 		void testpTimer();
 		void checkRatioSettings();
 
@@ -123,6 +126,7 @@ class SampleEditor :  public QDialog, public Ui_SampleEditor_UI,  public H2Core:
 		unsigned long m_nRealtimeFrameEnd;
 		unsigned long m_nRealtimeFrameEndForTarget;
 		unsigned m_nSlframes;
+		/** Native rate of the edited sample. */
 		unsigned m_nSamplerate;
 		QTimer *m_pTimer;
 		QTimer *m_pTargetDisplayTimer;
@@ -59,8 +59,8 @@ TargetWaveDisplay::TargetWaveDisplay(QWidget* pParent)
 	}
 
 	m_EditMode = EnvelopeEditMode::VELOCITY;
-	m_pPeakData_Left = new int[ w ];
-	m_pPeakData_Right = new int[ w ];
+	m_peaks_Left.assign( w, { 0, 0, 0 } );
+	m_peaks_Right.assign( w, { 0, 0, 0 } );
 	m_sInfo = "";
 	m_nX = -10;
 	m_nY = -10;
@@ -77,9 +77,6 @@ TargetWaveDisplay::TargetWaveDisplay(QWidget* pParent)
 TargetWaveDisplay::~TargetWaveDisplay()
 {
 	//INFOLOG( "DESTROY" );
-
-	delete[] m_pPeakData_Left;
-	delete[] m_pPeakData_Right;
 }
 
 static void paintEnvelope(Sample::VelocityEnvelope &envelope, QPainter &painter,
@@ -130,13 +127,20 @@ void TargetWaveDisplay::paintEvent(QPaintEvent *ev)
 	int LCenter = VCenter -4;
 	int RCenter = VCenter +4;
 
-	for ( int x = 0; x < width() - 1; x++ ) {
-		painter.drawLine( x, LCenter, x, -m_pPeakData_Left[x +1] +LCenter  );
+	// The left channel is drawn above and the right one below the
+	// center line.
+	const int nPixels = std::min( width(), static_cast<int>(m_peaks_Left.size()) );
+	for ( int x = 0; x < nPixels - 1; x++ ) {
+		const auto& peak = m_peaks_Left[ x + 1 ];
+		painter.drawLine( x, LCenter, x,
+						  -std::max( peak.fMax, -peak.fMin ) +LCenter  );
 	}
 
 	painter.setPen( QColor( 116, 186, 255 ));
-	for ( int x = 0; x < width() - 1; x++ ) {
-		painter.drawLine( x, RCenter, x, -m_pPeakData_Right[x +1] +RCenter  );
+	for ( int x = 0; x < nPixels - 1; x++ ) {
+		const auto& peak = m_peaks_Right[ x + 1 ];
+		painter.drawLine( x, RCenter, x,
+						  std::max( peak.fMax, -peak.fMin ) +RCenter  );
 	}
 
 	QFont Font;
@@ -210,42 +214,22 @@ void TargetWaveDisplay::updateDisplay( std::shared_ptr<H2Core::InstrumentLayer>
 {
 	if ( pLayer && pLayer->get_sample() ) {
 
-		int nSampleLength = pLayer->get_sample()->get_frames();
-		float nScaleFactor = nSampleLength / width();
-
-		float fGain = (height() - 8) / 2.0 * pLayer->get_gain();
-
-		auto pSampleDatal = pLayer->get_sample()->get_data_l();
-		auto pSampleDatar = pLayer->get_sample()->get_data_r();
-		int nSamplePos = 0;
-		int nVall;
-		int nValr;
-		for ( int i = 0; i < width(); ++i ){
-			nVall = 0;
-			nValr = 0;
-			for ( int j = 0; j < nScaleFactor; ++j ) {
-				if ( j < nSampleLength ) {
-					if ( pSampleDatal[ nSamplePos ] < 0 ){
-						int newVal = static_cast<int>( pSampleDatal[ nSamplePos ] * -fGain );
-						nVall = newVal;
-					}else
-					{
-						int newVal = static_cast<int>( pSampleDatal[ nSamplePos ] * fGain );
-						nVall = newVal;
-					}
-					if ( pSampleDatar[ nSamplePos ] > 0 ){
-						int newVal = static_cast<int>( pSampleDatar[ nSamplePos ] * -fGain );
-						nValr = newVal;
-					}else
-					{
-						int newVal = static_cast<int>( pSampleDatar[ nSamplePos ] * fGain );
-						nValr = newVal;
-					}
-				}
-				++nSamplePos;
+		auto pSample = pLayer->get_sample();
+		const int nWidth = width();
+		const double fFramesPerPixel =
+			static_cast<double>(pSample->get_frames()) / nWidth;
+		m_peaks_Left.resize( nWidth );
+		m_peaks_Right.resize( nWidth );
+		pSample->getPeaks( PeakPyramid::Channel::Left, 0, fFramesPerPixel,
+						   nWidth, m_peaks_Left.data() );
+		pSample->getPeaks( PeakPyramid::Channel::Right, 0, fFramesPerPixel,
+						   nWidth, m_peaks_Right.data() );
+
+		const float fGain = (height() - 8) / 2.0 * pLayer->get_gain();
+		for ( auto* pPeaks : { &m_peaks_Left, &m_peaks_Right } ) {
+			for ( auto& peak : *pPeaks ) {
+				peak = { peak.fMin * fGain, peak.fMax * fGain, peak.fRms * fGain };
 			}
-			m_pPeakData_Left[ i ] = nVall;
-			m_pPeakData_Right[ i ] = nValr;
 		}
 	}
 
@@ -27,8 +27,10 @@
 #include <QtWidgets>
 
 #include <core/Object.h>
+#include <core/Basics/PeakPyramid.h>
 #include <core/Basics/Sample.h>
 #include <memory>
+#include <vector>
 
 class SampleEditor;
 
@@ -70,8 +72,10 @@ class TargetWaveDisplay :  public QWidget,  public H2Core::Object<TargetWaveDisp
 		int m_nY;
 		int m_nLocator;
 
-		int *m_pPeakData_Left;
-		int *m_pPeakData_Right;
+		/** One entry per pixel already scaled to the height of the
+		 * widget. */
+		std::vector<H2Core::PeakPyramid::Peak> m_peaks_Left;
+		std::vector<H2Core::PeakPyramid::Peak> m_peaks_Right;
 
 		bool m_UpdatePosition;
 		EnvelopeEditMode m_EditMode;
@@ -103,9 +103,9 @@ void PlaybackTrackWaveDisplay::updateDisplay( std::shared_ptr<H2Core::Instrument
 		m_pBackgroundPixmap->setDevicePixelRatio( pixelRatio );
 	}
 
-	int currentWidth = width();
+	const int nWidth = width();
 
-	if( pLayer == nullptr || currentWidth <= 0 ){
+	if( pLayer == nullptr || nWidth <= 0 ){
 		m_pLayer = nullptr;
 		m_sSampleName = tr( "No playback track selected" );
 
@@ -115,15 +115,8 @@ void PlaybackTrackWaveDisplay::updateDisplay( std::shared_ptr<H2Core::Instrument
 		return;
 	}
 	
-	if(currentWidth != m_nCurrentWidth){
-		delete[] m_pPeakData;
-		m_pPeakData = new int[ currentWidth ];
-		
-		m_nCurrentWidth = currentWidth;
-	}
-	
 	//initialise everything with 0..	
-	memset( m_pPeakData, 0, currentWidth * sizeof(m_pPeakData[0]) );	
+	m_peaks.assign( nWidth, { 0, 0, 0 } );
 	
 	if ( pLayer && pLayer->get_sample() ) {
 		std::shared_ptr<Song> pSong = Hydrogen::get_instance()->getSong();
@@ -131,12 +124,12 @@ void PlaybackTrackWaveDisplay::updateDisplay( std::shared_ptr<H2Core::Instrument
 		m_pLayer = pLayer;
 		m_sSampleName = m_pLayer->get_sample()->get_filename();
 		
-		auto	pSampleData = pLayer->get_sample()->get_data_l();
+		auto	pSample = pLayer->get_sample();
 		int		nSampleLength = m_pLayer->get_sample()->get_frames();
 		float	fLengthOfPlaybackTrackInSecs = ( float )( nSampleLength / (float) m_pLayer->get_sample()->get_sample_rate() );
 		float	fRemainingLengthOfPlaybackTrack = fLengthOfPlaybackTrackInSecs;		
 		float	fGain = height() / 2.0 * pLayer->get_gain();
-		int		nSamplePos = 0;
+		double	fFramePos = 0;
 		int		nMaxBars = pPref->getMaxBars();
 		
 		std::vector<PatternList*> *pPatternColumns = pSong->getPatternGroupVector();
@@ -181,38 +174,26 @@ void PlaybackTrackWaveDisplay::updateDisplay( std::shared_ptr<H2Core::Instrument
 				float nScaleFactor = fLengthOfCurrentPatternInSecs / fLengthOfPlaybackTrackInSecs;
 				int nSamplesToRender = nScaleFactor * nSampleLength;
 				
-				int nVal = 0;
-				
-				for ( int i = nRenderStartPosition; i < nRenderStartPosition + nSongEditorGridWith ; ++i ) {
-					if( i < m_nCurrentWidth ) {
-						nVal = 0;
-						
-						int nSamplesToRenderInThisStep =  (nSamplesToRender / nSongEditorGridWith);
-						for ( int j = 0; j < nSamplesToRenderInThisStep; ++j ) {
-							if ( nSamplePos < nSampleLength ) {
-								int newVal = (int)( pSampleData[ nSamplePos ] * fGain );
-								if ( newVal > nVal ) {
-									nVal = newVal;
-								}
-							}
-							
-							++nSamplePos;
-						}
-					
-						m_pPeakData[ i ] = nVal;
-					}
+				const int nPixels = std::min( nSongEditorGridWith,
+											  nWidth - nRenderStartPosition );
+				if ( nPixels > 0 ) {
+					pSample->getPeaks( PeakPyramid::Channel::Both, fFramePos,
+									   static_cast<double>(nSamplesToRender) /
+									   nSongEditorGridWith, nPixels,
+									   m_peaks.data() + nRenderStartPosition );
 				}
+				fFramePos += nSamplesToRender;
 				
 				nRenderStartPosition += nSongEditorGridWith;
 				fRemainingLengthOfPlaybackTrack -= fLengthOfCurrentPatternInSecs;
 			}
 		}
+
+		for ( auto& peak : m_peaks ) {
+			peak = { peak.fMin * fGain, peak.fMax * fGain, peak.fRms * fGain };
+		}
 	} else {
 		m_sSampleName = "-";
-		for ( int i =0; i < m_nCurrentWidth; ++i ){
-			m_pPeakData[ i ] = 0;
-		}
-		
 	}
 
 	QPainter painter( m_pBackgroundPixmap );
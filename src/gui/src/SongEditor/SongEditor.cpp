@@ -83,8 +83,7 @@ SongEditor::SongEditor( QWidget *parent, QScrollArea *pScrollView, SongEditorPan
  , m_pHydrogen( nullptr )
  , m_pAudioEngine( nullptr )
  , m_bEntered( false )
- , m_pBackgroundPixmap( nullptr )
- , m_pSequencePixmap( nullptr )
+ , m_fTilePixelRatio( 1.0 )
 {
 	m_pHydrogen = Hydrogen::get_instance();
 	m_pAudioEngine = m_pHydrogen->getAudioEngine();
@@ -108,7 +107,7 @@ SongEditor::SongEditor( QWidget *parent, QScrollArea *pScrollView, SongEditorPan
 
 	this->resize( QSize( nInitialWidth, m_nMinimumHeight ) );
 
-	createBackground();	// create m_backgroundPixmap pixmap
+	createBackground();
 
 	// Popup context menu
 	m_pPopupMenu = new QMenu( this );
@@ -127,12 +126,6 @@ SongEditor::SongEditor( QWidget *parent, QScrollArea *pScrollView, SongEditorPan
 
 SongEditor::~SongEditor()
 {
-	if ( m_pBackgroundPixmap ) {
-		delete m_pBackgroundPixmap;
-	}
-	if ( m_pSequencePixmap ) {
-		delete m_pSequencePixmap;
-	}
 }
 
 
@@ -1021,13 +1014,29 @@ void SongEditor::paintEvent( QPaintEvent *ev )
 	// ridisegno tutto solo se sono cambiate le note
 	if (m_bSequenceChanged) {
 		m_bSequenceChanged = false;
-		drawSequence();
+		updateGridCells();
+	}
+	updateDrawnSelection();
+
+	const qreal fPixelRatio = devicePixelRatio();
+	if ( fPixelRatio != m_fTilePixelRatio ) {
+		m_tiles.clear();
+		m_fTilePixelRatio = fPixelRatio;
 	}
 	
 	const auto pPref = Preferences::get_instance();
 
 	QPainter painter(this);
-	painter.drawPixmap( ev->rect(), *m_pSequencePixmap, ev->rect() );
+
+	// Only tiles within the exposed part of the widget are rendered.
+	const QRect rect = ev->rect();
+	for ( int nTileY = rect.top() / nTileSize; nTileY <= rect.bottom() / nTileSize; ++nTileY ) {
+		for ( int nTileX = rect.left() / nTileSize; nTileX <= rect.right() / nTileSize; ++nTileX ) {
+			painter.drawPixmap( QPoint( nTileX * nTileSize, nTileY * nTileSize ),
+								getTile( QPoint( nTileX, nTileY ) ) );
+		}
+	}
+	evictTiles();
 
 	// Draw moving selected cells
 	QColor patternColor( 0, 0, 0 );
@@ -1118,40 +1127,47 @@ void SongEditor::leaveEvent( QEvent *ev ) {
 void SongEditor::createBackground()
 {
 	m_bBackgroundInvalid = false;
-	const auto pPref = H2Core::Preferences::get_instance();
 	std::shared_ptr<Song> pSong = m_pHydrogen->getSong();
 
 	uint nPatterns = pSong->getPatternList()->size();
-	int nSelectedPatternNumber = m_pHydrogen->getSelectedPatternNumber();
-	int nMaxPatternSequence = pPref->getMaxBars();
-
-	static int nOldHeight = -1;
 	int nNewHeight = m_nGridHeight * nPatterns;
 
-	if (nOldHeight != nNewHeight) {
-		// cambiamento di dimensioni...
-		if ( nNewHeight < m_nMinimumHeight ) {
-			WARNINGLOG( QString( "nNewHeight [%1] below minimum one [%2]" )
-						.arg( nNewHeight ).arg( m_nMinimumHeight ) );
-			nNewHeight = m_nMinimumHeight;	// the pixmap should not be empty
-		}
-		if ( m_pBackgroundPixmap ) {
-			delete m_pBackgroundPixmap;
-		}
-		if ( m_pSequencePixmap ) {
-			delete m_pSequencePixmap;
-		}
-		m_pBackgroundPixmap = new QPixmap( width(), nNewHeight );	// initialize the pixmap
-		m_pSequencePixmap = new QPixmap( width(), nNewHeight );	// initialize the pixmap
+	if ( nNewHeight < m_nMinimumHeight ) {
+		WARNINGLOG( QString( "nNewHeight [%1] below minimum one [%2]" )
+					.arg( nNewHeight ).arg( m_nMinimumHeight ) );
+		nNewHeight = m_nMinimumHeight;	// the widget should not be empty
+	}
+	if ( height() != nNewHeight ) {
 		this->resize( QSize( width(), nNewHeight ) );
 	}
 
-	
-	m_pBackgroundPixmap->fill( pPref->getTheme().m_color.m_songEditor_backgroundColor );
+	// All tiles will be rendered again once they are exposed.
+	m_tiles.clear();
+	m_bSequenceChanged = true;
+}
 
-	QPainter p( m_pBackgroundPixmap );
-	
-	for ( int ii = 0; ii < nPatterns + 1; ii++) {
+void SongEditor::drawBackground( QPainter& p, const QRect& rect )
+{
+	const auto pPref = H2Core::Preferences::get_instance();
+	std::shared_ptr<Song> pSong = m_pHydrogen->getSong();
+
+	int nPatterns = pSong->getPatternList()->size();
+	int nSelectedPatternNumber = m_pHydrogen->getSelectedPatternNumber();
+	int nMaxPatternSequence = pPref->getMaxBars();
+
+	// Rows and columns intersecting rect. The lines are drawn across
+	// the whole grid in order to keep the pattern of the dotted ones
+	// aligned between adjacent tiles.
+	const int nFirstRow = std::max( rect.top() / static_cast<int>(m_nGridHeight), 0 );
+	const int nLastRow = rect.bottom() / static_cast<int>(m_nGridHeight);
+	const int nFirstColumn = std::max(
+		( rect.left() - SongEditor::nMargin ) / static_cast<int>(m_nGridWidth), 0 );
+	const int nLastColumn =
+		( rect.right() - SongEditor::nMargin ) / static_cast<int>(m_nGridWidth) + 1;
+
+	p.fillRect( rect, pPref->getTheme().m_color.m_songEditor_backgroundColor );
+
+	for ( int ii = nFirstRow; ii <= std::min( nLastRow, nPatterns ); ii++) {
 		if ( ( ii % 2 ) == 0 &&
 			 ii != nSelectedPatternNumber ) {
 			continue;
@@ -1172,21 +1188,18 @@ void SongEditor::createBackground()
 					Qt::DotLine ) );
 
 	// vertical lines
-	for ( float ii = 0; ii <= nMaxPatternSequence + 1; ii++) {
+	for ( float ii = nFirstColumn;
+		  ii <= std::min( nMaxPatternSequence + 1, nLastColumn ); ii++) {
 		float x = SongEditor::nMargin + ii * m_nGridWidth;
 		p.drawLine( x, 0, x, m_nGridHeight * nPatterns );
 	}
 	
 	// horizontal lines
-	for (uint i = 0; i < nPatterns; i++) {
+	for ( int i = nFirstRow; i <= std::min( nLastRow, nPatterns - 1 ); i++) {
 		uint y = m_nGridHeight * i;
 
 		p.drawLine( 0, y, (nMaxPatternSequence * m_nGridWidth), y );
 	}
-
-	// ~ celle
-	m_bSequenceChanged = true;
-
 }
 
 void SongEditor::invalidateBackground() {
@@ -1196,30 +1209,142 @@ void SongEditor::invalidateBackground() {
 // Update the GridCell representation.
 void SongEditor::updateGridCells() {
 
-	m_gridCells.clear();
+	std::map< QPoint, GridCell > gridCells;
 	std::shared_ptr<Song> pSong = Hydrogen::get_instance()->getSong();
 	PatternList *pPatternList = pSong->getPatternList();
 	std::vector< PatternList* > *pColumns = pSong->getPatternGroupVector();
 
+	// Avoid a linear search for each cell.
+	std::map< const Pattern*, int > patternIndices;
+	for ( int ii = 0; ii < pPatternList->size(); ii++ ) {
+		patternIndices[ pPatternList->get( ii ) ] = ii;
+	}
+	auto patternIndex = [&]( const Pattern* pPattern ) {
+		auto it = patternIndices.find( pPattern );
+		return it != patternIndices.end() ? it->second : -1;
+	};
+
 	for ( int nColumn = 0; nColumn < pColumns->size(); nColumn++ ) {
 		PatternList *pColumn = (*pColumns)[nColumn];
 		int nMaxLength = pColumn->longest_pattern_length();
 
 		for ( uint nPat = 0; nPat < pColumn->size(); nPat++ ) {
 			Pattern *pPattern = (*pColumn)[ nPat ];
-			int y = pPatternList->index( pPattern );
+			int y = patternIndex( pPattern );
 			assert( y != -1 );
-			GridCell *pCell = &( m_gridCells[ QPoint( nColumn, y ) ] );
+			GridCell *pCell = &( gridCells[ QPoint( nColumn, y ) ] );
 			pCell->m_bActive = true;
 			pCell->m_fWidth = (float) pPattern->get_length() / nMaxLength;
 
 			for ( Pattern *pVPattern : *( pPattern->get_flattened_virtual_patterns() ) ) {
-				GridCell *pVCell = &( m_gridCells[ QPoint( nColumn, pPatternList->index( pVPattern ) ) ] );
+				GridCell *pVCell = &( gridCells[ QPoint( nColumn, patternIndex( pVPattern ) ) ] );
 				pVCell->m_bDrawnVirtual = true;
 				pVCell->m_fWidth = (float) pVPattern->get_length() / nMaxLength;
 			}
 		}
 	}
+
+	// Drop the tiles of all cells which were added, removed, or
+	// altered. Both maps are sorted the same way.
+	auto itOld = m_gridCells.cbegin();
+	auto itNew = gridCells.cbegin();
+	while ( itOld != m_gridCells.cend() || itNew != gridCells.cend() ) {
+		if ( itNew == gridCells.cend() ||
+			 ( itOld != m_gridCells.cend() && itOld->first < itNew->first ) ) {
+			invalidateCell( itOld->first );
+			++itOld;
+		}
+		else if ( itOld == m_gridCells.cend() || itNew->first < itOld->first ) {
+			invalidateCell( itNew->first );
+			++itNew;
+		}
+		else {
+			if ( itOld->second.m_bActive != itNew->second.m_bActive ||
+				 itOld->second.m_bDrawnVirtual != itNew->second.m_bDrawnVirtual ||
+				 itOld->second.m_fWidth != itNew->second.m_fWidth ) {
+				invalidateCell( itNew->first );
+			}
+			++itOld;
+			++itNew;
+		}
+	}
+
+	m_gridCells = std::move( gridCells );
+}
+
+const QPixmap& SongEditor::getTile( const QPoint& tile ) {
+	auto it = m_tiles.find( tile );
+	if ( it != m_tiles.end() ) {
+		return it->second;
+	}
+
+	QPixmap pixmap( nTileSize * m_fTilePixelRatio, nTileSize * m_fTilePixelRatio );
+	pixmap.setDevicePixelRatio( m_fTilePixelRatio );
+
+	const QRect tileRect( tile.x() * nTileSize, tile.y() * nTileSize,
+						  nTileSize, nTileSize );
+	QPainter p( &pixmap );
+	p.translate( -tileRect.topLeft() );
+	drawBackground( p, tileRect );
+	drawCells( p, tileRect );
+	p.end();
+
+	return m_tiles.emplace( tile, std::move( pixmap ) ).first->second;
+}
+
+void SongEditor::evictTiles() {
+	// Keep a margin of one tile around the visible part of the widget to
+	// not render the tiles at its border over and over again while
+	// scrolling back and forth.
+	const QRect keepRect = visibleRegion().boundingRect()
+		.adjusted( -nTileSize, -nTileSize, nTileSize, nTileSize );
+	for ( auto it = m_tiles.begin(); it != m_tiles.end(); ) {
+		const QRect tileRect( it->first.x() * nTileSize, it->first.y() * nTileSize,
+							  nTileSize, nTileSize );
+		if ( ! keepRect.intersects( tileRect ) ) {
+			it = m_tiles.erase( it );
+		} else {
+			++it;
+		}
+	}
+}
+
+void SongEditor::invalidateTiles( const QRect& rect ) {
+	for ( int nTileY = std::max( rect.top(), 0 ) / nTileSize;
+		  nTileY <= std::max( rect.bottom(), 0 ) / nTileSize; ++nTileY ) {
+		for ( int nTileX = std::max( rect.left(), 0 ) / nTileSize;
+			  nTileX <= std::max( rect.right(), 0 ) / nTileSize; ++nTileX ) {
+			m_tiles.erase( QPoint( nTileX, nTileY ) );
+		}
+	}
+}
+
+void SongEditor::invalidateCell( const QPoint& cell ) {
+	// The border of a cell is drawn one pixel beyond its size.
+	invalidateTiles( QRect( columnRowToXy( cell ),
+							QSize( m_nGridWidth + 1, m_nGridHeight + 1 ) ) );
+}
+
+void SongEditor::updateDrawnSelection() {
+	std::set< QPoint > selection;
+	for ( QPoint cell : m_selection ) {
+		selection.insert( cell );
+	}
+	if ( selection == m_drawnSelection ) {
+		return;
+	}
+
+	for ( const auto& cell : selection ) {
+		if ( m_drawnSelection.find( cell ) == m_drawnSelection.end() ) {
+			invalidateCell( cell );
+		}
+	}
+	for ( const auto& cell : m_drawnSelection ) {
+		if ( selection.find( cell ) == selection.end() ) {
+			invalidateCell( cell );
+		}
+	}
+	m_drawnSelection = std::move( selection );
 }
 
 // Return grid offset (in cell coordinate space) of moving selection
@@ -1239,39 +1364,44 @@ QPoint SongEditor::movingGridOffset( ) const {
 }
 
 
-void SongEditor::drawSequence()
+void SongEditor::drawCells( QPainter& p, const QRect& rect )
 {
-	QPainter p;
-
-	p.begin( m_pSequencePixmap );
-	p.drawPixmap( rect(), *m_pBackgroundPixmap, rect() );
-	p.end();
+	// Cells starting in the column left of rect may reach into it with
+	// their border.
+	const int nFirstColumn =
+		( rect.left() - SongEditor::nMargin ) / static_cast<int>(m_nGridWidth) - 1;
+	const int nLastColumn =
+		( rect.right() - SongEditor::nMargin ) / static_cast<int>(m_nGridWidth);
+	const int nFirstRow = rect.top() / static_cast<int>(m_nGridHeight) - 1;
+	const int nLastRow = rect.bottom() / static_cast<int>(m_nGridHeight);
 
-	updateGridCells();
+	auto itBegin = m_gridCells.lower_bound( QPoint( nFirstColumn, nFirstRow ) );
+	auto itEnd = m_gridCells.upper_bound( QPoint( nLastColumn, nLastRow ) );
 
 	// Draw using GridCells representation
-	for ( const auto& it : m_gridCells ) {
-		if ( ! m_selection.isSelected( QPoint( it.first.x(), it.first.y() ) ) ) {
-			drawPattern( it.first.x(), it.first.y(),
-						 it.second.m_bDrawnVirtual, it.second.m_fWidth );
+	for ( auto it = itBegin; it != itEnd; ++it ) {
+		if ( it->first.y() >= nFirstRow && it->first.y() <= nLastRow &&
+			 ! m_selection.isSelected( QPoint( it->first.x(), it->first.y() ) ) ) {
+			drawPattern( p, it->first.x(), it->first.y(),
+						 it->second.m_bDrawnVirtual, it->second.m_fWidth );
 		}
 	}
 	// We draw all selected patterns in a second run to ensure their
 	// border does have the proper color (else the bottom and left one
 	// could be overwritten by an adjecent, unselected pattern).
-	for ( const auto& it : m_gridCells ) {
-		if ( m_selection.isSelected( QPoint( it.first.x(), it.first.y() ) ) ) {
-			drawPattern( it.first.x(), it.first.y(),
-						 it.second.m_bDrawnVirtual, it.second.m_fWidth );
+	for ( auto it = itBegin; it != itEnd; ++it ) {
+		if ( it->first.y() >= nFirstRow && it->first.y() <= nLastRow &&
+			 m_selection.isSelected( QPoint( it->first.x(), it->first.y() ) ) ) {
+			drawPattern( p, it->first.x(), it->first.y(),
+						 it->second.m_bDrawnVirtual, it->second.m_fWidth );
 		}
 	}
 }
 
 
 
-void SongEditor::drawPattern( int nPos, int nNumber, bool bInvertColour, double fWidth )
+void SongEditor::drawPattern( QPainter& p, int nPos, int nNumber, bool bInvertColour, double fWidth )
 {
-	QPainter p( m_pSequencePixmap );
 	/*
 	 * The default color of the cubes in rgb is 97,167,251.
 	 */
@@ -1343,11 +1473,16 @@ void SongEditor::drawPattern( int nPos, int nNumber, bool bInvertColour, double
 std::vector<SongEditor::SelectionIndex> SongEditor::elementsIntersecting( const QRect& r )
 {
 	std::vector<SelectionIndex> elems;
-	for ( auto it : m_gridCells ) {
-		if ( r.intersects( QRect( columnRowToXy( it.first ),
+	// Only the columns covered by r have to be checked.
+	auto itBegin = m_gridCells.lower_bound(
+		QPoint( ( r.left() - SongEditor::nMargin ) / static_cast<int>(m_nGridWidth) - 1, 0 ) );
+	auto itEnd = m_gridCells.lower_bound(
+		QPoint( ( r.right() - SongEditor::nMargin ) / static_cast<int>(m_nGridWidth) + 1, 0 ) );
+	for ( auto it = itBegin; it != itEnd; ++it ) {
+		if ( r.intersects( QRect( columnRowToXy( it->first ),
 								  QSize( m_nGridWidth, m_nGridHeight) ) ) ) {
-			if ( ! it.second.m_bDrawnVirtual ) {
-				elems.push_back( it.first );
+			if ( ! it->second.m_bDrawnVirtual ) {
+				elems.push_back( it->first );
 			}
 		}
 	}
@@ -1359,7 +1494,7 @@ QRect SongEditor::getKeyboardCursorRect() {
 				  QSize( m_nGridWidth, m_nGridHeight -1 ) );
 }
 
-void SongEditor::clearThePatternSequenceVector( const QString& filename )
+void SongEditor::clearThePatternSequenceVector()
 {
 	Hydrogen *pHydrogen = Hydrogen::get_instance();
 
@@ -1367,9 +1502,6 @@ void SongEditor::clearThePatternSequenceVector( const QString& filename )
 
 	std::shared_ptr<Song> pSong = pHydrogen->getSong();
 
-	//before deleting the sequence, write a temp sequence file to disk
-	pSong->saveTempPatternList( filename );
-
 	std::vector<PatternList*> *pPatternGroupsVect = pSong->getPatternGroupVector();
 	for (uint i = 0; i < pPatternGroupsVect->size(); i++) {
 		PatternList *pPatternList = (*pPatternGroupsVect)[i];
@@ -1947,23 +2079,16 @@ void SongEditorPatternList::patternPopup_load()
 	}
 	QString patternPath = fd.selectedFiles().first();
 
-	QString prevPatternPath =
-		Files::savePatternTmp( pPattern->get_name(), pPattern, pSong,
-							   pDrumkit->getName() );
-
-	if ( prevPatternPath.isEmpty() ) {
-		QMessageBox::warning( this, "Hydrogen", tr("Could not save pattern to temporary directory.") );
-		return;
-	}
-	QString sequencePath = Filesystem::tmp_file_path( "SEQ.xml" );
-	if ( !pSong->saveTempPatternList( sequencePath ) ) {
-		QMessageBox::warning( this, "Hydrogen", tr("Could not export sequence.") );
+	Pattern* pNewPattern = Pattern::load_file( patternPath );
+	if ( pNewPattern == nullptr ) {
+		ERRORLOG( QString( "Error loading pattern %1" ).arg( patternPath ) );
 		return;
 	}
 	pPref->setLastOpenPatternDirectory( fd.directory().absolutePath() );
 
 	SE_loadPatternAction *action =
-		new SE_loadPatternAction( patternPath, prevPatternPath, sequencePath,
+		new SE_loadPatternAction( pNewPattern, new Pattern( pPattern ),
+								  pSong->getPatternSequence(),
 								  m_nRowClicked, false );
 	HydrogenApp *hydrogenApp = HydrogenApp::get_instance();
 	hydrogenApp->m_pUndoStack->push( action );
@@ -2101,22 +2226,13 @@ void SongEditorPatternList::patternPopup_delete()
 	}
 
 	auto pPattern = pSong->getPatternList()->get( m_nRowClicked );
-
-	QString patternPath =
-		Files::savePatternTmp( pPattern->get_name(), pPattern, pSong,
-							   pDrumkit->getName() );
-	if ( patternPath.isEmpty() ) {
-		QMessageBox::warning( this, "Hydrogen", tr("Could not save pattern to temporary directory.") );
-		return;
-	}
-	QString sequencePath = Filesystem::tmp_file_path( "SEQ.xml" );
-	if ( !pSong->saveTempPatternList( sequencePath ) ) {
-		QMessageBox::warning( this, "Hydrogen", tr("Could not export sequence.") );
+	if ( pPattern == nullptr ) {
 		return;
 	}
 
 	SE_deletePatternFromListAction *action =
-		new SE_deletePatternFromListAction( patternPath, sequencePath,
+		new SE_deletePatternFromListAction( new Pattern( pPattern ),
+											pSong->getPatternSequence(),
 											m_nRowClicked );
 	HydrogenApp *hydrogenApp = HydrogenApp::get_instance();
 	hydrogenApp->m_pUndoStack->push( action );
@@ -2155,20 +2271,14 @@ void SongEditorPatternList::patternPopup_duplicate()
 	PatternPropertiesDialog *dialog = new PatternPropertiesDialog( this, pNewPattern, m_nRowClicked, true );
 
 	if ( dialog->exec() == QDialog::Accepted ) {
-		QString filePath = Files::savePatternTmp( pNewPattern->get_name(),
-												  pNewPattern, pSong,
-												  pDrumkit->getName() );
-		if ( filePath.isEmpty() ) {
-			QMessageBox::warning( this, "Hydrogen", tr("Could not save pattern to temporary directory.") );
-			return;
-		}
 		SE_duplicatePatternAction *action =
-			new SE_duplicatePatternAction( filePath, m_nRowClicked + 1 );
+			new SE_duplicatePatternAction( pNewPattern, m_nRowClicked + 1 );
 		HydrogenApp::get_instance()->m_pUndoStack->push( action );
+	} else {
+		delete pNewPattern;
 	}
 
 	delete dialog;
-	delete pNewPattern;
 }
 
 void SongEditorPatternList::patternPopup_fill()
@@ -2250,6 +2360,8 @@ void SongEditorPatternList::fillRangeWithPattern( FillRange* pRange, int nPatter
 				break;
 			}
 		}
+
+	m_pHydrogen->updateSongSize();
 	m_pAudioEngine->unlock();
 
 
@@ -2344,16 +2456,25 @@ void SongEditorPatternList::dropEvent(QDropEvent *event)
 		QStringList tokens = sText.split( "::" );
 		QString sPatternName = tokens.at( 1 );
 
-		//create a unique sequencefilename
 		Pattern *pPattern = pSong->getPatternList()->get( nTargetPattern );
 		HydrogenApp *pHydrogenApp = HydrogenApp::get_instance();
 
-		QString oldPatternName = pPattern->get_name();
+		Pattern* pNewPattern = Pattern::load_file( sPatternName );
+		if ( pNewPattern == nullptr ) {
+			ERRORLOG( QString( "Error loading pattern %1" ).arg( sPatternName ) );
+			return;
+		}
 
-		QString sequenceFilename = Filesystem::tmp_file_path( "SEQ.xml" );
 		bool drag = false;
 		if( QString( tokens.at(0) ).contains( "drag pattern" )) drag = true;
-		SE_loadPatternAction *pAction = new SE_loadPatternAction( sPatternName, oldPatternName, sequenceFilename, nTargetPattern, drag );
+		Pattern* pOldPattern = nullptr;
+		if ( ! drag && pPattern != nullptr ) {
+			pOldPattern = new Pattern( pPattern );
+		}
+		SE_loadPatternAction *pAction =
+			new SE_loadPatternAction( pNewPattern, pOldPattern,
+									  pSong->getPatternSequence(),
+									  nTargetPattern, drag );
 
 		pHydrogenApp->m_pUndoStack->push( pAction );
 	}
@@ -23,6 +23,8 @@
 #ifndef SONG_EDITOR_H
 #define SONG_EDITOR_H
 
+#include <map>
+#include <set>
 #include <vector>
 #include <memory>
 
@@ -99,7 +101,7 @@ class SongEditor : public QWidget
 									   const std::vector<QPoint>& deleteCells,
 									   const std::vector<QPoint>& selectCells );
 
-		void clearThePatternSequenceVector( const QString& filename );
+		void clearThePatternSequenceVector();
 		void updateEditorandSetTrue();
 
 		int yScrollTarget( QScrollArea *pScrollArea, int *pnPatternInView );
@@ -139,7 +141,7 @@ class SongEditor : public QWidget
 		//! set at the start of the draw gesture.
 		bool 					m_bDrawingActiveCell;
 
-		//! Pattern sequence or selection has changed, so must be redrawn.
+		//! Pattern sequence or selection has changed, so #m_gridCells must be rebuilt.
 		bool 					m_bSequenceChanged;
 
 		QMenu *					m_pPopupMenu;
@@ -147,16 +149,36 @@ class SongEditor : public QWidget
 		bool m_bBackgroundInvalid;
 
 
-		//! @name Background pixmap caching
+		//! @name Tiled pixmap caching
 		//!
-		//! To make painting the song editor sequence grid more efficient, the drawing uses multiple levels of lazy painting.
-		//!   * The grid background pixmap is only updated when the size of the pattern grid changes.
-		//!   * The sequence pixmap are only updated when cells are added/removed or selections change
-		//!       * the cached grid background pixmap is used when repainting the pattern
-		//!   * selections and moving cells are painted on top of the cached sequence pixmap
+		//! To make painting the song editor sequence grid more efficient, the grid is rendered into tiles of
+		//! #nTileSize pixels which are created lazily when first exposed.
+		//!   * Only tiles intersecting the area to be repainted are rendered. Since Qt restricts paint
+		//!     events to the visible part of the scroll area, long songs cost no more than short ones.
+		//!   * All tiles are dropped when the size, colors, or structure of the grid change.
+		//!   * When cells are added/removed or selections change only tiles touching the affected cells are
+		//!     dropped.
+		//!   * Tiles scrolled out of view are dropped after each repaint, so memory stays bounded by the
+		//!     size of the viewport.
+		//!   * selections and moving cells are painted on top of the cached tiles
 		//! @{
-		QPixmap *				m_pBackgroundPixmap;
-		QPixmap *				m_pSequencePixmap;
+		static constexpr int	nTileSize = 256;
+		std::map< QPoint, QPixmap >	m_tiles;
+		//! Device pixel ratio the tiles in #m_tiles were rendered for.
+		qreal					m_fTilePixelRatio;
+		//! Selected cells at the time the tiles were rendered.
+		std::set< QPoint >		m_drawnSelection;
+
+		const QPixmap& getTile( const QPoint& tile );
+		//! Drops all tiles not within or next to the visible part of the widget.
+		void evictTiles();
+		//! Drops all tiles intersecting @a rect (in widget coordinates).
+		void invalidateTiles( const QRect& rect );
+		void invalidateCell( const QPoint& cell );
+		//! Drops the tiles of all cells which were selected or deselected since the last repaint.
+		void updateDrawnSelection();
+		void drawBackground( QPainter& p, const QRect& rect );
+		void drawCells( QPainter& p, const QRect& rect );
 		//! @}
 
 		//! @name Position of the keyboard input cursor
@@ -206,12 +228,12 @@ class SongEditor : public QWidget
     	void togglePatternActive( int nColumn, int nRow );
 		void setPatternActive( int nColumn, int nRow, bool bActivate );
 
-		void drawSequence();
-  
-		void drawPattern( int pos, int number, bool invertColour, double width );
+		void drawPattern( QPainter& p, int pos, int number, bool invertColour, double width );
 		void drawFocus( QPainter& painter );
 
 		std::map< QPoint, GridCell > m_gridCells;
+		//! Rebuilds #m_gridCells from the pattern sequence of the song and drops the tiles of all cells
+		//! which changed.
 		void updateGridCells();
 		bool m_bEntered;
 
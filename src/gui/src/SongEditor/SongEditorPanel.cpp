@@ -697,29 +697,25 @@ void SongEditorPanel::clearSequence()
 		return;
 	}
 	
-	QString filename = Filesystem::tmp_file_path( "SEQ.xml" );
-	SE_deletePatternSequenceAction *pAction = new SE_deletePatternSequenceAction( filename );
+	SE_deletePatternSequenceAction *pAction = new SE_deletePatternSequenceAction(
+		Hydrogen::get_instance()->getSong()->getPatternSequence() );
 	HydrogenApp *pH2App = HydrogenApp::get_instance();
 
 	pH2App->m_pUndoStack->push( pAction );
 }
 
 
-void SongEditorPanel::restoreGroupVector( const QString& filename )
+void SongEditorPanel::restoreGroupVector(
+	std::shared_ptr<const Song::PatternSequence> pSequence )
 {
 	auto pHydrogen = Hydrogen::get_instance();
 	auto pAudioEngine = pHydrogen->getAudioEngine();
-	//clear the old sequese
-	std::vector<PatternList*> *pPatternGroupsVect = pHydrogen->getSong()->getPatternGroupVector();
-	for (uint i = 0; i < pPatternGroupsVect->size(); i++) {
-		PatternList *pPatternList = (*pPatternGroupsVect)[i];
-		pPatternList->clear();
-		delete pPatternList;
+	if ( pSequence == nullptr || pHydrogen->getSong() == nullptr ) {
+		return;
 	}
-	pPatternGroupsVect->clear();
 
 	pAudioEngine->lock( RIGHT_HERE );
-	pHydrogen->getSong()->loadTempPatternList( filename );
+	pHydrogen->getSong()->setPatternSequence( *pSequence );
 	pHydrogen->updateSongSize();
 	pHydrogen->updateSelectedPattern( false );
 	pAudioEngine->unlock();
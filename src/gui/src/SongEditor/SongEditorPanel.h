@@ -27,6 +27,7 @@
 #include "../EventListener.h"
 #include <core/Object.h>
 #include <core/Basics/Pattern.h>
+#include <core/Basics/Song.h>
 
 #include <QtGui>
 #include <QtWidgets>
@@ -76,7 +77,8 @@ class SongEditorPanel :  public QWidget, public EventListener,  public H2Core::O
 		 * signal the user her last action was not permitted.
 		 */
 		void highlightPatternEditorLocked( bool bUseRedBackground );	
-		void restoreGroupVector( const QString& filename );
+		void restoreGroupVector(
+			std::shared_ptr<const H2Core::Song::PatternSequence> pSequence );
 		// ~ Implements EventListener interface
 		/** Disables and deactivates the Timeline when an external
 		 * JACK timebase master is detected and enables it when it's
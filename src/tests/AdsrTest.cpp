@@ -23,6 +23,7 @@
 #include "AdsrTest.h"
 
 #include <core/Basics/Adsr.h>
+#include <algorithm>
 #include <stdio.h>
 #include <memory>
 
@@ -163,6 +164,34 @@ void ADSRTest::testBufferChunks() {
 
 }
 
+/* Same as above but with chunks not aligned to the phase boundaries. The
+   Sampler renders voices in blocks not related to the envelope at all. */
+void ADSRTest::testUnalignedChunks() {
+	___INFOLOG( "" );
+	const int N = 256;
+	const float fSustain = 0.75;
+	float a[5*N], b[5*N];
+	float c[5*N], d[5*N];
+
+	for ( const int nChunk : { 7, 100, 333 } ) {
+		for ( int nReleasePoint = N / 3; nReleasePoint < 5 * N; nReleasePoint += N / 3 ) {
+
+			for ( int n = 0; n < 5*N; n++) {
+				a[n] = b[n] = c[n] = d[n] = 1.0;
+			}
+
+			ADSR AdsrRef( N, N, fSustain, N ), AdsrTest( N, N, fSustain, N );
+			AdsrRef.applyADSR( a, b, 5 * N, nReleasePoint, 1.0 );
+
+			for ( int n = 0; n < 5 * N; n += nChunk ) {
+				const int nFrames = std::min( nChunk, 5 * N - n );
+				AdsrTest.applyADSR( c + n, d + n, nFrames, nReleasePoint - n, 1.0 );
+				checkEqual( a + n, c + n, nFrames );
+			}
+		}
+	}
+	___INFOLOG( "passed" );
+}
 
 void ADSRTest::testEarlyRelease() {
 	___INFOLOG( "" );
@@ -270,3 +299,44 @@ void ADSRTest::testRelease()
 	CPPUNIT_ASSERT_DOUBLES_EQUAL( 0.0, getValue( 2.0 ), delta );
 	___INFOLOG( "passed" );
 }
+
+/* Voices stolen by the Sampler are faded out way faster than the release
+   of their instrument. */
+void ADSRTest::testFadeOut() {
+	___INFOLOG( "" );
+	const int N = 256;
+	const int nFadeOut = 16;
+	const float fSustain = 0.75;
+	float a[4*N], b[4*N];
+	for ( int n = 0; n < 4*N; n++) {
+		a[n] = b[n] = 1.0;
+	}
+
+	ADSR Adsr( N, N, fSustain, 4 * N );
+	// Attack, decay, and part of sustain.
+	Adsr.applyADSR( a, b, 3 * N, 4 * N, 1.0 );
+	CPPUNIT_ASSERT_DOUBLES_EQUAL( fSustain, Adsr.getValue(), delta );
+
+	Adsr.fadeOut( nFadeOut );
+	CPPUNIT_ASSERT( Adsr.getState() == ADSR::State::Release );
+	CPPUNIT_ASSERT( Adsr.applyADSR( &a[3*N], &b[3*N], N, 4 * N, 1.0 ) );
+	checkEqual( a, b, 4 * N );
+
+	CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE( "fade-out starting at sustain level",
+										  fSustain, a[3*N], 1.0/nFadeOut );
+	checkConcave( &a[3*N], nFadeOut );
+	checkAllEqual( &a[3*N + nFadeOut], 0.0, N - nFadeOut );
+
+	// A release ending earlier than the fade-out must not be prolonged.
+	ADSR Adsr2( 0, 0, 1.0, N );
+	Adsr2.release();
+	CPPUNIT_ASSERT( ! Adsr2.applyADSR( a, b, N - nFadeOut / 2, N, 1.0 ) );
+	Adsr2.fadeOut( nFadeOut );
+	CPPUNIT_ASSERT_EQUAL( static_cast<unsigned int>(N), Adsr2.getRelease() );
+
+	// Idle envelopes stay idle.
+	CPPUNIT_ASSERT( Adsr2.applyADSR( a, b, N, N, 1.0 ) );
+	Adsr2.fadeOut( nFadeOut );
+	CPPUNIT_ASSERT( Adsr2.getState() == ADSR::State::Idle );
+	___INFOLOG( "passed" );
+}
@@ -36,6 +36,8 @@ class ADSRTest : public CppUnit::TestCase {
 	CPPUNIT_TEST( testBasicADSR );
 	CPPUNIT_TEST( testEarlyRelease );
   	CPPUNIT_TEST( testBufferChunks );
+	CPPUNIT_TEST( testUnalignedChunks );
+	CPPUNIT_TEST( testFadeOut );
 	CPPUNIT_TEST_SUITE_END();
 
 	private:
@@ -51,6 +53,8 @@ class ADSRTest : public CppUnit::TestCase {
 	void testBasicADSR();
   	void testEarlyRelease();
 	void testBufferChunks();
+	void testUnalignedChunks();
+	void testFadeOut();
 };
 
 #endif
@@ -31,6 +31,8 @@
 #include <core/Basics/Drumkit.h>
 #include <core/Basics/InstrumentList.h>
 #include <core/Basics/InstrumentComponent.h>
+#include <core/Basics/Note.h>
+#include <core/Basics/Pattern.h>
 #include <core/Basics/PatternList.h>
 #include "TestHelper.h"
 #include "AudioBenchmark.h"
@@ -146,6 +148,53 @@ void AudioBenchmark::timeADSR() {
 	out << "ADSR time: " << showTimes( times, nFrames ) << Qt::endl;
 }
 
+void AudioBenchmark::timeLoading() {
+	const int nIterations = 32;
+	const int nNotes = 20000;
+	std::vector< clock_t > times;
+
+	// Synthesize a pattern large enough for parsing to dominate the
+	// file system access.
+	auto sPatternFile = Filesystem::tmp_file_path( "benchmark.h2pattern" );
+	{
+		Pattern pattern( "benchmark", "", "", MAX_NOTES, 4 );
+		for ( int i = 0; i < nNotes; i++ ) {
+			auto pNote = new Note( nullptr, i % MAX_NOTES, 0.8, 0.0, -1, 0.0 );
+			pNote->set_instrument_id( i % 16 );
+			pNote->setType( QString( "type %1" ).arg( i % 16 ) );
+			pattern.insert_note( pNote );
+		}
+		CPPUNIT_ASSERT( pattern.save_file( "GMRockKit", sPatternFile, true ) );
+	}
+
+	for ( int i = 0; i < nIterations; i++ ) {
+		std::clock_t start = std::clock();
+		auto pPattern = Pattern::load_file( sPatternFile );
+		std::clock_t end = std::clock();
+
+		CPPUNIT_ASSERT( pPattern != nullptr );
+		CPPUNIT_ASSERT( pPattern->get_notes()->size() == nNotes );
+		delete pPattern;
+
+		times.push_back( end - start );
+	}
+	out << "Pattern loading time: " << showTimes( times, nNotes ) << Qt::endl;
+	Filesystem::rm( sPatternFile );
+
+	times.clear();
+	auto sSongFile = H2TEST_FILE( "functional/test.h2song" );
+	for ( int i = 0; i < nIterations; i++ ) {
+		std::clock_t start = std::clock();
+		auto pSong = Song::load( sSongFile, true );
+		std::clock_t end = std::clock();
+
+		CPPUNIT_ASSERT( pSong != nullptr );
+
+		times.push_back( end - start );
+	}
+	out << "Song loading time: " << showTimes( times, 1 ) << Qt::endl;
+}
+
 double AudioBenchmark::timeExport( int nSampleRate,
 								   Interpolation::InterpolateMode interpolateMode,
 								   double fReference,
@@ -214,6 +263,9 @@ void AudioBenchmark::audioBenchmark(void)
 	out << "Benchmark ADSR method:" << Qt::endl;
 	timeADSR();
 
+	out << "Benchmark loading of songs and patterns:" << Qt::endl;
+	timeLoading();
+
 	auto songFile = H2TEST_FILE("functional/test.h2song");
 	auto songADSRFile = H2TEST_FILE("functional/test_adsr.h2song");
 
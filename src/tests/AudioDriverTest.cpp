@@ -21,8 +21,14 @@
 
 #include "AudioDriverTest.h"
 
+#include <cmath>
+#include <limits>
+#include <vector>
+
 #include <core/AudioEngine/AudioEngine.h>
+#include <core/AudioEngine/ProcessProfiler.h>
 #include <core/Hydrogen.h>
+#include <core/IO/PcmConverter.h>
 
 void AudioDriverTest::setUp() {
 	auto pPref = H2Core::Preferences::get_instance();
@@ -86,6 +92,118 @@ void AudioDriverTest::testDriverSwitching() {
 	___INFOLOG("done");
 }
 
+void AudioDriverTest::testProcessProfiler() {
+	___INFOLOG("");
+
+	using Stage = H2Core::ProcessProfiler::Stage;
+	H2Core::ProcessProfiler profiler;
+
+	auto statistics = profiler.getStatistics( Stage::Sampler );
+	CPPUNIT_ASSERT( statistics.nCount == 0 );
+	CPPUNIT_ASSERT( statistics.fMean == 0 );
+
+	// 99 cycles of 1.5us and a single one of 3ms.
+	for ( int ii = 0; ii < 99; ++ii ) {
+		profiler.record( Stage::Sampler, 1500 );
+	}
+	profiler.record( Stage::Sampler, 3000000 );
+
+	statistics = profiler.getStatistics( Stage::Sampler );
+	CPPUNIT_ASSERT( statistics.nCount == 100 );
+	CPPUNIT_ASSERT( std::abs( statistics.fLast - 3.0 ) < 1e-6 );
+	CPPUNIT_ASSERT( std::abs( statistics.fMax - 3.0 ) < 1e-6 );
+	CPPUNIT_ASSERT( std::abs( statistics.fMean - 0.031485 ) < 1e-6 );
+	// Upper bound of the [1us, 2us) bin.
+	CPPUNIT_ASSERT( std::abs( statistics.fPercentile99 - 0.002 ) < 1e-6 );
+	CPPUNIT_ASSERT( statistics.histogram[ 1 ] == 99 );
+	CPPUNIT_ASSERT( statistics.histogram[ 12 ] == 1 );
+
+	// Other stages are not affected.
+	CPPUNIT_ASSERT( profiler.getStatistics( Stage::Total ).nCount == 0 );
+	CPPUNIT_ASSERT( profiler.format().contains( "Sampler" ) );
+	CPPUNIT_ASSERT( ! profiler.format().contains( "Total" ) );
+
+	profiler.reset();
+	CPPUNIT_ASSERT( profiler.getStatistics( Stage::Sampler ).nCount == 0 );
+
+	___INFOLOG("done");
+}
+
+void AudioDriverTest::testPcmConverter() {
+	___INFOLOG("");
+
+	using Format = H2Core::PcmConverter::Format;
+
+	const int nFrames = 5;
+	const float in_L[ nFrames ] = { 0, 0.5, -1, 2, -2 };
+	const float in_R[ nFrames ] = { 1, -0.5, 1.5 / 32768, -1.5 / 32768, 0.25 };
+
+	{
+		H2Core::PcmConverter converter( Format::S16, false );
+		CPPUNIT_ASSERT( converter.getSampleSize() == 2 );
+		int16_t out[ 2 * nFrames ];
+		converter.convert( in_L, in_R, out, nFrames );
+		const int16_t expected[ 2 * nFrames ] =
+			{ 0, 32767, 16384, -16384, -32768, 2, 32767, -2, -32768, 8192 };
+		for ( int ii = 0; ii < 2 * nFrames; ++ii ) {
+			CPPUNIT_ASSERT( out[ ii ] == expected[ ii ] );
+		}
+	}
+
+	{
+		H2Core::PcmConverter converter( Format::S32, false );
+		int32_t out[ 2 * nFrames ];
+		converter.convert( in_L, in_R, out, nFrames );
+		CPPUNIT_ASSERT( out[ 0 ] == 0 );
+		CPPUNIT_ASSERT( out[ 1 ] > 2147483000 );
+		CPPUNIT_ASSERT( out[ 4 ] == std::numeric_limits<int32_t>::min() );
+		CPPUNIT_ASSERT( out[ 6 ] > 2147483000 );
+		CPPUNIT_ASSERT( out[ 8 ] == std::numeric_limits<int32_t>::min() );
+	}
+
+	{
+		H2Core::PcmConverter converter( Format::S24_3LE, false );
+		CPPUNIT_ASSERT( converter.getSampleSize() == 3 );
+		uint8_t out[ 6 * nFrames ];
+		converter.convert( in_L, in_R, out, nFrames );
+		// 0.5 and -0.5 in 24 bit little endian.
+		CPPUNIT_ASSERT( out[ 6 ] == 0x00 && out[ 7 ] == 0x00 && out[ 8 ] == 0x40 );
+		CPPUNIT_ASSERT( out[ 9 ] == 0x00 && out[ 10 ] == 0x00 && out[ 11 ] == 0xc0 );
+		// Saturated at 2^23 - 1.
+		CPPUNIT_ASSERT( out[ 18 ] == 0xff && out[ 19 ] == 0xff && out[ 20 ] == 0x7f );
+	}
+
+	{
+		H2Core::PcmConverter converter( Format::Float, false );
+		float out[ 2 * nFrames ];
+		converter.convert( in_L, in_R, out, nFrames );
+		CPPUNIT_ASSERT( out[ 2 ] == 0.5 );
+		CPPUNIT_ASSERT( out[ 6 ] == 1 );
+		CPPUNIT_ASSERT( out[ 8 ] == -1 );
+	}
+
+	{
+		// Dither must neither exceed one LSB nor introduce an offset.
+		const int nDitherFrames = 4096;
+		std::vector<float> silence( nDitherFrames, 0 );
+		std::vector<int16_t> out( 2 * nDitherFrames );
+		H2Core::PcmConverter converter( Format::S16, true );
+		converter.convert( silence.data(), silence.data(), out.data(),
+						   nDitherFrames );
+		double fSum = 0;
+		bool bNonZero = false;
+		for ( const auto& nValue : out ) {
+			CPPUNIT_ASSERT( std::abs( nValue ) <= 1 );
+			fSum += nValue;
+			bNonZero = bNonZero || nValue != 0;
+		}
+		CPPUNIT_ASSERT( bNonZero );
+		CPPUNIT_ASSERT( std::abs( fSum / out.size() ) < 0.05 );
+	}
+
+	___INFOLOG("done");
+}
+
 void AudioDriverTest::tearDown() {
 	auto pHydrogen = H2Core::Hydrogen::get_instance();
 	auto pAudioEngine = pHydrogen->getAudioEngine();
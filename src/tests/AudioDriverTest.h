@@ -29,6 +29,8 @@
 class AudioDriverTest : public CppUnit::TestCase {
 	CPPUNIT_TEST_SUITE( AudioDriverTest );
 	CPPUNIT_TEST( testDriverSwitching );
+	CPPUNIT_TEST( testProcessProfiler );
+	CPPUNIT_TEST( testPcmConverter );
 	CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -38,6 +40,14 @@ class AudioDriverTest : public CppUnit::TestCase {
 		// Check that drivers can be switched without any crashes.
 		void testDriverSwitching();
 
+		// Check the statistics derived from the durations recorded by
+		// the ProcessProfiler.
+		void testProcessProfiler();
+
+		// Check saturation, rounding, and packing of the sample formats
+		// supported by the PcmConverter.
+		void testPcmConverter();
+
 	private:
 		int m_nPrevBufferSize;
 		H2Core::Preferences::AudioDriver m_prevAudioDriver;
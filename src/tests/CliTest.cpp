@@ -23,6 +23,8 @@
 #include "CliTest.h"
 
 #include <QFileInfo>
+#include <QLocalSocket>
+#include <QTest>
 
 #include "TestHelper.h"
 #include "assertions/File.h"
@@ -99,3 +101,124 @@ void CliTest::testKitToDrumkitMap() {
 
 	___INFOLOG( "passed" );
 }
+
+void CliTest::startDaemon( QProcess* pProcess, QLocalSocket* pSocket,
+						   const QString& sSocketPath ) {
+	QStringList args;
+	args << "-d" << "Null" << "--daemon" << sSocketPath;
+	pProcess->start( m_sCliPath, args );
+	CPPUNIT_ASSERT( pProcess->waitForStarted() );
+
+	// The socket is created once h2cli is done starting up.
+	for ( int ii = 0; ii < 100; ++ii ) {
+		pSocket->connectToServer( sSocketPath );
+		if ( pSocket->waitForConnected( 100 ) ) {
+			break;
+		}
+		QTest::qSleep( 100 );
+	}
+	CPPUNIT_ASSERT( pSocket->state() == QLocalSocket::ConnectedState );
+}
+
+void CliTest::testDaemon() {
+	___INFOLOG( "" );
+
+	const QString sSocketPath =
+		H2Core::Filesystem::tmp_dir() + "h2cli-test.sock";
+	QProcess process;
+	QLocalSocket socket;
+	startDaemon( &process, &socket, sSocketPath );
+
+	auto readLine = [&]() {
+		while ( ! socket.canReadLine() ) {
+			if ( ! socket.waitForReadyRead( 10000 ) ) {
+				return QString();
+			}
+		}
+		return QString::fromUtf8( socket.readLine() ).trimmed();
+	};
+	auto command = [&]( const QString& sCommand ) {
+		socket.write( ( sCommand + "\n" ).toUtf8() );
+		socket.waitForBytesWritten();
+		return readLine();
+	};
+
+	CPPUNIT_ASSERT( command( "stats" ).startsWith( "OK state=" ) );
+	CPPUNIT_ASSERT( command( "unknownCommand" ).startsWith( "ERR" ) );
+	CPPUNIT_ASSERT( command( "export" ).startsWith( "ERR usage" ) );
+	CPPUNIT_ASSERT( command( "export \"unterminated" ).startsWith( "ERR" ) );
+
+	// Jobs are acknowledged right away and their result is reported
+	// separately.
+	CPPUNIT_ASSERT( command( "load \"/nonexisting path/song.h2song\"" ) ==
+					"OK queued 1" );
+	CPPUNIT_ASSERT( readLine().startsWith( "FAILED 1" ) );
+	CPPUNIT_ASSERT( command( "stats" ).contains( "failed=1" ) );
+
+	CPPUNIT_ASSERT( command( "quit" ) == "OK" );
+	CPPUNIT_ASSERT( process.waitForFinished() );
+	CPPUNIT_ASSERT( process.exitCode() == 0 );
+	CPPUNIT_ASSERT( ! QFileInfo::exists( sSocketPath ) );
+
+	___INFOLOG( "passed" );
+}
+
+void CliTest::testDaemonExports() {
+	___INFOLOG( "" );
+
+	const QString sSocketPath =
+		H2Core::Filesystem::tmp_dir() + "h2cli-export-test.sock";
+	const QString sOutFile1 =
+		H2Core::Filesystem::tmp_dir() + "h2cli-export-1.wav";
+	const QString sOutFile2 =
+		H2Core::Filesystem::tmp_dir() + "h2cli-export-2.wav";
+	H2Core::Filesystem::rm( sOutFile1, false, true );
+	H2Core::Filesystem::rm( sOutFile2, false, true );
+
+	QProcess process;
+	QLocalSocket socket;
+	startDaemon( &process, &socket, sSocketPath );
+
+	// Exporting takes a while.
+	auto readLine = [&]() {
+		while ( ! socket.canReadLine() ) {
+			if ( ! socket.waitForReadyRead( 60000 ) ) {
+				return QString();
+			}
+		}
+		return QString::fromUtf8( socket.readLine() ).trimmed();
+	};
+
+	// Submitted in a single write to have them queued back to back.
+	socket.write( QString( "load \"%1\"\nexport \"%2\"\nexport \"%3\"\n" )
+				  .arg( H2TEST_FILE( "functional/test.h2song" ) )
+				  .arg( sOutFile1 ).arg( sOutFile2 ).toUtf8() );
+	socket.waitForBytesWritten();
+
+	QStringList lines;
+	for ( int ii = 0; ii < 6; ++ii ) {
+		lines << readLine();
+	}
+	CPPUNIT_ASSERT( lines.contains( "OK queued 1" ) );
+	CPPUNIT_ASSERT( lines.contains( "OK queued 2" ) );
+	CPPUNIT_ASSERT( lines.contains( "OK queued 3" ) );
+	CPPUNIT_ASSERT( lines.contains( "DONE 1" ) );
+	CPPUNIT_ASSERT( lines.contains( "DONE 2" ) );
+	CPPUNIT_ASSERT( lines.contains( "DONE 3" ) );
+	// Both exports are finished in the order they were submitted.
+	CPPUNIT_ASSERT( lines.indexOf( "DONE 2" ) < lines.indexOf( "DONE 3" ) );
+
+	CPPUNIT_ASSERT( QFileInfo( sOutFile1 ).size() > 0 );
+	CPPUNIT_ASSERT( QFileInfo( sOutFile2 ).size() > 0 );
+
+	socket.write( "quit\n" );
+	socket.waitForBytesWritten();
+	CPPUNIT_ASSERT( readLine() == "OK" );
+	CPPUNIT_ASSERT( process.waitForFinished() );
+	CPPUNIT_ASSERT( process.exitCode() == 0 );
+
+	H2Core::Filesystem::rm( sOutFile1 );
+	H2Core::Filesystem::rm( sOutFile2 );
+
+	___INFOLOG( "passed" );
+}
@@ -23,6 +23,8 @@
 #ifndef CLI_TEST_H
 #define CLI_TEST_H
 
+#include <QLocalSocket>
+#include <QProcess>
 #include <QString>
 
 #include <cppunit/extensions/HelperMacros.h>
@@ -30,6 +32,8 @@
 class CliTest : public CppUnit::TestCase {
 	CPPUNIT_TEST_SUITE(CliTest);
 	CPPUNIT_TEST(testKitToDrumkitMap);
+	CPPUNIT_TEST(testDaemon);
+	CPPUNIT_TEST(testDaemonExports);
 	CPPUNIT_TEST_SUITE_END();
 
 	public:
@@ -38,8 +42,18 @@ class CliTest : public CppUnit::TestCase {
 		 * when running the unit tests.*/
 		void setUp();
 		void testKitToDrumkitMap();
+		/** Talks to h2cli running in daemon mode via its control
+		 * socket. */
+		void testDaemon();
+		/** Submits two exports at once and checks that both are
+		 * reported and written. */
+		void testDaemonExports();
 
 	private:
+		/** Starts h2cli in daemon mode listening at @a sSocketPath
+		 * and connects @a pSocket to it. */
+		void startDaemon( QProcess* pProcess, QLocalSocket* pSocket,
+						  const QString& sSocketPath );
 		QString m_sCliPath;
 };
 
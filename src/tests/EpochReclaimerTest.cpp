@@ -0,0 +1,145 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <core/AudioEngine/EpochReclaimer.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+
+using namespace H2Core;
+
+class EpochReclaimerTest : public CppUnit::TestCase {
+	CPPUNIT_TEST_SUITE( EpochReclaimerTest );
+	CPPUNIT_TEST( testRetireOutsideOfCycle );
+	CPPUNIT_TEST( testRetireDuringCycle );
+	CPPUNIT_TEST( testPredicate );
+	CPPUNIT_TEST( testSynchronize );
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+
+	// Without a cycle in progress nobody can reach the object anymore.
+	void testRetireOutsideOfCycle() {
+		___INFOLOG( "" );
+		EpochReclaimer reclaimer;
+
+		auto pObject = std::make_shared<int>( 1 );
+		std::weak_ptr<int> pWeak = pObject;
+		reclaimer.retire( pObject );
+		pObject = nullptr;
+
+		CPPUNIT_ASSERT( reclaimer.reclaim() == 0 );
+		CPPUNIT_ASSERT( pWeak.expired() );
+		___INFOLOG( "passed" );
+	}
+
+	// An object retired while a reader is inside a cycle must survive
+	// until that reader left - no matter how often the reclaimer
+	// checks in between.
+	void testRetireDuringCycle() {
+		___INFOLOG( "" );
+		EpochReclaimer reclaimer;
+
+		auto pObject = std::make_shared<int>( 1 );
+		std::weak_ptr<int> pWeak = pObject;
+		std::atomic<bool> bReleased( false );
+
+		std::promise<void> entered;
+		std::promise<void> leave;
+		auto leaveFuture = leave.get_future();
+		std::thread reader( [&]() {
+			EpochReclaimer::Cycle cycle( &reclaimer );
+			entered.set_value();
+			leaveFuture.wait();
+		} );
+		entered.get_future().wait();
+
+		reclaimer.retire( pObject, nullptr, [&]() { bReleased = true; } );
+		pObject = nullptr;
+
+		CPPUNIT_ASSERT( reclaimer.reclaim() == 1 );
+		// Give the reclaimer thread a couple of chances as well.
+		std::this_thread::sleep_for( std::chrono::milliseconds(
+			5 * EpochReclaimer::nPollIntervalMs ) );
+		CPPUNIT_ASSERT( ! pWeak.expired() );
+		CPPUNIT_ASSERT( ! bReleased );
+		CPPUNIT_ASSERT( reclaimer.isRetired( pWeak.lock() ) );
+
+		leave.set_value();
+		reader.join();
+
+		CPPUNIT_ASSERT( reclaimer.reclaim() == 0 );
+		CPPUNIT_ASSERT( pWeak.expired() );
+		CPPUNIT_ASSERT( bReleased );
+		___INFOLOG( "passed" );
+	}
+
+	// Objects are kept as long as their predicate does not hold, even
+	// if all readers passed.
+	void testPredicate() {
+		___INFOLOG( "" );
+		EpochReclaimer reclaimer;
+
+		auto pObject = std::make_shared<int>( 1 );
+		std::weak_ptr<int> pWeak = pObject;
+		std::atomic<bool> bReleasable( false );
+		reclaimer.retire( pObject, [&]() { return bReleasable.load(); } );
+		pObject = nullptr;
+
+		CPPUNIT_ASSERT( reclaimer.reclaim() == 1 );
+		CPPUNIT_ASSERT( ! pWeak.expired() );
+
+		bReleasable = true;
+		CPPUNIT_ASSERT( reclaimer.reclaim() == 0 );
+		CPPUNIT_ASSERT( pWeak.expired() );
+		___INFOLOG( "passed" );
+	}
+
+	// synchronize() returns only after the cycle running at the time
+	// it was called has finished.
+	void testSynchronize() {
+		___INFOLOG( "" );
+		EpochReclaimer reclaimer;
+
+		// Nothing to wait for.
+		reclaimer.synchronize();
+
+		std::promise<void> entered;
+		std::atomic<bool> bLeft( false );
+		std::thread reader( [&]() {
+			EpochReclaimer::Cycle cycle( &reclaimer );
+			entered.set_value();
+			std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+			bLeft = true;
+		} );
+		entered.get_future().wait();
+
+		reclaimer.synchronize();
+		CPPUNIT_ASSERT( bLeft );
+
+		reader.join();
+		___INFOLOG( "passed" );
+	}
+};
@@ -27,9 +27,13 @@
 #include <core/Basics/Note.h>
 #include <core/IO/MidiCommon.h>
 #include <core/Preferences/Shortcuts.h>
+#include <core/Helpers/Random.h>
 #include <core/Helpers/Xml.h>
 #include <QDomDocument>
 
+#include <cmath>
+#include <vector>
+
 using namespace H2Core;
 
 class NoteTest : public CppUnit::TestCase {
@@ -38,6 +42,7 @@ class NoteTest : public CppUnit::TestCase {
 	CPPUNIT_TEST( testVirtualKeyboard );
 	CPPUNIT_TEST( testProbability );
 	CPPUNIT_TEST( testSerializeProbability );
+	CPPUNIT_TEST( testHumanizationRandom );
 	CPPUNIT_TEST_SUITE_END();
 
 	void testMidiDefaultOffset() {
@@ -100,5 +105,46 @@ class NoteTest : public CppUnit::TestCase {
 		delete pOut;
 	___INFOLOG( "passed" );
 	}
+
+	/** The random numbers used for humanization must follow the
+	 * requested distribution and be reproducible when seeded. */
+	void testHumanizationRandom()
+	{
+	___INFOLOG( "" );
+		const int nDraws = 100000;
+		const float fStandardDeviation = 0.3;
+
+		Random::setSeed( 42 );
+		std::vector<float> values( nDraws );
+		double fSum = 0;
+		double fSumSquares = 0;
+		for ( auto& ffValue : values ) {
+			ffValue = Random::getGaussian( fStandardDeviation );
+			fSum += ffValue;
+			fSumSquares += ffValue * ffValue;
+		}
+		const double fMean = fSum / nDraws;
+		const double fVariance = fSumSquares / nDraws - fMean * fMean;
+		CPPUNIT_ASSERT( std::abs( fMean ) < 0.01 );
+		CPPUNIT_ASSERT( std::abs( std::sqrt( fVariance ) - fStandardDeviation ) <
+						0.01 );
+
+		Random::setSeed( 42 );
+		for ( const auto& ffValue : values ) {
+			CPPUNIT_ASSERT_EQUAL( ffValue,
+								  Random::getGaussian( fStandardDeviation ) );
+		}
+
+		for ( int ii = 0; ii < nDraws; ++ii ) {
+			const float fUniform = Random::getUniform();
+			CPPUNIT_ASSERT( fUniform >= 0 && fUniform < 1 );
+			const int nInt = Random::getInt( 7 );
+			CPPUNIT_ASSERT( nInt >= 0 && nInt < 7 );
+		}
+
+		// Do not affect other tests.
+		Random::setSeed( 0 );
+	___INFOLOG( "passed" );
+	}
 };
 
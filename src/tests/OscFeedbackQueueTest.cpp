@@ -0,0 +1,70 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <core/OscFeedbackQueue.h>
+
+using namespace H2Core;
+
+class OscFeedbackQueueTest : public CppUnit::TestCase {
+	CPPUNIT_TEST_SUITE( OscFeedbackQueueTest );
+	CPPUNIT_TEST( testCoalescing );
+	CPPUNIT_TEST_SUITE_END();
+
+	typedef OscFeedbackQueue::Clock Clock;
+
+public:
+
+	// Changes of the same path within a window are merged and all
+	// paths are due at the end of the window.
+	void testCoalescing() {
+		___INFOLOG( "" );
+		OscFeedbackQueue queue;
+		CPPUNIT_ASSERT( queue.isEmpty() );
+
+		const auto start = Clock::now();
+		const auto window =
+			std::chrono::milliseconds( OscFeedbackQueue::nCoalescingWindowMs );
+		queue.push( "/Hydrogen/STRIP_VOLUME_ABSOLUTE/1", "a", start );
+		queue.push( "/Hydrogen/STRIP_VOLUME_ABSOLUTE/1", "b",
+					start + window / 4 );
+		queue.push( "/Hydrogen/MASTER_VOLUME_ABSOLUTE", "c", start + window / 2 );
+		CPPUNIT_ASSERT( ! queue.isEmpty() );
+		CPPUNIT_ASSERT( queue.nextDue() == start + window );
+
+		CPPUNIT_ASSERT( queue.takeDue( start + window / 2 ).empty() );
+
+		const auto messages = queue.takeDue( start + window );
+		CPPUNIT_ASSERT( messages.size() == 2 );
+		CPPUNIT_ASSERT( messages[ 0 ].sPath == "/Hydrogen/MASTER_VOLUME_ABSOLUTE" );
+		CPPUNIT_ASSERT( messages[ 0 ].data == "c" );
+		CPPUNIT_ASSERT( messages[ 1 ].sPath == "/Hydrogen/STRIP_VOLUME_ABSOLUTE/1" );
+		CPPUNIT_ASSERT( messages[ 1 ].data == "b" );
+		CPPUNIT_ASSERT( queue.isEmpty() );
+
+		// A new window is opened by the next change.
+		const auto later = start + 10 * window;
+		queue.push( "/Hydrogen/MASTER_VOLUME_ABSOLUTE", "d", later );
+		CPPUNIT_ASSERT( queue.nextDue() == later + window );
+		___INFOLOG( "passed" );
+	}
+};
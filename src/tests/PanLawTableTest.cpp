@@ -0,0 +1,74 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2002-2008 by Alex >Comix< Cominu [comix@users.sourceforge.net]
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <core/Sampler/PanLawTable.h>
+#include <core/Sampler/Sampler.h>
+
+#include "TestHelper.h"
+
+#include <cmath>
+
+using namespace H2Core;
+
+/** Checks the lookup table against the exact pan laws of the
+ * Sampler. */
+class PanLawTableTest : public CppUnit::TestCase {
+	CPPUNIT_TEST_SUITE( PanLawTableTest );
+	CPPUNIT_TEST( testPanLawTable );
+	CPPUNIT_TEST_SUITE_END();
+
+	void testPanLawTable()
+	{
+	___INFOLOG( "" );
+		PanLawTable table;
+		table.update( Sampler::QUADRATIC_CONST_K_NORM, 2 );
+		for ( int nType = Sampler::RATIO_STRAIGHT_POLYGONAL;
+			  nType <= Sampler::QUADRATIC_CONST_K_NORM; ++nType ) {
+			for ( const float fKNorm : { Sampler::K_NORM_DEFAULT, 2.f } ) {
+				const int nVersion = table.getVersion();
+				table.update( nType, fKNorm );
+				CPPUNIT_ASSERT( table.getVersion() != nVersion );
+
+				// Exact at center and both hard pans.
+				for ( const float fPan : { -1.f, 0.f, 1.f } ) {
+					CPPUNIT_ASSERT( table.gain( fPan ) ==
+									Sampler::computePanLaw( fPan, nType, fKNorm ) );
+				}
+
+				for ( int ii = 0; ii <= 10000; ++ii ) {
+					const float fPan = -1 + 2 * static_cast<float>(ii) / 10000;
+					CPPUNIT_ASSERT( std::abs(
+						table.gain( fPan ) -
+						Sampler::computePanLaw( fPan, nType, fKNorm ) ) < 0.006 );
+				}
+			}
+		}
+
+		// Same settings do not refill the table.
+		const int nVersion = table.getVersion();
+		CPPUNIT_ASSERT( ! table.update( Sampler::QUADRATIC_CONST_K_NORM, 2 ) );
+		CPPUNIT_ASSERT( table.getVersion() == nVersion );
+	___INFOLOG( "passed" );
+	}
+};
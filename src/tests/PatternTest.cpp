@@ -24,6 +24,8 @@
 
 #include <core/AudioEngine/AudioEngine.h>
 #include <core/Basics/Pattern.h>
+#include <core/Basics/PatternList.h>
+#include <core/Basics/Song.h>
 
 using namespace H2Core;
 
@@ -43,3 +45,36 @@ void PatternTest::testPurgeInstrument()
 	delete pPattern;
 	___INFOLOG( "passed" );
 }
+
+void PatternTest::testPatternSequence()
+{
+	___INFOLOG( "" );
+	auto pSong = Song::getEmptySong();
+	auto pPatternList = pSong->getPatternList();
+	auto pColumns = pSong->getPatternGroupVector();
+
+	auto pColumn = new PatternList();
+	pColumn->add( pPatternList->get( 1 ) );
+	pColumn->add( pPatternList->get( 2 ) );
+	pColumns->push_back( pColumn );
+	pPatternList->get( 3 )->virtual_patterns_add( pPatternList->get( 4 ) );
+
+	const auto pSequence = pSong->getPatternSequence();
+	CPPUNIT_ASSERT( pSequence->columns.size() == 2 );
+	CPPUNIT_ASSERT( *pSequence->columns[ 1 ] == std::vector<int>( { 1, 2 } ) );
+	CPPUNIT_ASSERT( pSequence->virtualPatterns[ 3 ] == std::vector<int>( { 4 } ) );
+
+	// Unchanged columns are shared with the previous snapshot.
+	pColumns->at( 0 )->add( pPatternList->get( 5 ) );
+	const auto pModified = pSong->getPatternSequence();
+	CPPUNIT_ASSERT( pModified->columns[ 0 ] != pSequence->columns[ 0 ] );
+	CPPUNIT_ASSERT( pModified->columns[ 1 ] == pSequence->columns[ 1 ] );
+
+	pSong->setPatternSequence( *pSequence );
+	CPPUNIT_ASSERT( pColumns->size() == 2 );
+	CPPUNIT_ASSERT( pColumns->at( 0 )->size() == 1 );
+	CPPUNIT_ASSERT( pColumns->at( 1 )->get( 1 ) == pPatternList->get( 2 ) );
+	CPPUNIT_ASSERT( pPatternList->get( 3 )->get_virtual_patterns()->size() == 1 );
+	CPPUNIT_ASSERT( pPatternList->size() == 10 );
+	___INFOLOG( "passed" );
+}
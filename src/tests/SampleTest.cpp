@@ -23,11 +23,34 @@
 #include "PatternTest.h"
 #include "TestHelper.h"
 
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/AudioEngine/EpochReclaimer.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentComponent.h>
+#include <core/Basics/InstrumentLayer.h>
+#include <core/Basics/Note.h>
+#include <core/Basics/PeakPyramid.h>
 #include <core/Basics/Sample.h>
+#include <core/Hydrogen.h>
+#include <core/Helpers/Xml.h>
+#include <core/Sampler/Sampler.h>
+#include <core/Sampler/SampleRateConverter.h>
+#include <core/Sampler/SincInterpolator.h>
+#include <core/Sampler/TimeStretcher.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 class SampleTest : public CppUnit::TestCase {
 	CPPUNIT_TEST_SUITE( SampleTest );
 	CPPUNIT_TEST( testLoadInvalidSample );
+	CPPUNIT_TEST( testTimeStretcherCache );
+	CPPUNIT_TEST( testRetireStretchedVariant );
+	CPPUNIT_TEST( testSampleRateConversion );
+	CPPUNIT_TEST( testSincInterpolation );
+	CPPUNIT_TEST( testTailPeaks );
+	CPPUNIT_TEST( testPeakPyramid );
 
 	CPPUNIT_TEST_SUITE_END();
 
@@ -47,4 +70,316 @@ class SampleTest : public CppUnit::TestCase {
 		CPPUNIT_ASSERT(pSample == nullptr);
 	___INFOLOG( "passed" );
 	}
+
+	void testTimeStretcherCache()
+	{
+	___INFOLOG( "" );
+		auto pTimeStretcher =
+			H2Core::Hydrogen::get_instance()->getAudioEngine()->getTimeStretcher();
+		const auto nOldLimit = pTimeStretcher->getMemoryLimit();
+		pTimeStretcher->clear();
+
+		auto pKick = H2Core::Sample::load( H2TEST_FILE( "drumkits/baseKit/kick.wav" ) );
+		auto pSnare = H2Core::Sample::load( H2TEST_FILE( "drumkits/baseKit/snare.wav" ) );
+		CPPUNIT_ASSERT( pKick != nullptr );
+		CPPUNIT_ASSERT( pSnare != nullptr );
+
+		// Variants are cached per tempo. Each caller gets a copy of its
+		// own.
+		auto pKick120 = pTimeStretcher->stretch( pKick, 120 );
+		CPPUNIT_ASSERT( pKick120 != nullptr );
+		CPPUNIT_ASSERT( pKick120 != pKick );
+		CPPUNIT_ASSERT( pKick120->get_frames() == pKick->get_frames() );
+		CPPUNIT_ASSERT( pTimeStretcher->isCached( pKick, 120 ) );
+		auto pKick120Copy = pTimeStretcher->stretch( pKick, 120 );
+		CPPUNIT_ASSERT( pKick120Copy != pKick120 );
+		CPPUNIT_ASSERT( pKick120Copy->get_data_l() != pKick120->get_data_l() );
+		CPPUNIT_ASSERT( std::equal( pKick120->get_data_l(),
+									pKick120->get_data_l() + pKick120->get_frames(),
+									pKick120Copy->get_data_l() ) );
+		CPPUNIT_ASSERT( pTimeStretcher->stretch( pKick120, 120 ) != nullptr );
+		CPPUNIT_ASSERT( pTimeStretcher->getCacheSize() == 1 );
+		auto pKick130 = pTimeStretcher->stretch( pKick, 130 );
+		CPPUNIT_ASSERT( pKick130 != nullptr );
+		CPPUNIT_ASSERT( pTimeStretcher->getCacheSize() == 2 );
+		CPPUNIT_ASSERT( pTimeStretcher->getMemoryUsage() ==
+						4 * pKick->get_frames() * sizeof( float ) );
+
+		// Unloading a handed out variant does not affect the cache.
+		pKick130->unload();
+		CPPUNIT_ASSERT( pTimeStretcher->isCached( pKick, 130 ) );
+		auto pKick130Copy = pTimeStretcher->stretch( pKick, 130 );
+		CPPUNIT_ASSERT( pKick130Copy->isLoaded() );
+		CPPUNIT_ASSERT( pKick130Copy->get_frames() == pKick->get_frames() );
+
+		// Least recently used variants are evicted first.
+		pTimeStretcher->stretch( pKick, 120 );
+		pTimeStretcher->setMemoryLimit(
+			2 * ( pKick->get_frames() + pSnare->get_frames() ) * sizeof( float ) );
+		pTimeStretcher->stretch( pSnare, 120 );
+		CPPUNIT_ASSERT( pTimeStretcher->getCacheSize() == 2 );
+		CPPUNIT_ASSERT( pTimeStretcher->isCached( pKick, 120 ) );
+		CPPUNIT_ASSERT( ! pTimeStretcher->isCached( pKick, 130 ) );
+
+		pTimeStretcher->setMemoryLimit( nOldLimit );
+		pTimeStretcher->clear();
+	___INFOLOG( "passed" );
+	}
+
+	// Retiring an instrument unloads the samples of its layers. Other
+	// instruments using the same stretched variant must keep playing.
+	void testRetireStretchedVariant()
+	{
+	___INFOLOG( "" );
+		auto pHydrogen = H2Core::Hydrogen::get_instance();
+		auto pAudioEngine = pHydrogen->getAudioEngine();
+		auto pTimeStretcher = pAudioEngine->getTimeStretcher();
+		pTimeStretcher->clear();
+
+		auto pKick = H2Core::Sample::load( H2TEST_FILE( "drumkits/baseKit/kick.wav" ) );
+		CPPUNIT_ASSERT( pKick != nullptr );
+
+		// Layers are set up the same way Drumkit::recalculateRubberband()
+		// and the workers of the TimeStretcher do.
+		auto createInstrument = [&]( int nId ) {
+			auto pInstrument = std::make_shared<H2Core::Instrument>(
+				nId, QString( "stretched %1" ).arg( nId ) );
+			auto pComponent = std::make_shared<H2Core::InstrumentComponent>();
+			pComponent->setLayer( std::make_shared<H2Core::InstrumentLayer>(
+									  pTimeStretcher->stretch( pKick, 120 ) ), 0 );
+			pInstrument->addComponent( pComponent );
+			return pInstrument;
+		};
+		auto pRetired = createInstrument( 0 );
+		auto pPlayed = createInstrument( 1 );
+		CPPUNIT_ASSERT( pTimeStretcher->getCacheSize() == 1 );
+
+		auto getSample = []( std::shared_ptr<H2Core::Instrument> pInstrument ) {
+			return pInstrument->get_component( 0 )->getLayer( 0 )->get_sample();
+		};
+
+		pHydrogen->retireInstrument( pRetired );
+		CPPUNIT_ASSERT( pAudioEngine->getReclaimer()->reclaim() == 0 );
+		CPPUNIT_ASSERT( ! getSample( pRetired )->isLoaded() );
+		CPPUNIT_ASSERT( getSample( pPlayed )->isLoaded() );
+		CPPUNIT_ASSERT( getSample( pPlayed )->get_data_l() != nullptr );
+
+		pAudioEngine->lock( RIGHT_HERE );
+		auto pSampler = pAudioEngine->getSampler();
+		const int nBufferSize = pAudioEngine->getAudioDriver()->getBufferSize();
+		pSampler->noteOn( new H2Core::Note( pPlayed, 0, 1.0 ) );
+		pSampler->process( nBufferSize );
+		float fPeak = 0;
+		for ( int ii = 0; ii < nBufferSize; ++ii ) {
+			fPeak = std::max( fPeak, std::abs( pSampler->m_pMainOut_L[ ii ] ) );
+		}
+		pSampler->stopPlayingNotes();
+		pAudioEngine->unlock();
+		CPPUNIT_ASSERT( fPeak > 0 );
+
+		pTimeStretcher->clear();
+	___INFOLOG( "passed" );
+	}
+
+	void testSampleRateConversion()
+	{
+	___INFOLOG( "" );
+		// A sine well below both Nyquist frequencies has to survive the
+		// conversion in both directions.
+		for ( const auto& [ nInputRate, nOutputRate ] :
+				  std::vector<std::pair<int,int>>{ { 44100, 48000 },
+												   { 48000, 44100 },
+												   { 44100, 47999 } } ) {
+			H2Core::SampleRateConverter converter( nInputRate, nOutputRate );
+			const int nInputFrames = nInputRate / 2;
+			const int nOutputFrames = converter.getOutputFrames( nInputFrames );
+			CPPUNIT_ASSERT( nOutputFrames == nOutputRate / 2 );
+
+			std::vector<float> input( nInputFrames );
+			for ( int ii = 0; ii < nInputFrames; ++ii ) {
+				input[ ii ] = std::sin( 2 * M_PI * 1000.0 * ii / nInputRate );
+			}
+			std::vector<float> output( nOutputFrames );
+			converter.process( input.data(), nInputFrames, output.data() );
+
+			// Edges are affected by the zero-padding.
+			for ( int ii = 1000; ii < nOutputFrames - 1000; ++ii ) {
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(
+					std::sin( 2 * M_PI * 1000.0 * ii / nOutputRate ),
+					output[ ii ], 1e-4 );
+			}
+		}
+
+		// Samples are converted while loading.
+		const QString sPath = H2TEST_FILE( "drumkits/baseKit/kick.wav" );
+		auto pNative = H2Core::Sample::load( sPath );
+		CPPUNIT_ASSERT( pNative != nullptr );
+		const int nTargetRate = pNative->get_sample_rate() == 48000 ? 44100 : 48000;
+
+		H2Core::Sample::setTargetSampleRate( nTargetRate );
+		auto pConverted = H2Core::Sample::load( sPath );
+		// Editors of loops and envelopes work with native frames.
+		auto pUnconverted = H2Core::Sample::load( sPath, H2Core::License(), false );
+		H2Core::Sample::setTargetSampleRate( 0 );
+
+		CPPUNIT_ASSERT( pUnconverted != nullptr );
+		CPPUNIT_ASSERT( pUnconverted->get_sample_rate() == pNative->get_sample_rate() );
+		CPPUNIT_ASSERT( pUnconverted->get_frames() == pNative->get_frames() );
+
+		CPPUNIT_ASSERT( pConverted != nullptr );
+		CPPUNIT_ASSERT( pConverted->get_sample_rate() == nTargetRate );
+		CPPUNIT_ASSERT( pConverted->get_frames() ==
+						H2Core::SampleRateConverter( pNative->get_sample_rate(),
+													 nTargetRate )
+						.getOutputFrames( pNative->get_frames() ) );
+	___INFOLOG( "passed" );
+	}
+
+	void testSincInterpolation()
+	{
+	___INFOLOG( "" );
+		H2Core::SincInterpolator interpolator;
+		const int nSampleRate = 44100;
+		const int nSampleFrames = nSampleRate / 2;
+
+		auto render = [&]( double fFrequency, float fStep, double* pMaxError ) {
+			std::vector<float> sample( nSampleFrames );
+			for ( int ii = 0; ii < nSampleFrames; ++ii ) {
+				sample[ ii ] = std::sin( 2 * M_PI * fFrequency * ii / nSampleRate );
+			}
+			const int nFrames = static_cast<int>( nSampleFrames / fStep );
+			std::vector<float> buffer_L( nFrames ), buffer_R( nFrames );
+			double fSamplePos = 0;
+			interpolator.resample( buffer_L.data(), buffer_R.data(),
+								   sample.data(), sample.data(), nFrames,
+								   fSamplePos, fStep, nSampleFrames );
+			CPPUNIT_ASSERT_DOUBLES_EQUAL( nFrames * fStep, fSamplePos, 1e-2 );
+
+			// Root mean square of the output and the maximum deviation
+			// from the expected sine. The edges are affected by the
+			// silence surrounding the sample.
+			double fSum = 0;
+			*pMaxError = 0;
+			int nCount = 0;
+			for ( int ii = 200; ii < nFrames - 200; ++ii ) {
+				const double fExpected =
+					std::sin( 2 * M_PI * fFrequency * ii * fStep / nSampleRate );
+				*pMaxError = std::max( *pMaxError,
+									   std::abs( buffer_L[ ii ] - fExpected ) );
+				CPPUNIT_ASSERT( buffer_L[ ii ] == buffer_R[ ii ] );
+				fSum += buffer_L[ ii ] * buffer_L[ ii ];
+				++nCount;
+			}
+			return std::sqrt( fSum / nCount );
+		};
+
+		double fMaxError;
+		for ( const float fStep : { 0.5f, 0.91875f, 1.5f, 3.0f } ) {
+			render( 1000, fStep, &fMaxError );
+			CPPUNIT_ASSERT( fMaxError < 1e-3 );
+		}
+
+		// Pitching up a 15kHz tone by an octave must not fold it back
+		// into the audible range.
+		CPPUNIT_ASSERT( render( 15000, 2, &fMaxError ) < 1e-3 );
+
+		// Interpolation mode of an instrument survives serialization.
+		auto pInstrument = std::make_shared<H2Core::Instrument>( 1, "Cymbal" );
+		CPPUNIT_ASSERT( ! pInstrument->hasCustomInterpolateMode() );
+		pInstrument->setInterpolateMode( H2Core::Interpolation::InterpolateMode::Sinc );
+
+		H2Core::XMLDoc doc;
+		H2Core::XMLNode root = doc.set_root( "instrumentList" );
+		pInstrument->save_to( root );
+		auto pLoaded = H2Core::Instrument::load_from(
+			root.firstChildElement( "instrument" ) );
+		CPPUNIT_ASSERT( pLoaded != nullptr );
+		CPPUNIT_ASSERT( pLoaded->hasCustomInterpolateMode() );
+		CPPUNIT_ASSERT( pLoaded->getInterpolateMode() ==
+						H2Core::Interpolation::InterpolateMode::Sinc );
+	___INFOLOG( "passed" );
+	}
+
+	void testTailPeaks()
+	{
+	___INFOLOG( "" );
+		auto pSample = H2Core::Sample::load( H2TEST_FILE( "drumkits/baseKit/crash.wav" ) );
+		CPPUNIT_ASSERT( pSample != nullptr );
+		const int nFrames = pSample->get_frames();
+		const float* pData_L = pSample->get_data_l();
+		const float* pData_R = pSample->get_data_r();
+
+		// The bound holds for every frame and decreases towards the end.
+		float fPeak = 0;
+		float fLastBound = pSample->getTailPeak( nFrames - 1 );
+		for ( int ii = nFrames - 1; ii >= 0; --ii ) {
+			fPeak = std::max( fPeak, std::max( std::abs( pData_L[ ii ] ),
+											   std::abs( pData_R[ ii ] ) ) );
+			const float fBound = pSample->getTailPeak( ii );
+			CPPUNIT_ASSERT( fBound >= fPeak );
+			CPPUNIT_ASSERT( fBound >= fLastBound );
+			fLastBound = fBound;
+		}
+		CPPUNIT_ASSERT( pSample->getTailPeak( 0 ) == fPeak );
+		CPPUNIT_ASSERT( pSample->getTailPeak( nFrames ) == 0 );
+		CPPUNIT_ASSERT( pSample->getTailPeak(
+							nFrames + H2Core::Sample::nTailBlockSize ) == 0 );
+
+		pSample->unload();
+		CPPUNIT_ASSERT( pSample->getTailPeak( 0 ) == 0 );
+	___INFOLOG( "passed" );
+	}
+
+	void testPeakPyramid()
+	{
+	___INFOLOG( "" );
+		using H2Core::PeakPyramid;
+		auto pSample = H2Core::Sample::load( H2TEST_FILE( "drumkits/baseKit/crash.wav" ) );
+		CPPUNIT_ASSERT( pSample != nullptr );
+		const int nFrames = pSample->get_frames();
+
+		// The pyramid only widens the pixels to the blocks of the level
+		// it is read from. Peaks are thus never missed.
+		for ( const double fFramesPerPixel : { 1.0, 37.0, 200.0, 1000.5 } ) {
+			for ( const auto channel : { PeakPyramid::Channel::Left,
+										 PeakPyramid::Channel::Right,
+										 PeakPyramid::Channel::Both } ) {
+				const int nPixels =
+					static_cast<int>( std::ceil( nFrames / fFramesPerPixel ) ) + 2;
+				std::vector<PeakPyramid::Peak> peaks( nPixels );
+				std::vector<PeakPyramid::Peak> exactPeaks( nPixels );
+				pSample->getPeaks( channel, 3, fFramesPerPixel, nPixels,
+								   peaks.data() );
+				PeakPyramid::computePeaks( pSample->get_data_l(),
+										   pSample->get_data_r(), nFrames,
+										   channel, 3, fFramesPerPixel, nPixels,
+										   exactPeaks.data() );
+				for ( int ii = 0; ii < nPixels; ++ii ) {
+					CPPUNIT_ASSERT( peaks[ ii ].fMax >= exactPeaks[ ii ].fMax );
+					CPPUNIT_ASSERT( peaks[ ii ].fMin <= exactPeaks[ ii ].fMin );
+					CPPUNIT_ASSERT( peaks[ ii ].fRms >= 0 );
+				}
+				// Beyond the end of the sample.
+				CPPUNIT_ASSERT( peaks[ nPixels - 1 ].fMax == 0 );
+				CPPUNIT_ASSERT( peaks[ nPixels - 1 ].fMin == 0 );
+			}
+		}
+
+		// A single pixel covering the whole sample.
+		PeakPyramid::Peak peak, exactPeak;
+		pSample->getPeaks( PeakPyramid::Channel::Both, 0, nFrames, 1, &peak );
+		PeakPyramid::computePeaks( pSample->get_data_l(), pSample->get_data_r(),
+								   nFrames, PeakPyramid::Channel::Both, 0,
+								   nFrames, 1, &exactPeak );
+		CPPUNIT_ASSERT( peak.fMax == exactPeak.fMax );
+		CPPUNIT_ASSERT( peak.fMin == exactPeak.fMin );
+		CPPUNIT_ASSERT( std::abs( peak.fRms - exactPeak.fRms ) < 1e-4 );
+
+		// Copies share the pyramid.
+		auto pCopy = std::make_shared<H2Core::Sample>( pSample );
+		PeakPyramid::Peak copyPeak;
+		pCopy->getPeaks( PeakPyramid::Channel::Both, 0, nFrames, 1, &copyPeak );
+		CPPUNIT_ASSERT( copyPeak.fMax == peak.fMax );
+	___INFOLOG( "passed" );
+	}
 };
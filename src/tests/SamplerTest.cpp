@@ -0,0 +1,316 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2002-2008 by Alex >Comix< Cominu [comix@users.sourceforge.net]
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <core/AudioEngine/AudioEngine.h>
+#include <core/Basics/Adsr.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentComponent.h>
+#include <core/Basics/InstrumentLayer.h>
+#include <core/Basics/Note.h>
+#include <core/Basics/Sample.h>
+#include <core/Hydrogen.h>
+#include <core/IO/AudioOutput.h>
+#include <core/Sampler/ResonantFilter.h>
+#include <core/Sampler/Sampler.h>
+
+#include "TestHelper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace H2Core;
+
+/** Checks the polyphony limits, choke groups, and rendering of the
+ * Sampler. */
+class SamplerTest : public CppUnit::TestCase {
+	CPPUNIT_TEST_SUITE( SamplerTest );
+	CPPUNIT_TEST( testVoiceLimit );
+	CPPUNIT_TEST( testVoiceStealing );
+	CPPUNIT_TEST( testChokeGroup );
+	CPPUNIT_TEST( testFusedRendering );
+	CPPUNIT_TEST_SUITE_END();
+
+	std::shared_ptr<Instrument> createInstrument( int nId ) {
+		auto pInstrument = std::make_shared<Instrument>(
+			nId, QString( "voice test %1" ).arg( nId ) );
+		pInstrument->addComponent( std::make_shared<InstrumentComponent>() );
+		return pInstrument;
+	}
+
+	/** Whether @a pNote was stolen and is released. */
+	bool isFadingOut( Note* pNote ) {
+		return pNote->isStolen() &&
+			pNote->get_adsr()->getState() == ADSR::State::Release;
+	}
+
+public:
+	void tearDown() override {
+		auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+		pAudioEngine->lock( RIGHT_HERE );
+		pAudioEngine->getSampler()->stopPlayingNotes();
+		pAudioEngine->unlock();
+	}
+
+	void testVoiceLimit() {
+		___INFOLOG( "" );
+		auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+		auto pSampler = pAudioEngine->getSampler();
+		auto pInstrument = createInstrument( 0 );
+		pInstrument->setMaxVoices( 2 );
+		auto pUnlimited = createInstrument( 1 );
+
+		pAudioEngine->lock( RIGHT_HERE );
+		const int nVoicesBefore = pSampler->getVoices();
+
+		std::vector<Note*> notes;
+		for ( int ii = 0; ii < 4; ++ii ) {
+			notes.push_back( new Note( pInstrument, 0, 0.8 ) );
+			pSampler->noteOn( notes.back() );
+			pSampler->noteOn( new Note( pUnlimited, 0, 0.8 ) );
+		}
+
+		// Stolen voices keep playing till they are faded out but do
+		// not count towards the limit anymore.
+		CPPUNIT_ASSERT( pInstrument->getVoices() == 2 );
+		CPPUNIT_ASSERT( pUnlimited->getVoices() == 4 );
+		CPPUNIT_ASSERT( pSampler->getPlayingNotesNumber() == 8 );
+		CPPUNIT_ASSERT( pSampler->getVoices() == nVoicesBefore + 6 );
+		CPPUNIT_ASSERT( isFadingOut( notes[ 0 ] ) );
+		CPPUNIT_ASSERT( isFadingOut( notes[ 1 ] ) );
+		// Without using the release of the instrument.
+		CPPUNIT_ASSERT( notes[ 0 ]->get_adsr()->getRelease() <
+						pInstrument->get_adsr()->getRelease() );
+		CPPUNIT_ASSERT( ! notes[ 2 ]->isStolen() );
+		CPPUNIT_ASSERT( ! notes[ 3 ]->isStolen() );
+		for ( const auto& ppNote : pSampler->getPlayingNotesQueue() ) {
+			if ( ppNote->get_instrument() == pUnlimited ) {
+				CPPUNIT_ASSERT( ! ppNote->isStolen() );
+			}
+		}
+
+		pSampler->stopPlayingNotes( pInstrument );
+		CPPUNIT_ASSERT( pInstrument->getVoices() == 0 );
+		CPPUNIT_ASSERT( pSampler->getVoices() == nVoicesBefore + 4 );
+		pAudioEngine->unlock();
+		___INFOLOG( "passed" );
+	}
+
+	void testVoiceStealing() {
+		___INFOLOG( "" );
+		auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+		auto pSampler = pAudioEngine->getSampler();
+
+		// For all policies the same notes are started:
+		// - the oldest one,
+		// - the loudest one in terms of velocity but already deep
+		//   within its release, and
+		// - the one with the lowest velocity.
+		const std::vector<std::pair<Instrument::VoiceStealing, size_t>> policies{
+			{ Instrument::VoiceStealing::Oldest, 0 },
+			{ Instrument::VoiceStealing::Quietest, 1 },
+			{ Instrument::VoiceStealing::LowestVelocity, 2 } };
+
+		for ( const auto& [ voiceStealing, nVictim ] : policies ) {
+			auto pInstrument = createInstrument( 0 );
+			pInstrument->setMaxVoices( 3 );
+			pInstrument->setVoiceStealing( voiceStealing );
+
+			pAudioEngine->lock( RIGHT_HERE );
+			std::vector<Note*> notes{ new Note( pInstrument, 0, 0.8 ),
+									  new Note( pInstrument, 0, 1.0 ),
+									  new Note( pInstrument, 0, 0.5 ) };
+			for ( const auto& ppNote : notes ) {
+				pSampler->noteOn( ppNote );
+			}
+
+			// Render most of the release of the second note.
+			auto pAdsr = notes[ 1 ]->get_adsr();
+			pAdsr->release();
+			std::vector<float> buffer_L( pAdsr->getRelease() * 9 / 10, 1.0 );
+			std::vector<float> buffer_R( buffer_L.size(), 1.0 );
+			pAdsr->applyADSR( buffer_L.data(), buffer_R.data(), buffer_L.size(),
+							  buffer_L.size(), 1.0 );
+			notes[ 1 ]->get_layer_selected( 0 )->fSamplePosition = buffer_L.size();
+			CPPUNIT_ASSERT( pAdsr->getValue() * notes[ 1 ]->get_velocity() <
+							notes[ 2 ]->get_velocity() );
+
+			pSampler->noteOn( new Note( pInstrument, 0, 0.8 ) );
+
+			for ( size_t ii = 0; ii < notes.size(); ++ii ) {
+				if ( ii == nVictim ) {
+					CPPUNIT_ASSERT_MESSAGE(
+						Instrument::VoiceStealingToQString( voiceStealing ).toStdString(),
+						isFadingOut( notes[ ii ] ) );
+				} else {
+					CPPUNIT_ASSERT_MESSAGE(
+						Instrument::VoiceStealingToQString( voiceStealing ).toStdString(),
+						! notes[ ii ]->isStolen() );
+				}
+			}
+			CPPUNIT_ASSERT( pInstrument->getVoices() == 3 );
+
+			pSampler->stopPlayingNotes();
+			pAudioEngine->unlock();
+		}
+		___INFOLOG( "passed" );
+	}
+
+	void testChokeGroup() {
+		___INFOLOG( "" );
+		auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+		auto pSampler = pAudioEngine->getSampler();
+
+		auto pOpenHiHat = createInstrument( 0 );
+		pOpenHiHat->setChokeGroup( 1 );
+		auto pClosedHiHat = createInstrument( 1 );
+		pClosedHiHat->setChokeGroup( 1 );
+		auto pCrash = createInstrument( 2 );
+		pCrash->setChokeGroup( 2 );
+		auto pKick = createInstrument( 3 );
+
+		pAudioEngine->lock( RIGHT_HERE );
+		auto pOpen = new Note( pOpenHiHat, 0, 0.8 );
+		auto pCrashNote = new Note( pCrash, 0, 0.8 );
+		auto pKickNote = new Note( pKick, 0, 0.8 );
+		auto pClosed = new Note( pClosedHiHat, 0, 0.8 );
+		pSampler->noteOn( pOpen );
+		pSampler->noteOn( pCrashNote );
+		pSampler->noteOn( pKickNote );
+		pSampler->noteOn( pClosed );
+
+		// Only other instruments of the same group are cut off.
+		CPPUNIT_ASSERT( isFadingOut( pOpen ) );
+		CPPUNIT_ASSERT( pOpenHiHat->getVoices() == 0 );
+		CPPUNIT_ASSERT( ! pCrashNote->isStolen() );
+		CPPUNIT_ASSERT( ! pKickNote->isStolen() );
+		CPPUNIT_ASSERT( ! pClosed->isStolen() );
+
+		// Notes of the same instrument do not choke each other.
+		auto pClosedAgain = new Note( pClosedHiHat, 0, 0.8 );
+		pSampler->noteOn( pClosedAgain );
+		CPPUNIT_ASSERT( ! pClosed->isStolen() );
+		CPPUNIT_ASSERT( pClosedHiHat->getVoices() == 2 );
+
+		// And the other way around.
+		pSampler->noteOn( new Note( pOpenHiHat, 0, 0.8 ) );
+		CPPUNIT_ASSERT( isFadingOut( pClosed ) );
+		CPPUNIT_ASSERT( isFadingOut( pClosedAgain ) );
+		CPPUNIT_ASSERT( pClosedHiHat->getVoices() == 0 );
+		CPPUNIT_ASSERT( pOpenHiHat->getVoices() == 1 );
+		pAudioEngine->unlock();
+		___INFOLOG( "passed" );
+	}
+
+	/** Sampler::renderVoice() resamples, envelopes, filters, and mixes
+	 * a voice block by block. The result must not differ from doing
+	 * each stage on the whole buffer one after another. */
+	void testFusedRendering() {
+		___INFOLOG( "" );
+		auto pAudioEngine = Hydrogen::get_instance()->getAudioEngine();
+		auto pSampler = pAudioEngine->getSampler();
+		const int nBufferSize = pAudioEngine->getAudioDriver()->getBufferSize();
+		const int nSampleRate = pAudioEngine->getAudioDriver()->getSampleRate();
+
+		// Matching the rate of the driver the sample is copied
+		// without interpolation.
+		const int nOldTargetRate = Sample::getTargetSampleRate();
+		Sample::setTargetSampleRate( nSampleRate );
+		auto pSample = Sample::load( H2TEST_FILE( "drumkits/baseKit/kick.wav" ) );
+		Sample::setTargetSampleRate( nOldTargetRate );
+		CPPUNIT_ASSERT( pSample != nullptr );
+		CPPUNIT_ASSERT( pSample->get_sample_rate() == nSampleRate );
+
+		// Stages spanning several blocks and process cycles.
+		auto pInstrument = createInstrument( 0 );
+		pInstrument->get_component( 0 )->setLayer(
+			std::make_shared<InstrumentLayer>( pSample ), 0 );
+		pInstrument->set_adsr( std::make_shared<ADSR>( 100, 300, 0.5, 1000 ) );
+		pInstrument->set_filter_active( true );
+		pInstrument->set_filter_cutoff( 0.3 );
+		pInstrument->set_filter_resonance( 0.6 );
+
+		const int nCycles = std::min( 4, pSample->get_frames() / nBufferSize );
+		CPPUNIT_ASSERT( nCycles > 0 );
+		const int nFrames = nCycles * nBufferSize;
+
+		std::vector<float> fused_L, fused_R;
+		pAudioEngine->lock( RIGHT_HERE );
+		pSampler->noteOn( new Note( pInstrument, 0, 1.0 ) );
+		for ( int nCycle = 0; nCycle < nCycles; ++nCycle ) {
+			pSampler->process( nBufferSize );
+			fused_L.insert( fused_L.end(), pSampler->m_pMainOut_L,
+							pSampler->m_pMainOut_L + nBufferSize );
+			fused_R.insert( fused_R.end(), pSampler->m_pMainOut_R,
+							pSampler->m_pMainOut_R + nBufferSize );
+		}
+		pSampler->stopPlayingNotes();
+		pAudioEngine->unlock();
+
+		// Unfused reference.
+		std::vector<float> reference_L( pSample->get_data_l(),
+										pSample->get_data_l() + nFrames );
+		std::vector<float> reference_R( pSample->get_data_r(),
+										pSample->get_data_r() + nFrames );
+		ADSR adsr( pInstrument->get_adsr() );
+		adsr.attack();
+		adsr.applyADSR( reference_L.data(), reference_R.data(), nFrames,
+						nFrames + 1, 1.0 );
+		ResonantFilter::State filterState;
+		ResonantFilter::process( pInstrument->getFilterMode(), filterState,
+								 reference_L.data(), reference_R.data(),
+								 nFrames, pInstrument->get_filter_cutoff(),
+								 pInstrument->get_filter_resonance() );
+
+		// The note might start a couple of frames into the first
+		// buffer. Pan and gains are constant and only scale the
+		// output.
+		auto compare = [&]( const std::vector<float>& fused,
+							const std::vector<float>& reference ) {
+			auto firstNonZero = []( const std::vector<float>& buffer ) {
+				return std::find_if( buffer.begin(), buffer.end(),
+									 []( float fValue ) { return fValue != 0; } ) -
+					buffer.begin();
+			};
+			const int nOffset = firstNonZero( fused ) - firstNonZero( reference );
+			CPPUNIT_ASSERT( nOffset >= 0 && nOffset < nBufferSize );
+
+			const int nPeak = std::max_element(
+				reference.begin(), reference.end(), []( float fA, float fB ) {
+					return std::abs( fA ) < std::abs( fB ); } ) - reference.begin();
+			CPPUNIT_ASSERT( nPeak + nOffset < nFrames );
+			const float fScale = fused[ nPeak + nOffset ] / reference[ nPeak ];
+			CPPUNIT_ASSERT( fScale > 0 );
+
+			const float fTolerance = 1e-4 * std::abs( fused[ nPeak + nOffset ] );
+			for ( int ii = 0; ii + nOffset < nFrames; ++ii ) {
+				CPPUNIT_ASSERT_DOUBLES_EQUAL( fScale * reference[ ii ],
+											  fused[ ii + nOffset ], fTolerance );
+			}
+		};
+		compare( fused_L, reference_L );
+		compare( fused_R, reference_R );
+		___INFOLOG( "passed" );
+	}
+};
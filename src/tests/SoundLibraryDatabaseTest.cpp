@@ -0,0 +1,187 @@
+/*
+ * Hydrogen
+ * Copyright(c) 2008-2024 The hydrogen development team [hydrogen-devel@lists.sourceforge.net]
+ *
+ * http://www.hydrogen-music.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY, without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see https://www.gnu.org/licenses
+ *
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <QDateTime>
+#include <QFile>
+
+#include <core/Basics/Drumkit.h>
+#include <core/Basics/Instrument.h>
+#include <core/Basics/InstrumentList.h>
+#include <core/Helpers/Filesystem.h>
+#include <core/SoundLibrary/SoundLibraryDatabase.h>
+
+#include "TestHelper.h"
+
+using namespace H2Core;
+
+class SoundLibraryDatabaseTest : public CppUnit::TestCase {
+	CPPUNIT_TEST_SUITE( SoundLibraryDatabaseTest );
+	CPPUNIT_TEST( testIndexLookup );
+	CPPUNIT_TEST( testIndexInvalidation );
+	CPPUNIT_TEST( testFallbackDrumkit );
+	CPPUNIT_TEST_SUITE_END();
+
+	QString m_sKitFolder;
+
+	/** Whether all instruments of @a pDrumkit were loaded from disk
+	 * instead of being restored from the on-disk index. */
+	static bool isFullyLoaded( std::shared_ptr<Drumkit> pDrumkit ) {
+		for ( const auto& ppInstrument : *pDrumkit->getInstruments() ) {
+			if ( ppInstrument->get_components()->size() == 0 ) {
+				return false;
+			}
+		}
+		return pDrumkit->getInstruments()->size() > 0;
+	}
+
+public:
+
+	void setUp() override {
+		m_sKitFolder = Filesystem::tmp_dir() + "soundLibraryIndexTest/";
+		const QString sKitPath = m_sKitFolder + "baseKit/";
+		CPPUNIT_ASSERT( Filesystem::mkdir( sKitPath ) );
+		for ( const auto& sFile : { "drumkit.xml", "crash.wav", "hh.wav",
+									"kick.wav", "snare.wav" } ) {
+			CPPUNIT_ASSERT( Filesystem::file_copy(
+								H2TEST_FILE( "drumkits/baseKit/" ) + sFile,
+								sKitPath + sFile, true ) );
+		}
+	}
+
+	void tearDown() override {
+		Filesystem::rm( m_sKitFolder, true, true );
+
+		// Drop the kit of the temporary folder from the index again.
+		SoundLibraryDatabase db;
+	}
+
+	// Kits of a fresh database are restored from the index written by
+	// the previous one and loaded from disk once they are requested.
+	void testIndexLookup() {
+		___INFOLOG( "" );
+		const QString sDefaultKit =
+			Filesystem::absolute_path( Filesystem::drumkit_default_kit() );
+
+		auto pReference = Drumkit::load( sDefaultKit );
+		CPPUNIT_ASSERT( pReference != nullptr );
+
+		{
+			// Ensure the index is up to date.
+			SoundLibraryDatabase db;
+		}
+		SoundLibraryDatabase db;
+		CPPUNIT_ASSERT( db.isIndexed( sDefaultKit ) );
+
+		const auto pIndexed = db.getDrumkitDatabase().at( sDefaultKit );
+		CPPUNIT_ASSERT( pIndexed->getName() == pReference->getName() );
+		CPPUNIT_ASSERT( pIndexed->getInstruments()->size() ==
+						pReference->getInstruments()->size() );
+		CPPUNIT_ASSERT( ! isFullyLoaded( pIndexed ) );
+
+		const auto pDrumkit = db.getDrumkit( sDefaultKit );
+		CPPUNIT_ASSERT( pDrumkit != nullptr );
+		CPPUNIT_ASSERT( ! db.isIndexed( sDefaultKit ) );
+		CPPUNIT_ASSERT( isFullyLoaded( pDrumkit ) );
+		CPPUNIT_ASSERT( pDrumkit->getInstruments()->size() ==
+						pReference->getInstruments()->size() );
+		for ( int ii = 0; ii < pReference->getInstruments()->size(); ++ii ) {
+			CPPUNIT_ASSERT( pDrumkit->getInstruments()->get( ii )->get_name() ==
+							pReference->getInstruments()->get( ii )->get_name() );
+		}
+
+		// Further requests are served from the database.
+		CPPUNIT_ASSERT( db.getDrumkit( sDefaultKit ) == pDrumkit );
+		___INFOLOG( "passed" );
+	}
+
+	// A kit whose drumkit.xml changed after it was indexed is loaded
+	// from disk again.
+	void testIndexInvalidation() {
+		___INFOLOG( "" );
+		QString sKitPath;
+		{
+			SoundLibraryDatabase db;
+			db.registerDrumkitFolder( m_sKitFolder );
+			db.updateDrumkits( false );
+			for ( const auto& entry : db.getDrumkitDatabase() ) {
+				if ( entry.first.contains( "soundLibraryIndexTest" ) ) {
+					sKitPath = entry.first;
+				}
+			}
+			CPPUNIT_ASSERT( ! sKitPath.isEmpty() );
+			CPPUNIT_ASSERT( ! db.isIndexed( sKitPath ) );
+		}
+		{
+			SoundLibraryDatabase db;
+			db.registerDrumkitFolder( m_sKitFolder );
+			db.updateDrumkits( false );
+			CPPUNIT_ASSERT( db.isIndexed( sKitPath ) );
+			CPPUNIT_ASSERT( db.getDrumkitDatabase().at( sKitPath )->getName() ==
+							"H2 test DK" );
+		}
+
+		// Rename the kit. The modification time is advanced explicitly
+		// since file systems may store it with a resolution of seconds.
+		const QString sDrumkitFile = Filesystem::drumkit_file( sKitPath );
+		QFile file( sDrumkitFile );
+		CPPUNIT_ASSERT( file.open( QIODevice::ReadOnly ) );
+		QString sContent = QString::fromUtf8( file.readAll() );
+		file.close();
+		sContent.replace( "<name>H2 test DK</name>",
+						  "<name>H2 index test DK</name>" );
+		CPPUNIT_ASSERT( file.open( QIODevice::WriteOnly | QIODevice::Truncate ) );
+		file.write( sContent.toUtf8() );
+		CPPUNIT_ASSERT( file.setFileTime(
+							QDateTime::currentDateTime().addSecs( 10 ),
+							QFileDevice::FileModificationTime ) );
+		file.close();
+
+		{
+			SoundLibraryDatabase db;
+			db.registerDrumkitFolder( m_sKitFolder );
+			db.updateDrumkits( false );
+			CPPUNIT_ASSERT( ! db.isIndexed( sKitPath ) );
+			const auto pDrumkit = db.getDrumkitDatabase().at( sKitPath );
+			CPPUNIT_ASSERT( pDrumkit->getName() == "H2 index test DK" );
+			CPPUNIT_ASSERT( isFullyLoaded( pDrumkit ) );
+		}
+		___INFOLOG( "passed" );
+	}
+
+	// The fallback used by Song::getEmptySong() must not hand out kits
+	// only holding the metadata stored in the index.
+	void testFallbackDrumkit() {
+		___INFOLOG( "" );
+		{
+			SoundLibraryDatabase db;
+		}
+		SoundLibraryDatabase db;
+		CPPUNIT_ASSERT( db.getDrumkitDatabase().size() > 0 );
+
+		const auto pDrumkit = db.getFallbackDrumkit();
+		CPPUNIT_ASSERT( pDrumkit != nullptr );
+		CPPUNIT_ASSERT( ! db.isIndexed( pDrumkit->getPath() ) );
+		CPPUNIT_ASSERT( isFullyLoaded( pDrumkit ) );
+		___INFOLOG( "passed" );
+	}
+};
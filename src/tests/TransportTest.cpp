@@ -193,6 +193,17 @@ void TransportTest::testSongSizeChangeInLoopMode() {
 	___INFOLOG( "passed" );
 }
 
+void TransportTest::testColumnPatterns() {
+	___INFOLOG( "" );
+	auto pSongDemo = Song::load( QString( "%1/GM_kit_demo3.h2song" )
+								   .arg( Filesystem::demos_dir() ) );
+	CPPUNIT_ASSERT( pSongDemo != nullptr );
+	H2Core::CoreActionController::setSong( pSongDemo );
+
+	perform( &AudioEngineTests::testColumnPatterns );
+	___INFOLOG( "passed" );
+}
+
 void TransportTest::testPlaybackTrack() {
 	___INFOLOG( "" );
 
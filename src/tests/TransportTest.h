@@ -36,6 +36,7 @@ class TransportTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST( testLoopMode );
 	CPPUNIT_TEST( testSongSizeChange );
 	CPPUNIT_TEST( testSongSizeChangeInLoopMode );
+	CPPUNIT_TEST( testColumnPatterns );
 #ifndef WIN32
 	CPPUNIT_TEST( testPlaybackTrack );
 	CPPUNIT_TEST( testSampleConsistency );
@@ -60,6 +61,7 @@ public:
 	void testLoopMode();
 	void testSongSizeChange();
 	void testSongSizeChangeInLoopMode();
+	void testColumnPatterns();
 	/**
 	 * Checks whether the playback track is rendered properly and
 	 * whether it doesn't get affected by tempo markers.
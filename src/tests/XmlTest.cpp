@@ -33,6 +33,7 @@
 #include <core/Basics/Sample.h>
 #include <core/Basics/Playlist.h>
 #include <core/CoreActionController.h>
+#include <core/Helpers/BackgroundWriter.h>
 #include <core/Helpers/Filesystem.h>
 #include <core/Hydrogen.h>
 #include <core/Helpers/Xml.h>
@@ -215,6 +216,35 @@ void XmlTest::testDrumkit()
 	___INFOLOG( "passed" );
 }
 
+void XmlTest::testDrumkitStreamed()
+{
+	___INFOLOG( "" );
+	const QString sDrumkitFile = H2Core::Filesystem::drumkit_file(
+		H2TEST_FILE( "/drumkits/format-integrity" ) );
+	const QString sDrumkitDir =
+		sDrumkitFile.left( sDrumkitFile.lastIndexOf( "/" ) );
+
+	const auto pDrumkitStreamed =
+		H2Core::Drumkit::load( sDrumkitDir, false, true );
+	CPPUNIT_ASSERT( pDrumkitStreamed != nullptr );
+
+	H2Core::XMLDoc doc;
+	CPPUNIT_ASSERT( doc.read( sDrumkitFile,
+							  H2Core::Filesystem::drumkit_xsd_path(), true ) );
+	const auto pDrumkitParsed = H2Core::Drumkit::loadFrom(
+		doc.firstChildElement( "drumkit_info" ), sDrumkitDir, "", false, true );
+	CPPUNIT_ASSERT( pDrumkitParsed != nullptr );
+
+	H2Core::XMLDoc docStreamed, docParsed;
+	H2Core::XMLNode rootStreamed = docStreamed.set_root( "drumkit_info", "drumkit" );
+	pDrumkitStreamed->saveTo( rootStreamed, false, false );
+	H2Core::XMLNode rootParsed = docParsed.set_root( "drumkit_info", "drumkit" );
+	pDrumkitParsed->saveTo( rootParsed, false, false );
+
+	CPPUNIT_ASSERT( docStreamed.toString() == docParsed.toString() );
+	___INFOLOG( "passed" );
+}
+
 void XmlTest::testDrumkitLegacy()
 {
 	___INFOLOG( "" );
@@ -893,6 +923,97 @@ void XmlTest::testSong()
 	___INFOLOG( "passed" );
 }
 
+void XmlTest::testSongBackgroundWriter() {
+	___INFOLOG( "" );
+	const QString sTestFile = H2TEST_FILE( "song/current.h2song" );
+	const auto pSong = H2Core::Song::load( sTestFile );
+	CPPUNIT_ASSERT( pSong != nullptr );
+	pSong->setIsModified( true );
+	const int nRevision = pSong->getRevision();
+
+	const QString sTmpSong =
+		H2Core::Filesystem::tmp_file_path( "background-writer.h2song" );
+
+	H2Core::BackgroundWriter writer;
+	writer.write( sTmpSong, pSong->toXml() );
+	writer.waitForFinished();
+
+	H2TEST_ASSERT_H2SONG_FILES_EQUAL( sTestFile, sTmpSong );
+
+	// Serializing must neither touch the filename nor the modification
+	// state.
+	CPPUNIT_ASSERT( pSong->getFilename() == sTestFile );
+	CPPUNIT_ASSERT( pSong->getIsModified() );
+	CPPUNIT_ASSERT( pSong->getRevision() == nRevision );
+
+	writer.remove( sTmpSong );
+	writer.waitForFinished();
+	CPPUNIT_ASSERT( ! H2Core::Filesystem::file_exists( sTmpSong, true ) );
+	___INFOLOG( "passed" );
+}
+
+void XmlTest::testSongRepeatedAutoSave() {
+	___INFOLOG( "" );
+	auto pHydrogen = H2Core::Hydrogen::get_instance();
+	pHydrogen->setSong( H2Core::Song::getEmptySong() );
+	auto pSong = pHydrogen->getSong();
+	CPPUNIT_ASSERT( pSong != nullptr );
+	CPPUNIT_ASSERT( ! pSong->getIsModified() );
+
+	const QString sTmpSong =
+		H2Core::Filesystem::tmp_file_path( "repeated-autosave.h2song" );
+	H2Core::BackgroundWriter writer;
+
+	// Mimics MainForm::onAutoSaveTimer(), which only writes the song in
+	// case its revision changed since the last autosave.
+	int nAutoSavedRevision = pSong->getRevision();
+	for ( const float fVolume : { 0.5, 0.25 } ) {
+		CPPUNIT_ASSERT( H2Core::CoreActionController::setStripVolume(
+							0, fVolume, false ) );
+		CPPUNIT_ASSERT( pSong->getIsModified() );
+		CPPUNIT_ASSERT( pSong->getRevision() != nAutoSavedRevision );
+
+		writer.write( sTmpSong, pSong->toXml() );
+		writer.waitForFinished();
+		nAutoSavedRevision = pSong->getRevision();
+
+		const auto pAutoSavedSong = H2Core::Song::load( sTmpSong );
+		CPPUNIT_ASSERT( pAutoSavedSong != nullptr );
+		CPPUNIT_ASSERT( pAutoSavedSong->getDrumkit()->getInstruments()
+						->get( 0 )->get_volume() == fVolume );
+	}
+
+	writer.remove( sTmpSong );
+	writer.waitForFinished();
+	pHydrogen->setSong( H2Core::Song::getEmptySong() );
+	___INFOLOG( "passed" );
+}
+
+void XmlTest::testWriteSymlink() {
+	___INFOLOG( "" );
+	QTemporaryDir tmpDir( H2Core::Filesystem::tmp_dir() + "symlink-XXXXXX" );
+	CPPUNIT_ASSERT( tmpDir.isValid() );
+	const QString sTarget = tmpDir.filePath( "target.xml" );
+	const QString sLink = tmpDir.filePath( "link.xml" );
+
+	QFile target( sTarget );
+	CPPUNIT_ASSERT( target.open( QIODevice::WriteOnly ) );
+	target.close();
+	CPPUNIT_ASSERT( QFile::link( sTarget, sLink ) );
+
+	H2Core::XMLDoc doc;
+	auto root = doc.set_root( "root" );
+	root.write_int( "value", 42 );
+	CPPUNIT_ASSERT( doc.write( sLink ) );
+
+	CPPUNIT_ASSERT( QFileInfo( sLink ).isSymLink() );
+	H2Core::XMLDoc readDoc;
+	CPPUNIT_ASSERT( readDoc.read( sTarget, nullptr, true ) );
+	CPPUNIT_ASSERT( readDoc.firstChildElement( "root" )
+					.firstChildElement( "value" ).text() == "42" );
+	___INFOLOG( "passed" );
+}
+
 void XmlTest::testSongLegacy() {
 	___INFOLOG( "" );
 	QStringList testSongs;
@@ -35,6 +35,7 @@ class XmlTest : public CppUnit::TestCase {
 	CPPUNIT_TEST_SUITE(XmlTest);
 	CPPUNIT_TEST(testDrumkitFormatIntegrity);
 	CPPUNIT_TEST(testDrumkit);
+	CPPUNIT_TEST(testDrumkitStreamed);
 	CPPUNIT_TEST(testDrumkitLegacy);
 	CPPUNIT_TEST(testDrumkit_UpgradeInvalidADSRValues);
 	CPPUNIT_TEST(testDrumkitUpgrade);
@@ -53,6 +54,9 @@ class XmlTest : public CppUnit::TestCase {
 	CPPUNIT_TEST(testSongFormatIntegrity);
 	CPPUNIT_TEST(testSong);
 	CPPUNIT_TEST(testSongLegacy);
+	CPPUNIT_TEST(testSongBackgroundWriter);
+	CPPUNIT_TEST(testSongRepeatedAutoSave);
+	CPPUNIT_TEST(testWriteSymlink);
 	CPPUNIT_TEST(testPreferencesFormatIntegrity);
 	CPPUNIT_TEST(testShippedPreferences);
 	CPPUNIT_TEST_SUITE_END();
@@ -64,6 +68,9 @@ class XmlTest : public CppUnit::TestCase {
 		/** Checks whether the format of `drumkit.xml` files did change. */
 		void testDrumkitFormatIntegrity();
 		void testDrumkit();
+		/** Streaming a drumkit.xml has to yield the same kit as reading
+		 * it into a DOM. */
+		void testDrumkitStreamed();
 		void testDrumkitLegacy();
 		void testDrumkit_UpgradeInvalidADSRValues();
 		void testDrumkitUpgrade();
@@ -103,6 +110,13 @@ class XmlTest : public CppUnit::TestCase {
 		// This test loads song of various versions and checks whether all
 		// samples could be loaded.
 		void testSongLegacy();
+		/** Writes a song the way autosave does. */
+		void testSongBackgroundWriter();
+		/** Each edit of an already modified song has to result in
+		 * another autosave. */
+		void testSongRepeatedAutoSave();
+		/** Writing to a symbolic link must not replace the link. */
+		void testWriteSymlink();
 
 		/** Checks whether the format of our preferences file `hydrogen.conf`
 		 * did change. */
@@ -30,6 +30,7 @@
 #include "AutomationPathTest.cpp"
 #include "CliTest.h"
 #include "CoreActionControllerTest.h"
+#include "EpochReclaimerTest.cpp"
 #include "EventQueueTest.cpp"
 #include "DrumkitExportTest.h"
 #include "FilesystemTest.h"
@@ -41,9 +42,14 @@
 #include "MimeTest.h"
 #include "NetworkTest.h"
 #include "NoteTest.cpp"
+#include "OscFeedbackQueueTest.cpp"
 #include "OscServerTest.h"
+#include "PanLawTableTest.cpp"
 #include "PatternTest.h"
+#include "ResonantFilterTest.cpp"
 #include "SampleTest.cpp"
+#include "SamplerTest.cpp"
+#include "SoundLibraryDatabaseTest.cpp"
 #include "TimeTest.h"
 #include "Translations.cpp"
 #include "TransportTest.h"
@@ -60,6 +66,7 @@ CPPUNIT_TEST_SUITE_REGISTRATION( AutomationPathTest );
   CPPUNIT_TEST_SUITE_REGISTRATION( CliTest );
 #endif
 CPPUNIT_TEST_SUITE_REGISTRATION( CoreActionControllerTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( EpochReclaimerTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( EventQueueTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( DrumkitExportTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( FilesystemTest );
@@ -71,11 +78,16 @@ CPPUNIT_TEST_SUITE_REGISTRATION( MimeTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( MidiNoteTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( NetworkTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( NoteTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( OscFeedbackQueueTest );
 #ifdef H2CORE_HAVE_OSC
 CPPUNIT_TEST_SUITE_REGISTRATION( OscServerTest );
 #endif
+CPPUNIT_TEST_SUITE_REGISTRATION( PanLawTableTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( PatternTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( ResonantFilterTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( SampleTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( SamplerTest );
+CPPUNIT_TEST_SUITE_REGISTRATION( SoundLibraryDatabaseTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( TimeTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( TransportTest );
 CPPUNIT_TEST_SUITE_REGISTRATION( UITranslationTest );